@@ -64,6 +64,25 @@ export declare const enum EBlendingMode {
     Lighten = 5,
     Darken = 6
 }
+export declare const enum ESceneItemField {
+    Visible = 1,
+    Selected = 2,
+    StreamVisible = 4,
+    RecordingVisible = 8,
+    Position = 16,
+    Rotation = 32,
+    Scale = 64,
+    Alignment = 128,
+    Bounds = 256,
+    BoundsAlignment = 512,
+    BoundsType = 1024,
+    Crop = 2048,
+    ScaleFilter = 4096,
+    BlendingMethod = 8192,
+    BlendingMode = 16384,
+    Id = 32768,
+    All = 65535
+}
 export declare const enum EFontStyle {
     Bold = 1,
     Italic = 2,
@@ -292,11 +311,14 @@ export declare const FilterFactory: IFilterFactory;
 export declare const TransitionFactory: ITransitionFactory;
 export declare const DisplayFactory: IDisplayFactory;
 export declare const VolmeterFactory: IVolmeterFactory;
+export declare const SceneItemFactory: ISceneItemFactory;
+export declare const CollectionFactory: ICollectionFactory;
 export declare const FaderFactory: IFaderFactory;
 export declare const Audio: IAudio;
 export declare const AudioFactory: IAudioFactory;
 export declare const ModuleFactory: IModuleFactory;
 export declare const IPC: IIPC;
+export declare const Diagnostics: IDiagnostics;
 export declare const VideoEncoderFactory: IVideoEncoderFactory;
 export declare const ServiceFactory: IServiceFactory;
 export declare const SimpleStreamingFactory: ISimpleStreamingFactory;
@@ -342,6 +364,30 @@ export interface IIPC {
     host(uri: string): EIPCError;
     disconnect(): void;
 }
+export interface ILatencyInfo {
+    p50: number;
+    p90: number;
+    p99: number;
+    max: number;
+    mean: number;
+}
+export interface IIpcCallStats {
+    name: string;
+    calls: number;
+    handlerCalls: number;
+    roundTrip?: ILatencyInfo;
+    handler?: ILatencyInfo;
+}
+export interface IStartupPhase {
+    name: string;
+    start: number;
+    duration: number;
+    background: boolean;
+}
+export interface IDiagnostics {
+    getIpcStats(): IIpcCallStats[];
+    getStartupTimeline(): IStartupPhase[];
+}
 export interface IGlobal {
     startup(locale: string, path?: string): void;
     shutdown(): void;
@@ -564,6 +610,46 @@ export interface ISceneItem {
     blendingMethod: EBlendingMethod;
     blendingMode: EBlendingMode;
 }
+export interface ISceneItemState {
+    visible?: boolean;
+    selected?: boolean;
+    streamVisible?: boolean;
+    recordingVisible?: boolean;
+    position?: IVec2;
+    rotation?: number;
+    scale?: IVec2;
+    alignment?: EAlignment;
+    bounds?: IVec2;
+    boundsAlignment?: number;
+    boundsType?: EBoundsType;
+    crop?: ICropInfo;
+    scaleFilter?: EScaleType;
+    blendingMethod?: EBlendingMethod;
+    blendingMode?: EBlendingMode;
+    id?: number;
+}
+export interface ISceneItemUpdate {
+    item: ISceneItem;
+    visible?: boolean;
+    selected?: boolean;
+    streamVisible?: boolean;
+    recordingVisible?: boolean;
+    position?: IVec2;
+    rotation?: number;
+    scale?: IVec2;
+    alignment?: EAlignment;
+    bounds?: IVec2;
+    boundsAlignment?: number;
+    boundsType?: EBoundsType;
+    crop?: ICropInfo;
+    scaleFilter?: EScaleType;
+    blendingMethod?: EBlendingMethod;
+    blendingMode?: EBlendingMode;
+}
+export interface ISceneItemFactory {
+    batchGet(items: ISceneItem[], fields: ESceneItemField): ISceneItemState[];
+    batchSet(updates: ISceneItemUpdate[]): number;
+}
 export interface ITransitionFactory extends IFactoryTypes {
     create(id: string, name: string, settings?: ISettings, hotkeys?: ISettings): ITransition;
     createPrivate(id: string, name: string, settings?: ISettings): ITransition;
@@ -616,8 +702,16 @@ export interface IVolmeter {
     destroy(): void;
     attach(source: IInput): void;
     detach(): void;
-    addCallback(cb: (magnitude: number[], peak: number[], inputPeak: number[]) => void): ICallbackData;
+    addCallback(cb: (magnitude: number[], peak: number[], inputPeak: number[], ballistics: IVolmeterBallistics) => void): ICallbackData;
     removeCallback(cbData: ICallbackData): void;
+    setBallistics(attack: number, decay: number, peakHold: number): void;
+    readLevels(ballistics?: boolean): Float32Array;
+}
+export interface IVolmeterBallistics {
+    magnitude: number[];
+    peak: number[];
+    peakHold: number[];
+    maxPeak: number[];
 }
 export interface ICallbackData {
 }
@@ -722,6 +816,31 @@ export interface SourceInfo {
     deinterlaceFieldOrder: EDeinterlaceFieldOrder;
 }
 export declare function createSources(sources: SourceInfo[]): IInput[];
+export interface ICollectionItemInfo extends ISceneItemInfo {
+    alignment?: EAlignment;
+    bounds?: IVec2;
+    boundsType?: EBoundsType;
+    boundsAlignment?: number;
+    blendingMethod?: EBlendingMethod;
+}
+export interface ICollectionSceneInfo {
+    name: string;
+    group?: boolean;
+    items: ICollectionItemInfo[];
+}
+export interface ISceneCollectionInfo {
+    sources: SourceInfo[];
+    scenes: ICollectionSceneInfo[];
+}
+export interface ILoadedCollection {
+    sources: IInput[];
+    scenes: IScene[];
+    items: ISceneItem[][];
+}
+export interface ICollectionFactory {
+    load(collection: ISceneCollectionInfo): ILoadedCollection;
+    save(): ISceneCollectionInfo;
+}
 export interface ISourceSize {
     name: string;
     width: number;
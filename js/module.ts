@@ -97,6 +97,30 @@ export const enum EBlendingMode {
     Darken
 }
 
+/**
+ * Fields of a scene item, combine them to select what
+ * {@link ISceneItemFactory.batchGet} returns
+ */
+export const enum ESceneItemField {
+    Visible = (1 << 0),
+    Selected = (1 << 1),
+    StreamVisible = (1 << 2),
+    RecordingVisible = (1 << 3),
+    Position = (1 << 4),
+    Rotation = (1 << 5),
+    Scale = (1 << 6),
+    Alignment = (1 << 7),
+    Bounds = (1 << 8),
+    BoundsAlignment = (1 << 9),
+    BoundsType = (1 << 10),
+    Crop = (1 << 11),
+    ScaleFilter = (1 << 12),
+    BlendingMethod = (1 << 13),
+    BlendingMode = (1 << 14),
+    Id = (1 << 15),
+    All = (1 << 16) - 1
+}
+
 export const enum EFontStyle {
   Bold = (1<<0),
   Italic = (1<<1),
@@ -371,11 +395,14 @@ export const FilterFactory: IFilterFactory = obs.Filter;
 export const TransitionFactory: ITransitionFactory = obs.Transition;
 export const DisplayFactory: IDisplayFactory = obs.Display;
 export const VolmeterFactory: IVolmeterFactory = obs.Volmeter;
+export const SceneItemFactory: ISceneItemFactory = obs.SceneItem;
+export const CollectionFactory: ICollectionFactory = obs.Collection;
 export const FaderFactory: IFaderFactory = obs.Fader;
 export const Audio: IAudio = obs.Audio;
 export const AudioFactory: IAudioFactory = obs.Audio;
 export const ModuleFactory: IModuleFactory = obs.Module;
 export const IPC: IIPC = obs.IPC;
+export const Diagnostics: IDiagnostics = obs.Diagnostics;
 export const VideoEncoderFactory: IVideoEncoderFactory = obs.VideoEncoder;
 export const ServiceFactory: IServiceFactory = obs.Service;
 export const SimpleStreamingFactory: ISimpleStreamingFactory = obs.SimpleStreaming;
@@ -476,6 +503,59 @@ export interface IIPC {
 	disconnect(): void;
 }
  
+/**
+ * Latency of one IPC function, in microseconds
+ */
+export interface ILatencyInfo {
+    p50: number,
+    p90: number,
+    p99: number,
+    max: number,
+    mean: number
+}
+
+export interface IIpcCallStats {
+    /**
+     * Class and function, e.g. "Source.GetProperties"
+     */
+    name: string,
+    calls: number,
+    handlerCalls: number,
+    /**
+     * Time from the client sending the call to receiving its answer
+     */
+    roundTrip?: ILatencyInfo,
+    /**
+     * Time spent by the server handler alone
+     */
+    handler?: ILatencyInfo
+}
+
+export interface IStartupPhase {
+    name: string,
+    /**
+     * Milliseconds since the server process started
+     */
+    start: number,
+    duration: number,
+    /**
+     * Deferred work that ran while the server already answered calls
+     */
+    background: boolean
+}
+
+export interface IDiagnostics {
+    /**
+     * Latency of every IPC function called since startup, sorted by name
+     */
+    getIpcStats(): IIpcCallStats[];
+
+    /**
+     * Phases of the server startup in the order they ended
+     */
+    getStartupTimeline(): IStartupPhase[];
+}
+
 export interface IGlobal {
     /**
      * Initializes libobs global context
@@ -1130,6 +1210,68 @@ export interface ISceneItem {
     blendingMode: EBlendingMode;
 }
 
+/**
+ * Values of a scene item, only the fields requested
+ * through {@link ESceneItemField} are present
+ */
+export interface ISceneItemState {
+    visible?: boolean;
+    selected?: boolean;
+    streamVisible?: boolean;
+    recordingVisible?: boolean;
+    position?: IVec2;
+    rotation?: number;
+    scale?: IVec2;
+    alignment?: EAlignment;
+    bounds?: IVec2;
+    boundsAlignment?: number;
+    boundsType?: EBoundsType;
+    crop?: ICropInfo;
+    scaleFilter?: EScaleType;
+    blendingMethod?: EBlendingMethod;
+    blendingMode?: EBlendingMode;
+    id?: number;
+}
+
+/**
+ * Values to apply to a scene item, fields left out are not changed
+ */
+export interface ISceneItemUpdate {
+    item: ISceneItem;
+    visible?: boolean;
+    selected?: boolean;
+    streamVisible?: boolean;
+    recordingVisible?: boolean;
+    position?: IVec2;
+    rotation?: number;
+    scale?: IVec2;
+    alignment?: EAlignment;
+    bounds?: IVec2;
+    boundsAlignment?: number;
+    boundsType?: EBoundsType;
+    crop?: ICropInfo;
+    scaleFilter?: EScaleType;
+    blendingMethod?: EBlendingMethod;
+    blendingMode?: EBlendingMode;
+}
+
+export interface ISceneItemFactory {
+    /**
+     * Read the same fields of several scene items in a single call
+     * @param items - Items to read
+     * @param fields - Combination of {@link ESceneItemField}
+     * @returns - One state per item, in order, or null for items that no longer exist
+     */
+    batchGet(items: ISceneItem[], fields: ESceneItemField): ISceneItemState[];
+
+    /**
+     * Apply changes to several scene items in a single call
+     * @param updates - Item and values to apply
+     * @returns - Number of items that no longer exist and were skipped
+     */
+    batchSet(updates: ISceneItemUpdate[]): number;
+}
+
 export interface ITransitionFactory extends IFactoryTypes {
     /**
      * Create a new instance of an ObsTransition
@@ -1384,13 +1526,57 @@ export interface IVolmeter {
     addCallback(
         cb: (magnitude: number[],
              peak: number[],
-             inputPeak: number[]) => void): ICallbackData;
+             inputPeak: number[],
+             ballistics: IVolmeterBallistics) => void): ICallbackData;
 
     /**
      * Remove a callback to prevent events from occuring immediately. 
      * @param cbData - Object passed back from a call to {@link ObsVolmeter#addCallback}
      */
     removeCallback(cbData: ICallbackData): void;
+
+    /**
+     * Configure the level ballistics computed by the server on every audio callback.
+     * @param attack - Magnitude integration time, in seconds. 0 follows the magnitude as is.
+     * @param decay - Peak decay rate, in dB per second.
+     * @param peakHold - How long the highest peak is held, in seconds.
+     */
+    setBallistics(attack: number, decay: number, peakHold: number): void;
+
+    /**
+     * Read the latest levels from the shared level buffer without any IPC call.
+     * The array is reused between calls and holds the magnitude, peak and input peak
+     * values of every channel, in that order. It is empty while the source is muted.
+     * @param ballistics - Also append the smoothed magnitude, decaying peak, held peak
+     * and the max peak since the last read, in that order. Reading them starts a new
+     * max peak window, which is shared with the callbacks of the same volmeter.
+     */
+    readLevels(ballistics?: boolean): Float32Array;
+}
+
+/**
+ * Levels smoothed by the server, in dB, one value per channel.
+ */
+export interface IVolmeterBallistics {
+    /**
+     * Magnitude integrated over the attack time.
+     */
+    magnitude: number[];
+
+    /**
+     * Follows rising peaks at once and falls at the decay rate.
+     */
+    peak: number[];
+
+    /**
+     * Highest peak, held for the peak hold duration.
+     */
+    peakHold: number[];
+
+    /**
+     * Highest peak since the previous callback or ballistics read, clips are never missed.
+     */
+    maxPeak: number[];
 }
 
 /**
@@ -1566,6 +1752,46 @@ export function createSources(sources: SourceInfo[]): IInput[] {
     }
     return items;
 }
+export interface ICollectionItemInfo extends ISceneItemInfo {
+    alignment?: EAlignment,
+    bounds?: IVec2,
+    boundsType?: EBoundsType,
+    boundsAlignment?: number,
+    blendingMethod?: EBlendingMethod
+}
+
+export interface ICollectionSceneInfo {
+    name: string,
+    group?: boolean,
+    items: ICollectionItemInfo[]
+}
+
+export interface ISceneCollectionInfo {
+    sources: SourceInfo[],
+    scenes: ICollectionSceneInfo[]
+}
+
+export interface ILoadedCollection {
+    sources: IInput[],
+    scenes: IScene[],
+    items: ISceneItem[][]
+}
+
+export interface ICollectionFactory {
+    /**
+     * Create every source, filter, scene and scene item of a collection in a single call
+     * @param collection - Sources first, scene items refer to sources and scenes by name
+     * @returns - Objects in the order of the collection, null for those that failed
+     */
+    load(collection: ISceneCollectionInfo): ILoadedCollection;
+
+    /**
+     * Read every public source and scene in a single call, groups are listed with the scenes
+     * @returns - A collection that load accepts
+     */
+    save(): ISceneCollectionInfo;
+}
+
 export interface ISourceSize {
     name: string,
     width: number,
@@ -16,14 +16,91 @@
 
 ******************************************************************************/
 
+#pragma once
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include "utility-v8.hpp"
 #include "properties.hpp"
 
+// Generation of the data cached for each scene.
+//
+// Entries remember the generation of their scene when they were filled, if it
+// moved since then the entry is reset on its next Retrieve. Bumping a scene is
+// therefore enough to invalidate all of its items at once. The server pushes
+// a new generation over the event channel whenever items are added, removed,
+// reordered or toggled outside of the client's control.
+class CacheGenerations {
+public:
+	static CacheGenerations &getInstance()
+	{
+		static CacheGenerations instance;
+		return instance;
+	}
+
+	CacheGenerations(CacheGenerations const &) = delete;
+	void operator=(CacheGenerations const &) = delete;
+
+	uint64_t Get(uint64_t scene_id)
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		auto it = scenes.find(scene_id);
+		if (it == scenes.end() || it->second < global)
+			return global;
+		return it->second;
+	}
+
+	// A change the client made to the scene itself.
+	void InvalidateScene(uint64_t scene_id)
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		scenes[scene_id] = ++counter;
+	}
+
+	// Every scene, for changes the client cannot pin on scenes: a removed
+	// source leaves every scene holding it, see ISource::Remove. The
+	// generations last pushed by the server are forgotten as well, the next
+	// push of each scene counts as a change.
+	void InvalidateAll()
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		global = ++counter;
+		scenes.clear();
+		server.clear();
+	}
+
+	// Generation received from the server, only a change invalidates the scene.
+	void Update(uint64_t scene_id, uint64_t generation)
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		uint64_t &last = server[scene_id];
+		if (last == generation)
+			return;
+		last = generation;
+		scenes[scene_id] = ++counter;
+	}
+
+private:
+	CacheGenerations(){};
+
+	std::mutex mtx;
+	uint64_t counter = 0;
+	uint64_t global = 0;
+	std::unordered_map<uint64_t, uint64_t> scenes;
+	std::unordered_map<uint64_t, uint64_t> server;
+};
+
 struct SceneInfo {
 	uint64_t id;
 	std::vector<std::pair<int64_t, uint64_t>> items;
 	bool itemsOrderCached = false;
 	std::string name;
+
+	uint64_t generation = 0;
+	uint64_t generationKey() const { return id; }
+	void invalidate() { itemsOrderCached = false; }
 };
 
 struct SourceDataInfo {
@@ -34,16 +111,20 @@ struct SourceDataInfo {
 	bool isMuted = false;
 	bool mutedChanged = true;
 
-	std::string setting = "";
+	// In the format of settings-binary.hpp, Update diffs against it.
+	std::vector<char> setting;
 	bool settingsChanged = true;
 
 	osn::property_map_t properties;
 	bool propertiesChanged = true;
+	// Hashes from the last property snapshot, one per entry of properties.
+	uint64_t propertiesHash = 0;
+	std::vector<uint64_t> propertyHashes;
 
 	uint32_t audioMixers = UINT32_MAX;
 	bool audioMixersChanged = true;
 
-	std::vector<uint64_t> *filters = new std::vector<uint64_t>();
+	std::vector<uint64_t> filters;
 	bool filtersOrderChanged = true;
 
 	uint32_t deinterlaceMode = 0;
@@ -51,6 +132,20 @@ struct SourceDataInfo {
 
 	uint32_t deinterlaceFieldOrder = 0;
 	bool deinterlaceFieldOrderChanged = true;
+
+	uint64_t generation = 0;
+	// Scenes share their id with their source.
+	uint64_t generationKey() const { return id; }
+	void invalidate()
+	{
+		mutedChanged = true;
+		settingsChanged = true;
+		propertiesChanged = true;
+		audioMixersChanged = true;
+		filtersOrderChanged = true;
+		deinterlaceModeChanged = true;
+		deinterlaceFieldOrderChanged = true;
+	}
 };
 
 struct SceneItemData {
@@ -95,9 +190,31 @@ struct SceneItemData {
 
 	uint32_t blendingMethod = 0;
 	bool blendingMethodChanged = true;
+
+	uint64_t generation = 0;
+	uint64_t generationKey() const { return scene_id; }
+	void invalidate()
+	{
+		cached = false;
+		posChanged = true;
+		scaleChanged = true;
+		visibleChanged = true;
+		cropChanged = true;
+		rotationChanged = true;
+		streamVisibleChanged = true;
+		recordingVisibleChanged = true;
+		scaleFilterChanged = true;
+		blendingModeChanged = true;
+		blendingMethodChanged = true;
+	}
 };
 
+// Owns the cached entries of one type, T is a pointer to SceneInfo,
+// SourceDataInfo or SceneItemData. Pointers returned by Retrieve stay valid
+// until the entry is removed or replaced, which only happens on the JS thread.
 template<class T> class CacheManager {
+	using Entry = typename std::remove_pointer<T>::type;
+
 public:
 	static CacheManager &getInstance()
 	{
@@ -113,94 +230,95 @@ public:
 	void operator=(CacheManager const &) = delete;
 
 private:
-	std::map<std::string, SceneInfo *> scenesByName;
-	std::map<uint64_t, SceneInfo *> scenesById;
-	std::map<std::string, SourceDataInfo *> sourcesByName;
-	std::map<uint64_t, SourceDataInfo *> sourcesById;
-	std::map<uint64_t, SceneItemData *> itemsData;
+	std::mutex mtx;
+	std::unordered_map<uint64_t, std::unique_ptr<Entry>> byId;
+	std::unordered_map<std::string, Entry *> byName;
+	// Name each entry was stored under, entries may rename themselves later.
+	std::unordered_map<uint64_t, std::string> names;
 
-public:
-	void Store(uint64_t id, std::string name, SceneInfo *si)
+	// Resets entry if its scene was invalidated since it was filled.
+	void validate(Entry *entry)
+	{
+		uint64_t generation = CacheGenerations::getInstance().Get(entry->generationKey());
+		if (entry->generation != generation) {
+			entry->invalidate();
+			entry->generation = generation;
+		}
+	}
+
+	void unname(uint64_t id)
 	{
-		si->name = name;
-		scenesByName.erase(name);
-		scenesById.erase(id);
-		scenesByName.emplace(name, si);
-		scenesById.emplace(id, si);
+		auto name = names.find(id);
+		if (name == names.end())
+			return;
+
+		auto it = byId.find(id);
+		auto named = byName.find(name->second);
+		if (it != byId.end() && named != byName.end() && named->second == it->second.get())
+			byName.erase(named);
+		names.erase(name);
 	}
-	void Store(uint64_t id, std::string name, SourceDataInfo *sdi)
+
+public:
+	// Takes ownership of entry, replacing any previous entry with the same id.
+	void Store(uint64_t id, std::string name, T entry)
 	{
-		sdi->name = name;
-		sourcesByName.erase(name);
-		sourcesById.erase(id);
-		sourcesByName.emplace(name, sdi);
-		sourcesById.emplace(id, sdi);
+		std::lock_guard<std::mutex> lock(mtx);
+		entry->name = name;
+		entry->generation = CacheGenerations::getInstance().Get(entry->generationKey());
+
+		unname(id);
+		byName.insert_or_assign(name, entry);
+		names.insert_or_assign(id, name);
+		byId.insert_or_assign(id, std::unique_ptr<Entry>(entry));
 	}
-	void Store(uint64_t id, SceneItemData *sid)
+	void Store(uint64_t id, T entry)
 	{
-		itemsData.erase(id);
-		itemsData.emplace(id, sid);
+		std::lock_guard<std::mutex> lock(mtx);
+		entry->generation = CacheGenerations::getInstance().Get(entry->generationKey());
+		byId.insert_or_assign(id, std::unique_ptr<Entry>(entry));
 	}
 	T Retrieve(uint64_t id)
 	{
-		if (id != UINT64_MAX) {
-			if (typeid(T) == typeid(SceneInfo *)) {
-				auto it = scenesById.find(id);
-				if (it != scenesById.end()) {
-					return (T)it->second;
-				}
-			} else if (typeid(T) == typeid(SourceDataInfo *)) {
-				auto it = sourcesById.find(id);
-				if (it != sourcesById.end()) {
-					return (T)it->second;
-				}
-			} else if (typeid(T) == typeid(SceneItemData *)) {
-				auto it = itemsData.find(id);
-				if (it != itemsData.end()) {
-					return (T)it->second;
-				}
-			}
-		}
-		return nullptr;
+		if (id == UINT64_MAX)
+			return nullptr;
+
+		std::lock_guard<std::mutex> lock(mtx);
+		auto it = byId.find(id);
+		if (it == byId.end())
+			return nullptr;
+
+		validate(it->second.get());
+		return it->second.get();
 	}
 	T Retrieve(const std::string &name)
 	{
-		if (name.size() > 0) {
-			if (typeid(T) == typeid(SceneInfo *)) {
-				auto it = scenesByName.find(name);
-				if (it != scenesByName.end()) {
-					return (T)it->second;
-				}
-			} else if (typeid(T) == typeid(SourceDataInfo *)) {
-				auto it = sourcesByName.find(name);
-				if (it != sourcesByName.end()) {
-					return (T)it->second;
-				}
-			}
-		}
-		return nullptr;
+		if (name.size() == 0)
+			return nullptr;
+
+		std::lock_guard<std::mutex> lock(mtx);
+		auto it = byName.find(name);
+		if (it == byName.end())
+			return nullptr;
+
+		validate(it->second);
+		return it->second;
 	}
 	void Remove(uint64_t id)
 	{
-		if (id != UINT64_MAX) {
-			if (typeid(T) == typeid(SceneInfo *)) {
-				auto it = scenesById.find(id);
-				if (it != scenesById.end()) {
-					scenesByName.erase(it->second->name);
-					scenesById.erase(id);
-				}
-			} else if (typeid(T) == typeid(SourceDataInfo *)) {
-				auto it = sourcesById.find(id);
-				if (it != sourcesById.end()) {
-					sourcesByName.erase(it->second->name);
-					sourcesById.erase(id);
-				}
-			} else if (typeid(T) == typeid(SceneItemData *)) {
-				auto it = itemsData.find(id);
-				if (it != itemsData.end()) {
-					itemsData.erase(id);
-				}
-			}
+		if (id == UINT64_MAX)
+			return;
+
+		std::unique_ptr<Entry> entry;
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			auto it = byId.find(id);
+			if (it == byId.end())
+				return;
+
+			unname(id);
+			entry = std::move(it->second);
+			byId.erase(it);
 		}
 	}
-};
\ No newline at end of file
+};
@@ -17,6 +17,7 @@
 ******************************************************************************/
 
 #include "callback-manager.hpp"
+#include "cache-manager.hpp"
 #include "controller.hpp"
 #include "osn-error.hpp"
 #include "utility-v8.hpp"
@@ -30,12 +31,12 @@
 
 bool globalCallback::isWorkerRunning = false;
 bool globalCallback::worker_stop = true;
-uint32_t globalCallback::sleepIntervalMS = 50;
+uint32_t globalCallback::eventsTimeoutMS = 1000;
 std::thread *globalCallback::worker_thread = nullptr;
 Napi::ThreadSafeFunction globalCallback::js_thread;
 bool globalCallback::m_all_workers_stop = false;
 std::mutex globalCallback::mtx_volmeters;
-std::map<uint64_t, Napi::ThreadSafeFunction> globalCallback::volmeters;
+std::map<uint64_t, VolmeterCallback> globalCallback::volmeters;
 
 void globalCallback::Init(Napi::Env env, Napi::Object exports)
 {
@@ -78,6 +79,12 @@ void globalCallback::stop_worker(void)
 		return;
 
 	worker_stop = true;
+
+	// Release the pending WaitEvents call so the worker notices the stop request
+	auto conn = Controller::GetInstance().GetConnection();
+	if (conn)
+		conn->call_synchronous_helper("CallbackManager", "Interrupt", {});
+
 	if (worker_thread->joinable()) {
 		worker_thread->join();
 	}
@@ -120,104 +127,109 @@ void globalCallback::worker()
 				input_peak.Set(i, Napi::Number::New(env, data->input_peak[i]));
 			}
 
+			auto to_array = [&env](const std::vector<float> &values) {
+				Napi::Array array = Napi::Array::New(env, values.size());
+				for (size_t i = 0; i < values.size(); i++)
+					array.Set(i, Napi::Number::New(env, values[i]));
+				return array;
+			};
+
+			Napi::Object ballistics = Napi::Object::New(env);
+			ballistics.Set("magnitude", to_array(data->display_magnitude));
+			ballistics.Set("peak", to_array(data->display_peak));
+			ballistics.Set("peakHold", to_array(data->peak_hold));
+			ballistics.Set("maxPeak", to_array(data->max_peak));
+
 			if (data->magnitude.size() > 0 && data->peak.size() > 0 && data->input_peak.size() > 0) {
-				jsCallback.Call({magnitude, peak, input_peak});
+				jsCallback.Call({magnitude, peak, input_peak, ballistics});
 			}
 		} catch (...) {
 		}
 		delete data;
 	};
 
-	size_t totalSleepMS = 0;
+	// Events are pushed by the server through a blocking call on a dedicated
+	// connection, idle periods cost a single wake up per timeout.
+	auto conn = Controller::GetInstance().OpenChannel();
+	if (!conn)
+		return;
 
 	while (!worker_stop && !m_all_workers_stop) {
-		auto tp_start = std::chrono::high_resolution_clock::now();
-
-		auto conn = Controller::GetInstance().GetConnection();
-		if (!conn)
-			return;
-
-		mtx_volmeters.lock();
-		std::vector<char> volmeters_ids;
-		{
-			uint32_t index = 0;
-			volmeters_ids.resize(sizeof(uint64_t) * volmeters.size());
-			for (auto vol : volmeters) {
-				*reinterpret_cast<uint64_t *>(volmeters_ids.data() + index) = vol.first;
-				index += sizeof(uint64_t);
-			}
-		}
-
-		{
-			std::vector<ipc::value> response = conn->call_synchronous_helper(
-				"CallbackManager", "GlobalQuery", {ipc::value((uint64_t)volmeters_ids.size()), ipc::value(volmeters_ids)});
-			if (!response.size() || (response.size() == 1)) {
-				goto do_sleep;
-			}
+		std::vector<ipc::value> response = conn->call_synchronous_helper("CallbackManager", "WaitEvents", {ipc::value(eventsTimeoutMS)});
+		if (!response.size() || (ErrorCode)response[0].value_union.ui64 != ErrorCode::Ok)
+			break;
 
-			uint32_t index = 1;
+		if (worker_stop || m_all_workers_stop)
+			break;
 
+		size_t index = 1;
+		uint32_t sourcesCount = response[index++].value_union.ui32;
+		if (sourcesCount > 0) {
 			SourceSizeInfoData *data = new SourceSizeInfoData{{}};
-			for (int i = 2; i < (response[1].value_union.ui32 * 4) + 2; i++) {
+			data->items.reserve(sourcesCount);
+			for (uint32_t i = 0; i < sourcesCount; i++) {
 				SourceSizeInfo *item = new SourceSizeInfo;
 
-				item->name = response[i++].value_str;
-				item->width = response[i++].value_union.ui32;
-				item->height = response[i++].value_union.ui32;
-				item->flags = response[i].value_union.ui32;
+				item->name = response[index++].value_str;
+				item->width = response[index++].value_union.ui32;
+				item->height = response[index++].value_union.ui32;
+				item->flags = response[index++].value_union.ui32;
 				data->items.push_back(item);
-				index = i;
 			}
 
-			if (data->items.size() > 0) {
-				napi_status status = js_thread.NonBlockingCall(data, sources_callback);
-				if (status != napi_ok) {
-					delete data;
-				}
+			napi_status status = js_thread.NonBlockingCall(data, sources_callback);
+			if (status != napi_ok) {
+				delete data;
 			}
+		}
 
-			index++;
-
-			for (auto vol : volmeters) {
-				VolmeterData *data = new VolmeterData{{}, {}, {}};
-				size_t channels = response[index++].value_union.i32;
-				bool isMuted = response[index++].value_union.i32;
-				if (!channels)
-					continue;
-				if (!isMuted) {
-					data->magnitude.resize(channels);
-					data->peak.resize(channels);
-					data->input_peak.resize(channels);
-					for (size_t ch = 0; ch < channels; ch++) {
-						data->magnitude[ch] = response[index + ch * 3 + 0].value_union.fp32;
-						data->peak[ch] = response[index + ch * 3 + 1].value_union.fp32;
-						data->input_peak[ch] = response[index + ch * 3 + 2].value_union.fp32;
-					}
-					napi_status status = vol.second.NonBlockingCall(data, volmeter_callback);
-					if (status != napi_ok) {
-						delete data;
-					}
-
-					index += (3 * channels);
-				}
+		// Only the ids of the updated meters are sent, levels are read from the shared buffer
+		uint32_t volmetersCount = response[index++].value_union.ui32;
+		std::unique_lock<std::mutex> ulock(mtx_volmeters);
+		for (uint32_t i = 0; i < volmetersCount; i++) {
+			uint64_t id = response[index++].value_union.ui64;
+
+			auto vol = volmeters.find(id);
+			if (vol == volmeters.end() || !osn::Volmeter::levels)
+				continue;
+
+			volmeter::LevelsSnapshot snapshot;
+			if (!osn::Volmeter::levels->read(vol->second.slot, snapshot) || snapshot.uid != id)
+				continue;
+			if (snapshot.muted || !snapshot.channels)
+				continue;
+			osn::Volmeter::levels->acknowledge(vol->second.slot, snapshot);
+
+			VolmeterData *data = new VolmeterData{{}, {}, {}, {}, {}, {}, {}};
+			data->magnitude.assign(snapshot.magnitude, snapshot.magnitude + snapshot.channels);
+			data->peak.assign(snapshot.peak, snapshot.peak + snapshot.channels);
+			data->input_peak.assign(snapshot.input_peak, snapshot.input_peak + snapshot.channels);
+			data->display_magnitude.assign(snapshot.display_magnitude, snapshot.display_magnitude + snapshot.channels);
+			data->display_peak.assign(snapshot.display_peak, snapshot.display_peak + snapshot.channels);
+			data->peak_hold.assign(snapshot.peak_hold, snapshot.peak_hold + snapshot.channels);
+			data->max_peak.assign(snapshot.max_peak, snapshot.max_peak + snapshot.channels);
+			napi_status status = vol->second.js_thread.NonBlockingCall(data, volmeter_callback);
+			if (status != napi_ok) {
+				delete data;
 			}
 		}
-
-	do_sleep:
-		mtx_volmeters.unlock();
-		auto tp_end = std::chrono::high_resolution_clock::now();
-		auto dur = std::chrono::duration_cast<std::chrono::milliseconds>(tp_end - tp_start);
-		totalSleepMS = sleepIntervalMS - dur.count();
-		if (totalSleepMS > 0)
-			std::this_thread::sleep_for(std::chrono::milliseconds(totalSleepMS));
+		ulock.unlock();
+
+		// Scenes changed on the server side, drop what is cached for their items
+		uint32_t scenesCount = response[index++].value_union.ui32;
+		for (uint32_t i = 0; i < scenesCount; i++) {
+			uint64_t id = response[index++].value_union.ui64;
+			uint64_t generation = response[index++].value_union.ui64;
+			CacheGenerations::getInstance().Update(id, generation);
+		}
 	}
 	return;
 }
 
-void globalCallback::add_volmeter(napi_env env, uint64_t id, Napi::Function cb)
+void globalCallback::add_volmeter(napi_env env, uint64_t id, uint32_t slot, Napi::Function cb)
 {
 	Napi::ThreadSafeFunction vol_thread = Napi::ThreadSafeFunction::New(env, cb, "Volmeter", 0, 1, [](Napi::Env) {});
-	volmeters.insert(std::make_pair(id, vol_thread));
+	volmeters.insert(std::make_pair(id, VolmeterCallback{vol_thread, slot}));
 }
 
 void globalCallback::remove_volmeter(uint64_t id)
@@ -225,6 +237,6 @@ void globalCallback::remove_volmeter(uint64_t id)
 	if (volmeters.find(id) == volmeters.end())
 		return;
 
-	volmeters[id].Release();
+	volmeters[id].js_thread.Release();
 	volmeters.erase(id);
 }
\ No newline at end of file
@@ -33,22 +33,27 @@ struct SourceSizeInfoData {
 	std::vector<SourceSizeInfo *> items;
 };
 
+struct VolmeterCallback {
+	Napi::ThreadSafeFunction js_thread;
+	uint32_t slot;
+};
+
 namespace globalCallback {
 extern bool isWorkerRunning;
 extern bool worker_stop;
-extern uint32_t sleepIntervalMS;
+extern uint32_t eventsTimeoutMS;
 extern std::thread *worker_thread;
 extern Napi::ThreadSafeFunction js_thread;
 extern bool m_all_workers_stop;
 
 extern std::mutex mtx_volmeters;
-extern std::map<uint64_t, Napi::ThreadSafeFunction> volmeters;
+extern std::map<uint64_t, VolmeterCallback> volmeters;
 
 void worker(void);
 void start_worker(napi_env env, Napi::Function async_callback);
 void stop_worker(void);
 
-void add_volmeter(napi_env env, uint64_t id, Napi::Function cb);
+void add_volmeter(napi_env env, uint64_t id, uint32_t slot, Napi::Function cb);
 void remove_volmeter(uint64_t id);
 
 void Init(Napi::Env env, Napi::Object exports);
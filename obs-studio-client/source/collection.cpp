@@ -0,0 +1,229 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#include "collection.hpp"
+#include <string>
+#include <vector>
+#include "cache-manager.hpp"
+#include "controller.hpp"
+#include "osn-error.hpp"
+#include "input.hpp"
+#include "ipc-value.hpp"
+#include "scene.hpp"
+#include "sceneitem.hpp"
+#include "settings-v8.hpp"
+#include "shared.hpp"
+#include "utility.hpp"
+
+Napi::FunctionReference osn::Collection::constructor;
+
+Napi::Object osn::Collection::Init(Napi::Env env, Napi::Object exports)
+{
+	Napi::HandleScope scope(env);
+	Napi::Function func = DefineClass(env, "Collection",
+					  {
+						  StaticMethod("load", &osn::Collection::Load),
+						  StaticMethod("save", &osn::Collection::Save),
+					  });
+	exports.Set("Collection", func);
+	osn::Collection::constructor = Napi::Persistent(func);
+	osn::Collection::constructor.SuppressDestruct();
+	return exports;
+}
+
+osn::Collection::Collection(const Napi::CallbackInfo &info) : Napi::ObjectWrap<osn::Collection>(info)
+{
+	Napi::Env env = info.Env();
+	Napi::HandleScope scope(env);
+}
+
+// One entry of the Load reply, id stays UINT64_MAX if it failed.
+struct LoadedEntry {
+	uint64_t id = UINT64_MAX;
+	std::string name;
+	std::string type;
+	std::vector<char> settings;
+	uint32_t audioMixers = 0;
+	uint32_t deinterlaceMode = 0;
+	uint32_t deinterlaceFieldOrder = 0;
+	settings::Record items = {};
+
+	LoadedEntry(settings::Reader reader)
+	{
+		settings::Record record;
+		while (reader.next(record)) {
+			if (record.is("id"))
+				id = (uint64_t)record.number();
+			else if (record.is("name") && record.type == settings::String)
+				name.assign(record.value, record.value_size);
+			else if (record.is("type") && record.type == settings::String)
+				type.assign(record.value, record.value_size);
+			else if (record.is("settings") && record.type == settings::Object)
+				settings.assign(record.value, record.value + record.value_size);
+			else if (record.is("audioMixers"))
+				audioMixers = (uint32_t)record.number();
+			else if (record.is("deinterlaceMode"))
+				deinterlaceMode = (uint32_t)record.number();
+			else if (record.is("deinterlaceFieldOrder"))
+				deinterlaceFieldOrder = (uint32_t)record.number();
+			else if (record.is("items") && record.type == settings::Array)
+				items = record;
+		}
+	}
+};
+
+static Napi::Array LoadSources(Napi::Env env, const settings::Record &sources)
+{
+	Napi::Array array = Napi::Array::New(env, sources.count);
+	settings::Reader elements(sources.value, sources.value_size);
+	settings::Reader element(nullptr, 0);
+	for (uint32_t i = 0; i < sources.count && elements.next_element(element); i++) {
+		LoadedEntry entry(element);
+		if (entry.id == UINT64_MAX) {
+			array.Set(i, env.Null());
+			continue;
+		}
+
+		SourceDataInfo *sdi = new SourceDataInfo;
+		sdi->name = entry.name;
+		sdi->obs_sourceId = entry.type;
+		sdi->id = entry.id;
+		sdi->setting = std::move(entry.settings);
+		sdi->audioMixers = entry.audioMixers;
+		sdi->deinterlaceMode = entry.deinterlaceMode;
+		sdi->deinterlaceFieldOrder = entry.deinterlaceFieldOrder;
+		CacheManager<SourceDataInfo *>::getInstance().Store(entry.id, entry.name, sdi);
+
+		array.Set(i, osn::Input::constructor.New({Napi::Number::New(env, entry.id)}));
+	}
+	return array;
+}
+
+// Fills scenes and their items, both indexed like the scenes of the request.
+static void LoadScenes(Napi::Env env, const settings::Record &scenes, Napi::Array &sceneArray, Napi::Array &itemArray)
+{
+	sceneArray = Napi::Array::New(env, scenes.count);
+	itemArray = Napi::Array::New(env, scenes.count);
+	settings::Reader elements(scenes.value, scenes.value_size);
+	settings::Reader element(nullptr, 0);
+	for (uint32_t i = 0; i < scenes.count && elements.next_element(element); i++) {
+		LoadedEntry entry(element);
+		if (entry.id == UINT64_MAX) {
+			sceneArray.Set(i, env.Null());
+			itemArray.Set(i, Napi::Array::New(env, 0));
+			continue;
+		}
+
+		SceneInfo *si = new SceneInfo;
+		si->name = entry.name;
+		si->id = entry.id;
+		SourceDataInfo *sdi = new SourceDataInfo;
+		sdi->name = entry.name;
+		sdi->obs_sourceId = entry.type.empty() ? "scene" : entry.type;
+		sdi->id = entry.id;
+
+		// The scene was created empty, so the reply holds its full item order
+		Napi::Array items = Napi::Array::New(env, entry.items.count);
+		settings::Reader itemElements(entry.items.value, entry.items.value_size);
+		settings::Reader itemElement(nullptr, 0);
+		bool complete = true;
+		for (uint32_t j = 0; j < entry.items.count && itemElements.next_element(itemElement); j++) {
+			settings::Reader reader(itemElement);
+			settings::Record record;
+			uint64_t id = UINT64_MAX;
+			int64_t obs_id = -1;
+			while (reader.next(record)) {
+				if (record.is("id"))
+					id = (uint64_t)record.number();
+				else if (record.is("obsId"))
+					obs_id = (int64_t)record.number();
+			}
+
+			if (id == UINT64_MAX) {
+				complete = false;
+				items.Set(j, env.Null());
+				continue;
+			}
+
+			SceneItemData *sid = new SceneItemData;
+			sid->obs_itemId = obs_id;
+			sid->scene_id = entry.id;
+			CacheManager<SceneItemData *>::getInstance().Store(id, sid);
+
+			si->items.push_back(std::make_pair(obs_id, id));
+			items.Set(j, osn::SceneItem::constructor.New({Napi::Number::New(env, id)}));
+		}
+		si->itemsOrderCached = complete;
+
+		CacheManager<SourceDataInfo *>::getInstance().Store(entry.id, entry.name, sdi);
+		CacheManager<SceneInfo *>::getInstance().Store(entry.id, entry.name, si);
+
+		sceneArray.Set(i, osn::Scene::constructor.New({Napi::Number::New(env, entry.id)}));
+		itemArray.Set(i, items);
+	}
+}
+
+Napi::Value osn::Collection::Load(const Napi::CallbackInfo &info)
+{
+	Napi::Env env = info.Env();
+	std::vector<char> collection;
+	utilv8::SettingsFromObject(info[0].ToObject(), collection);
+
+	auto conn = GetConnection(info);
+	if (!conn)
+		return env.Undefined();
+
+	std::vector<ipc::value> response = conn->call_synchronous_helper("Collection", "Load", {ipc::value(collection)});
+
+	if (!ValidateResponse(info, response))
+		return env.Undefined();
+
+	Napi::Object result = Napi::Object::New(env);
+	Napi::Array scenes = Napi::Array::New(env, 0);
+	Napi::Array items = Napi::Array::New(env, 0);
+	result.Set("sources", Napi::Array::New(env, 0));
+
+	settings::Reader reader(response[1].value_bin);
+	settings::Record record;
+	while (reader.next(record)) {
+		if (record.type != settings::Array)
+			continue;
+		if (record.is("sources"))
+			result.Set("sources", LoadSources(env, record));
+		else if (record.is("scenes"))
+			LoadScenes(env, record, scenes, items);
+	}
+	result.Set("scenes", scenes);
+	result.Set("items", items);
+
+	return result;
+}
+
+Napi::Value osn::Collection::Save(const Napi::CallbackInfo &info)
+{
+	auto conn = GetConnection(info);
+	if (!conn)
+		return info.Env().Undefined();
+
+	std::vector<ipc::value> response = conn->call_synchronous_helper("Collection", "Save", {});
+
+	if (!ValidateResponse(info, response))
+		return info.Env().Undefined();
+
+	return utilv8::SettingsToObject(info.Env(), response[1].value_bin);
+}
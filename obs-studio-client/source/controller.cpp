@@ -369,6 +369,11 @@ std::shared_ptr<ipc::client> Controller::connect(const std::string &uri)
 	}
 
 	m_connection = cl;
+#ifdef WIN32
+	m_path = uri;
+#else
+	m_path = "/tmp/" + uri;
+#endif
 	return m_connection;
 }
 
@@ -391,6 +396,18 @@ std::shared_ptr<ipc::client> Controller::GetConnection()
 	return m_connection;
 }
 
+std::shared_ptr<ipc::client> Controller::OpenChannel()
+{
+	if (!m_connection)
+		return nullptr;
+
+	try {
+		return ipc::client::create(m_path);
+	} catch (...) {
+		return nullptr;
+	}
+}
+
 Napi::Value js_setServerPath(const Napi::CallbackInfo &info)
 {
 	if (info.Length() == 0) {
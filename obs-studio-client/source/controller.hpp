@@ -53,8 +53,13 @@ public:
 
 	std::shared_ptr<ipc::client> GetConnection();
 
+	// Opens an additional connection to the current server, used by the
+	// event channels so that their blocking calls never stall the main one.
+	std::shared_ptr<ipc::client> OpenChannel();
+
 private:
 	bool m_isServer = false;
 	std::shared_ptr<ipc::client> m_connection;
+	std::string m_path;
 	ipc::ProcessInfo procId;
 };
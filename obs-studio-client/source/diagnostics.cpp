@@ -0,0 +1,156 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#include "diagnostics.hpp"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "latency-histogram.hpp"
+#include "osn-error.hpp"
+#include "shared.hpp"
+#include "utility.hpp"
+
+Napi::FunctionReference osn::Diagnostics::constructor;
+
+// Round trips by "Class.Function", in nanoseconds. Histograms are never
+// removed, so a pointer found under the lock stays valid after it.
+static std::map<std::string, std::unique_ptr<diagnostics::LatencyHistogram>> roundTrips;
+static std::mutex roundTripsMutex;
+
+Napi::Object osn::Diagnostics::Init(Napi::Env env, Napi::Object exports)
+{
+	Napi::HandleScope scope(env);
+	Napi::Function func = DefineClass(env, "Diagnostics",
+					  {
+						  StaticMethod("getIpcStats", &osn::Diagnostics::GetIpcStats),
+						  StaticMethod("getStartupTimeline", &osn::Diagnostics::GetStartupTimeline),
+					  });
+	exports.Set("Diagnostics", func);
+	osn::Diagnostics::constructor = Napi::Persistent(func);
+	osn::Diagnostics::constructor.SuppressDestruct();
+	return exports;
+}
+
+osn::Diagnostics::Diagnostics(const Napi::CallbackInfo &info) : Napi::ObjectWrap<osn::Diagnostics>(info)
+{
+	Napi::Env env = info.Env();
+	Napi::HandleScope scope(env);
+}
+
+void osn::Diagnostics::RecordRoundTrip(const std::string &cname, const std::string &fname, uint64_t nanoseconds)
+{
+	thread_local std::string key;
+	key.assign(cname).append(".").append(fname);
+
+	diagnostics::LatencyHistogram *histogram;
+	{
+		std::lock_guard<std::mutex> lock(roundTripsMutex);
+		auto found = roundTrips.find(key);
+		if (found == roundTrips.end())
+			found = roundTrips.emplace(key, std::make_unique<diagnostics::LatencyHistogram>()).first;
+		histogram = found->second.get();
+	}
+	histogram->record(nanoseconds);
+}
+
+static Napi::Object Percentiles(Napi::Env env, uint64_t p50, uint64_t p90, uint64_t p99, uint64_t max, uint64_t mean)
+{
+	// Microseconds read better in JS than nanoseconds
+	Napi::Object result = Napi::Object::New(env);
+	result.Set("p50", Napi::Number::New(env, p50 / 1000.0));
+	result.Set("p90", Napi::Number::New(env, p90 / 1000.0));
+	result.Set("p99", Napi::Number::New(env, p99 / 1000.0));
+	result.Set("max", Napi::Number::New(env, max / 1000.0));
+	result.Set("mean", Napi::Number::New(env, mean / 1000.0));
+	return result;
+}
+
+Napi::Value osn::Diagnostics::GetIpcStats(const Napi::CallbackInfo &info)
+{
+	auto conn = GetConnection(info);
+	if (!conn)
+		return info.Env().Undefined();
+
+	std::vector<ipc::value> response = conn->call_synchronous_helper("Diagnostics", "GetIpcStats", {});
+
+	if (!ValidateResponse(info, response))
+		return info.Env().Undefined();
+
+	std::map<std::string, Napi::Object> calls;
+	auto entry = [&](const std::string &name) -> Napi::Object & {
+		auto found = calls.find(name);
+		if (found == calls.end()) {
+			Napi::Object call = Napi::Object::New(info.Env());
+			call.Set("name", Napi::String::New(info.Env(), name));
+			call.Set("calls", Napi::Number::New(info.Env(), 0));
+			call.Set("handlerCalls", Napi::Number::New(info.Env(), 0));
+			found = calls.emplace(name, call).first;
+		}
+		return found->second;
+	};
+
+	for (size_t i = 1; i + 6 < response.size(); i += 7) {
+		Napi::Object &call = entry(response[i].value_str);
+		call.Set("handlerCalls", Napi::Number::New(info.Env(), response[i + 1].value_union.ui64));
+		call.Set("handler", Percentiles(info.Env(), response[i + 2].value_union.ui64, response[i + 3].value_union.ui64,
+						 response[i + 4].value_union.ui64, response[i + 5].value_union.ui64, response[i + 6].value_union.ui64));
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(roundTripsMutex);
+		for (auto &roundTrip : roundTrips) {
+			const diagnostics::LatencyHistogram &histogram = *roundTrip.second;
+			Napi::Object &call = entry(roundTrip.first);
+			call.Set("calls", Napi::Number::New(info.Env(), histogram.count()));
+			call.Set("roundTrip", Percentiles(info.Env(), histogram.percentile(0.5), histogram.percentile(0.9), histogram.percentile(0.99),
+							  histogram.max(), histogram.mean()));
+		}
+	}
+
+	Napi::Array result = Napi::Array::New(info.Env(), calls.size());
+	uint32_t index = 0;
+	for (auto &call : calls)
+		result.Set(index++, call.second);
+	return result;
+}
+
+Napi::Value osn::Diagnostics::GetStartupTimeline(const Napi::CallbackInfo &info)
+{
+	auto conn = GetConnection(info);
+	if (!conn)
+		return info.Env().Undefined();
+
+	std::vector<ipc::value> response = conn->call_synchronous_helper("Diagnostics", "GetStartupTimeline", {});
+
+	if (!ValidateResponse(info, response))
+		return info.Env().Undefined();
+
+	// Milliseconds, the phases are too long for microseconds to read well
+	Napi::Array result = Napi::Array::New(info.Env());
+	uint32_t index = 0;
+	for (size_t i = 1; i + 3 < response.size(); i += 4) {
+		Napi::Object phase = Napi::Object::New(info.Env());
+		phase.Set("name", Napi::String::New(info.Env(), response[i].value_str));
+		phase.Set("start", Napi::Number::New(info.Env(), response[i + 1].value_union.ui64 / 1000.0));
+		phase.Set("duration", Napi::Number::New(info.Env(), response[i + 2].value_union.ui64 / 1000.0));
+		phase.Set("background", Napi::Boolean::New(info.Env(), response[i + 3].value_union.ui32 != 0));
+		result.Set(index++, phase);
+	}
+	return result;
+}
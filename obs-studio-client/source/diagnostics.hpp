@@ -0,0 +1,37 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#pragma once
+#include <napi.h>
+#include <string>
+
+namespace osn {
+// IPC latency, round trips measured here and handler time reported by the
+// server, see latency-histogram.hpp.
+class Diagnostics : public Napi::ObjectWrap<osn::Diagnostics> {
+public:
+	static Napi::FunctionReference constructor;
+	static Napi::Object Init(Napi::Env env, Napi::Object exports);
+	Diagnostics(const Napi::CallbackInfo &info);
+
+	static void RecordRoundTrip(const std::string &cname, const std::string &fname, uint64_t nanoseconds);
+
+	static Napi::Value GetIpcStats(const Napi::CallbackInfo &info);
+	static Napi::Value GetStartupTimeline(const Napi::CallbackInfo &info);
+};
+}
@@ -27,6 +27,7 @@
 #include "filter.hpp"
 #include "ipc-value.hpp"
 #include "shared.hpp"
+#include "settings-v8.hpp"
 #include "utility.hpp"
 
 Napi::FunctionReference osn::Input::constructor;
@@ -136,7 +137,7 @@ Napi::Value osn::Input::Create(const Napi::CallbackInfo &info)
 {
 	std::string type = info[0].ToString().Utf8Value();
 	std::string name = info[1].ToString().Utf8Value();
-	Napi::String settings = Napi::String::New(info.Env(), "");
+	std::vector<char> settings;
 	Napi::String hotkeys = Napi::String::New(info.Env(), "");
 
 	Napi::Object json = info.Env().Global().Get("JSON").As<Napi::Object>();
@@ -149,25 +150,20 @@ Napi::Value osn::Input::Create(const Napi::CallbackInfo &info)
 			hotkeys = stringify.Call(json, {hksobj}).As<Napi::String>();
 		}
 	}
-	if (info.Length() >= 3) {
-		if (!info[2].IsUndefined()) {
-			Napi::Object setobj = info[2].ToObject();
-			settings = stringify.Call(json, {setobj}).As<Napi::String>();
-		}
-	}
+	bool hasSettings = info.Length() >= 3 && !info[2].IsUndefined();
+	if (hasSettings)
+		utilv8::SettingsFromObject(info[2].ToObject(), settings);
 
 	auto conn = GetConnection(info);
 	if (!conn)
 		return info.Env().Undefined();
 
+	// Hotkeys come after the settings, send empty settings along with them if needed
 	auto params = std::vector<ipc::value>{ipc::value(type), ipc::value(name)};
-	if (settings.Utf8Value().length() != 0) {
-		std::string value;
-		if (utilv8::FromValue(settings, value)) {
-			params.push_back(ipc::value(value));
-		}
-	}
-	if (hotkeys.Utf8Value().length() != 0) {
+	bool hasHotkeys = hotkeys.Utf8Value().length() != 0;
+	if (hasSettings || hasHotkeys)
+		params.push_back(ipc::value(settings));
+	if (hasHotkeys) {
 		std::string value;
 		if (utilv8::FromValue(hotkeys, value)) {
 			params.push_back(ipc::value(value));
@@ -183,7 +179,7 @@ Napi::Value osn::Input::Create(const Napi::CallbackInfo &info)
 	sdi->name = name;
 	sdi->obs_sourceId = type;
 	sdi->id = response[1].value_union.ui64;
-	sdi->setting = response[2].value_str;
+	sdi->setting = response[2].value_bin;
 	sdi->audioMixers = response[3].value_union.ui32;
 	sdi->deinterlaceMode = response[4].value_union.ui32;
 	sdi->deinterlaceFieldOrder = response[5].value_union.ui32;
@@ -199,26 +195,16 @@ Napi::Value osn::Input::CreatePrivate(const Napi::CallbackInfo &info)
 {
 	std::string type = info[0].ToString().Utf8Value();
 	std::string name = info[1].ToString().Utf8Value();
-	Napi::String settings = Napi::String::New(info.Env(), "");
-
-	Napi::Object json = info.Env().Global().Get("JSON").As<Napi::Object>();
-	Napi::Function stringify = json.Get("stringify").As<Napi::Function>();
-
-	if (info.Length() >= 3) {
-		Napi::Object setobj = info[2].ToObject();
-		settings = stringify.Call(json, {setobj}).As<Napi::String>();
-	}
 
 	auto conn = GetConnection(info);
 	if (!conn)
 		return info.Env().Undefined();
 
 	auto params = std::vector<ipc::value>{ipc::value(type), ipc::value(name)};
-	if (settings.Utf8Value().length() != 0) {
-		std::string value;
-		if (utilv8::FromValue(settings, value)) {
-			params.push_back(ipc::value(value));
-		}
+	if (info.Length() >= 3 && !info[2].IsUndefined()) {
+		std::vector<char> settings;
+		utilv8::SettingsFromObject(info[2].ToObject(), settings);
+		params.push_back(ipc::value(settings));
 	}
 
 	std::vector<ipc::value> response = conn->call_synchronous_helper("Input", "CreatePrivate", {std::move(params)});
@@ -230,7 +216,7 @@ Napi::Value osn::Input::CreatePrivate(const Napi::CallbackInfo &info)
 	sdi->name = name;
 	sdi->obs_sourceId = type;
 	sdi->id = response[1].value_union.ui64;
-	sdi->setting = response[2].value_str;
+	sdi->setting = response[2].value_bin;
 	sdi->audioMixers = response[3].value_union.ui32;
 	sdi->deinterlaceMode = response[4].value_union.ui32;
 	sdi->deinterlaceFieldOrder = response[5].value_union.ui32;
@@ -549,10 +535,10 @@ Napi::Value osn::Input::Filters(const Napi::CallbackInfo &info)
 	SourceDataInfo *sdi = CacheManager<SourceDataInfo *>::getInstance().Retrieve(this->sourceId);
 
 	if (sdi && !sdi->filtersOrderChanged) {
-		std::vector<uint64_t> *filters = sdi->filters;
-		Napi::Array array = Napi::Array::New(info.Env(), int(filters->size()));
-		for (uint32_t i = 0; i < filters->size(); i++) {
-			auto instance = osn::Filter::constructor.New({Napi::Number::New(info.Env(), filters->at(i))});
+		const std::vector<uint64_t> &filters = sdi->filters;
+		Napi::Array array = Napi::Array::New(info.Env(), int(filters.size()));
+		for (uint32_t i = 0; i < filters.size(); i++) {
+			auto instance = osn::Filter::constructor.New({Napi::Number::New(info.Env(), filters[i])});
 			array.Set(i, instance);
 		}
 		return array;
@@ -567,11 +553,8 @@ Napi::Value osn::Input::Filters(const Napi::CallbackInfo &info)
 	if (!ValidateResponse(info, response))
 		return info.Env().Undefined();
 
-	std::vector<uint64_t> *filters;
-	if (sdi) {
-		filters = sdi->filters;
-		filters->clear();
-	}
+	if (sdi)
+		sdi->filters.clear();
 
 	Napi::Array array = Napi::Array::New(info.Env(), response.size() - 1);
 	for (size_t idx = 1; idx < response.size(); idx++) {
@@ -579,7 +562,7 @@ Napi::Value osn::Input::Filters(const Napi::CallbackInfo &info)
 		array.Set(uint32_t(idx) - 1, instance);
 
 		if (sdi)
-			filters->push_back(response[idx].value_union.ui64);
+			sdi->filters.push_back(response[idx].value_union.ui64);
 	}
 
 	if (sdi)
@@ -19,10 +19,12 @@
 #include "isource.hpp"
 #include "osn-error.hpp"
 #include <functional>
+#include <unordered_map>
 #include "controller.hpp"
 #include "shared.hpp"
 #include "utility-v8.hpp"
 #include "utility.hpp"
+#include "settings-v8.hpp"
 
 void osn::ISource::Release(const Napi::CallbackInfo &info, uint64_t id)
 {
@@ -36,6 +38,10 @@ void osn::ISource::Release(const Napi::CallbackInfo &info, uint64_t id)
 void osn::ISource::Remove(const Napi::CallbackInfo &info, uint64_t id)
 {
 	CacheManager<SourceDataInfo *>::getInstance().Remove(id);
+	// The server also removes the items of the source from every scene. The
+	// client does not know which scenes hold it, and the generation push may
+	// never come, so every cached scene and item is reset.
+	CacheGenerations::getInstance().InvalidateAll();
 
 	auto conn = GetConnection(info);
 	if (!conn)
@@ -62,6 +68,48 @@ Napi::Value osn::ISource::IsConfigurable(const Napi::CallbackInfo &info, uint64_
 	return Napi::Boolean::New(info.Env(), (bool)response[1].value_union.i32);
 }
 
+// Rebuilds the property map from a snapshot, taking entries sent without data
+// from the cache. Fails if one of those is not cached anymore.
+static bool ApplyPropertySnapshot(const obs::PropertySnapshot &snapshot, SourceDataInfo *sdi, osn::property_map_t &pmap, std::vector<uint64_t> &hashes)
+{
+	pmap.clear();
+	hashes.clear();
+
+	if (snapshot.flags & obs::PropertySnapshot::Unchanged) {
+		if (!sdi || sdi->properties.size() != sdi->propertyHashes.size())
+			return false;
+		pmap = sdi->properties;
+		hashes = sdi->propertyHashes;
+		return true;
+	}
+
+	std::unordered_map<uint64_t, std::shared_ptr<osn::Property>> cached;
+	if (sdi && sdi->properties.size() == sdi->propertyHashes.size()) {
+		size_t idx = 0;
+		for (auto &entry : sdi->properties)
+			cached.emplace(sdi->propertyHashes[idx++], entry.second);
+	}
+
+	for (auto &entry : snapshot.entries) {
+		std::shared_ptr<osn::Property> pr;
+		if (entry.size > 0) {
+			pr = osn::ProcessProperty(obs::Property::deserialize(snapshot.data(entry), entry.size));
+		} else {
+			auto iter = cached.find(entry.hash);
+			if (iter == cached.end())
+				return false;
+			pr = iter->second;
+		}
+		if (!pr)
+			continue;
+
+		pmap.emplace(pmap.size(), pr);
+		hashes.push_back(entry.hash);
+	}
+
+	return true;
+}
+
 Napi::Value osn::ISource::GetProperties(const Napi::CallbackInfo &info, uint64_t id)
 {
 	osn::ISource *source = Napi::ObjectWrap<osn::ISource>::Unwrap(info.This().ToObject());
@@ -81,19 +129,39 @@ Napi::Value osn::ISource::GetProperties(const Napi::CallbackInfo &info, uint64_t
 	if (!conn)
 		return info.Env().Undefined();
 
-	std::vector<ipc::value> response = conn->call_synchronous_helper("Source", "GetProperties", {ipc::value(id)});
+	// Only the properties that changed since the last snapshot are sent back,
+	// the others are reused from the cache.
+	std::vector<char> known;
+	if (sdi && sdi->properties.size() == sdi->propertyHashes.size())
+		known = obs::PropertySnapshot::known(sdi->propertiesHash, sdi->propertyHashes);
+
+	std::vector<ipc::value> response = conn->call_synchronous_helper("Source", "GetPropertiesSnapshot", {ipc::value(id), ipc::value(known)});
 
 	if (!ValidateResponse(info, response))
 		return info.Env().Undefined();
 
-	if (response.size() == 1)
-		return info.Env().Null();
+	obs::PropertySnapshot snapshot;
+	osn::property_map_t pmap;
+	std::vector<uint64_t> hashes;
+	if (!snapshot.read(std::move(response[1].value_bin)) || !ApplyPropertySnapshot(snapshot, sdi, pmap, hashes)) {
+		// Cached entries are gone or the snapshot is broken, ask for everything.
+		response = conn->call_synchronous_helper("Source", "GetPropertiesSnapshot", {ipc::value(id), ipc::value(std::vector<char>())});
 
-	osn::property_map_t pmap = osn::ProcessProperties(response, 1);
+		if (!ValidateResponse(info, response))
+			return info.Env().Undefined();
+
+		if (!snapshot.read(std::move(response[1].value_bin)) || !ApplyPropertySnapshot(snapshot, nullptr, pmap, hashes))
+			return info.Env().Undefined();
+	}
+
+	if (pmap.size() == 0)
+		return info.Env().Null();
 
 	if (sdi) {
 		sdi->properties = pmap;
 		sdi->propertiesChanged = false;
+		sdi->propertiesHash = snapshot.hash;
+		sdi->propertyHashes = std::move(hashes);
 	}
 	std::shared_ptr<property_map_t> pSomeObject = std::make_shared<property_map_t>(pmap);
 	auto prop_ptr = Napi::External<property_map_t>::New(info.Env(), pSomeObject.get());
@@ -116,13 +184,13 @@ Napi::Value osn::ISource::GetSlowUncachedSettings(const Napi::CallbackInfo &info
 	if (!ValidateResponse(info, response))
 		return info.Env().Undefined();
 
-	Napi::Object json = info.Env().Global().Get("JSON").As<Napi::Object>();
-	Napi::Function parse = json.Get("parse").As<Napi::Function>();
-
-	Napi::String jsondata = Napi::String::New(info.Env(), response[1].value_str);
-	Napi::Object jsonObj = parse.Call(json, {jsondata}).As<Napi::Object>();
+	return utilv8::SettingsToObject(info.Env(), response[1].value_bin);
+}
 
-	return jsonObj;
+static void StoreSettings(SourceDataInfo *sdi, const std::vector<char> &settings)
+{
+	sdi->setting = settings;
+	sdi->settingsChanged = false;
 }
 
 Napi::Value osn::ISource::GetSettings(const Napi::CallbackInfo &info, uint64_t id)
@@ -131,16 +199,10 @@ Napi::Value osn::ISource::GetSettings(const Napi::CallbackInfo &info, uint64_t i
 	if (!source)
 		return info.Env().Undefined();
 
-	Napi::Object json = info.Env().Global().Get("JSON").As<Napi::Object>();
-	Napi::Function parse = json.Get("parse").As<Napi::Function>();
-
 	SourceDataInfo *sdi = CacheManager<SourceDataInfo *>::getInstance().Retrieve(id);
 
-	if (sdi && !sdi->settingsChanged && sdi->setting.size() > 0) {
-		Napi::String jsondata = Napi::String::New(info.Env(), sdi->setting);
-		Napi::Object jsonObj = parse.Call(json, {jsondata}).As<Napi::Object>();
-		return jsonObj;
-	}
+	if (sdi && !sdi->settingsChanged)
+		return utilv8::SettingsToObject(info.Env(), sdi->setting);
 
 	auto conn = GetConnection(info);
 	if (!conn)
@@ -151,61 +213,69 @@ Napi::Value osn::ISource::GetSettings(const Napi::CallbackInfo &info, uint64_t i
 	if (!ValidateResponse(info, response))
 		return info.Env().Undefined();
 
-	Napi::String jsondata = Napi::String::New(info.Env(), response[1].value_str);
-	Napi::Object jsonObj = parse.Call(json, {jsondata}).As<Napi::Object>();
-
-	if (sdi) {
-		sdi->setting = response[1].value_str;
-		sdi->settingsChanged = false;
-	}
+	if (sdi)
+		StoreSettings(sdi, response[1].value_bin);
 
-	return jsonObj;
+	return utilv8::SettingsToObject(info.Env(), response[1].value_bin);
 }
 
-void osn::ISource::Update(const Napi::CallbackInfo &info, uint64_t id)
+static void UpdateFull(const Napi::CallbackInfo &info, uint64_t id, SourceDataInfo *sdi)
 {
-	Napi::Object jsonObj = info[0].ToObject();
-	bool shouldUpdate = true;
+	std::vector<char> buffer;
+	utilv8::SettingsFromObject(info[0].ToObject(), buffer);
 
-	Napi::Object json = info.Env().Global().Get("JSON").As<Napi::Object>();
-	Napi::Function stringify = json.Get("stringify").As<Napi::Function>();
+	auto conn = GetConnection(info);
+	if (!conn)
+		return;
 
-	std::string jsondata = stringify.Call(json, {jsonObj}).As<Napi::String>();
+	std::vector<ipc::value> response = conn->call_synchronous_helper("Source", "Update", {ipc::value(id), ipc::value(buffer)});
+
+	if (!ValidateResponse(info, response))
+		return;
 
+	if (sdi) {
+		StoreSettings(sdi, response[1].value_bin);
+		sdi->propertiesChanged = true;
+	}
+}
+
+void osn::ISource::Update(const Napi::CallbackInfo &info, uint64_t id)
+{
 	SourceDataInfo *sdi = CacheManager<SourceDataInfo *>::getInstance().Retrieve(id);
 
-	if (sdi && sdi->setting.size() > 0) {
-		auto newSettings = nlohmann::json::parse(jsondata);
-		auto settings = nlohmann::json::parse(sdi->setting);
-
-		nlohmann::json::iterator it = newSettings.begin();
-		while (!shouldUpdate && it != newSettings.end()) {
-			nlohmann::json::iterator item = settings.find(it.key());
-			if (item != settings.end()) {
-				if (it.value() != item.value()) {
-					shouldUpdate = false;
-				}
-			}
-			it++;
-		}
+	// Only keys that differ from the cached settings are sent, which needs an
+	// up to date copy of them.
+	if (!sdi || sdi->settingsChanged) {
+		UpdateFull(info, id, sdi);
+		return;
 	}
 
-	if (shouldUpdate) {
-		auto conn = GetConnection(info);
-		if (!conn)
-			return;
+	std::vector<char> buffer;
+	utilv8::SettingsPatchFromObject(info[0].ToObject(), sdi->setting, buffer);
 
-		std::vector<ipc::value> response = conn->call_synchronous_helper("Source", "Update", {ipc::value(id), ipc::value(jsondata)});
+	// Even an empty patch goes through, sources still expect their update callback.
+	auto conn = GetConnection(info);
+	if (!conn)
+		return;
 
-		if (!ValidateResponse(info, response))
-			return;
+	std::vector<ipc::value> response = conn->call_synchronous_helper("Source", "UpdatePatch", {ipc::value(id), ipc::value(buffer)});
 
-		if (sdi) {
-			sdi->setting = response[1].value_str;
-			sdi->settingsChanged = false;
-			sdi->propertiesChanged = true;
-		}
+	if (!ValidateResponse(info, response))
+		return;
+
+	sdi->propertiesChanged = true;
+
+	// The full settings only come back if the source changed some on its own
+	if (response.size() > 1) {
+		StoreSettings(sdi, response[1].value_bin);
+		return;
 	}
+
+	// Otherwise the patch applies to the cached settings as it did on the server
+	std::vector<char> merged;
+	merged.reserve(sdi->setting.size() + buffer.size());
+	settings::merge(settings::Reader(sdi->setting), settings::Reader(buffer), merged);
+	sdi->setting = std::move(merged);
 }
 
 void osn::ISource::Load(const Napi::CallbackInfo &info, uint64_t id)
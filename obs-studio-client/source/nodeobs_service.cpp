@@ -27,6 +27,7 @@
 #include "shared.hpp"
 #include "utility.hpp"
 #include "video.hpp"
+#include "worker-signals.hpp"
 
 #ifdef WIN32
 
@@ -39,24 +40,14 @@ enum VcamInstalledStatus : uint8_t { NotInstalled = 0, LegacyInstalled = 1, Inst
 #endif
 
 bool service::isWorkerRunning = false;
-bool service::worker_stop = true;
-uint32_t service::sleepIntervalMS = 33;
-std::thread *service::worker_thread = nullptr;
-Napi::ThreadSafeFunction service::js_thread;
 Napi::FunctionReference service::cb;
 
 void service::start_worker(napi_env env, Napi::Function async_callback)
 {
-	if (isWorkerRunning)
+	if (isWorkerRunning || async_callback.IsEmpty())
 		return;
 
-	if (!worker_stop)
-		return;
-
-	worker_stop = false;
-	js_thread = Napi::ThreadSafeFunction::New(env, async_callback, "NodeOBS_Service", 0, 1, [](Napi::Env) {});
-	worker_thread = new std::thread(&service::worker);
-
+	outputSignals::add(env, async_callback, "", outputSignals::serviceId);
 	isWorkerRunning = true;
 }
 
@@ -65,14 +56,7 @@ void service::stop_worker(void)
 	if (!isWorkerRunning)
 		return;
 
-	if (worker_stop != false)
-		return;
-
-	worker_stop = true;
-	if (worker_thread->joinable()) {
-		worker_thread->join();
-	}
-
+	outputSignals::remove("", outputSignals::serviceId);
 	isWorkerRunning = false;
 }
 
@@ -279,80 +263,6 @@ std::string service::getServiceNameById(int serviceId)
 	return "default";
 }
 
-void service::worker()
-{
-	const static int maximum_signals_in_queue = 100;
-	auto callback = [](Napi::Env env, Napi::Function jsCallback, ServiceSignalInfo *data) {
-		try {
-			Napi::Object result = Napi::Object::New(env);
-
-			result.Set(Napi::String::New(env, "type"), Napi::String::New(env, data->outputType));
-			result.Set(Napi::String::New(env, "signal"), Napi::String::New(env, data->signal));
-			result.Set(Napi::String::New(env, "code"), Napi::Number::New(env, data->code));
-			result.Set(Napi::String::New(env, "error"), Napi::String::New(env, data->errorMessage));
-			result.Set(Napi::String::New(env, "service"), Napi::String::New(env, getServiceNameById(data->service)));
-
-			jsCallback.Call({result});
-		} catch (...) {
-			data->tosend = true;
-			return;
-		}
-		data->sent = true;
-	};
-	size_t totalSleepMS = 0;
-	std::vector<ServiceSignalInfo *> signalsList;
-	while (!worker_stop) {
-		auto tp_start = std::chrono::high_resolution_clock::now();
-
-		// Validate Connection
-		auto conn = Controller::GetInstance().GetConnection();
-		if (conn) {
-			std::vector<ipc::value> response = conn->call_synchronous_helper("NodeOBS_Service", "Query", {});
-			if ((response.size() == 6) && signalsList.size() < maximum_signals_in_queue) {
-				ErrorCode error = (ErrorCode)response[0].value_union.ui64;
-				if (error == ErrorCode::Ok) {
-					ServiceSignalInfo *data = new ServiceSignalInfo{"", "", 0, ""};
-					data->outputType = response[1].value_str;
-					data->signal = response[2].value_str;
-					data->code = response[3].value_union.i32;
-					data->errorMessage = response[4].value_str;
-					data->service = response[5].value_union.i32;
-					data->sent = false;
-					data->tosend = true;
-					signalsList.push_back(data);
-				}
-			}
-
-			std::vector<ServiceSignalInfo *>::iterator i = signalsList.begin();
-			while (i != signalsList.end()) {
-				if ((*i)->tosend) {
-					(*i)->tosend = false;
-					napi_status status = js_thread.BlockingCall((*i), callback);
-					if (status != napi_ok) {
-						(*i)->tosend = true;
-						break;
-					}
-				}
-				if ((*i)->sent) {
-					i = signalsList.erase(i);
-				} else {
-					i++;
-				}
-			}
-		}
-
-		auto tp_end = std::chrono::high_resolution_clock::now();
-		auto dur = std::chrono::duration_cast<std::chrono::milliseconds>(tp_end - tp_start);
-		totalSleepMS = sleepIntervalMS - dur.count();
-		std::this_thread::sleep_for(std::chrono::milliseconds(totalSleepMS));
-	}
-
-	for (auto &signalData : signalsList) {
-		delete signalData;
-	}
-	return;
-}
-
 Napi::Value service::OBS_service_removeCallback(const Napi::CallbackInfo &info)
 {
 	stop_worker();
@@ -467,10 +377,7 @@ Napi::Value service::OBS_service_uninstallVirtualCamPlugin(const Napi::CallbackI
 
 Napi::Value service::OBS_service_isRecording(const Napi::CallbackInfo& info)
 {
-	if (!isWorkerRunning) {
-		start_worker(info.Env(), cb.Value());
-		isWorkerRunning = true;
-	}
+	start_worker(info.Env(), cb.Value());
 
 	auto conn = GetConnection(info);
 	if (!conn)
@@ -22,6 +22,8 @@
 #include <math.h>
 #include <napi.h>
 #include <unordered_map>
+#include <vector>
+#include "obs-property.hpp"
 #include "utility-v8.hpp"
 
 namespace osn {
@@ -124,7 +126,7 @@ struct ListProperty : Property {
 
 	Type field_type;
 	Format item_format;
-	std::list<Item> items;
+	std::vector<Item> items;
 };
 
 struct FontProperty : Property {
@@ -146,7 +148,7 @@ struct EditableListProperty : Property {
 	Type field_type;
 	std::string filter;
 	std::string default_path;
-	std::list<std::string> values;
+	std::vector<std::string> values;
 };
 
 struct FrameRateProperty : Property {
@@ -214,4 +216,5 @@ public:
 };
 
 property_map_t ProcessProperties(const std::vector<ipc::value> &data, size_t index);
+std::shared_ptr<Property> ProcessProperty(const std::shared_ptr<obs::Property> &raw_property);
 }
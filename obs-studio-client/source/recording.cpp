@@ -78,7 +78,7 @@ void osn::Recording::Start(const Napi::CallbackInfo &info)
 	if (!conn)
 		return;
 
-	startWorker(info.Env(), this->cb.Value(), className, this->uid);
+	startWorker(info.Env(), this->cb.Value(), this->uid);
 
 	conn->call(className, "Start", {ipc::value(this->uid)});
 }
@@ -24,7 +24,7 @@
 namespace osn {
 class Recording : public WorkerSignals, public FileOutput {
 public:
-	Recording() : WorkerSignals(), FileOutput(){};
+	Recording() : WorkerSignals("recording"), FileOutput(){};
 
 protected:
 	Napi::Function signalHandler;
@@ -138,7 +138,7 @@ void osn::ReplayBuffer::Start(const Napi::CallbackInfo &info)
 	if (!conn)
 		return;
 
-	startWorker(info.Env(), this->cb.Value(), className, this->uid);
+	startWorker(info.Env(), this->cb.Value(), this->uid);
 
 	conn->call(className, "Start", {ipc::value(this->uid)});
 }
@@ -24,7 +24,7 @@
 namespace osn {
 class ReplayBuffer : public WorkerSignals, public FileOutput {
 public:
-	ReplayBuffer() : WorkerSignals(), FileOutput(){};
+	ReplayBuffer() : WorkerSignals("replay-buffer"), FileOutput(){};
 
 protected:
 	Napi::Function signalHandler;
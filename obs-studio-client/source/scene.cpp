@@ -17,20 +17,54 @@
 ******************************************************************************/
 
 #include "scene.hpp"
+#include <algorithm>
 #include <condition_variable>
 #include <mutex>
 #include <string>
+#include "cache-manager.hpp"
 #include "controller.hpp"
 #include "osn-error.hpp"
 #include "input.hpp"
 #include "video.hpp"
 #include "ipc-value.hpp"
+#include "sceneitem-batch.hpp"
 #include "sceneitem.hpp"
 #include "shared.hpp"
 #include "utility.hpp"
 
 Napi::FunctionReference osn::Scene::constructor;
 
+static std::vector<sceneitem::ItemRef> ReadItems(const std::vector<char> &buffer)
+{
+	std::vector<sceneitem::ItemRef> items;
+	items.reserve(buffer.size() / sizeof(sceneitem::ItemRef));
+	sceneitem::BatchReader reader(buffer);
+	sceneitem::ItemRef item;
+	while (reader.get(item))
+		items.push_back(item);
+	return items;
+}
+
+static void StoreItems(SceneInfo *si, const std::vector<sceneitem::ItemRef> &items)
+{
+	if (!si)
+		return;
+
+	// Items gone from the scene were removed on the server, for example along
+	// with their source, so their cached data is dropped.
+	for (const auto &old : si->items) {
+		auto found = std::find_if(items.begin(), items.end(), [&](const sceneitem::ItemRef &item) { return item.uid == old.second; });
+		if (found == items.end())
+			CacheManager<SceneItemData *>::getInstance().Remove(old.second);
+	}
+
+	si->items.clear();
+	si->items.reserve(items.size());
+	for (const sceneitem::ItemRef &item : items)
+		si->items.push_back(std::make_pair(item.obs_id, item.uid));
+	si->itemsOrderCached = true;
+}
+
 Napi::Object osn::Scene::Init(Napi::Env env, Napi::Object exports)
 {
 	Napi::HandleScope scope(env);
@@ -293,10 +327,9 @@ Napi::Value osn::Scene::AddSource(const Napi::CallbackInfo &info)
 
 	SceneInfo *si = CacheManager<SceneInfo *>::getInstance().Retrieve(this->sourceId);
 
-	if (si) {
+	// Only extend an order that is complete, otherwise the next GetItems fetches it
+	if (si && si->itemsOrderCached)
 		si->items.push_back(std::make_pair(obs_id, id));
-		si->itemsOrderCached = true;
-	}
 
 	SceneItemData *sid = new SceneItemData;
 	sid->obs_itemId = obs_id;
@@ -422,16 +455,8 @@ Napi::Value osn::Scene::MoveItem(const Napi::CallbackInfo &info)
 	if (!ValidateResponse(info, response))
 		return info.Env().Undefined();
 
-	SceneInfo *si = CacheManager<SceneInfo *>::getInstance().Retrieve(this->sourceId);
-
-	if (si && response.size() > 2) {
-		si->items.clear();
-
-		for (size_t i = 1; i < response.size(); i += 2) {
-			si->items.push_back(std::make_pair(response[i + 1].value_union.i64, response[i].value_union.ui64));
-		}
-		si->itemsOrderCached = true;
-	}
+	if (response.size() > 1)
+		StoreItems(CacheManager<SceneInfo *>::getInstance().Retrieve(this->sourceId), ReadItems(response[1].value_bin));
 	return info.Env().Undefined();
 }
 
@@ -460,16 +485,8 @@ Napi::Value osn::Scene::OrderItems(const Napi::CallbackInfo &info)
 	if (!ValidateResponse(info, response))
 		return info.Env().Undefined();
 
-	SceneInfo *si = CacheManager<SceneInfo *>::getInstance().Retrieve(this->sourceId);
-
-	if (si && response.size() > 2) {
-		si->items.clear();
-
-		for (size_t i = 1; i < response.size(); i += 2) {
-			si->items.push_back(std::make_pair(response[i + 1].value_union.i64, response[i].value_union.ui64));
-		}
-		si->itemsOrderCached = true;
-	}
+	if (response.size() > 1)
+		StoreItems(CacheManager<SceneInfo *>::getInstance().Retrieve(this->sourceId), ReadItems(response[1].value_bin));
 
 	return info.Env().Undefined();
 }
@@ -500,12 +517,12 @@ Napi::Value osn::Scene::GetItems(const Napi::CallbackInfo &info)
 	SceneInfo *si = CacheManager<SceneInfo *>::getInstance().Retrieve(this->sourceId);
 
 	if (si && si->itemsOrderCached) {
-		Napi::Array array = Napi::Array::New(info.Env(), int(si->items.size()) - 1);
+		Napi::Array array = Napi::Array::New(info.Env(), si->items.size());
 		size_t index = 0;
 		bool itemRemoved = false;
 
 		for (auto item : si->items) {
-			SceneItemData *sid = CacheManager<SceneItemData *>::getInstance().Retrieve(item.first);
+			SceneItemData *sid = CacheManager<SceneItemData *>::getInstance().Retrieve(item.second);
 			if (!sid) {
 				itemRemoved = true;
 				break;
@@ -527,22 +544,14 @@ Napi::Value osn::Scene::GetItems(const Napi::CallbackInfo &info)
 	if (!ValidateResponse(info, response))
 		return info.Env().Undefined();
 
-	Napi::Array array = Napi::Array::New(info.Env(), int((response.size()) - 1) / 2);
-	size_t index = 0;
-	for (size_t i = 1; i < response.size(); i++) {
-		auto instance = osn::SceneItem::constructor.New({Napi::Number::New(info.Env(), response[i++].value_union.ui64)});
-		array.Set(uint32_t(index++), instance);
+	std::vector<sceneitem::ItemRef> items = ReadItems(response[1].value_bin);
+	Napi::Array array = Napi::Array::New(info.Env(), items.size());
+	for (size_t i = 0; i < items.size(); i++) {
+		auto instance = osn::SceneItem::constructor.New({Napi::Number::New(info.Env(), items[i].uid)});
+		array.Set(uint32_t(i), instance);
 	}
 
-	if (si) {
-		si->items.clear();
-
-		for (size_t i = 1; i < response.size(); i += 2) {
-			si->items.push_back(std::make_pair(response[i + 1].value_union.i64, response[i].value_union.ui64));
-		}
-
-		si->itemsOrderCached = true;
-	}
+	StoreItems(si, items);
 
 	return array;
 }
@@ -562,10 +571,11 @@ Napi::Value osn::Scene::GetItemsInRange(const Napi::CallbackInfo &info)
 	if (!ValidateResponse(info, response))
 		return info.Env().Undefined();
 
-	Napi::Array array = Napi::Array::New(info.Env(), int(response.size() - 1));
-	for (size_t i = 1; i < response.size(); i++) {
-		auto instance = osn::SceneItem::constructor.New({Napi::Number::New(info.Env(), response[i].value_union.ui64)});
-		array.Set(uint32_t(i - 1), instance);
+	std::vector<sceneitem::ItemRef> items = ReadItems(response[1].value_bin);
+	Napi::Array array = Napi::Array::New(info.Env(), items.size());
+	for (size_t i = 0; i < items.size(); i++) {
+		auto instance = osn::SceneItem::constructor.New({Napi::Number::New(info.Env(), items[i].uid)});
+		array.Set(uint32_t(i), instance);
 	}
 
 	return array;
@@ -665,6 +675,7 @@ Napi::Value osn::Scene::CallCallHandler(const Napi::CallbackInfo &info)
 
 Napi::Value osn::Scene::CallRemove(const Napi::CallbackInfo &info)
 {
+	CacheGenerations::getInstance().InvalidateScene(this->sourceId);
 	osn::ISource::Remove(info, this->sourceId);
 	this->sourceId = UINT64_MAX;
 
@@ -681,6 +692,7 @@ Napi::Value osn::Scene::CallUpdate(const Napi::CallbackInfo &info)
 Napi::Value osn::Scene::CallLoad(const Napi::CallbackInfo &info)
 {
 	osn::ISource::Load(info, this->sourceId);
+	CacheGenerations::getInstance().InvalidateScene(this->sourceId);
 
 	return info.Env().Undefined();
 }
@@ -26,6 +26,7 @@
 #include "ipc-value.hpp"
 #include "scene.hpp"
 #include "sceneitem.hpp"
+#include "sceneitem-batch.hpp"
 #include "shared.hpp"
 #include "utility.hpp"
 #include "video.hpp"
@@ -67,6 +68,9 @@ Napi::Object osn::SceneItem::Init(Napi::Env env, Napi::Object exports)
 				    InstanceMethod("remove", &osn::SceneItem::Remove),
 				    InstanceMethod("deferUpdateBegin", &osn::SceneItem::DeferUpdateBegin),
 				    InstanceMethod("deferUpdateEnd", &osn::SceneItem::DeferUpdateEnd),
+
+				    StaticMethod("batchGet", &osn::SceneItem::BatchGet),
+				    StaticMethod("batchSet", &osn::SceneItem::BatchSet),
 			    });
 	exports.Set("SceneItem", func);
 	osn::SceneItem::constructor = Napi::Persistent(func);
@@ -173,7 +177,7 @@ void osn::SceneItem::SetVisible(const Napi::CallbackInfo &info, const Napi::Valu
 	bool visible = value.ToBoolean().Value();
 	SceneItemData *sid = CacheManager<SceneItemData *>::getInstance().Retrieve(this->itemId);
 
-	if (sid && visible == sid->isVisible)
+	if (sid && !sid->visibleChanged && visible == sid->isVisible)
 		return;
 
 	auto conn = GetConnection(info);
@@ -374,7 +378,7 @@ void osn::SceneItem::SetPosition(const Napi::CallbackInfo &info, const Napi::Val
 
 	SceneItemData *sid = CacheManager<SceneItemData *>::getInstance().Retrieve(this->itemId);
 
-	if (sid && x == sid->posX && y == sid->posY)
+	if (sid && !sid->posChanged && x == sid->posX && y == sid->posY)
 		return;
 
 	auto conn = GetConnection(info);
@@ -448,7 +452,7 @@ void osn::SceneItem::SetRotation(const Napi::CallbackInfo &info, const Napi::Val
 
 	SceneItemData *sid = CacheManager<SceneItemData *>::getInstance().Retrieve(this->itemId);
 
-	if (sid && vector == sid->rotation)
+	if (sid && !sid->rotationChanged && vector == sid->rotation)
 		return;
 
 	auto conn = GetConnection(info);
@@ -501,7 +505,7 @@ void osn::SceneItem::SetScale(const Napi::CallbackInfo &info, const Napi::Value
 
 	SceneItemData *sid = CacheManager<SceneItemData *>::getInstance().Retrieve(this->itemId);
 
-	if (sid && x == sid->scaleX && y == sid->scaleY)
+	if (sid && !sid->scaleChanged && x == sid->scaleX && y == sid->scaleY)
 		return;
 
 	auto conn = GetConnection(info);
@@ -718,7 +722,7 @@ void osn::SceneItem::SetCrop(const Napi::CallbackInfo &info, const Napi::Value &
 
 	SceneItemData *sid = CacheManager<SceneItemData *>::getInstance().Retrieve(this->itemId);
 
-	if (sid && left == sid->cropLeft && top == sid->cropTop && right == sid->cropRight && bottom == sid->cropBottom)
+	if (sid && !sid->cropChanged && left == sid->cropLeft && top == sid->cropTop && right == sid->cropRight && bottom == sid->cropBottom)
 		return;
 
 	auto conn = GetConnection(info);
@@ -980,3 +984,361 @@ void osn::SceneItem::SetBlendingMode(const Napi::CallbackInfo &info, const Napi:
 	sid->blendingMode = mode;
 	sid->blendingModeChanged = false;
 }
+
+static Napi::Object Vec2ToObject(Napi::Env env, float x, float y)
+{
+	Napi::Object obj = Napi::Object::New(env);
+	obj.Set("x", Napi::Number::New(env, x));
+	obj.Set("y", Napi::Number::New(env, y));
+	return obj;
+}
+
+// Decodes the masked fields of one BatchGet record into obj and refreshes the
+// cached values of the item on the way.
+static bool ReadItemFields(Napi::Env env, sceneitem::BatchReader &reader, uint32_t mask, SceneItemData *sid, Napi::Object obj)
+{
+	uint8_t flag;
+	float x, y;
+	uint32_t value;
+
+	if (mask & sceneitem::Visible) {
+		if (!reader.get(flag))
+			return false;
+		obj.Set("visible", Napi::Boolean::New(env, !!flag));
+		if (sid) {
+			sid->isVisible = !!flag;
+			sid->visibleChanged = false;
+		}
+	}
+	if (mask & sceneitem::Selected) {
+		if (!reader.get(flag))
+			return false;
+		obj.Set("selected", Napi::Boolean::New(env, !!flag));
+		if (sid) {
+			sid->isSelected = !!flag;
+			sid->selectedChanged = false;
+			sid->cached = true;
+		}
+	}
+	if (mask & sceneitem::StreamVisible) {
+		if (!reader.get(flag))
+			return false;
+		obj.Set("streamVisible", Napi::Boolean::New(env, !!flag));
+		if (sid) {
+			sid->isStreamVisible = !!flag;
+			sid->streamVisibleChanged = false;
+		}
+	}
+	if (mask & sceneitem::RecordingVisible) {
+		if (!reader.get(flag))
+			return false;
+		obj.Set("recordingVisible", Napi::Boolean::New(env, !!flag));
+		if (sid) {
+			sid->isRecordingVisible = !!flag;
+			sid->recordingVisibleChanged = false;
+		}
+	}
+	if (mask & sceneitem::Position) {
+		if (!reader.get(x) || !reader.get(y))
+			return false;
+		obj.Set("position", Vec2ToObject(env, x, y));
+		if (sid) {
+			sid->posX = x;
+			sid->posY = y;
+			sid->posChanged = false;
+		}
+	}
+	if (mask & sceneitem::Rotation) {
+		if (!reader.get(x))
+			return false;
+		obj.Set("rotation", Napi::Number::New(env, x));
+		if (sid) {
+			sid->rotation = x;
+			sid->rotationChanged = false;
+		}
+	}
+	if (mask & sceneitem::Scale) {
+		if (!reader.get(x) || !reader.get(y))
+			return false;
+		obj.Set("scale", Vec2ToObject(env, x, y));
+		if (sid) {
+			sid->scaleX = x;
+			sid->scaleY = y;
+			sid->scaleChanged = false;
+		}
+	}
+	if (mask & sceneitem::Alignment) {
+		if (!reader.get(value))
+			return false;
+		obj.Set("alignment", Napi::Number::New(env, value));
+	}
+	if (mask & sceneitem::Bounds) {
+		if (!reader.get(x) || !reader.get(y))
+			return false;
+		obj.Set("bounds", Vec2ToObject(env, x, y));
+	}
+	if (mask & sceneitem::BoundsAlignment) {
+		if (!reader.get(value))
+			return false;
+		obj.Set("boundsAlignment", Napi::Number::New(env, value));
+	}
+	if (mask & sceneitem::BoundsType) {
+		if (!reader.get(value))
+			return false;
+		obj.Set("boundsType", Napi::Number::New(env, value));
+	}
+	if (mask & sceneitem::Crop) {
+		int32_t left, top, right, bottom;
+		if (!reader.get(left) || !reader.get(top) || !reader.get(right) || !reader.get(bottom))
+			return false;
+		Napi::Object crop = Napi::Object::New(env);
+		crop.Set("left", Napi::Number::New(env, left));
+		crop.Set("top", Napi::Number::New(env, top));
+		crop.Set("right", Napi::Number::New(env, right));
+		crop.Set("bottom", Napi::Number::New(env, bottom));
+		obj.Set("crop", crop);
+		if (sid) {
+			sid->cropLeft = left;
+			sid->cropTop = top;
+			sid->cropRight = right;
+			sid->cropBottom = bottom;
+			sid->cropChanged = false;
+		}
+	}
+	if (mask & sceneitem::ScaleFilter) {
+		if (!reader.get(value))
+			return false;
+		obj.Set("scaleFilter", Napi::Number::New(env, value));
+		if (sid) {
+			sid->scaleFilter = value;
+			sid->scaleFilterChanged = false;
+		}
+	}
+	if (mask & sceneitem::BlendingMethod) {
+		if (!reader.get(value))
+			return false;
+		obj.Set("blendingMethod", Napi::Number::New(env, value));
+		if (sid) {
+			sid->blendingMethod = value;
+			sid->blendingMethodChanged = false;
+		}
+	}
+	if (mask & sceneitem::BlendingMode) {
+		if (!reader.get(value))
+			return false;
+		obj.Set("blendingMode", Napi::Number::New(env, value));
+		if (sid) {
+			sid->blendingMode = value;
+			sid->blendingModeChanged = false;
+		}
+	}
+	if (mask & sceneitem::ObsId) {
+		int64_t obs_id;
+		if (!reader.get(obs_id))
+			return false;
+		obj.Set("id", Napi::Number::New(env, obs_id));
+		if (sid)
+			sid->obs_itemId = obs_id;
+	}
+
+	return true;
+}
+
+Napi::Value osn::SceneItem::BatchGet(const Napi::CallbackInfo &info)
+{
+	Napi::Array items = info[0].As<Napi::Array>();
+	uint32_t mask = info[1].ToNumber().Uint32Value() & sceneitem::AllFields;
+
+	std::vector<char> ids;
+	sceneitem::BatchWriter writer(ids);
+	for (uint32_t i = 0; i < items.Length(); i++) {
+		osn::SceneItem *item = Napi::ObjectWrap<osn::SceneItem>::Unwrap(items.Get(i).ToObject());
+		writer.put<uint64_t>(item->itemId);
+	}
+
+	auto conn = GetConnection(info);
+	if (!conn)
+		return info.Env().Undefined();
+
+	std::vector<ipc::value> response = conn->call_synchronous_helper("SceneItem", "BatchGet", {ipc::value(ids), ipc::value(mask)});
+
+	if (!ValidateResponse(info, response))
+		return info.Env().Undefined();
+
+	Napi::Array results = Napi::Array::New(info.Env(), items.Length());
+	sceneitem::BatchReader reader(response[1].value_bin);
+	for (uint32_t i = 0; i < items.Length(); i++) {
+		uint64_t uid;
+		uint8_t valid;
+		if (!reader.get(uid) || !reader.get(valid))
+			break;
+
+		if (!valid) {
+			results.Set(i, info.Env().Null());
+			continue;
+		}
+
+		SceneItemData *sid = CacheManager<SceneItemData *>::getInstance().Retrieve(uid);
+		Napi::Object obj = Napi::Object::New(info.Env());
+		if (!ReadItemFields(info.Env(), reader, mask, sid, obj))
+			break;
+		results.Set(i, obj);
+	}
+
+	return results;
+}
+
+Napi::Value osn::SceneItem::BatchSet(const Napi::CallbackInfo &info)
+{
+	Napi::Env env = info.Env();
+	Napi::Array updates = info[0].As<Napi::Array>();
+
+	std::vector<char> buffer;
+	sceneitem::BatchWriter writer(buffer);
+	for (uint32_t i = 0; i < updates.Length(); i++) {
+		Napi::Object update = updates.Get(i).ToObject();
+		osn::SceneItem *item = Napi::ObjectWrap<osn::SceneItem>::Unwrap(update.Get("item").ToObject());
+		SceneItemData *sid = CacheManager<SceneItemData *>::getInstance().Retrieve(item->itemId);
+
+		uint32_t mask = 0;
+		if (update.Has("visible"))
+			mask |= sceneitem::Visible;
+		if (update.Has("selected"))
+			mask |= sceneitem::Selected;
+		if (update.Has("streamVisible"))
+			mask |= sceneitem::StreamVisible;
+		if (update.Has("recordingVisible"))
+			mask |= sceneitem::RecordingVisible;
+		if (update.Has("position"))
+			mask |= sceneitem::Position;
+		if (update.Has("rotation"))
+			mask |= sceneitem::Rotation;
+		if (update.Has("scale"))
+			mask |= sceneitem::Scale;
+		if (update.Has("alignment"))
+			mask |= sceneitem::Alignment;
+		if (update.Has("bounds"))
+			mask |= sceneitem::Bounds;
+		if (update.Has("boundsAlignment"))
+			mask |= sceneitem::BoundsAlignment;
+		if (update.Has("boundsType"))
+			mask |= sceneitem::BoundsType;
+		if (update.Has("crop"))
+			mask |= sceneitem::Crop;
+		if (update.Has("scaleFilter"))
+			mask |= sceneitem::ScaleFilter;
+		if (update.Has("blendingMethod"))
+			mask |= sceneitem::BlendingMethod;
+		if (update.Has("blendingMode"))
+			mask |= sceneitem::BlendingMode;
+
+		writer.put<uint64_t>(item->itemId);
+		writer.put<uint32_t>(mask);
+
+		// The server may reject the batch, skip a record or clamp a value, so
+		// the cache only learns that these fields changed and reads them back
+		// on the next get. The single setters do not compare against a
+		// changed field.
+		if (mask & sceneitem::Visible) {
+			bool visible = update.Get("visible").ToBoolean().Value();
+			writer.put<uint8_t>(visible);
+			if (sid)
+				sid->visibleChanged = true;
+		}
+		if (mask & sceneitem::Selected) {
+			bool selected = update.Get("selected").ToBoolean().Value();
+			writer.put<uint8_t>(selected);
+			if (sid)
+				sid->selectedChanged = true;
+		}
+		if (mask & sceneitem::StreamVisible) {
+			bool streamVisible = update.Get("streamVisible").ToBoolean().Value();
+			writer.put<uint8_t>(streamVisible);
+			if (sid)
+				sid->streamVisibleChanged = true;
+		}
+		if (mask & sceneitem::RecordingVisible) {
+			bool recordingVisible = update.Get("recordingVisible").ToBoolean().Value();
+			writer.put<uint8_t>(recordingVisible);
+			if (sid)
+				sid->recordingVisibleChanged = true;
+		}
+		if (mask & sceneitem::Position) {
+			Napi::Object pos = update.Get("position").ToObject();
+			float x = pos.Get("x").ToNumber().FloatValue();
+			float y = pos.Get("y").ToNumber().FloatValue();
+			writer.put<float>(x);
+			writer.put<float>(y);
+			if (sid)
+				sid->posChanged = true;
+		}
+		if (mask & sceneitem::Rotation) {
+			float rotation = update.Get("rotation").ToNumber().FloatValue();
+			writer.put<float>(rotation);
+			if (sid)
+				sid->rotationChanged = true;
+		}
+		if (mask & sceneitem::Scale) {
+			Napi::Object scale = update.Get("scale").ToObject();
+			float x = scale.Get("x").ToNumber().FloatValue();
+			float y = scale.Get("y").ToNumber().FloatValue();
+			writer.put<float>(x);
+			writer.put<float>(y);
+			if (sid)
+				sid->scaleChanged = true;
+		}
+		if (mask & sceneitem::Alignment)
+			writer.put<uint32_t>(update.Get("alignment").ToNumber().Uint32Value());
+		if (mask & sceneitem::Bounds) {
+			Napi::Object bounds = update.Get("bounds").ToObject();
+			writer.put<float>(bounds.Get("x").ToNumber().FloatValue());
+			writer.put<float>(bounds.Get("y").ToNumber().FloatValue());
+		}
+		if (mask & sceneitem::BoundsAlignment)
+			writer.put<uint32_t>(update.Get("boundsAlignment").ToNumber().Uint32Value());
+		if (mask & sceneitem::BoundsType)
+			writer.put<uint32_t>(update.Get("boundsType").ToNumber().Uint32Value());
+		if (mask & sceneitem::Crop) {
+			Napi::Object crop = update.Get("crop").ToObject();
+			int32_t left = crop.Get("left").ToNumber().Int32Value();
+			int32_t top = crop.Get("top").ToNumber().Int32Value();
+			int32_t right = crop.Get("right").ToNumber().Int32Value();
+			int32_t bottom = crop.Get("bottom").ToNumber().Int32Value();
+			writer.put<int32_t>(left);
+			writer.put<int32_t>(top);
+			writer.put<int32_t>(right);
+			writer.put<int32_t>(bottom);
+			if (sid)
+				sid->cropChanged = true;
+		}
+		if (mask & sceneitem::ScaleFilter) {
+			uint32_t filter = update.Get("scaleFilter").ToNumber().Uint32Value();
+			writer.put<uint32_t>(filter);
+			if (sid)
+				sid->scaleFilterChanged = true;
+		}
+		if (mask & sceneitem::BlendingMethod) {
+			uint32_t method = update.Get("blendingMethod").ToNumber().Uint32Value();
+			writer.put<uint32_t>(method);
+			if (sid)
+				sid->blendingMethodChanged = true;
+		}
+		if (mask & sceneitem::BlendingMode) {
+			uint32_t mode = update.Get("blendingMode").ToNumber().Uint32Value();
+			writer.put<uint32_t>(mode);
+			if (sid)
+				sid->blendingModeChanged = true;
+		}
+	}
+
+	auto conn = GetConnection(info);
+	if (!conn)
+		return env.Undefined();
+
+	std::vector<ipc::value> response = conn->call_synchronous_helper("SceneItem", "BatchSet", {ipc::value(buffer)});
+
+	if (!ValidateResponse(info, response))
+		return env.Undefined();
+
+	return Napi::Number::New(env, response[1].value_union.ui32);
+}
@@ -79,5 +79,8 @@ public:
 	void SetBlendingMethod(const Napi::CallbackInfo &info, const Napi::Value &value);
 	Napi::Value GetBlendingMode(const Napi::CallbackInfo &info);
 	void SetBlendingMode(const Napi::CallbackInfo &info, const Napi::Value &value);
+
+	static Napi::Value BatchGet(const Napi::CallbackInfo &info);
+	static Napi::Value BatchSet(const Napi::CallbackInfo &info);
 };
 }
@@ -0,0 +1,245 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#include "settings-v8.hpp"
+#include "settings-json.hpp"
+#include <cmath>
+#include <string_view>
+#include <unordered_map>
+
+static void ReadObject(Napi::Env env, settings::Reader &reader, Napi::Object &object)
+{
+	settings::Record record;
+	while (reader.next(record)) {
+		Napi::Value value;
+
+		switch (record.type) {
+		case settings::Bool:
+			value = Napi::Boolean::New(env, record.get<uint8_t>() != 0);
+			break;
+		case settings::Int:
+			value = Napi::Number::New(env, (double)record.get<int64_t>());
+			break;
+		case settings::Double:
+			value = Napi::Number::New(env, record.get<double>());
+			break;
+		case settings::String:
+			value = Napi::String::New(env, record.value, record.value_size);
+			break;
+		case settings::Object: {
+			settings::Reader child(record.value, record.value_size);
+			Napi::Object obj = Napi::Object::New(env);
+			ReadObject(env, child, obj);
+			value = obj;
+			break;
+		}
+		case settings::Array: {
+			settings::Reader elements(record.value, record.value_size);
+			Napi::Array array = Napi::Array::New(env, record.count);
+			for (uint32_t i = 0; i < record.count; i++) {
+				settings::Reader element(nullptr, 0);
+				if (!elements.next_element(element))
+					break;
+				Napi::Object obj = Napi::Object::New(env);
+				ReadObject(env, element, obj);
+				array.Set(i, obj);
+			}
+			value = array;
+			break;
+		}
+		}
+
+		object.Set(Napi::String::New(env, record.key, record.key_size), value);
+	}
+}
+
+Napi::Object utilv8::SettingsToObjectDirect(Napi::Env env, const std::vector<char> &buffer)
+{
+	settings::Reader reader(buffer);
+	Napi::Object object = Napi::Object::New(env);
+	ReadObject(env, reader, object);
+	return object;
+}
+
+Napi::Object utilv8::SettingsToObjectJson(Napi::Env env, const std::vector<char> &buffer)
+{
+	std::string text;
+	text.reserve(buffer.size());
+	settings::ToJson(settings::Reader(buffer), text);
+
+	Napi::Object json = env.Global().Get("JSON").As<Napi::Object>();
+	Napi::Function parse = json.Get("parse").As<Napi::Function>();
+	return parse.Call(json, {Napi::String::New(env, text)}).As<Napi::Object>();
+}
+
+// Average size of a record from which building the object directly beats
+// printing and parsing JSON text, see tests/native/bench-settings-v8.cpp.
+static const size_t direct_record_size = 512;
+
+static void CountRecords(settings::Reader reader, size_t &count)
+{
+	settings::Record record;
+	while (reader.next(record)) {
+		count++;
+		if (record.type == settings::Object) {
+			CountRecords(settings::Reader(record.value, record.value_size), count);
+		} else if (record.type == settings::Array) {
+			settings::Reader elements(record.value, record.value_size);
+			settings::Reader element(nullptr, 0);
+			while (elements.next_element(element))
+				CountRecords(element, count);
+		}
+	}
+}
+
+Napi::Object utilv8::SettingsToObject(Napi::Env env, const std::vector<char> &buffer)
+{
+	size_t count = 0;
+	CountRecords(settings::Reader(buffer), count);
+	if (buffer.size() >= count * direct_record_size)
+		return SettingsToObjectDirect(env, buffer);
+	return SettingsToObjectJson(env, buffer);
+}
+
+static void WriteObject(settings::Writer &writer, const Napi::Object &object)
+{
+	Napi::Array keys = object.GetPropertyNames();
+	for (uint32_t i = 0; i < keys.Length(); i++) {
+		Napi::Value key = keys.Get(i);
+		utilv8::WriteSetting(writer, key.As<Napi::String>().Utf8Value(), object.Get(key));
+	}
+}
+
+void utilv8::SettingsFromObjectDirect(const Napi::Object &object, std::vector<char> &buffer)
+{
+	settings::Writer writer(buffer);
+	WriteObject(writer, object);
+}
+
+bool utilv8::SettingsFromObjectJson(const Napi::Object &object, std::vector<char> &buffer)
+{
+	Napi::Env env = object.Env();
+	Napi::Object json = env.Global().Get("JSON").As<Napi::Object>();
+	Napi::Function stringify = json.Get("stringify").As<Napi::Function>();
+	std::string text = stringify.Call(json, {object}).As<Napi::String>().Utf8Value();
+
+	size_t mark = buffer.size();
+	settings::Writer writer(buffer);
+	if (settings::FromJson(text.data(), text.size(), writer))
+		return true;
+	writer.truncate(mark);
+	return false;
+}
+
+// Strings at least this long are copied faster straight out of V8 than
+// escaped by JSON.stringify and unescaped again. Only the top level is
+// probed, where browser and text sources keep their large strings.
+static const size_t direct_string_size = 4096;
+static const uint32_t probe_key_count = 64;
+
+static bool HasLargeString(const Napi::Object &object)
+{
+	Napi::Array keys = object.GetPropertyNames();
+	uint32_t count = keys.Length();
+	if (count > probe_key_count)
+		return false;
+
+	for (uint32_t i = 0; i < count; i++) {
+		Napi::Value value = object.Get(keys.Get(i));
+		size_t length = 0;
+		// Without a buffer this is the UTF-16 length, read in constant time.
+		if (value.IsString() && napi_get_value_string_utf16(value.Env(), value, nullptr, 0, &length) == napi_ok &&
+		    length >= direct_string_size)
+			return true;
+	}
+	return false;
+}
+
+void utilv8::SettingsFromObject(const Napi::Object &object, std::vector<char> &buffer)
+{
+	if (HasLargeString(object) || !SettingsFromObjectJson(object, buffer))
+		SettingsFromObjectDirect(object, buffer);
+}
+
+void utilv8::SettingsPatchFromObject(const Napi::Object &object, const std::vector<char> &cached, std::vector<char> &patch)
+{
+	std::unordered_map<std::string_view, std::string_view> records;
+	settings::Record record;
+	for (settings::Reader reader(cached); reader.next(record);)
+		records.emplace(std::string_view(record.key, record.key_size), std::string_view(record.data, record.size));
+
+	// Encoded whole by the fastest path, then only the changed records are kept
+	std::vector<char> buffer;
+	SettingsFromObject(object, buffer);
+	for (settings::Reader reader(buffer); reader.next(record);) {
+		auto iter = records.find(std::string_view(record.key, record.key_size));
+		if (iter == records.end() || iter->second != std::string_view(record.data, record.size))
+			patch.insert(patch.end(), record.data, record.data + record.size);
+	}
+}
+
+bool utilv8::WriteSetting(settings::Writer &writer, const std::string &key, const Napi::Value &value)
+{
+	switch (value.Type()) {
+	case napi_boolean:
+		writer.put_bool(key.data(), key.size(), value.As<Napi::Boolean>().Value());
+		return true;
+	case napi_number: {
+		// libobs tells integers from doubles by their JSON text, as JSON.stringify writes them
+		double number = value.As<Napi::Number>().DoubleValue();
+		if (!std::isfinite(number))
+			return false;
+		if (std::trunc(number) == number && std::fabs(number) < 9007199254740992.0)
+			writer.put_int(key.data(), key.size(), (int64_t)number);
+		else
+			writer.put_double(key.data(), key.size(), number);
+		return true;
+	}
+	case napi_string: {
+		std::string text = value.As<Napi::String>().Utf8Value();
+		writer.put_string(key.data(), key.size(), text.data(), text.size());
+		return true;
+	}
+	case napi_object: {
+		if (!value.IsArray()) {
+			size_t mark = writer.begin_object(key.data(), key.size());
+			WriteObject(writer, value.As<Napi::Object>());
+			writer.end_object(mark);
+			return true;
+		}
+
+		Napi::Array array = value.As<Napi::Array>();
+		uint32_t count = 0;
+		size_t mark = writer.begin_array(key.data(), key.size());
+		for (uint32_t i = 0; i < array.Length(); i++) {
+			Napi::Value element = array.Get(i);
+			if (!element.IsObject() || element.IsArray())
+				continue;
+
+			size_t element_mark = writer.begin_element();
+			WriteObject(writer, element.As<Napi::Object>());
+			writer.end_element(element_mark);
+			count++;
+		}
+		writer.end_array(mark, count);
+		return true;
+	}
+	default:
+		return false;
+	}
+}
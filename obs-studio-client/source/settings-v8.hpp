@@ -0,0 +1,53 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#pragma once
+#include <napi.h>
+#include <string>
+#include <vector>
+#include "settings-binary.hpp"
+
+// Conversion between JS objects and the binary settings format.
+//
+// Encoding follows what JSON.stringify followed by obs_data_create_from_json
+// used to produce: null, undefined and functions are left out, integral
+// numbers become Int and array elements that are not objects are dropped.
+namespace utilv8 {
+// Builds the object in one pass, stops at the first malformed record.
+Napi::Object SettingsToObjectDirect(Napi::Env env, const std::vector<char> &buffer);
+// Prints the settings as JSON text and hands it to JSON.parse.
+Napi::Object SettingsToObjectJson(Napi::Env env, const std::vector<char> &buffer);
+// Picks the faster of the two from the average record size.
+Napi::Object SettingsToObject(Napi::Env env, const std::vector<char> &buffer);
+
+void SettingsFromObjectDirect(const Napi::Object &object, std::vector<char> &buffer);
+// Encodes the text of JSON.stringify, returns false and leaves buffer
+// untouched if it is not an object.
+bool SettingsFromObjectJson(const Napi::Object &object, std::vector<char> &buffer);
+// Goes direct if the object holds a large string at the top level, through
+// JSON text otherwise.
+void SettingsFromObject(const Napi::Object &object, std::vector<char> &buffer);
+
+// Records of the object that differ from the cached settings. Records are
+// compared as encoded, so equal values written differently, like keys of a
+// nested object in another order, are merely sent again.
+void SettingsPatchFromObject(const Napi::Object &object, const std::vector<char> &cached, std::vector<char> &patch);
+
+// Writes a single record, returns false if the value is left out.
+bool WriteSetting(settings::Writer &writer, const std::string &key, const Napi::Value &value);
+} // namespace utilv8
@@ -21,9 +21,11 @@
 #include <string>
 #include <vector>
 
+#include <chrono>
 #include <napi.h>
 #include "shared.hpp"
 #include "controller.hpp"
+#include "diagnostics.hpp"
 #include "osn-error.hpp"
 #include <thread>
 
@@ -118,7 +120,36 @@ static bool ValidateResponse(const Napi::CallbackInfo &info, std::vector<ipc::va
 	return true;
 }
 
-static FORCE_INLINE std::shared_ptr<ipc::client> GetConnection(const Napi::CallbackInfo &info)
+// Connection used by the bindings, times every synchronous call so that
+// Diagnostics.getIpcStats can report round trips next to handler times.
+class TimedConnection {
+public:
+	TimedConnection(std::shared_ptr<ipc::client> client) : client(std::move(client)) {}
+
+	explicit operator bool() const { return client != nullptr; }
+	TimedConnection *operator->() { return this; }
+
+	std::vector<ipc::value> call_synchronous_helper(const std::string &cname, const std::string &fname, const std::vector<ipc::value> &args)
+	{
+		auto start = std::chrono::steady_clock::now();
+		std::vector<ipc::value> response = client->call_synchronous_helper(cname, fname, args);
+		auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+		osn::Diagnostics::RecordRoundTrip(cname, fname, elapsed.count());
+		return response;
+	}
+
+	auto call(const std::string &cname, const std::string &fname, std::vector<ipc::value> args)
+	{
+		return client->call(cname, fname, std::move(args));
+	}
+
+	std::shared_ptr<ipc::client> get() const { return client; }
+
+private:
+	std::shared_ptr<ipc::client> client;
+};
+
+static FORCE_INLINE TimedConnection GetConnection(const Napi::CallbackInfo &info)
 {
 	auto conn = Controller::GetInstance().GetConnection();
 	if (!conn) {
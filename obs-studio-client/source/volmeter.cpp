@@ -29,6 +29,7 @@
 #include "callback-manager.hpp"
 
 Napi::FunctionReference osn::Volmeter::constructor;
+std::shared_ptr<volmeter::LevelsBuffer> osn::Volmeter::levels;
 
 Napi::Object osn::Volmeter::Init(Napi::Env env, Napi::Object exports)
 {
@@ -42,6 +43,8 @@ Napi::Object osn::Volmeter::Init(Napi::Env env, Napi::Object exports)
 						  InstanceMethod("detach", &osn::Volmeter::Detach),
 						  InstanceMethod("addCallback", &osn::Volmeter::AddCallback),
 						  InstanceMethod("removeCallback", &osn::Volmeter::RemoveCallback),
+						  InstanceMethod("setBallistics", &osn::Volmeter::SetBallistics),
+						  InstanceMethod("readLevels", &osn::Volmeter::ReadLevels),
 					  });
 	exports.Set("Volmeter", func);
 	osn::Volmeter::constructor = Napi::Persistent(func);
@@ -61,6 +64,7 @@ osn::Volmeter::Volmeter(const Napi::CallbackInfo &info) : Napi::ObjectWrap<osn::
 	}
 
 	this->m_uid = (uint64_t)info[0].ToNumber().Int64Value();
+	this->m_slot = length > 2 ? info[2].ToNumber().Uint32Value() : volmeter::levels_invalid_slot;
 }
 
 Napi::Value osn::Volmeter::Create(const Napi::CallbackInfo &info)
@@ -79,8 +83,17 @@ Napi::Value osn::Volmeter::Create(const Napi::CallbackInfo &info)
 	if (!ValidateResponse(info, response))
 		return info.Env().Undefined();
 
-	auto instance = osn::Volmeter::constructor.New(
-		{Napi::Number::New(info.Env(), response[1].value_union.ui64), Napi::Number::New(info.Env(), response[2].value_union.ui32)});
+	if (!levels) {
+		std::vector<ipc::value> buffer = conn->call_synchronous_helper("Volmeter", "GetLevelsBuffer", {});
+		if (buffer.size() == 3 && (ErrorCode)buffer[0].value_union.ui64 == ErrorCode::Ok) {
+			std::unique_lock<std::mutex> lck(globalCallback::mtx_volmeters);
+			levels = volmeter::LevelsBuffer::Open(buffer[1].value_str);
+		}
+	}
+
+	auto instance = osn::Volmeter::constructor.New({Napi::Number::New(info.Env(), response[1].value_union.ui64),
+							Napi::Number::New(info.Env(), response[2].value_union.ui32),
+							Napi::Number::New(info.Env(), response[3].value_union.ui32)});
 	return instance;
 }
 
@@ -131,7 +144,7 @@ Napi::Value osn::Volmeter::AddCallback(const Napi::CallbackInfo &info)
 	if (!ValidateResponse(info, response))
 		return info.Env().Undefined();
 
-	globalCallback::add_volmeter(info.Env(), this->m_uid, async_callback);
+	globalCallback::add_volmeter(info.Env(), this->m_uid, this->m_slot, async_callback);
 
 	return Napi::Boolean::New(info.Env(), true);
 }
@@ -151,4 +164,59 @@ Napi::Value osn::Volmeter::RemoveCallback(const Napi::CallbackInfo &info)
 	globalCallback::remove_volmeter(this->m_uid);
 
 	return Napi::Boolean::New(info.Env(), true);
-}
\ No newline at end of file
+}
+
+Napi::Value osn::Volmeter::SetBallistics(const Napi::CallbackInfo &info)
+{
+	float attack = info[0].ToNumber().FloatValue();
+	float decay = info[1].ToNumber().FloatValue();
+	float peakHold = info[2].ToNumber().FloatValue();
+
+	auto conn = GetConnection(info);
+	if (!conn)
+		return info.Env().Undefined();
+
+	std::vector<ipc::value> response =
+		conn->call_synchronous_helper("Volmeter", "SetBallistics", {ipc::value(this->m_uid), ipc::value(attack), ipc::value(decay), ipc::value(peakHold)});
+
+	ValidateResponse(info, response);
+	return info.Env().Undefined();
+}
+
+Napi::Value osn::Volmeter::ReadLevels(const Napi::CallbackInfo &info)
+{
+	bool ballistics = info.Length() > 0 && info[0].IsBoolean() && info[0].ToBoolean().Value();
+
+	volmeter::LevelsSnapshot snapshot;
+	{
+		std::unique_lock<std::mutex> lck(globalCallback::mtx_volmeters);
+		if (!levels || !levels->read(this->m_slot, snapshot) || snapshot.uid != this->m_uid || snapshot.muted)
+			snapshot.channels = 0;
+		else if (ballistics)
+			levels->acknowledge(this->m_slot, snapshot);
+	}
+
+	// The view is reused between calls and only reallocated when its layout changes
+	size_t blocks = ballistics ? 7 : 3;
+	if (m_levelsView.IsEmpty() || m_levelsChannels != snapshot.channels || m_levelsBallistics != ballistics) {
+		m_levelsView = Napi::Persistent(Napi::Float32Array::New(info.Env(), snapshot.channels * blocks));
+		m_levelsChannels = snapshot.channels;
+		m_levelsBallistics = ballistics;
+	}
+
+	Napi::Float32Array view = m_levelsView.Value();
+	float *data = view.Data();
+	for (int32_t ch = 0; ch < snapshot.channels; ch++) {
+		data[ch] = snapshot.magnitude[ch];
+		data[snapshot.channels + ch] = snapshot.peak[ch];
+		data[snapshot.channels * 2 + ch] = snapshot.input_peak[ch];
+		if (!ballistics)
+			continue;
+		data[snapshot.channels * 3 + ch] = snapshot.display_magnitude[ch];
+		data[snapshot.channels * 4 + ch] = snapshot.display_peak[ch];
+		data[snapshot.channels * 5 + ch] = snapshot.peak_hold[ch];
+		data[snapshot.channels * 6 + ch] = snapshot.max_peak[ch];
+	}
+
+	return view;
+}
@@ -20,17 +20,31 @@
 #include <napi.h>
 #include <thread>
 #include "utility-v8.hpp"
+#include "volmeter-levels.hpp"
 
 struct VolmeterData {
 	std::vector<float> magnitude;
 	std::vector<float> peak;
 	std::vector<float> input_peak;
+	std::vector<float> display_magnitude;
+	std::vector<float> display_peak;
+	std::vector<float> peak_hold;
+	std::vector<float> max_peak;
 };
 
 namespace osn {
 class Volmeter : public Napi::ObjectWrap<osn::Volmeter> {
 public:
 	uint64_t m_uid;
+	uint32_t m_slot;
+
+	// Shared levels written by the server, opened on the first Create.
+	static std::shared_ptr<volmeter::LevelsBuffer> levels;
+
+private:
+	Napi::Reference<Napi::Float32Array> m_levelsView;
+	int32_t m_levelsChannels = -1;
+	bool m_levelsBallistics = false;
 
 public:
 	static Napi::FunctionReference constructor;
@@ -43,5 +57,7 @@ public:
 	Napi::Value Detach(const Napi::CallbackInfo &info);
 	Napi::Value AddCallback(const Napi::CallbackInfo &info);
 	Napi::Value RemoveCallback(const Napi::CallbackInfo &info);
+	Napi::Value SetBallistics(const Napi::CallbackInfo &info);
+	Napi::Value ReadLevels(const Napi::CallbackInfo &info);
 };
 }
@@ -0,0 +1,177 @@
+/******************************************************************************
+    Copyright (C) 2016-2022 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#include "worker-signals.hpp"
+#include <map>
+#include <mutex>
+#include <thread>
+#include "controller.hpp"
+#include "nodeobs_service.hpp"
+
+uint32_t outputSignals::waitTimeoutMS = 1000;
+
+// Outputs are registered by type and id, ids are only unique per manager on
+// the server side. The legacy service registers with an empty type.
+typedef std::pair<std::string, uint64_t> SignalsKey;
+
+static std::mutex signals_mtx;
+static std::map<SignalsKey, Napi::ThreadSafeFunction> signals_callbacks;
+// The dispatcher is started and stopped from the JS thread only, the worker
+// flags signals_exited when the server went away so the next add restarts it.
+static std::thread *signals_thread = nullptr;
+static bool signals_stop = false;
+static bool signals_exited = false;
+
+static SignalsKey signals_key(const std::string &type, uint64_t uid)
+{
+	if (uid == outputSignals::serviceId)
+		return SignalsKey("", uid);
+	return SignalsKey(type, uid);
+}
+
+static void join_thread()
+{
+	if (!signals_thread)
+		return;
+
+	if (signals_thread->joinable())
+		signals_thread->join();
+	delete signals_thread;
+	signals_thread = nullptr;
+}
+
+void outputSignals::add(napi_env env, Napi::Function cb, const std::string &type, uint64_t uid)
+{
+	if (cb.IsEmpty() || !cb.IsFunction())
+		return;
+
+	Napi::ThreadSafeFunction js_thread = Napi::ThreadSafeFunction::New(env, cb, type.c_str(), 0, 1, [](Napi::Env) {});
+
+	bool restart = false;
+	{
+		std::unique_lock<std::mutex> ulock(signals_mtx);
+		auto result = signals_callbacks.emplace(signals_key(type, uid), js_thread);
+		if (!result.second) {
+			result.first->second.Release();
+			result.first->second = js_thread;
+		}
+		restart = signals_exited;
+	}
+
+	if (signals_thread && !restart)
+		return;
+
+	join_thread();
+	signals_stop = false;
+	signals_exited = false;
+	signals_thread = new std::thread(&outputSignals::worker);
+}
+
+void outputSignals::remove(const std::string &type, uint64_t uid)
+{
+	{
+		std::unique_lock<std::mutex> ulock(signals_mtx);
+		auto iter = signals_callbacks.find(signals_key(type, uid));
+		if (iter == signals_callbacks.end())
+			return;
+
+		iter->second.Release();
+		signals_callbacks.erase(iter);
+		if (!signals_callbacks.empty() || !signals_thread)
+			return;
+
+		signals_stop = true;
+	}
+
+	// Release the pending WaitSignals call so the dispatcher notices the stop request
+	auto conn = Controller::GetInstance().GetConnection();
+	if (conn)
+		conn->call_synchronous_helper("CallbackManager", "InterruptSignals", {});
+
+	join_thread();
+}
+
+void outputSignals::worker()
+{
+	auto callback = [](Napi::Env env, Napi::Function jsCallback, SignalOutput *data) {
+		try {
+			Napi::Object result = Napi::Object::New(env);
+
+			result.Set(Napi::String::New(env, "type"), Napi::String::New(env, data->outputType));
+			result.Set(Napi::String::New(env, "signal"), Napi::String::New(env, data->signal));
+			result.Set(Napi::String::New(env, "code"), Napi::Number::New(env, data->code));
+			result.Set(Napi::String::New(env, "error"), Napi::String::New(env, data->errorMessage));
+			if (data->legacy)
+				result.Set(Napi::String::New(env, "service"), Napi::String::New(env, service::getServiceNameById(data->service)));
+
+			jsCallback.Call({result});
+		} catch (...) {
+		}
+		delete data;
+	};
+
+	auto conn = Controller::GetInstance().OpenChannel();
+
+	while (conn) {
+		{
+			std::unique_lock<std::mutex> ulock(signals_mtx);
+			if (signals_stop)
+				break;
+		}
+
+		std::vector<ipc::value> response = conn->call_synchronous_helper("CallbackManager", "WaitSignals", {ipc::value(waitTimeoutMS)});
+		if (!response.size() || (ErrorCode)response[0].value_union.ui64 != ErrorCode::Ok)
+			break;
+
+		size_t index = 1;
+		uint32_t count = response[index++].value_union.ui32;
+		if (response.size() < index + size_t(count) * 6)
+			break;
+
+		for (uint32_t i = 0; i < count; i++) {
+			uint64_t uid = response[index++].value_union.ui64;
+			SignalOutput *data = new SignalOutput{"", "", 0, "", 0, uid == serviceId};
+			data->outputType = response[index++].value_str;
+			data->signal = response[index++].value_str;
+			data->code = response[index++].value_union.i32;
+			data->errorMessage = response[index++].value_str;
+			data->service = response[index++].value_union.i32;
+
+			// Keep the callback alive while the call is queued, the output may unregister meanwhile
+			Napi::ThreadSafeFunction js_thread;
+			{
+				std::unique_lock<std::mutex> ulock(signals_mtx);
+				auto iter = signals_callbacks.find(signals_key(data->outputType, uid));
+				if (iter != signals_callbacks.end() && iter->second.Acquire() == napi_ok)
+					js_thread = iter->second;
+			}
+
+			if (!js_thread) {
+				delete data;
+				continue;
+			}
+
+			if (js_thread.BlockingCall(data, callback) != napi_ok)
+				delete data;
+			js_thread.Release();
+		}
+	}
+
+	std::unique_lock<std::mutex> ulock(signals_mtx);
+	signals_exited = true;
+}
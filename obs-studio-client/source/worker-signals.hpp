@@ -18,6 +18,7 @@
 
 #pragma once
 #include <napi.h>
+#include <string>
 #include "osn-error.hpp"
 #include "utility.hpp"
 
@@ -26,118 +27,53 @@ struct SignalOutput {
 	std::string signal;
 	int code;
 	std::string errorMessage;
-	bool sent;
-	bool tosend;
+	int service;
+	bool legacy;
 };
 
+// Output signals of every output arrive through a single CallbackManager.WaitSignals
+// long poll, one dispatcher thread forwards them to the callback registered
+// for the output. The thread only runs while at least one callback is registered.
+namespace outputSignals {
+// Id the outputs of NodeOBS_Service report under, see CallbackManager::ServiceSignalsId.
+const uint64_t serviceId = UINT64_MAX;
+
+extern uint32_t waitTimeoutMS;
+
+void add(napi_env env, Napi::Function cb, const std::string &type, uint64_t uid);
+void remove(const std::string &type, uint64_t uid);
+void worker(void);
+}
+
 class WorkerSignals {
 public:
-	WorkerSignals()
-	{
-		isWorkerRunning = false;
-		workerStop = true;
-		sleepIntervalMS = 33;
-		workerThread = nullptr;
-	};
+	WorkerSignals(const std::string &signalsType) : signalsType(signalsType), isWorkerRunning(false) {}
 	~WorkerSignals(){};
 
 protected:
+	std::string signalsType;
 	bool isWorkerRunning;
-	bool workerStop;
-	uint32_t sleepIntervalMS;
-	std::thread *workerThread;
-	Napi::ThreadSafeFunction jsThread;
 	Napi::FunctionReference cb;
 
-	void startWorker(napi_env env, Napi::Function asyncCallback, const std::string &name, const uint64_t &refID)
+	void startWorker(napi_env env, Napi::Function asyncCallback, const uint64_t &refID)
 	{
-		if (!workerStop || isWorkerRunning)
+		if (isWorkerRunning)
 			return;
 
 		isWorkerRunning = true;
-		workerStop = false;
-		jsThread = Napi::ThreadSafeFunction::New(env, asyncCallback, name.c_str(), 0, 1, [](Napi::Env) {});
-		workerThread = new std::thread(&WorkerSignals::worker, this, name, refID);
-	}
-
-	void worker(const std::string &name, const uint64_t &refID)
-	{
-		const static int maximum_signals_in_queue = 100;
-		auto callback = [](Napi::Env env, Napi::Function jsCallback, SignalOutput *data) {
-			try {
-				Napi::Object result = Napi::Object::New(env);
-
-				result.Set(Napi::String::New(env, "type"), Napi::String::New(env, data->outputType));
-				result.Set(Napi::String::New(env, "signal"), Napi::String::New(env, data->signal));
-				result.Set(Napi::String::New(env, "code"), Napi::Number::New(env, data->code));
-				result.Set(Napi::String::New(env, "error"), Napi::String::New(env, data->errorMessage));
-
-				jsCallback.Call({result});
-			} catch (...) {
-				data->tosend = true;
-				return;
-			}
-			data->sent = true;
-		};
-		size_t totalSleepMS = 0;
-		std::vector<SignalOutput *> signalsList;
-		while (!workerStop) {
-			auto tp_start = std::chrono::high_resolution_clock::now();
-
-			// Validate Connection
-			auto conn = Controller::GetInstance().GetConnection();
-			if (conn) {
-				std::vector<ipc::value> response = conn->call_synchronous_helper(name, "Query", {ipc::value(refID)});
-				if ((response.size() == 5) && signalsList.size() < maximum_signals_in_queue) {
-					ErrorCode error = (ErrorCode)response[0].value_union.ui64;
-					if (error == ErrorCode::Ok) {
-						SignalOutput *data = new SignalOutput{"", "", 0, ""};
-						data->outputType = response[1].value_str;
-						data->signal = response[2].value_str;
-						data->code = response[3].value_union.i32;
-						data->errorMessage = response[4].value_str;
-						data->sent = false;
-						data->tosend = true;
-						signalsList.push_back(data);
-					}
-				}
-
-				std::vector<SignalOutput *>::iterator i = signalsList.begin();
-				while (i != signalsList.end()) {
-					if ((*i)->tosend) {
-						(*i)->tosend = false;
-						napi_status status = jsThread.BlockingCall((*i), callback);
-						if (status != napi_ok) {
-							(*i)->tosend = true;
-							break;
-						}
-					}
-					if ((*i)->sent) {
-						i = signalsList.erase(i);
-					} else {
-						i++;
-					}
-				}
-			}
-
-			auto tp_end = std::chrono::high_resolution_clock::now();
-			auto dur = std::chrono::duration_cast<std::chrono::milliseconds>(tp_end - tp_start);
-			totalSleepMS = sleepIntervalMS - dur.count();
-			std::this_thread::sleep_for(std::chrono::milliseconds(totalSleepMS));
-		}
-
-		return;
+		signalsId = refID;
+		outputSignals::add(env, asyncCallback, signalsType, signalsId);
 	}
 
 	void stopWorker(void)
 	{
-		if (workerStop || !isWorkerRunning)
+		if (!isWorkerRunning)
 			return;
 
-		workerStop = true;
 		isWorkerRunning = false;
-		if (workerThread->joinable()) {
-			workerThread->join();
-		}
+		outputSignals::remove(signalsType, signalsId);
 	}
-};
\ No newline at end of file
+
+private:
+	uint64_t signalsId = UINT64_MAX;
+};
@@ -25,28 +25,107 @@
 #include "shared.hpp"
 #include "osn-source.hpp"
 #include "osn-volmeter.hpp"
+#include <atomic>
+#include <condition_variable>
 
 std::mutex sources_sizes_mtx;
 std::map<std::string, SourceSizeInfo *> sources;
 
+// Event channel state, the client keeps one WaitEvents call in flight on a
+// dedicated connection and the server answers it as soon as something changed.
+static std::mutex events_mtx;
+static std::condition_variable events_cv;
+static bool sizes_pending = false;
+// Set from the audio thread, only the first update of a batch takes the lock.
+static std::atomic<bool> volmeters_pending{false};
+// Scenes bumped since the last batch, with their latest generation.
+static uint64_t scene_generation = 0;
+static std::map<uint64_t, uint64_t> scenes_pending;
+static bool events_interrupt = false;
+// Output signals have their own long poll so outputs still report to the
+// client when no source callback is registered.
+static std::deque<OutputSignal> signals_pending;
+static bool signals_interrupt = false;
+static bool events_stop = false;
+static bool tick_registered = false;
+
+// Volmeters of all sources are updated from the same audio tick, give the
+// remaining callbacks of the burst a chance to land in the same batch.
+static const std::chrono::milliseconds events_coalesce_window(4);
+static const uint32_t events_max_timeout_ms = 5000;
+// Drops the oldest signals when nobody listens to the channel.
+static const size_t signals_max_pending = 1024;
+
 void CallbackManager::Register(ipc::server &srv)
 {
 	std::shared_ptr<ipc::collection> cls = std::make_shared<ipc::collection>("CallbackManager");
-	cls->register_function(std::make_shared<ipc::function>("GlobalQuery", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::Binary}, GlobalQuery));
+	cls->register_function(std::make_shared<ipc::function>("WaitEvents", std::vector<ipc::type>{ipc::type::UInt32}, WaitEvents));
+	cls->register_function(std::make_shared<ipc::function>("Interrupt", std::vector<ipc::type>{}, Interrupt));
+	cls->register_function(std::make_shared<ipc::function>("WaitSignals", std::vector<ipc::type>{ipc::type::UInt32}, WaitSignals));
+	cls->register_function(std::make_shared<ipc::function>("InterruptSignals", std::vector<ipc::type>{}, InterruptSignals));
 	srv.register_collection(cls);
 }
 
-void CallbackManager::GlobalQuery(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
+void CallbackManager::Initialize()
 {
-	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	{
+		std::unique_lock<std::mutex> ulock(events_mtx);
+		events_stop = false;
+	}
+
+	if (!tick_registered) {
+		obs_add_tick_callback(SourceSizeTick, nullptr);
+		tick_registered = true;
+	}
+}
+
+void CallbackManager::Finalize()
+{
+	if (tick_registered) {
+		obs_remove_tick_callback(SourceSizeTick, nullptr);
+		tick_registered = false;
+	}
 
-	if (!sources.empty()) {
-		sources_sizes_mtx.lock();
-		uint32_t size = 0;
+	std::unique_lock<std::mutex> ulock(events_mtx);
+	events_stop = true;
+	events_cv.notify_all();
+}
+
+void CallbackManager::NotifyVolmeterUpdate()
+{
+	if (volmeters_pending.load(std::memory_order_relaxed) || volmeters_pending.exchange(true))
+		return;
+
+	std::unique_lock<std::mutex> ulock(events_mtx);
+	events_cv.notify_all();
+}
+
+void CallbackManager::NotifySceneChanged(uint64_t uid)
+{
+	std::unique_lock<std::mutex> ulock(events_mtx);
+	scenes_pending[uid] = ++scene_generation;
+	events_cv.notify_all();
+}
 
+void CallbackManager::NotifyOutputSignal(uint64_t uid, const std::string &type, const std::string &signal, int32_t code, const std::string &errorMessage,
+					 int32_t service)
+{
+	std::unique_lock<std::mutex> ulock(events_mtx);
+	if (signals_pending.size() >= signals_max_pending)
+		signals_pending.pop_front();
+
+	signals_pending.push_back({uid, type, signal, code, errorMessage, service});
+	events_cv.notify_all();
+}
+
+void CallbackManager::SourceSizeTick(void *param, float seconds)
+{
+	bool changed = false;
+
+	{
+		std::unique_lock<std::mutex> ulock(sources_sizes_mtx);
 		for (auto item : sources) {
 			SourceSizeInfo *si = item.second;
-			// See if width or height changed here
 			uint32_t newWidth = obs_source_get_width(si->source);
 			uint32_t newHeight = obs_source_get_height(si->source);
 			uint32_t newFlags = obs_source_get_output_flags(si->source);
@@ -55,35 +134,134 @@ void CallbackManager::GlobalQuery(void *data, const int64_t id, const std::vecto
 				si->width = newWidth;
 				si->height = newHeight;
 				si->flags = newFlags;
+				si->changed = true;
+			}
+			changed |= si->changed;
+		}
+	}
 
-				rval.push_back(ipc::value(obs_source_get_name(si->source)));
-				rval.push_back(ipc::value(si->width));
-				rval.push_back(ipc::value(si->height));
-				rval.push_back(ipc::value(si->flags));
+	if (changed) {
+		std::unique_lock<std::mutex> ulock(events_mtx);
+		if (!sizes_pending) {
+			sizes_pending = true;
+			events_cv.notify_all();
+		}
+	}
+}
 
-				size++;
-			}
+void CallbackManager::Interrupt(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
+{
+	{
+		std::unique_lock<std::mutex> ulock(events_mtx);
+		events_interrupt = true;
+		events_cv.notify_all();
+	}
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	AUTO_DEBUG;
+}
+
+void CallbackManager::WaitEvents(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
+{
+	uint32_t timeout = std::min(args[0].value_union.ui32, events_max_timeout_ms);
+	bool sendSizes = false;
+	bool sendVolmeters = false;
+	std::map<uint64_t, uint64_t> scenes;
+
+	{
+		std::unique_lock<std::mutex> ulock(events_mtx);
+		events_cv.wait_for(ulock, std::chrono::milliseconds(timeout),
+				   []() { return events_stop || events_interrupt || sizes_pending || volmeters_pending || !scenes_pending.empty(); });
+
+		if (!events_stop && !events_interrupt && (sizes_pending || volmeters_pending || !scenes_pending.empty()))
+			events_cv.wait_for(ulock, events_coalesce_window, []() { return events_stop || events_interrupt; });
+
+		if (events_stop) {
+			PRETTY_ERROR_RETURN(ErrorCode::Error, "Event channel is closed.");
+		}
+
+		sendSizes = sizes_pending;
+		sendVolmeters = volmeters_pending.exchange(false);
+		sizes_pending = false;
+		events_interrupt = false;
+		scenes.swap(scenes_pending);
+	}
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+
+	uint32_t size = 0;
+	rval.push_back(ipc::value(size));
+	if (sendSizes) {
+		std::unique_lock<std::mutex> ulock(sources_sizes_mtx);
+		for (auto item : sources) {
+			SourceSizeInfo *si = item.second;
+			if (!si->changed)
+				continue;
+
+			si->changed = false;
+			rval.push_back(ipc::value(obs_source_get_name(si->source)));
+			rval.push_back(ipc::value(si->width));
+			rval.push_back(ipc::value(si->height));
+			rval.push_back(ipc::value(si->flags));
+			size++;
 		}
+		rval[1] = ipc::value(size);
+	}
 
-		rval.insert(rval.begin() + 1, ipc::value(size));
-		sources_sizes_mtx.unlock();
+	if (sendVolmeters) {
+		osn::Volmeter::getAudioUpdates(rval);
 	} else {
-		rval.insert(rval.begin() + 1, ipc::value((uint32_t)0));
+		rval.push_back(ipc::value((uint32_t)0));
+	}
+
+	rval.push_back(ipc::value((uint32_t)scenes.size()));
+	for (auto &scene : scenes) {
+		rval.push_back(ipc::value(scene.first));
+		rval.push_back(ipc::value(scene.second));
 	}
 
-	uint64_t size_buffer = args[0].value_union.ui64;
+	AUTO_DEBUG;
+}
+
+void CallbackManager::InterruptSignals(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
+{
+	{
+		std::unique_lock<std::mutex> ulock(events_mtx);
+		signals_interrupt = true;
+		events_cv.notify_all();
+	}
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	AUTO_DEBUG;
+}
 
-	std::vector<char> buffer;
-	buffer.resize(size_buffer);
-	memcpy(buffer.data(), args[1].value_bin.data(), size_buffer);
+void CallbackManager::WaitSignals(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
+{
+	uint32_t timeout = std::min(args[0].value_union.ui32, events_max_timeout_ms);
+	std::deque<OutputSignal> signals;
+
+	{
+		std::unique_lock<std::mutex> ulock(events_mtx);
+		events_cv.wait_for(ulock, std::chrono::milliseconds(timeout),
+				   []() { return events_stop || signals_interrupt || !signals_pending.empty(); });
 
-	uint64_t nb_volmeters = size_buffer / sizeof(uint64_t);
-	uint64_t index = 0;
+		if (events_stop) {
+			PRETTY_ERROR_RETURN(ErrorCode::Error, "Event channel is closed.");
+		}
 
-	for (int i = 0; i < nb_volmeters; i++) {
-		uint64_t id = *reinterpret_cast<uint64_t *>(buffer.data() + index);
-		osn::Volmeter::getAudioData(id, rval);
-		index += sizeof(uint64_t);
+		signals_interrupt = false;
+		signals.swap(signals_pending);
+	}
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	rval.push_back(ipc::value((uint32_t)signals.size()));
+	for (auto &signal : signals) {
+		rval.push_back(ipc::value(signal.uid));
+		rval.push_back(ipc::value(signal.type));
+		rval.push_back(ipc::value(signal.signal));
+		rval.push_back(ipc::value(signal.code));
+		rval.push_back(ipc::value(signal.errorMessage));
+		rval.push_back(ipc::value(signal.service));
 	}
 
 	AUTO_DEBUG;
@@ -105,8 +283,11 @@ void CallbackManager::addSource(obs_source_t *source)
 	si->source = source;
 	si->width = obs_source_get_width(source);
 	si->height = obs_source_get_height(source);
+	si->flags = flags;
+	si->changed = true;
 
-	sources.emplace(std::make_pair(std::string(obs_source_get_name(source)), si));
+	if (!sources.emplace(std::make_pair(std::string(obs_source_get_name(source)), si)).second)
+		delete si;
 }
 void CallbackManager::removeSource(obs_source_t *source)
 {
@@ -116,7 +297,13 @@ void CallbackManager::removeSource(obs_source_t *source)
 		return;
 
 	const char *name = obs_source_get_name(source);
+	if (!name)
+		return;
+
+	auto iter = sources.find(name);
+	if (iter == sources.end() || iter->second->source != source)
+		return;
 
-	if (name)
-		sources.erase(name);
+	delete iter->second;
+	sources.erase(iter);
 }
\ No newline at end of file
@@ -24,6 +24,7 @@
 #include <map>
 #include <mutex>
 #include <obs.h>
+#include <deque>
 #include <queue>
 #include <string>
 #include <thread>
@@ -39,17 +40,46 @@ struct SourceSizeInfo {
 	uint32_t width = 0;
 	uint32_t height = 0;
 	uint32_t flags = 0;
+	bool changed = false;
+};
+
+struct OutputSignal {
+	uint64_t uid;
+	std::string type;
+	std::string signal;
+	int32_t code;
+	std::string errorMessage;
+	int32_t service;
 };
 
 class CallbackManager {
 public:
+	// Id under which the outputs of NodeOBS_Service push their signals.
+	static constexpr uint64_t ServiceSignalsId = UINT64_MAX;
+
 	CallbackManager(){};
 	~CallbackManager(){};
 
 	static void Register(ipc::server &);
-	static void QuerySourceSize(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
-	static void GlobalQuery(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
+	static void WaitEvents(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
+	static void Interrupt(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
+	static void WaitSignals(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
+	static void InterruptSignals(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
+
+	static void Initialize();
+	static void Finalize();
+
+	// Wakes up the event channel, the pending data is collected when the batch is built.
+	static void NotifyVolmeterUpdate();
+	// Bumps the generation of a scene, the client then drops what it cached for its items.
+	static void NotifySceneChanged(uint64_t uid);
+	// Queues an output signal for the client, uid is the id of the output in its manager.
+	static void NotifyOutputSignal(uint64_t uid, const std::string &type, const std::string &signal, int32_t code, const std::string &errorMessage,
+				       int32_t service = 0);
 
 	static void addSource(obs_source_t *source);
 	static void removeSource(obs_source_t *source);
+
+private:
+	static void SourceSizeTick(void *param, float seconds);
 };
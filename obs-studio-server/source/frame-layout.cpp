@@ -0,0 +1,104 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#include "frame-layout.h"
+#include <atomic>
+
+namespace {
+// Bytes per sample of a plane, and how many times its width and height are
+// halved by chroma subsampling. Packed 4:2:2 formats hold two pixels per
+// four bytes, their width is rounded up to an even number of pixels. v210
+// packs six pixels in a block of 16 bytes, bytes is then per block of pixels.
+struct Plane {
+	uint8_t bytes;
+	uint8_t shift_x;
+	uint8_t shift_y;
+	uint8_t pixels = 1;
+};
+
+struct Format {
+	enum video_format format;
+	uint32_t planes;
+	Plane plane[4];
+};
+
+const Format formats[] = {
+	{VIDEO_FORMAT_I420, 3, {{1, 0, 0}, {1, 1, 1}, {1, 1, 1}}},
+	{VIDEO_FORMAT_NV12, 2, {{1, 0, 0}, {2, 1, 1}}},
+	{VIDEO_FORMAT_YVYU, 1, {{4, 1, 0}}},
+	{VIDEO_FORMAT_YUY2, 1, {{4, 1, 0}}},
+	{VIDEO_FORMAT_UYVY, 1, {{4, 1, 0}}},
+	{VIDEO_FORMAT_RGBA, 1, {{4, 0, 0}}},
+	{VIDEO_FORMAT_BGRA, 1, {{4, 0, 0}}},
+	{VIDEO_FORMAT_BGRX, 1, {{4, 0, 0}}},
+	{VIDEO_FORMAT_Y800, 1, {{1, 0, 0}}},
+	{VIDEO_FORMAT_I444, 3, {{1, 0, 0}, {1, 0, 0}, {1, 0, 0}}},
+	{VIDEO_FORMAT_BGR3, 1, {{3, 0, 0}}},
+	{VIDEO_FORMAT_I422, 3, {{1, 0, 0}, {1, 1, 0}, {1, 1, 0}}},
+	{VIDEO_FORMAT_I40A, 4, {{1, 0, 0}, {1, 1, 1}, {1, 1, 1}, {1, 0, 0}}},
+	{VIDEO_FORMAT_I42A, 4, {{1, 0, 0}, {1, 1, 0}, {1, 1, 0}, {1, 0, 0}}},
+	{VIDEO_FORMAT_YUVA, 4, {{1, 0, 0}, {1, 0, 0}, {1, 0, 0}, {1, 0, 0}}},
+	{VIDEO_FORMAT_AYUV, 1, {{4, 0, 0}}},
+	// High bit depth, samples are 16 bit words
+	{VIDEO_FORMAT_I010, 3, {{2, 0, 0}, {2, 1, 1}, {2, 1, 1}}},
+	{VIDEO_FORMAT_P010, 2, {{2, 0, 0}, {4, 1, 1}}},
+	{VIDEO_FORMAT_I210, 3, {{2, 0, 0}, {2, 1, 0}, {2, 1, 0}}},
+	{VIDEO_FORMAT_I412, 3, {{2, 0, 0}, {2, 0, 0}, {2, 0, 0}}},
+	{VIDEO_FORMAT_YA2L, 4, {{2, 0, 0}, {2, 0, 0}, {2, 0, 0}, {2, 0, 0}}},
+	{VIDEO_FORMAT_P216, 2, {{2, 0, 0}, {4, 1, 0}}},
+	{VIDEO_FORMAT_P416, 2, {{2, 0, 0}, {4, 0, 0}}},
+	{VIDEO_FORMAT_V210, 1, {{16, 0, 0, 6}}},
+	{VIDEO_FORMAT_R10L, 1, {{4, 0, 0}}},
+};
+
+uint64_t align(uint64_t size)
+{
+	return (size + FRAME_ALIGNMENT - 1) & ~uint64_t(FRAME_ALIGNMENT - 1);
+}
+
+uint32_t subsample(uint32_t size, uint8_t shift)
+{
+	return (size + (1u << shift) - 1) >> shift;
+}
+}
+
+bool GetFrameLayout(enum video_format format, uint32_t width, uint32_t height, FrameLayout &layout)
+{
+	for (const Format &entry : formats) {
+		if (entry.format != format)
+			continue;
+
+		layout = FrameLayout();
+		layout.planes = entry.planes;
+		for (uint32_t i = 0; i < entry.planes; i++) {
+			const Plane &plane = entry.plane[i];
+			layout.linesize[i] = (subsample(width, plane.shift_x) + plane.pixels - 1) / plane.pixels * plane.bytes;
+			layout.height[i] = subsample(height, plane.shift_y);
+			layout.offset[i] = layout.size;
+			layout.size = align(layout.size + uint64_t(layout.linesize[i]) * layout.height[i]);
+		}
+		return true;
+	}
+
+	// Once per format, the frames of such sources are left out of the media cache
+	static std::atomic<uint64_t> logged = 0;
+	const uint64_t bit = 1ull << ((uint32_t)format & 63);
+	if (!(logged.fetch_or(bit) & bit))
+		blog(LOG_WARNING, "Frame layout of video format %d is unknown", (int)format);
+	return false;
+}
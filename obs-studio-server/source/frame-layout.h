@@ -0,0 +1,36 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#pragma once
+#include <obs.h>
+
+#define FRAME_ALIGNMENT 32
+
+// Memory of one decoded frame as video_frame_init lays it out: planes follow
+// each other in a single allocation and each one is padded to
+// FRAME_ALIGNMENT bytes.
+struct FrameLayout {
+	uint32_t planes = 0;
+	uint32_t linesize[MAX_AV_PLANES] = {};
+	uint32_t height[MAX_AV_PLANES] = {};
+	uint64_t offset[MAX_AV_PLANES] = {};
+	uint64_t size = 0;
+};
+
+// False for formats missing from the table.
+bool GetFrameLayout(enum video_format format, uint32_t width, uint32_t height, FrameLayout &layout);
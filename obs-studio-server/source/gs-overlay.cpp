@@ -0,0 +1,286 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#include "gs-overlay.h"
+#include <algorithm>
+#include <cmath>
+
+static const float Pi = 3.14159265358979323846f;
+
+static GS::OverlayVertex MakeVertex(const GS::OverlayTransform &transform, float x, float y, uint32_t color)
+{
+	GS::OverlayVertex vertex = {0, 0, 0, 0, color};
+	transform.Apply(x, y, vertex.x, vertex.y);
+	return vertex;
+}
+
+void GS::OverlayBuilder::Clear()
+{
+	m_triangles.clear();
+	m_lines.clear();
+	m_guidelines.clear();
+	m_text.clear();
+}
+
+void GS::OverlayBuilder::AddTriangle(const OverlayVertex &a, const OverlayVertex &b, const OverlayVertex &c)
+{
+	m_triangles.push_back(a);
+	m_triangles.push_back(b);
+	m_triangles.push_back(c);
+}
+
+// Corners in triangle strip order, keeps the winding the strips had.
+void GS::OverlayBuilder::AddQuad(const OverlayVertex &a, const OverlayVertex &b, const OverlayVertex &c, const OverlayVertex &d)
+{
+	AddTriangle(a, b, c);
+	AddTriangle(c, b, d);
+}
+
+void GS::OverlayBuilder::AddLine(std::vector<OverlayVertex> &lines, const OverlayVertex &a, const OverlayVertex &b)
+{
+	lines.push_back(a);
+	lines.push_back(b);
+}
+
+void GS::OverlayBuilder::AddOutline(const OverlayTransform &box, uint32_t cropped, float scaleX, float scaleY, uint32_t color, uint32_t cropColor)
+{
+	static const struct {
+		Side side;
+		float x1, y1, x2, y2;
+	} sides[] = {
+		{Left, 0.0f, 0.0f, 0.0f, 1.0f},
+		{Top, 0.0f, 0.0f, 1.0f, 0.0f},
+		{Right, 1.0f, 0.0f, 1.0f, 1.0f},
+		{Bottom, 0.0f, 1.0f, 1.0f, 1.0f},
+	};
+
+	for (const auto &side : sides) {
+		if (cropped & side.side)
+			AddCropOutline(box, side.x1, side.y1, side.x2, side.y2, scaleX, scaleY, cropColor);
+		else
+			AddLine(m_lines, MakeVertex(box, side.x1, side.y1, color), MakeVertex(box, side.x2, side.y2, color));
+	}
+}
+
+void GS::OverlayBuilder::AddCropOutline(const OverlayTransform &box, float x1, float y1, float x2, float y2, float scaleX, float scaleY,
+					uint32_t color)
+{
+	// This is partially code from OBS Studio. See window-basic-preview.cpp in obs-studio for copyright/license.
+
+	float ySide = (y1 == y2) ? (y1 < 0.5f ? 1.0f : -1.0f) : 0.0f;
+	float xSide = (x1 == x2) ? (x1 < 0.5f ? 1.0f : -1.0f) : 0.0f;
+
+	float dist = sqrt(pow((x1 - x2) * scaleX, 2) + pow((y1 - y2) * scaleY, 2));
+	float offX = (x2 - x1) / dist;
+	float offY = (y2 - y1) / dist;
+
+	int l = static_cast<int>(ceil(dist / 15));
+	for (int i = 0; i < l; ++i) {
+		float xx1 = x1 + i * 15 * offX;
+		float yy1 = y1 + i * 15 * offY;
+
+		float dx;
+		float dy;
+
+		if (x1 < x2) {
+			dx = std::min(xx1 + 7.5f * offX, x2);
+		} else {
+			dx = std::max(xx1 + 7.5f * offX, x2);
+		}
+
+		if (y1 < y2) {
+			dy = std::min(yy1 + 7.5f * offY, y2);
+		} else {
+			dy = std::max(yy1 + 7.5f * offY, y2);
+		}
+
+		AddQuad(MakeVertex(box, xx1, yy1, color), MakeVertex(box, xx1 + (xSide * (5 / scaleX)), yy1 + (ySide * (5 / scaleY)), color),
+			MakeVertex(box, dx, dy, color), MakeVertex(box, dx + (xSide * (5 / scaleX)), dy + (ySide * (5 / scaleY)), color));
+	}
+}
+
+void GS::OverlayBuilder::AddGuideline(const OverlayTransform &box, bool rot45, float x, float y, uint32_t color)
+{
+	OverlayVertex pos = MakeVertex(box, x, y, color);
+	OverlayVertex center = MakeVertex(box, 0.5f, 0.5f, color);
+
+	float normalX = center.x - pos.x;
+	float normalY = center.y - pos.y;
+	float length = sqrt(normalX * normalX + normalY * normalY);
+	if (length > 0.0f) {
+		normalX /= length;
+		normalY /= length;
+	}
+
+	float up[2], dn[2], lt[2], rt[2];
+	if (rot45) {
+		up[0] = -0.2f, up[1] = 1.0f;
+		dn[0] = 0.2f, dn[1] = -1.0f;
+		lt[0] = -1.0f, lt[1] = -0.2f;
+		rt[0] = 1.0f, rt[1] = 0.2f;
+	} else {
+		up[0] = 0.0f, up[1] = 1.0f;
+		dn[0] = 0.0f, dn[1] = -1.0f;
+		lt[0] = -1.0f, lt[1] = 0.0f;
+		rt[0] = 1.0f, rt[1] = 0.0f;
+	}
+
+	auto dot = [&](const float *v) {
+		return v[0] * normalX + v[1] * normalY;
+	};
+
+	// The line runs away from the center, long enough to leave any preview.
+	float dirX = 1.0f, dirY = 0.0f;
+	if (dot(up) > 0.707f) {
+		dirX = 0.0f, dirY = -1.0f;
+	} else if (dot(dn) > 0.707f) {
+		dirX = 0.0f, dirY = 1.0f;
+	} else if (dot(lt) > 0.707f) {
+		dirX = 1.0f, dirY = 0.0f;
+	} else if (dot(rt) > 0.707f) {
+		dirX = -1.0f, dirY = 0.0f;
+	}
+
+	OverlayVertex end = pos;
+	end.x += dirX * 65535;
+	end.y += dirY * 65535;
+	AddLine(m_guidelines, pos, end);
+}
+
+void GS::OverlayBuilder::AddRotationHandle(const OverlayTransform &box, float rot, float radius, uint32_t color)
+{
+	// The handle is modelled in a 3 radius wide square whose center sits on
+	// the middle of the top edge, rotated with the item.
+	OverlayTransform handle;
+	box.Apply(0.5f, 0.0f, handle.tx, handle.ty);
+
+	float c = cos(rot * Pi / 180.0f);
+	float s = sin(rot * Pi / 180.0f);
+	float size = radius * 3;
+	handle.xx = size * c;
+	handle.xy = size * s;
+	handle.yx = -size * s;
+	handle.yy = size * c;
+	handle.tx += -radius * 1.5f * c + radius * 1.5f * s;
+	handle.ty += -radius * 1.5f * s - radius * 1.5f * c;
+
+	float left = 0.5f - 0.34f / radius;
+	float right = 0.5f + 0.34f / radius;
+	AddQuad(MakeVertex(handle, left, 0.5f, color), MakeVertex(handle, left, -2.0f, color), MakeVertex(handle, right, 0.5f, color),
+		MakeVertex(handle, right, -2.0f, color));
+
+	// Circle at the end of the line, a fan around its lowest point
+	float offset = -radius * 0.6f;
+	OverlayVertex bottom = MakeVertex(handle, 0.5f, 1.0f + offset, color);
+	float angle = 180;
+	for (int i = 0; i < 40; ++i) {
+		float from = angle * Pi / 180.0f;
+		angle += 8.75f;
+		float to = angle * Pi / 180.0f;
+		AddTriangle(MakeVertex(handle, sin(from) / 2 + 0.5f, cos(from) / 2 + 0.5f + offset, color),
+			    MakeVertex(handle, sin(to) / 2 + 0.5f, cos(to) / 2 + 0.5f + offset, color), bottom);
+	}
+}
+
+void GS::OverlayBuilder::AddResizeHandle(const OverlayTransform &box, float x, float y, float radiusX, float radiusY, uint32_t inner, uint32_t outer)
+{
+	float centerX, centerY;
+	box.Apply(x, y, centerX, centerY);
+
+	OverlayVertex topLeft = {centerX - radiusX, centerY - radiusY, 0, 0, inner};
+	OverlayVertex topRight = {centerX + radiusX, centerY - radiusY, 0, 0, inner};
+	OverlayVertex bottomLeft = {centerX - radiusX, centerY + radiusY, 0, 0, inner};
+	OverlayVertex bottomRight = {centerX + radiusX, centerY + radiusY, 0, 0, inner};
+	AddQuad(topLeft, topRight, bottomLeft, bottomRight);
+
+	topLeft.color = topRight.color = bottomLeft.color = bottomRight.color = outer;
+	AddLine(m_lines, topLeft, topRight);
+	AddLine(m_lines, topRight, bottomRight);
+	AddLine(m_lines, bottomRight, bottomLeft);
+	AddLine(m_lines, bottomLeft, topLeft);
+}
+
+void GS::OverlayBuilder::AddGlyph(float x, float y, float scale, char glyph, uint32_t color)
+{
+	float uvX = 0, uvY = 0, uvO = 1.0 / 4.0;
+	switch (glyph) {
+	default:
+		return;
+		break;
+	case '1':
+		uvX = 0;
+		uvY = 0;
+		break;
+	case '2':
+		uvX = uvO;
+		uvY = 0;
+		break;
+	case '3':
+		uvX = uvO * 2;
+		uvY = 0;
+		break;
+	case '4':
+		uvX = uvO * 3;
+		uvY = 0;
+		break;
+	case '5':
+		uvX = 0;
+		uvY = uvO * 1;
+		break;
+	case '6':
+		uvX = uvO;
+		uvY = uvO * 1;
+		break;
+	case '7':
+		uvX = uvO * 2;
+		uvY = uvO * 1;
+		break;
+	case '8':
+		uvX = uvO * 3;
+		uvY = uvO * 1;
+		break;
+	case '9':
+		uvX = 0;
+		uvY = uvO * 2;
+		break;
+	case '0':
+		uvX = uvO;
+		uvY = uvO * 2;
+		break;
+	case 'p':
+		uvX = uvO * 2;
+		uvY = uvO * 2;
+		break;
+	case 'x':
+		uvX = uvO * 3;
+		uvY = uvO * 2;
+		break;
+	}
+
+	OverlayVertex topLeft = {x, y, uvX, uvY, color};
+	OverlayVertex topRight = {x + scale, y, uvX + uvO, uvY, color};
+	OverlayVertex bottomLeft = {x, y + scale * 2, uvX, uvY + uvO, color};
+	OverlayVertex bottomRight = {x + scale, y + scale * 2, uvX + uvO, uvY + uvO, color};
+
+	m_text.push_back(topLeft);
+	m_text.push_back(topRight);
+	m_text.push_back(bottomLeft);
+	m_text.push_back(topRight);
+	m_text.push_back(bottomLeft);
+	m_text.push_back(bottomRight);
+}
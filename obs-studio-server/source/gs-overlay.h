@@ -0,0 +1,90 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#pragma once
+#include <inttypes.h>
+#include <vector>
+
+namespace GS {
+struct OverlayVertex {
+	float x, y;
+	float u, v;
+	uint32_t color;
+};
+
+// 2D part of a libobs matrix4, applied to row vectors the same way
+// vec3_transform does: p' = p.x * x + p.y * y + t.
+struct OverlayTransform {
+	float xx = 1, xy = 0;
+	float yx = 0, yy = 1;
+	float tx = 0, ty = 0;
+
+	void Apply(float x, float y, float &outX, float &outY) const
+	{
+		outX = x * xx + y * yx + tx;
+		outY = x * xy + y * yy + ty;
+	}
+};
+
+// Collects the selection overlay of every scene item of a frame on the CPU,
+// so that the display uploads it once and draws it with a few calls instead
+// of a matrix push, buffer load and draw per primitive.
+//
+// Vertices are in world coordinates with their color already applied.
+// Triangles and lines are drawn with the solid effect, guidelines are lines
+// as well but drawn clipped to the preview, text uses the font texture.
+class OverlayBuilder {
+public:
+	enum Side { Left = 1, Top = 2, Right = 4, Bottom = 8 };
+
+	void Clear();
+
+	// Box outline of an item, cropped sides are dashed. cropped holds Side
+	// flags, scale is the size of the box in pixels.
+	void AddOutline(const OverlayTransform &box, uint32_t cropped, float scaleX, float scaleY, uint32_t color, uint32_t cropColor);
+
+	// Line from the point (x, y) of the box away from its center, to the
+	// edge of the preview.
+	void AddGuideline(const OverlayTransform &box, bool rot45, float x, float y, uint32_t color);
+
+	// Handle above the top edge of the box, rot in degrees, radius in pixels.
+	void AddRotationHandle(const OverlayTransform &box, float rot, float radius, uint32_t color);
+
+	// Square resize handle centered on the point (x, y) of the box.
+	void AddResizeHandle(const OverlayTransform &box, float x, float y, float radiusX, float radiusY, uint32_t inner, uint32_t outer);
+
+	// One glyph of the font texture, a 4x4 atlas of "1234567890px".
+	void AddGlyph(float x, float y, float scale, char glyph, uint32_t color);
+
+	const std::vector<OverlayVertex> &Triangles() const { return m_triangles; }
+	const std::vector<OverlayVertex> &Lines() const { return m_lines; }
+	const std::vector<OverlayVertex> &Guidelines() const { return m_guidelines; }
+	const std::vector<OverlayVertex> &Text() const { return m_text; }
+
+private:
+	void AddCropOutline(const OverlayTransform &box, float x1, float y1, float x2, float y2, float scaleX, float scaleY, uint32_t color);
+	void AddTriangle(const OverlayVertex &a, const OverlayVertex &b, const OverlayVertex &c);
+	void AddQuad(const OverlayVertex &a, const OverlayVertex &b, const OverlayVertex &c, const OverlayVertex &d);
+	void AddLine(std::vector<OverlayVertex> &lines, const OverlayVertex &a, const OverlayVertex &b);
+
+	std::vector<OverlayVertex> m_triangles;
+	std::vector<OverlayVertex> m_lines;
+	std::vector<OverlayVertex> m_guidelines;
+	std::vector<OverlayVertex> m_text;
+};
+} // namespace GS
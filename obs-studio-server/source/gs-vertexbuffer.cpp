@@ -172,6 +172,11 @@ uint32_t GS::VertexBuffer::Size()
 	return m_size;
 }
 
+uint32_t GS::VertexBuffer::Capacity()
+{
+	return m_capacity;
+}
+
 bool GS::VertexBuffer::Empty()
 {
 	return m_size == 0;
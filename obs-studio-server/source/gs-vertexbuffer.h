@@ -95,6 +95,8 @@ public:
 
 	uint32_t Size();
 
+	uint32_t Capacity();
+
 	bool Empty();
 
 	const GS::Vertex At(uint32_t idx);
@@ -32,6 +32,8 @@
 #include "nodeobs_content.h"
 #include "nodeobs_service.h"
 #include "nodeobs_settings.h"
+#include "osn-collection.hpp"
+#include "osn-diagnostics.hpp"
 #include "osn-fader.hpp"
 #include "osn-filter.hpp"
 #include "osn-global.hpp"
@@ -243,6 +245,8 @@ int main(int argc, char *argv[])
 	osn::Transition::Register(myServer);
 	osn::Scene::Register(myServer);
 	osn::SceneItem::Register(myServer);
+	osn::Collection::Register(myServer);
+	osn::Diagnostics::Register(myServer);
 	osn::Fader::Register(myServer);
 	osn::Volmeter::Register(myServer);
 	osn::Properties::Register(myServer);
@@ -316,12 +320,14 @@ int main(int argc, char *argv[])
 	OBS_API::WaitCrashHandlerClose(waitBeforeClosing);
 #endif
 	osn::Source::finalize_global_signals();
+	CallbackManager::Finalize();
 
 	// First, be sure there are no connected clients
 	myServer.finalize();
 
 	// Then, shutdown OBS
 	OBS_API::destroyOBS_API();
+	OBS_API::FlushLogs();
 #ifdef __APPLE__
 	util::CrashManager::DeleteBriefCrashInfoFile();
 	if (override_std_fd) {
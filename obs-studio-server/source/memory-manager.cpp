@@ -17,15 +17,21 @@
 ******************************************************************************/
 
 #include "memory-manager.h"
-#include "nodeobs_api.h"
+#include "frame-layout.h"
+#include <cstring>
+#include <media-io/video-frame.h>
 
 struct MemoryManager::source_info {
 	bool cached = false;
 	uint64_t size = 0;
 	obs_source_t *source = nullptr;
-	std::vector<std::thread> workers;
-	std::mutex mtx;
-	bool have_video = false;
+	bool showing = false;
+	std::chrono::steady_clock::time_point last_shown = std::chrono::steady_clock::now();
+
+	// Guarded by 'queue_mtx'
+	bool queued = false;
+	bool running = false;
+	bool removed = false;
 };
 
 MemoryManager &MemoryManager::GetInstance()
@@ -37,84 +43,100 @@ MemoryManager &MemoryManager::GetInstance()
 MemoryManager::MemoryManager()
 {
 	blog(LOG_INFO, "MemoryManager: constructor called");
-#ifdef WIN32
-	MEMORYSTATUSEX statex;
-	statex.dwLength = sizeof(statex);
-
-	if (::GlobalMemoryStatusEx(&statex)) {
-		available_memory = statex.ullTotalPhys;
-		allowed_cached_size = std::min<uint64_t>(LIMIT, available_memory / 2);
-	} else {
-		available_memory = 0;
-		allowed_cached_size = LIMIT;
-	}
-#elif __APPLE__
-	available_memory = g_util_osx->getTotalPhysicalMemory();
-	allowed_cached_size = std::min((uint64_t)LIMIT, (uint64_t)available_memory / 2);
-#endif
+	available_memory = 0;
+	current_cached_size = 0;
+	allowed_cached_size = 0;
+	updateBudget();
+	blog(LOG_INFO, "MemoryManager: %lluMB of memory, cache budget %lluMB", (unsigned long long)(available_memory / 1000000),
+	     (unsigned long long)(allowed_cached_size / 1000000));
+
+	for (int i = 0; i < WORKERS; i++)
+		workers.push_back(std::thread(&MemoryManager::worker, this));
 }
 
 MemoryManager::~MemoryManager()
 {
 	blog(LOG_INFO, "MemoryManager: destructor called");
-	for (auto &source : sources) {
-		unregisterSource(source.second->source);
+	{
+		std::unique_lock ulock(queue_mtx);
+		stopping = true;
+	}
+	queue_cv.notify_all();
+
+	for (auto &worker : workers) {
+		if (worker.joinable())
+			worker.join();
 	}
 }
 
-// Not thread safe. 'si.mtx' should be locked
-void MemoryManager::calculateRawSize(source_info &si)
+// Size of a frame by the table, checked once per format and size against
+// the frame libobs allocates for it. The media cache copies every frame into
+// such an allocation, libobs is trusted where the two disagree.
+static uint64_t frameSize(enum video_format format, uint32_t width, uint32_t height)
 {
-	calldata_t cd = {0};
-	proc_handler_t *ph = obs_source_get_proc_handler(si.source);
-	proc_handler_call(ph, "get_file_info", &cd);
-	si.have_video = calldata_bool(&cd, "have_video");
-
-	const uint32_t pix_fmt = calldata_int(&cd, "pix_format");
-	float bpp = 0;
-	switch (pix_fmt) {
-	case VIDEO_FORMAT_I420:
-	case VIDEO_FORMAT_NV12:
-	case VIDEO_FORMAT_I40A:
-		bpp = 1.5;
-		break;
-	case VIDEO_FORMAT_YVYU:
-	case VIDEO_FORMAT_YUY2:
-	case VIDEO_FORMAT_UYVY:
-	case VIDEO_FORMAT_I422:
-	case VIDEO_FORMAT_I42A:
-		bpp = 2;
-		break;
-	case VIDEO_FORMAT_RGBA:
-	case VIDEO_FORMAT_BGRA:
-	case VIDEO_FORMAT_BGRX:
-	case VIDEO_FORMAT_Y800:
-	case VIDEO_FORMAT_I444:
-	case VIDEO_FORMAT_BGR3:
-	case VIDEO_FORMAT_YUVA:
-	case VIDEO_FORMAT_AYUV:
-		bpp = 4;
+	static std::mutex checked_mtx;
+	static std::map<std::tuple<int, uint32_t, uint32_t>, uint64_t> checked;
+
+	FrameLayout layout;
+	if (!GetFrameLayout(format, width, height, layout))
+		return 0;
+
+	std::unique_lock ulock(checked_mtx);
+	auto key = std::make_tuple((int)format, width, height);
+	auto it = checked.find(key);
+	if (it != checked.end())
+		return it->second;
+
+	struct video_frame frame;
+	video_frame_init(&frame, format, width, height);
+	uint64_t size = layout.size;
+	for (uint32_t i = 0; i < layout.planes; i++) {
+		const uint64_t offset = frame.data[i] ? frame.data[i] - frame.data[0] : 0;
+		if (frame.linesize[i] == layout.linesize[i] && offset == layout.offset[i])
+			continue;
+
+		blog(LOG_WARNING, "MemoryManager: plane %u of %s at %ux%u is %u bytes wide at %llu, expected %u at %llu", i, get_video_format_name(format), width,
+		     height, frame.linesize[i], (unsigned long long)offset, layout.linesize[i], (unsigned long long)layout.offset[i]);
+		const uint32_t last = layout.planes - 1;
+		const uint64_t last_offset = frame.data[last] ? frame.data[last] - frame.data[0] : 0;
+		size = std::max(size, last_offset + uint64_t(frame.linesize[last]) * layout.height[last]);
 		break;
 	}
+	video_frame_free(&frame);
 
-	const uint64_t width = calldata_int(&cd, "width");
-	const uint64_t height = calldata_int(&cd, "height");
+	checked.emplace(key, size);
+	return size;
+}
+
+uint64_t MemoryManager::calculateRawSize(obs_source_t *source)
+{
+	calldata_t cd = {0};
+	proc_handler_t *ph = obs_source_get_proc_handler(source);
+	proc_handler_call(ph, "get_file_info", &cd);
+
+	const auto pix_fmt = (enum video_format)calldata_int(&cd, "pix_format");
+	const uint32_t width = calldata_int(&cd, "width");
+	const uint32_t height = calldata_int(&cd, "height");
 	const uint64_t nb_frames = calldata_int(&cd, "num_frames");
-	si.size = width * height * bpp * nb_frames;
+	calldata_free(&cd);
+
+	if (!width || !height)
+		return 0;
+	return frameSize(pix_fmt, width, height) * nb_frames;
 }
 
-// Not thread safe. 'si.mtx' AND 'mtx' should be locked
+// Not thread safe. 'mtx' should be locked
 bool MemoryManager::shouldCacheSource(source_info &si)
 {
 	obs_data_t *settings = obs_source_get_settings(si.source);
 
 	const bool looping = obs_data_get_bool(settings, "looping");
 	const bool local_file = obs_data_get_bool(settings, "is_local_file");
-	const bool enable_caching = OBS_API::getMediaFileCaching();
-	bool showing = obs_source_showing(si.source);
+	const bool enable_caching = media_file_caching;
+	bool showing = si.showing;
 
-	const bool is_small = obs_data_get_bool(settings, "caching") ? current_cached_size < allowed_cached_size
-								     : current_cached_size + si.size < allowed_cached_size;
+	// Sources that do not fit yet may still evict others, see addCachedMemory
+	const bool is_small = !si.cached || current_cached_size <= allowed_cached_size;
 
 	if (!showing && !obs_data_get_bool(settings, "close_when_inactive"))
 		showing = true;
@@ -137,44 +159,137 @@ void updateSource(obs_source_t *source, bool caching)
 	obs_data_release(settings);
 }
 
-// Not thread safe. 'mtx' and 'si.mtx' should be locked
-void MemoryManager::addCachedMemory(source_info &si)
+// Not thread safe. 'mtx' should be locked
+//
+// Frees room for 'si' from cached sources that are not showing and were last
+// shown before it. The oldest and largest go first: the age since a source was
+// last shown is weighted by its decoded size. Evicts nothing unless enough
+// room can be freed.
+bool MemoryManager::evictFor(source_info &si)
+{
+	const auto now = std::chrono::steady_clock::now();
+	std::vector<std::pair<double, source_info *>> candidates;
+	for (const auto &data : sources) {
+		source_info &other = *data.second;
+		if (&other == &si || !other.cached || other.showing || other.last_shown >= si.last_shown)
+			continue;
+
+		const double age = std::chrono::duration<double>(now - other.last_shown).count();
+		candidates.emplace_back(age * other.size, &other);
+	}
+	std::sort(candidates.begin(), candidates.end(), [](const auto &a, const auto &b) { return a.first > b.first; });
+
+	const uint64_t needed = current_cached_size + si.size - allowed_cached_size;
+	uint64_t freed = 0;
+	size_t count = 0;
+	while (count < candidates.size() && freed < needed)
+		freed += candidates[count++].second->size;
+	if (freed < needed)
+		return false;
+
+	for (size_t i = 0; i < count; i++) {
+		source_info &victim = *candidates[i].second;
+		const std::string name = obs_source_get_name(victim.source);
+		blog(LOG_INFO, "evicting %lluMB, source: %s, for source: %s", (unsigned long long)(victim.size / 1000000), name.c_str(),
+		     obs_source_get_name(si.source));
+		removeCachedMemory(victim, false, name);
+	}
+	return true;
+}
+
+// Not thread safe. 'mtx' should be locked
+void MemoryManager::updateBudget()
 {
-	if (!si.size || si.cached || current_cached_size + si.size > allowed_cached_size)
+	const auto now = std::chrono::steady_clock::now();
+	if (now - last_probe < std::chrono::seconds(PROBE_INTERVAL) && last_probe.time_since_epoch().count())
 		return;
+	last_probe = now;
 
-	int32_t retry = MAX_POLLS;
+	const MemoryStatus status = MemoryProbe::Query();
+	const uint64_t previous = allowed_cached_size;
+	if (!status.total) {
+		available_memory = 0;
+		allowed_cached_size = LIMIT;
+	} else {
+		// Memory the cache holds is not available anymore but is its own. Once
+		// less than the reserve is available, the cache gives back the rest.
+		const int64_t reserve = std::max<uint64_t>(RESERVE, status.total / 10);
+		const uint64_t room = std::max<int64_t>(0, (int64_t)current_cached_size + (int64_t)status.available - reserve);
+		available_memory = status.total;
+		allowed_cached_size = std::min({(uint64_t)LIMIT, status.total / 2, room});
+	}
 
-	proc_handler_t *ph = obs_source_get_proc_handler(si.source);
-	bool playing = false;
-	while (retry > 0) {
-		calldata_t cd = {0};
-		proc_handler_call(ph, "get_playing", &cd);
-		playing = calldata_bool(&cd, "playing");
-		if (playing)
-			break;
+	if (current_cached_size > allowed_cached_size) {
+		blog(LOG_INFO, "MemoryManager: %lluMB available, cache budget lowered to %lluMB", (unsigned long long)(status.available / 1000000),
+		     (unsigned long long)(allowed_cached_size / 1000000));
+		shrinkCache();
+	} else if (allowed_cached_size > previous) {
+		for (const auto &data : sources) {
+			source_info &si = *data.second;
+			if (!si.cached && si.size && current_cached_size + si.size <= allowed_cached_size)
+				queueSource(si);
+		}
+	}
+}
 
-		retry--;
-		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+// Not thread safe. 'mtx' should be locked
+//
+// Drops cached sources until the cache fits its budget, those not showing
+// first, then in the order evictFor uses.
+void MemoryManager::shrinkCache()
+{
+	const auto now = std::chrono::steady_clock::now();
+	std::vector<std::tuple<bool, double, source_info *>> candidates;
+	for (const auto &data : sources) {
+		source_info &si = *data.second;
+		if (si.cached)
+			candidates.emplace_back(si.showing, std::chrono::duration<double>(now - si.last_shown).count() * si.size, &si);
+	}
+	std::sort(candidates.begin(), candidates.end(), [](const auto &a, const auto &b) {
+		if (std::get<0>(a) != std::get<0>(b))
+			return !std::get<0>(a);
+		if (std::get<1>(a) != std::get<1>(b))
+			return std::get<1>(a) > std::get<1>(b);
+		return std::get<2>(a)->size > std::get<2>(b)->size;
+	});
+
+	for (const auto &candidate : candidates) {
+		if (current_cached_size <= allowed_cached_size)
+			break;
+		source_info &si = *std::get<2>(candidate);
+		removeCachedMemory(si, false, obs_source_get_name(si.source));
 	}
+}
+
+// Not thread safe. 'mtx' should be locked
+void MemoryManager::addCachedMemory(source_info &si)
+{
+	if (!si.size || si.cached)
+		return;
+
+	// Not playing yet, 'mediaStarted' queues the source again
+	calldata_t cd = {0};
+	proc_handler_call(obs_source_get_proc_handler(si.source), "get_playing", &cd);
+	if (!calldata_bool(&cd, "playing"))
+		return;
 
-	if (!playing)
+	if (current_cached_size + si.size > allowed_cached_size && !evictFor(si))
 		return;
 
-	blog(LOG_INFO, "adding %dMB, source: %s", si.size / 1000000, obs_source_get_name(si.source));
+	blog(LOG_INFO, "adding %lluMB, source: %s", (unsigned long long)(si.size / 1000000), obs_source_get_name(si.source));
 	current_cached_size += si.size;
 	si.cached = true;
 
 	updateSource(si.source, true);
 }
 
-// Not thread safe. 'mtx' and 'si.mtx' should be locked
+// Not thread safe. 'mtx' should be locked
 void MemoryManager::removeCachedMemory(source_info &si, bool cacheNewFiles, const std::string &sourceName)
 {
 	if (!si.cached)
 		return;
 
-	blog(LOG_INFO, "removing %dMB, source: %s", si.size / 1000000, sourceName.c_str());
+	blog(LOG_INFO, "removing %lluMB, source: %s", (unsigned long long)(si.size / 1000000), sourceName.c_str());
 	current_cached_size -= si.size;
 	si.cached = false;
 
@@ -184,67 +299,40 @@ void MemoryManager::removeCachedMemory(source_info &si, bool cacheNewFiles, cons
 		return;
 
 	for (const auto &data : sources) {
-		if (data.second.get() == &si) {
-			// Do not check self
-			continue;
-		}
-
-		std::unique_lock ulock(data.second->mtx);
-		if (shouldCacheSource(*data.second))
-			addCachedMemory(*data.second);
+		if (data.second.get() != &si && !data.second->cached)
+			queueSource(*data.second);
 	}
 }
 
-void MemoryManager::sourceManager(const std::string &sourceName)
+// Runs on a worker, at most one at a time per source
+void MemoryManager::sourceManager(source_info &si)
 {
-	auto it = sources.find(sourceName);
-	if (it == sources.end()) {
+	obs_data_t *settings = obs_source_get_settings(si.source);
+	const bool looping = obs_data_get_bool(settings, "looping");
+	const bool local_file = obs_data_get_bool(settings, "is_local_file");
+	obs_data_release(settings);
+
+	if (!looping || !local_file) {
 		return;
 	}
-	source_info &si = *it->second;
 
-	bool need_get_size = false;
+	// Zero until the file is open, 'mediaStarted' queues the source again
+	uint64_t size;
 	{
-		std::unique_lock si_mtx_lock(si.mtx);
-
-		obs_data_t *settings = obs_source_get_settings(si.source);
-		const bool looping = obs_data_get_bool(settings, "looping");
-		const bool local_file = obs_data_get_bool(settings, "is_local_file");
-		obs_data_release(settings);
-
-		if (!looping || !local_file) {
-			return;
-		}
-
-		need_get_size = si.size == 0;
+		std::unique_lock ulock(mtx);
+		size = si.size;
 	}
+	if (!size)
+		size = calculateRawSize(si.source);
 
-	if (need_get_size) {
-		uint32_t retry = MAX_POLLS;
-		while (retry > 0) {
-			si.mtx.lock();
-
-			auto check_source = sources.find(sourceName);
-			if (check_source == sources.end()) {
-				si.mtx.unlock();
-				break;
-			}
-			calculateRawSize(si); // This also sets 'si.have_video'
-
-			if (si.size || !si.have_video) {
-				si.mtx.unlock();
-				break;
-			}
-			si.mtx.unlock();
-
-			retry--;
-			std::this_thread::sleep_for(std::chrono::milliseconds(500));
-		}
-	}
+	std::unique_lock ulock(mtx);
+	si.size = size;
+	updateBudget();
 
-	std::unique_lock mtx_lock(mtx, std::defer_lock);
-	std::unique_lock si_mtx_lock(si.mtx, std::defer_lock);
-	std::lock(mtx_lock, si_mtx_lock);
+	const bool showing = obs_source_showing(si.source);
+	if (showing || si.showing)
+		si.last_shown = std::chrono::steady_clock::now();
+	si.showing = showing;
 
 	if (!si.size) {
 		return;
@@ -254,26 +342,70 @@ void MemoryManager::sourceManager(const std::string &sourceName)
 	if (should_cache)
 		addCachedMemory(si);
 	else
-		removeCachedMemory(si, true, sourceName);
+		removeCachedMemory(si, true, obs_source_get_name(si.source));
 }
 
-// Not thread safe, should be called with locked 'mtx'
-void MemoryManager::updateSettings(obs_source_t *source)
+void MemoryManager::worker()
 {
-	std::string sourceName = obs_source_get_name(source);
-	auto it = sources.find(sourceName);
-	if (it == sources.end())
+	std::unique_lock ulock(queue_mtx);
+	while (true) {
+		if (!queue_cv.wait_for(ulock, std::chrono::seconds(PROBE_INTERVAL), [this]() { return stopping || !queue.empty(); })) {
+			ulock.unlock();
+			{
+				std::unique_lock mtx_lock(mtx);
+				updateBudget();
+			}
+			ulock.lock();
+			continue;
+		}
+		if (stopping)
+			return;
+
+		source_info &si = *queue.front();
+		queue.pop_front();
+		si.queued = false;
+		si.running = true;
+
+		ulock.unlock();
+		sourceManager(si);
+		ulock.lock();
+
+		// Changed again while this ran
+		si.running = false;
+		if (si.queued && !si.removed) {
+			queue.push_back(&si);
+			queue_cv.notify_one();
+		}
+		idle_cv.notify_all();
+	}
+}
+
+// Safe to call with or without 'mtx' locked
+void MemoryManager::queueSource(source_info &si)
+{
+	std::unique_lock ulock(queue_mtx);
+	if (si.queued || si.removed)
 		return;
 
-	std::unique_lock ulock(it->second->mtx);
-	it->second->workers.push_back(std::thread(&MemoryManager::sourceManager, this, sourceName));
+	si.queued = true;
+	if (!si.running) {
+		queue.push_back(&si);
+		queue_cv.notify_one();
+	}
+}
+
+void MemoryManager::mediaStarted(void *data, calldata_t *cd)
+{
+	GetInstance().queueSource(*static_cast<source_info *>(data));
 }
 
 void MemoryManager::updateSourceCache(obs_source_t *source)
 {
 	std::unique_lock ulock(mtx);
 
-	updateSettings(source);
+	auto it = sources.find(obs_source_get_name(source));
+	if (it != sources.end())
+		queueSource(*it->second);
 }
 
 void MemoryManager::updateSourcesCache()
@@ -281,7 +413,16 @@ void MemoryManager::updateSourcesCache()
 	std::unique_lock ulock(mtx);
 
 	for (const auto &data : sources)
-		updateSettings(data.second->source);
+		queueSource(*data.second);
+}
+
+void MemoryManager::setMediaFileCaching(bool enabled)
+{
+	std::unique_lock ulock(mtx);
+	media_file_caching = enabled;
+
+	for (const auto &data : sources)
+		queueSource(*data.second);
 }
 
 bool MemoryManager::isSourceValid(obs_source_t *source) const
@@ -310,19 +451,14 @@ void MemoryManager::registerSource(obs_source_t *source)
 	source_info *si = new source_info;
 	si->source = source;
 	sources.emplace(obs_source_get_name(source), si);
+	signal_handler_connect(obs_source_get_signal_handler(source), "media_started", mediaStarted, si);
 	updateSource(source, false);
 }
 
-void MemoryManager::unregisterSource(obs_source_t *source)
+void MemoryManager::removeSource(const std::string &sourceName, bool cacheNewFiles)
 {
-	if (!isSourceValid(source)) {
-		return;
-	}
-
-	const std::string source_name = obs_source_get_name(source);
-
 	mtx.lock();
-	auto it = sources.find(source_name);
+	auto it = sources.find(sourceName);
 	if (it == sources.end()) {
 		mtx.unlock();
 		return;
@@ -331,51 +467,48 @@ void MemoryManager::unregisterSource(obs_source_t *source)
 	// Moving pointer to have a valid object when proceeding with further deinit.
 	auto moved_ptr = std::move(it->second);
 	// Removing object from the collection early to be sure that it is unavailable anymore for outer clients
-	// and someone can not spawn a new worker while we are waiting for worker threads to join.
+	// and nobody can queue it again while we are waiting for its worker.
 	// Also this prevents data race if someone called 'unregisterSource' from other thread
 	// while removal is in progress.
-	sources.erase(source_name);
+	sources.erase(sourceName);
 	mtx.unlock();
 
-	for (auto &worker : moved_ptr->workers) {
-		if (worker.joinable())
-			worker.join();
+	// Once disconnected no media thread is still in 'mediaStarted'
+	signal_handler_disconnect(obs_source_get_signal_handler(moved_ptr->source), "media_started", mediaStarted, moved_ptr.get());
+
+	{
+		std::unique_lock ulock(queue_mtx);
+		moved_ptr->removed = true;
+		if (moved_ptr->queued)
+			queue.erase(std::remove(queue.begin(), queue.end(), moved_ptr.get()), queue.end());
+		idle_cv.wait(ulock, [&]() { return !moved_ptr->running; });
 	}
 
-	std::lock(mtx, moved_ptr->mtx);
-	removeCachedMemory(*moved_ptr, true, source_name);
-	moved_ptr->mtx.unlock();
-	mtx.unlock();
+	std::unique_lock ulock(mtx);
+	removeCachedMemory(*moved_ptr, cacheNewFiles, sourceName);
 }
 
-void MemoryManager::shutdownAllSources()
+void MemoryManager::unregisterSource(obs_source_t *source)
 {
-	mtx.lock();
+	if (!isSourceValid(source)) {
+		return;
+	}
+
+	removeSource(obs_source_get_name(source), true);
+}
 
+void MemoryManager::shutdownAllSources()
+{
 	std::vector<std::string> sourceKeys;
-	for (const auto &pair : sources) {
-		sourceKeys.push_back(pair.first);
+	{
+		std::unique_lock ulock(mtx);
+		for (const auto &pair : sources) {
+			sourceKeys.push_back(pair.first);
+		}
 	}
 
 	for (auto &source_key : sourceKeys) {
 		blog(LOG_INFO, "MemoryManager: shutdownAllSources: source %s", source_key.c_str());
-		auto it = sources.find(source_key);
-		if (it == sources.end()) {
-			continue;
-		}
-
-		auto moved_ptr = std::move(it->second);
-		sources.erase(source_key);
-
-		for (auto &worker : moved_ptr->workers) {
-			if (worker.joinable())
-				worker.join();
-		}
-
-		moved_ptr->mtx.lock();
-		removeCachedMemory(*moved_ptr, false, source_key);
-		moved_ptr->mtx.unlock();
+		removeSource(source_key, false);
 	}
-
-	mtx.unlock();
 }
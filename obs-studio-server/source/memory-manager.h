@@ -19,11 +19,16 @@
 #pragma once
 #include "obs.h"
 #include "nodeobs_configManager.hpp"
+#include "memory-probe.h"
 #include <map>
 #include <mutex>
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <vector>
 #include <thread>
+#include <tuple>
 #include <shared.hpp>
 
 #ifdef WIN32
@@ -32,9 +37,23 @@
 #endif
 
 #define LIMIT 2004800000ul
-#define MAX_POLLS 10
+#define RESERVE 536870912ul
+#define WORKERS 2
+#define PROBE_INTERVAL 5
 
 // Implements 'Singleton' design pattern
+//
+// Decides which looping media sources keep their decoded frames in memory.
+// Sources are re-evaluated on a small pool of workers, each source is queued
+// at most once however often it changes. A source whose file is not open or
+// not playing yet is evaluated again when it starts playing. When the cache
+// is full, cached sources that are not showing are evicted for one that is,
+// see evictFor.
+//
+// The cache may take half of the physical memory up to LIMIT, but never more
+// than what it holds plus what is still available less a reserve. Memory is
+// probed every PROBE_INTERVAL seconds, when other processes take what is
+// left the cache shrinks before the machine starts swapping.
 class MemoryManager {
 public:
 	static MemoryManager &GetInstance();
@@ -45,6 +64,8 @@ public:
 	void shutdownAllSources();
 	void updateSourceCache(obs_source_t *source);
 	void updateSourcesCache();
+	// The media file caching setting, sources are evaluated again
+	void setMediaFileCaching(bool enabled);
 
 private:
 	// Types
@@ -61,13 +82,19 @@ private:
 
 	// Methods
 	bool isSourceValid(obs_source_t *source) const;
-	void updateSettings(obs_source_t *source);
+	void queueSource(source_info &si);
+	static void mediaStarted(void *data, calldata_t *cd);
+	void worker();
 
-	void calculateRawSize(source_info &si);
+	uint64_t calculateRawSize(obs_source_t *source);
 	bool shouldCacheSource(source_info &si);
+	bool evictFor(source_info &si);
+	void updateBudget();
+	void shrinkCache();
 	void addCachedMemory(source_info &si);
 	void removeCachedMemory(source_info &si, bool cacheNewFiles, const std::string &sourceName);
-	void sourceManager(const std::string &sourceName);
+	void removeSource(const std::string &sourceName, bool cacheNewFiles);
+	void sourceManager(source_info &si);
 
 	// Data
 	std::mutex mtx;
@@ -75,4 +102,16 @@ private:
 	uint64_t available_memory;
 	uint64_t current_cached_size;
 	uint64_t allowed_cached_size;
+	bool media_file_caching = true;
+	std::chrono::steady_clock::time_point last_probe;
+
+	// Sources waiting for a worker. Never wait for 'mtx' while holding
+	// 'queue_mtx', media threads queue sources while 'mtx' may be held by a
+	// worker stopping their media.
+	std::mutex queue_mtx;
+	std::condition_variable queue_cv;
+	std::condition_variable idle_cv;
+	std::deque<source_info *> queue;
+	std::vector<std::thread> workers;
+	bool stopping = false;
 };
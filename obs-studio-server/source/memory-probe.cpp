@@ -0,0 +1,161 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#include "memory-probe.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#ifdef WIN32
+#include <windows.h>
+#elif __APPLE__
+#include "shared.hpp"
+#endif
+
+static bool ReadFile(const std::string &path, std::string &text)
+{
+	std::ifstream file(path);
+	if (!file.is_open())
+		return false;
+
+	std::stringstream stream;
+	stream << file.rdbuf();
+	text = stream.str();
+	return true;
+}
+
+static bool ParseBytes(const std::string &text, uint64_t &value)
+{
+	size_t end = 0;
+	try {
+		value = std::stoull(text, &end);
+	} catch (...) {
+		return false;
+	}
+	return end > 0;
+}
+
+MemoryStatus MemoryProbe::Query()
+{
+	MemoryStatus status;
+#ifdef WIN32
+	MEMORYSTATUSEX statex;
+	statex.dwLength = sizeof(statex);
+	if (::GlobalMemoryStatusEx(&statex)) {
+		status.total = statex.ullTotalPhys;
+		status.available = statex.ullAvailPhys;
+	}
+#elif __APPLE__
+	status.total = g_util_osx->getTotalPhysicalMemory();
+	status.available = std::min<uint64_t>(status.total, g_util_osx->getAvailableMemory());
+#else
+	status = QueryLinux("");
+#endif
+	return status;
+}
+
+MemoryStatus MemoryProbe::QueryLinux(const std::string &root)
+{
+	MemoryStatus status;
+	std::string text;
+	if (!ReadFile(root + "/proc/meminfo", text) || !ParseMeminfo(text, status))
+		return MemoryStatus();
+
+	// Unified hierarchy entry, "0::/path/of/the/cgroup"
+	std::string cgroup;
+	if (!ReadFile(root + "/proc/self/cgroup", text))
+		return status;
+	std::istringstream lines(text);
+	for (std::string line; std::getline(lines, line);) {
+		if (line.compare(0, 3, "0::") == 0)
+			cgroup = line.substr(3);
+	}
+	if (cgroup.empty() || cgroup[0] != '/')
+		return status;
+
+	while (true) {
+		std::string max, current, stat;
+		const std::string dir = root + "/sys/fs/cgroup" + (cgroup == "/" ? "" : cgroup);
+		if (ReadFile(dir + "/memory.max", max) && ReadFile(dir + "/memory.current", current)) {
+			ReadFile(dir + "/memory.stat", stat);
+			ApplyCgroup(max, current, stat, status);
+		}
+
+		if (cgroup == "/")
+			break;
+		size_t separator = cgroup.find_last_of('/');
+		cgroup = separator == 0 ? "/" : cgroup.substr(0, separator);
+	}
+	return status;
+}
+
+bool MemoryProbe::ParseMeminfo(const std::string &text, MemoryStatus &status)
+{
+	uint64_t total = 0, available = 0, free = 0, buffers = 0, cached = 0;
+	bool has_available = false;
+
+	std::istringstream lines(text);
+	for (std::string line; std::getline(lines, line);) {
+		std::istringstream fields(line);
+		std::string key;
+		uint64_t kilobytes = 0;
+		if (!(fields >> key >> kilobytes))
+			continue;
+
+		if (key == "MemTotal:") {
+			total = kilobytes * 1024;
+		} else if (key == "MemAvailable:") {
+			available = kilobytes * 1024;
+			has_available = true;
+		} else if (key == "MemFree:") {
+			free = kilobytes * 1024;
+		} else if (key == "Buffers:") {
+			buffers = kilobytes * 1024;
+		} else if (key == "Cached:") {
+			cached = kilobytes * 1024;
+		}
+	}
+
+	if (!total)
+		return false;
+
+	status.total = total;
+	status.available = std::min(total, has_available ? available : free + buffers + cached);
+	return true;
+}
+
+void MemoryProbe::ApplyCgroup(const std::string &max, const std::string &current, const std::string &stat, MemoryStatus &status)
+{
+	uint64_t limit, used;
+	if (!ParseBytes(max, limit) || !ParseBytes(current, used))
+		return;
+
+	// Page cache the kernel drops before it hits the limit, reading media
+	// files alone would otherwise fill the cgroup
+	std::istringstream lines(stat);
+	for (std::string line; std::getline(lines, line);) {
+		std::istringstream fields(line);
+		std::string key;
+		uint64_t bytes = 0;
+		if (fields >> key >> bytes && key == "inactive_file")
+			used -= std::min(used, bytes);
+	}
+
+	status.total = std::min(status.total, limit);
+	status.available = std::min(status.available, limit > used ? limit - used : 0);
+}
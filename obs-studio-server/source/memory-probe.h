@@ -0,0 +1,50 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#pragma once
+#include <cstdint>
+#include <string>
+
+// Physical memory of the machine and how much of it is still available, in
+// bytes. Total is 0 when it could not be read.
+struct MemoryStatus {
+	uint64_t total = 0;
+	uint64_t available = 0;
+};
+
+class MemoryProbe {
+public:
+	// On macOS available is free, inactive and purgeable memory, which leaves
+	// out what the system could compress or swap, and is never above total.
+	static MemoryStatus Query();
+
+	// Reads /proc/meminfo, then lowers both values to the cgroup v2 limits
+	// of the process and of every cgroup above it, containers are limited by
+	// those long before the machine runs out. root is prepended to the /proc
+	// and /sys paths.
+	static MemoryStatus QueryLinux(const std::string &root);
+
+	// MemTotal and MemAvailable, or MemFree plus the page cache on kernels
+	// without MemAvailable.
+	static bool ParseMeminfo(const std::string &text, MemoryStatus &status);
+
+	// Contents of memory.max, memory.current and memory.stat, max may be
+	// "max". Usage is the working set, memory.current less the inactive_file
+	// page cache of memory.stat, as kubelet and docker count it.
+	static void ApplyCgroup(const std::string &max, const std::string &current, const std::string &stat, MemoryStatus &status);
+};
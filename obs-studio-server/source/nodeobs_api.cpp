@@ -29,6 +29,9 @@
 #include "util/lexer.h"
 #include "util-crashmanager.h"
 #include "util-metricsprovider.h"
+#include "util-modulemanifest.h"
+#include "util-logsink.h"
+#include "util-startuptimeline.h"
 
 #include "osn-streaming.hpp"
 #include "osn-recording.hpp"
@@ -40,6 +43,7 @@
 #include "osn-network.hpp"
 #include "osn-audio-track.hpp"
 #include "memory-manager.h"
+#include "callback-manager.h"
 
 #include <sys/types.h>
 
@@ -91,6 +95,7 @@
 #include "shared.hpp"
 
 #include <fstream>
+#include <future>
 
 #define BUFFSIZE 512
 #define CONNECTING_STATE 0
@@ -104,8 +109,15 @@ enum crashHandlerCommand { REGISTER = 0, UNREGISTER = 1, REGISTERMEMORYDUMP = 2,
 struct NodeOBSLogParam final {
 	std::fstream logStream;
 	bool enableDebugLogs = true;
+	// Lines are formatted on the calling thread and written by the sink.
+	std::unique_ptr<util::LogSink> sink;
 };
 
+// Records the log writer can fall behind by before debug messages get dropped.
+static const size_t log_sink_capacity = 8192;
+static const std::chrono::milliseconds log_flush_interval(100);
+static NodeOBSLogParam *g_logParam = nullptr;
+
 std::string g_moduleDirectory = "";
 os_cpu_usage_info_t *cpuUsageInfo = nullptr;
 #ifdef WIN32
@@ -133,6 +145,11 @@ static bool lowLatencyAudioBuffering = false;
 static bool forceGPURendering = true;
 static std::string processPriority = "Normal";
 
+// Creation of the legacy outputs when OBS_API_initAPI deferred it
+static std::mutex deferredOutputsMtx;
+static std::shared_future<void> deferredOutputs;
+static std::atomic<bool> deferredOutputsPending = false;
+
 void OBS_API::Register(ipc::server &srv)
 {
 	std::shared_ptr<ipc::collection> cls = std::make_shared<ipc::collection>("API");
@@ -361,6 +378,7 @@ outdated_driver_error *outdated_driver_error::instance()
 
 void outdated_driver_error::set_active(bool state)
 {
+	std::lock_guard<std::mutex> lock(mtx);
 	if (state) {
 		if (!lookup_enabled) {
 			line_1 = "";
@@ -374,6 +392,7 @@ void outdated_driver_error::set_active(bool state)
 
 std::string outdated_driver_error::get_error()
 {
+	std::lock_guard<std::mutex> lock(mtx);
 	if (line_1.size() && line_2.size())
 		return line_1 + std::string("\n") + line_2;
 	else
@@ -382,6 +401,11 @@ std::string outdated_driver_error::get_error()
 
 void outdated_driver_error::catch_error(const char *msg)
 {
+	// Called for every log message from any thread, only lock while an output starts.
+	if (!lookup_enabled.load(std::memory_order_relaxed))
+		return;
+
+	std::lock_guard<std::mutex> lock(mtx);
 	if (!lookup_enabled)
 		return;
 
@@ -425,6 +449,51 @@ static std::vector<char> nodeobs_log_formatted_message(const char *format, va_li
 	return buf;
 }
 
+// Runs on the log sink thread.
+static void node_obs_log_write(NodeOBSLogParam *logParam, int log_level, const std::string &newmsg)
+{
+	// File Log
+	if (log_level != LOG_DEBUG || logParam->enableDebugLogs) {
+		logParam->logStream << newmsg;
+	}
+
+	// Internal Log
+	{
+		std::lock_guard<std::mutex> lock(logMutex);
+		logReport.push(newmsg, log_level);
+	}
+
+	// Std Out / Std Err
+	/// Why fwrite and not std::cout and std::cerr?
+	/// Well, it seems that std::cout and std::cerr break if you click in the console window and paste.
+	/// Which is really bad, as nothing gets logged into the console anymore.
+	if (log_level <= LOG_WARNING) {
+		fwrite(newmsg.data(), sizeof(char), newmsg.length(), stderr);
+	}
+	fwrite(newmsg.data(), sizeof(char), newmsg.length(), stdout);
+
+	// Debugger
+#ifdef _WIN32
+	if (IsDebuggerPresent()) {
+		int wNum = MultiByteToWideChar(CP_UTF8, 0, newmsg.c_str(), -1, NULL, 0);
+		if (wNum > 1) {
+			std::wstring wide_buf;
+			wide_buf.reserve(wNum + 1);
+			wide_buf.resize(wNum - 1);
+			MultiByteToWideChar(CP_UTF8, 0, newmsg.c_str(), -1, &wide_buf[0], wNum);
+
+			OutputDebugStringW(wide_buf.c_str());
+		}
+	}
+#endif
+}
+
+static void node_obs_log_flush(NodeOBSLogParam *logParam)
+{
+	logParam->logStream << std::flush;
+	fflush(stdout);
+}
+
 std::chrono::high_resolution_clock hrc;
 std::chrono::high_resolution_clock::time_point tp = std::chrono::high_resolution_clock::now();
 static void node_obs_log(int log_level, const char *msg, va_list args, void *param)
@@ -508,8 +577,6 @@ static void node_obs_log(int log_level, const char *msg, va_list args, void *par
 	std::vector<char> buf = nodeobs_log_formatted_message(msg, args);
 	std::string_view text = (buf.size()) ? std::string_view(buf.data(), buf.size()) : std::string_view("");
 
-	std::lock_guard<std::mutex> lock(logMutex);
-
 	outdated_driver_error::instance()->catch_error(msg);
 	NodeOBSLogParam *logParam = reinterpret_cast<NodeOBSLogParam *>(param);
 
@@ -528,45 +595,9 @@ static void node_obs_log(int log_level, const char *msg, va_list args, void *par
 
 			last_valid_idx = idx + 1;
 
-			// File Log
-			if (log_level != LOG_DEBUG || logParam->enableDebugLogs) {
-				logParam->logStream << newmsg << std::flush;
-			}
-
-			// Internal Log
-			logReport.push(newmsg, log_level);
-
-			// Std Out / Std Err
-			/// Why fwrite and not std::cout and std::cerr?
-			/// Well, it seems that std::cout and std::cerr break if you click in the console window and paste.
-			/// Which is really bad, as nothing gets logged into the console anymore.
-			if (log_level <= LOG_WARNING) {
-				fwrite(newmsg.data(), sizeof(char), newmsg.length(), stderr);
-			}
-			fwrite(newmsg.data(), sizeof(char), newmsg.length(), stdout);
-
-			// Debugger
-#ifdef _WIN32
-			if (IsDebuggerPresent()) {
-				int wNum = MultiByteToWideChar(CP_UTF8, 0, newmsg.c_str(), -1, NULL, 0);
-				if (wNum > 1) {
-					std::wstring wide_buf;
-					std::mutex wide_mutex;
-
-					std::lock_guard<std::mutex> lock(wide_mutex);
-					wide_buf.reserve(wNum + 1);
-					wide_buf.resize(wNum - 1);
-					MultiByteToWideChar(CP_UTF8, 0, newmsg.c_str(), -1, &wide_buf[0], wNum);
-
-					OutputDebugStringW(wide_buf.c_str());
-				}
-			}
-#endif
+			logParam->sink->push(log_level, std::move(newmsg));
 		}
 	}
-	if (log_level != LOG_DEBUG || logParam->enableDebugLogs) {
-		logParam->logStream << std::flush;
-	}
 
 #if defined(_WIN32) && defined(OBS_DEBUGBREAK_ON_ERROR)
 	if (log_level <= LOG_ERROR && IsDebuggerPresent())
@@ -793,8 +824,71 @@ void addModulePaths()
 #endif
 }
 
+// Services, outputs and video encoders of the legacy output API, they only
+// need the modules to be loaded.
+static std::chrono::steady_clock::time_point CreateOutputs(std::chrono::steady_clock::time_point phase, bool background)
+{
+	OBS_service::createService(StreamServiceId::Main);
+	OBS_service::createService(StreamServiceId::Second);
+	phase = util::StartupTimeline::Mark("Services", phase, background);
+
+	OBS_service::createStreamingOutput(StreamServiceId::Main);
+	OBS_service::createStreamingOutput(StreamServiceId::Second);
+	OBS_service::createRecordingOutput();
+	OBS_service::createReplayBufferOutput();
+	phase = util::StartupTimeline::Mark("Outputs", phase, background);
+
+	OBS_service::createVideoStreamingEncoder(StreamServiceId::Main);
+	OBS_service::createVideoStreamingEncoder(StreamServiceId::Second);
+	OBS_service::createVideoRecordingEncoder();
+	return util::StartupTimeline::Mark("Video encoders", phase, background);
+}
+
+static void CreateDeferredOutputs()
+{
+	auto phase = CreateOutputs(std::chrono::steady_clock::now(), true);
+	try {
+		OBS_service::setupAudioEncoder();
+	} catch (const char *error) {
+		blog(LOG_ERROR, "%s", error);
+	}
+	util::StartupTimeline::Mark("Audio encoders", phase, true);
+	util::StartupTimeline::Log();
+}
+
+// The calls that read or change the legacy outputs and encoders
+static bool UsesOutputs(const std::string &cname, const std::string &fname)
+{
+	if (cname == "API")
+		return fname == "OBS_API_getPerformanceStatistics" || fname == "OBS_API_destroyOBS_API";
+	return cname == "NodeOBS_Service" || cname == "Settings" || cname == "AutoConfig" || cname == "Video";
+}
+
+void OBS_API::waitForDeferredOutputs(const std::string &cname, const std::string &fname)
+{
+	if (!deferredOutputsPending.load(std::memory_order_acquire) || !UsesOutputs(cname, fname))
+		return;
+
+	std::shared_future<void> pending;
+	{
+		std::lock_guard<std::mutex> lock(deferredOutputsMtx);
+		pending = deferredOutputs;
+	}
+	if (!pending.valid())
+		return;
+
+	if (pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+		auto start = std::chrono::steady_clock::now();
+		pending.wait();
+		util::StartupTimeline::Mark("Waiting for outputs in " + cname + "." + fname, start);
+		util::StartupTimeline::Log();
+	}
+	deferredOutputsPending = false;
+}
+
 void OBS_API::OBS_API_initAPI(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
 {
+	auto initStart = std::chrono::steady_clock::now();
 	writeCrashHandler(registerProcess());
 
 	/* Map base DLLs as soon as possible into the current process space.
@@ -820,24 +914,21 @@ void OBS_API::OBS_API_initAPI(void *data, const int64_t id, const std::vector<ip
 			writeCrashHandler(registerMemoryDump());
 		}
 	}
+#endif
 
-#ifdef WIN32
-	// Register the pre and post server callbacks to log the data into the crashmanager
+	// Register the pre and post server callbacks to record every call for the
+	// crash reports and Diagnostics.GetIpcStats
 	g_server->set_pre_callback(
 		[](std::string cname, std::string fname, const std::vector<ipc::value> &args, void *data) {
-			util::CrashManager &crashManager = *static_cast<util::CrashManager *>(data);
-			crashManager.ProcessPreServerCall(cname, fname, args);
+			OBS_API::waitForDeferredOutputs(cname, fname);
+			util::CrashManager::ProcessPreServerCall(cname, fname, args);
 		},
-		&crashManager);
+		nullptr);
 	g_server->set_post_callback(
 		[](std::string cname, std::string fname, const std::vector<ipc::value> &args, void *data) {
-			util::CrashManager &crashManager = *static_cast<util::CrashManager *>(data);
-			crashManager.ProcessPostServerCall(cname, fname, args);
+			util::CrashManager::ProcessPostServerCall(cname, fname, args);
 		},
-		&crashManager);
-
-#endif
-#endif
+		nullptr);
 
 #ifdef WIN32
 	// Connect the metrics provider with our crash handler process, sending our current version tag
@@ -850,6 +941,8 @@ void OBS_API::OBS_API_initAPI(void *data, const int64_t id, const std::vector<ip
 		func();
 	}
 #endif
+	auto phase = util::StartupTimeline::Mark("Crash handler", initStart);
+
 	obs_add_data_path((g_moduleDirectory + "/data/libobs/").c_str());
 	slobs_plugin = appdata.substr(0, appdata.size() - strlen("/slobs-client"));
 	slobs_plugin.append("/slobs-plugins");
@@ -867,6 +960,7 @@ void OBS_API::OBS_API_initAPI(void *data, const int64_t id, const std::vector<ip
 		util::CrashManager::AddWarning("Failed to start OBS, locale: " + locale + " user data: " + userDataPath);
 #endif
 	}
+	phase = util::StartupTimeline::Mark("obs_startup", phase);
 
 	/* Logging */
 	std::string filename = GenerateTimeDateFilename("txt");
@@ -898,6 +992,14 @@ void OBS_API::OBS_API_initAPI(void *data, const int64_t id, const std::vector<ip
 		logParam.reset();
 		util::CrashManager::AddWarning("Error on log file, failed to open: " + log_path);
 		std::cerr << "Failed to open log file" << std::endl;
+	} else {
+		NodeOBSLogParam *param = logParam.get();
+		param->sink = std::make_unique<util::LogSink>(
+			log_sink_capacity, log_flush_interval, [param](int level, const std::string &line) { node_obs_log_write(param, level, line); },
+			[param]() { node_obs_log_flush(param); });
+		// Debug messages only go to the file when enabled, anywhere else they can be dropped under load.
+		param->sink->set_drop_debug(!param->enableDebugLogs);
+		g_logParam = param;
 	}
 	base_set_log_handler(node_obs_log, (logParam) ? logParam.release() : nullptr);
 #ifndef _DEBUG
@@ -908,8 +1010,10 @@ void OBS_API::OBS_API_initAPI(void *data, const int64_t id, const std::vector<ip
 #ifdef _WIN32
 	SetPrivilegeForGPUPriority();
 #endif
+	phase = util::StartupTimeline::Mark("Logging", phase);
 
 	osn::Source::initialize_global_signals();
+	CallbackManager::Initialize();
 
 	cpuUsageInfo = os_cpu_usage_info_start();
 	ConfigManager::getInstance().setAppdataPath(appdata);
@@ -921,33 +1025,49 @@ void OBS_API::OBS_API_initAPI(void *data, const int64_t id, const std::vector<ip
 	obs_data_set_bool(private_settings, "BrowserHWAccel", browserAccel);
 	obs_apply_private_data(private_settings);
 	obs_data_release(private_settings);
+	phase = util::StartupTimeline::Mark("Signals and settings", phase);
 
 	addModulePaths();
-	struct obs_module_failure_info mfi;
-	obs_load_all_modules2(&mfi);
-
-	if (mfi.count) {
-		char **plugin = mfi.failed_modules;
-		while (*plugin) {
-			blog(LOG_ERROR, "Failed to load plugin: %s", *plugin);
-			plugin++;
+	if (config_get_bool(ConfigManager::getInstance().getGlobal(), "General", "LazyModuleLoading")) {
+		// Modules only registering sources are opened when a source of theirs is created
+		std::vector<std::string> failed;
+		util::ModuleManifest::LoadModules(ConfigManager::getInstance().getModuleManifest(), failed);
+		for (const auto &plugin : failed)
+			blog(LOG_ERROR, "Failed to load plugin: %s", plugin.c_str());
+	} else {
+		struct obs_module_failure_info mfi;
+		obs_load_all_modules2(&mfi);
+
+		if (mfi.count) {
+			char **plugin = mfi.failed_modules;
+			while (*plugin) {
+				blog(LOG_ERROR, "Failed to load plugin: %s", *plugin);
+				plugin++;
+			}
 		}
 	}
 
-	OBS_service::createService(StreamServiceId::Main);
-	OBS_service::createService(StreamServiceId::Second);
-	OBS_service::createStreamingOutput(StreamServiceId::Main);
-	OBS_service::createStreamingOutput(StreamServiceId::Second);
-	OBS_service::createRecordingOutput();
-	OBS_service::createReplayBufferOutput();
+	phase = util::StartupTimeline::Mark("Load modules", phase);
 
-	OBS_service::createVideoStreamingEncoder(StreamServiceId::Main);
-	OBS_service::createVideoStreamingEncoder(StreamServiceId::Second);
-	OBS_service::createVideoRecordingEncoder();
+	// The legacy outputs are only needed once the frontend streams, records or
+	// looks at their settings. Deferred, they are created on a background task
+	// while the frontend loads its scenes, and the calls that need them wait.
+	if (config_get_bool(ConfigManager::getInstance().getGlobal(), "General", "DeferOutputCreation")) {
+		OBS_service::resetAudioContext();
+		phase = util::StartupTimeline::Mark("Audio context", phase);
+
+		std::lock_guard<std::mutex> lock(deferredOutputsMtx);
+		deferredOutputs = std::async(std::launch::async, CreateDeferredOutputs).share();
+		deferredOutputsPending = true;
+	} else {
+		phase = CreateOutputs(phase, false);
 
-	OBS_service::resetAudioContext();
+		OBS_service::resetAudioContext();
+		phase = util::StartupTimeline::Mark("Audio context", phase);
 
-	OBS_service::setupAudioEncoder();
+		OBS_service::setupAudioEncoder();
+		phase = util::StartupTimeline::Mark("Audio encoders", phase);
+	}
 
 	setAudioDeviceMonitoring();
 
@@ -967,6 +1087,10 @@ void OBS_API::OBS_API_initAPI(void *data, const int64_t id, const std::vector<ip
 
 	util::CrashManager::setAppState("idle");
 
+	util::StartupTimeline::Mark("Audio monitoring and hotkeys", phase);
+	util::StartupTimeline::Mark("OBS_API_initAPI", initStart);
+	util::StartupTimeline::Log();
+
 	// We are returning a video result here because the frontend needs to know if we sucessfully
 	// initialized the Dx11 API
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
@@ -1521,6 +1645,7 @@ void OBS_API::InformCrashHandler(const int crash_id)
 void OBS_API::destroyOBS_API(void)
 {
 	blog(LOG_DEBUG, "OBS_API::destroyOBS_API started, objects allocated %d", bnum_allocs());
+	waitForDeferredOutputs("API", "OBS_API_destroyOBS_API");
 	debug_enum_sources(" on destroyOBS_API");
 	os_cpu_usage_info_destroy(cpuUsageInfo);
 
@@ -1532,6 +1657,7 @@ void OBS_API::destroyOBS_API(void)
 			DisableAudioDucking(false);
 	}
 #endif
+	CallbackManager::Finalize();
 	OBS_content::OBS_content_shutdownDisplays();
 
 	autoConfig::WaitPendingTests();
@@ -2006,6 +2132,12 @@ double OBS_API::getMemoryUsage()
 	return (double)os_get_proc_resident_size() / (1024.0 * 1024.0);
 }
 
+void OBS_API::FlushLogs(void)
+{
+	if (g_logParam && g_logParam->sink)
+		g_logParam->sink->flush(std::chrono::milliseconds(1000));
+}
+
 const std::vector<std::string> &OBS_API::getOBSLogErrors()
 {
 	return logReport.errors;
@@ -2069,7 +2201,7 @@ void OBS_API::SetMediaFileCaching(void *data, const int64_t id, const std::vecto
 	mediaFileCaching = args[0].value_union.ui32;
 	config_set_bool(ConfigManager::getInstance().getGlobal(), "General", "fileCaching", mediaFileCaching);
 	config_save_safe(ConfigManager::getInstance().getGlobal(), "tmp", nullptr);
-	MemoryManager::GetInstance().updateSourcesCache();
+	MemoryManager::GetInstance().setMediaFileCaching(mediaFileCaching);
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
 	AUTO_DEBUG;
 }
@@ -2102,11 +2234,6 @@ bool OBS_API::getBrowserAcceleration()
 	return browserAccel;
 }
 
-bool OBS_API::getMediaFileCaching()
-{
-	return mediaFileCaching;
-}
-
 void OBS_API::GetBrowserAcceleration(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
 {
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
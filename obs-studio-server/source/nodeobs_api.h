@@ -20,9 +20,11 @@
 #ifdef WIN32
 #include <io.h>
 #endif
+#include <atomic>
 #include <iostream>
 #include <ipc-server.hpp>
 #include <math.h>
+#include <mutex>
 #include <obs.h>
 #include <stdio.h>
 #include <string.h>
@@ -114,10 +116,12 @@ public:
 	static void GetForceGPURenderingLegacy(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
 
 	static bool getBrowserAcceleration();
-	static bool getMediaFileCaching();
 
 public:
 	static void initAPI(void);
+	// Blocks a call that needs the legacy outputs until they exist, when
+	// OBS_API_initAPI deferred their creation to a background task.
+	static void waitForDeferredOutputs(const std::string &cname, const std::string &fname);
 	static bool openAllModules(int &video_err);
 
 	static double getCPU_Percentage(void);
@@ -158,6 +162,8 @@ public:
 	static void setAudioDeviceMonitoring(void);
 	static void SetProcessPriorityOld(const char *priority);
 	static void destroyOBS_API(void);
+	// Waits for the log writer to catch up, used before the process goes down.
+	static void FlushLogs(void);
 
 	static void SetCrashHandlerPipe(const std::wstring &);
 	static void CreateCrashHandlerExitPipe();
@@ -168,7 +174,8 @@ class outdated_driver_error {
 	static outdated_driver_error *inst;
 	std::string line_1 = "";
 	std::string line_2 = "";
-	int lookup_enabled = 0;
+	std::atomic<int> lookup_enabled{0};
+	std::mutex mtx;
 
 public:
 	static outdated_driver_error *instance();
@@ -339,3 +339,11 @@ std::string ConfigManager::getRecord()
 	return appdata + "/recordEncoder.json";
 #endif
 };
+std::string ConfigManager::getModuleManifest()
+{
+#ifdef WIN32
+	return appdata + "\\moduleManifest.json";
+#else
+	return appdata + "/moduleManifest.json";
+#endif
+};
@@ -53,5 +53,6 @@ public:
 	std::string getService(size_t index);
 	std::string getStream();
 	std::string getRecord();
+	std::string getModuleManifest();
 	void reloadConfig(void);
 };
\ No newline at end of file
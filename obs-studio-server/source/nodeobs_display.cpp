@@ -293,86 +293,7 @@ OBS::Display::Display()
 
 		GS::Vertex v(nullptr, nullptr, nullptr, nullptr, nullptr);
 
-		// Left solid outline
-		m_leftSolidOutline = std::make_unique<GS::VertexBuffer>(2);
-		m_leftSolidOutline->Resize(2);
-		v = m_leftSolidOutline->At(0);
-		vec3_set(v.position, 0.0f, 0.0f, 0);
-		vec4_set(v.uv[0], 0, 0, 0, 0);
-		*v.color = 0xFFFFFFFF;
-		v = m_leftSolidOutline->At(1);
-		vec3_set(v.position, 0.0f, 1.0f, 0);
-		vec4_set(v.uv[0], 0, 0, 0, 0);
-		*v.color = 0xFFFFFFFF;
-		m_leftSolidOutline->Update();
-
-		// Top solid outline
-		m_topSolidOutline = std::make_unique<GS::VertexBuffer>(2);
-		m_topSolidOutline->Resize(2);
-		v = m_topSolidOutline->At(0);
-		vec3_set(v.position, 0.0f, 0.0f, 0);
-		vec4_set(v.uv[0], 0, 0, 0, 0);
-		*v.color = 0xFFFFFFFF;
-		v = m_topSolidOutline->At(1);
-		vec3_set(v.position, 1.0f, 0.0f, 0);
-		vec4_set(v.uv[0], 0, 0, 0, 0);
-		*v.color = 0xFFFFFFFF;
-		m_topSolidOutline->Update();
-
-		// Right solid outline
-		m_rightSolidOutline = std::make_unique<GS::VertexBuffer>(2);
-		m_rightSolidOutline->Resize(2);
-		v = m_rightSolidOutline->At(0);
-		vec3_set(v.position, 1.0f, 0.0f, 0);
-		vec4_set(v.uv[0], 0, 0, 0, 0);
-		*v.color = 0xFFFFFFFF;
-		v = m_rightSolidOutline->At(1);
-		vec3_set(v.position, 1.0f, 1.0f, 0);
-		vec4_set(v.uv[0], 0, 0, 0, 0);
-		*v.color = 0xFFFFFFFF;
-		m_rightSolidOutline->Update();
-
-		// Bottom solid outline
-		m_bottomSolidOutline = std::make_unique<GS::VertexBuffer>(2);
-		m_bottomSolidOutline->Resize(2);
-		v = m_bottomSolidOutline->At(0);
-		vec3_set(v.position, 0.0f, 1.0f, 0);
-		vec4_set(v.uv[0], 0, 0, 0, 0);
-		*v.color = 0xFFFFFFFF;
-		v = m_bottomSolidOutline->At(1);
-		vec3_set(v.position, 1.0f, 1.0f, 0);
-		vec4_set(v.uv[0], 0, 0, 0, 0);
-		*v.color = 0xFFFFFFFF;
-		m_bottomSolidOutline->Update();
-
-		// Crop effect outline
-		m_cropOutline = std::make_unique<GS::VertexBuffer>(4);
-		m_cropOutline->Resize(4);
-
-		m_boxLine = std::make_unique<GS::VertexBuffer>(6);
-		m_boxLine->Resize(6);
-		v = m_boxLine->At(0);
-		vec3_set(v.position, 0, 0, 0);
-		vec4_set(v.uv[0], 0, 0, 0, 0);
-		*v.color = 0xFFFFFFFF;
-		v = m_boxLine->At(1);
-		vec3_set(v.position, 1, 0, 0);
-		vec4_set(v.uv[0], 1, 0, 0, 0);
-		*v.color = 0xFFFFFFFF;
-		v = m_boxLine->At(2);
-		vec3_set(v.position, 1, 1, 0);
-		vec4_set(v.uv[0], 1, 1, 0, 0);
-		*v.color = 0xFFFFFFFF;
-		v = m_boxLine->At(3);
-		vec3_set(v.position, 0, 1, 0);
-		vec4_set(v.uv[0], 0, 1, 0, 0);
-		*v.color = 0xFFFFFFFF;
-		v = m_boxLine->At(4);
-		vec3_set(v.position, 0, 0, 0);
-		vec4_set(v.uv[0], 0, 0, 0, 0);
-		*v.color = 0xFFFFFFFF;
-		m_boxLine->Update();
-
+		// Background
 		m_boxTris = std::make_unique<GS::VertexBuffer>(4);
 		m_boxTris->Resize(4);
 		v = m_boxTris->At(0);
@@ -393,54 +314,7 @@ OBS::Display::Display()
 		*v.color = 0xFFFFFFFF;
 		m_boxTris->Update();
 
-		// Rotation handle line
-		m_rotHandleLine = std::make_unique<GS::VertexBuffer>(5);
-		m_rotHandleLine->Resize(5);
-		v = m_rotHandleLine->At(0);
-		vec3_set(v.position, 0.5f - 0.34f / HANDLE_RADIUS, 0.5f, 0);
-		vec4_set(v.uv[0], 0, 0, 0, 0);
-		*v.color = 0xFFFFFFFF;
-		v = m_rotHandleLine->At(1);
-		vec3_set(v.position, 0.5f - 0.34f / HANDLE_RADIUS, -2.0f, 0);
-		vec4_set(v.uv[0], 0, 0, 0, 0);
-		*v.color = 0xFFFFFFFF;
-		v = m_rotHandleLine->At(2);
-		vec3_set(v.position, 0.5f + 0.34f / HANDLE_RADIUS, -2.0f, 0);
-		vec4_set(v.uv[0], 0, 0, 0, 0);
-		*v.color = 0xFFFFFFFF;
-		v = m_rotHandleLine->At(3);
-		vec3_set(v.position, 0.5f + 0.34f / HANDLE_RADIUS, 0.5f, 0);
-		vec4_set(v.uv[0], 0, 0, 0, 0);
-		*v.color = 0xFFFFFFFF;
-		v = m_rotHandleLine->At(4);
-		vec3_set(v.position, 0.5f - 0.34f / HANDLE_RADIUS, 0.5f, 0);
-		vec4_set(v.uv[0], 0, 0, 0, 0);
-		*v.color = 0xFFFFFFFF;
-		m_rotHandleLine->Update();
-
-		// Rotation handle circle
-		m_rotHandleCircle = std::make_unique<GS::VertexBuffer>(120);
-		m_rotHandleCircle->Resize(120);
-		float angle = 180;
-		for (int i = 0; i < 40; ++i) {
-			v = m_rotHandleCircle->At(i * 3);
-			vec3_set(v.position, sin(RAD(angle)) / 2 + 0.5f, cos(RAD(angle)) / 2 + 0.5f, 0);
-			vec4_set(v.uv[0], 0, 0, 0, 0);
-			*v.color = 0xFFFFFFFF;
-			angle += 8.75f;
-			v = m_rotHandleCircle->At((i * 3) + 1);
-			vec3_set(v.position, sin(RAD(angle)) / 2 + 0.5f, cos(RAD(angle)) / 2 + 0.5f, 0);
-			vec4_set(v.uv[0], 0, 0, 0, 0);
-			*v.color = 0xFFFFFFFF;
-			v = m_rotHandleCircle->At((i * 3) + 2);
-			vec3_set(v.position, 0.5f, 1.0f, 0);
-			vec4_set(v.uv[0], 0, 0, 0, 0);
-			*v.color = 0xFFFFFFFF;
-		}
-		m_rotHandleCircle->Update();
-
 		// Text
-		m_textVertices = new GS::VertexBuffer(65535);
 		m_textEffect = obs_get_base_effect(OBS_EFFECT_DEFAULT);
 		m_textTexture = gs_texture_create_from_file((g_moduleDirectory + "/resources/roboto.png").c_str());
 		if (!m_textTexture) {
@@ -530,16 +404,13 @@ OBS::Display::~Display()
 		std::lock_guard lock(m_displayMtx);
 
 		obs_display_remove_draw_callback(m_display, DisplayCallback, this);
+		WatchScene(nullptr);
 
 		if (m_source) {
 			obs_source_dec_showing(m_source);
 			obs_source_release(m_source);
 		}
 
-		if (m_textVertices) {
-			delete m_textVertices;
-		}
-
 		if (m_textTexture) {
 			obs_enter_graphics();
 			gs_texture_destroy(m_textTexture);
@@ -558,15 +429,10 @@ OBS::Display::~Display()
 			obs_leave_graphics();
 		}
 
-		m_leftSolidOutline.reset();
-		m_topSolidOutline.reset();
-		m_rightSolidOutline.reset();
-		m_bottomSolidOutline.reset();
-		m_cropOutline.reset();
-		m_boxLine = nullptr;
 		m_boxTris = nullptr;
-		m_rotHandleLine.reset();
-		m_rotHandleCircle.reset();
+		m_overlayTriangles.reset();
+		m_overlayLines.reset();
+		m_textVertices.reset();
 
 		if (m_display)
 			obs_display_destroy(m_display);
@@ -609,6 +475,7 @@ void OBS::Display::SetPosition(uint32_t x, uint32_t y)
 	SetWindowPos(m_ourWindow, insertAfter, m_position.first, m_position.second, m_gsInitData.cx, m_gsInitData.cy,
 		     SWP_NOCOPYBITS | SWP_NOSIZE | SWP_NOACTIVATE);
 #endif
+	Invalidate();
 }
 
 std::pair<uint32_t, uint32_t> OBS::Display::GetPosition()
@@ -767,125 +634,37 @@ void OBS::Display::SetBackgroundColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a
 void OBS::Display::SetOutlineColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a /*= 255u*/)
 {
 	PrepareColor(r, g, b, a, &m_outlineColor, &m_outlineColorVec4);
+	Invalidate();
 }
 
 void OBS::Display::SetCropOutlineColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a /*= 255u*/)
 {
 	PrepareColor(r, g, b, a, &m_cropOutlineColor, &m_cropOutlineColorVec4);
+	Invalidate();
 }
 
 void OBS::Display::SetGuidelineColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a /*= 255u*/)
 {
 	PrepareColor(r, g, b, a, &m_guidelineColor, &m_guidelineColorVec4);
+	Invalidate();
 }
 
 void OBS::Display::SetResizeBoxOuterColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a /*= 255u*/)
 {
 	PrepareColor(r, g, b, a, &m_resizeOuterColor, &m_resizeOuterColorVec4);
+	Invalidate();
 }
 
 void OBS::Display::SetResizeBoxInnerColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a /*= 255u*/)
 {
 	PrepareColor(r, g, b, a, &m_resizeInnerColor, &m_resizeInnerColorVec4);
+	Invalidate();
 }
 
 void OBS::Display::SetRotationHandleColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a /*= 255u*/)
 {
 	PrepareColor(r, g, b, a, &m_rotationHandleColor, &m_rotationHandleColorVec4);
-}
-
-static void DrawGlyph(GS::VertexBuffer *vb, float_t x, float_t y, float_t scale, float_t depth, char glyph, uint32_t color)
-{
-	float uvX = 0, uvY = 0, uvO = 1.0 / 4.0;
-	switch (glyph) {
-	default:
-		return;
-		break;
-	case '1':
-		uvX = 0;
-		uvY = 0;
-		break;
-	case '2':
-		uvX = uvO;
-		uvY = 0;
-		break;
-	case '3':
-		uvX = uvO * 2;
-		uvY = 0;
-		break;
-	case '4':
-		uvX = uvO * 3;
-		uvY = 0;
-		break;
-	case '5':
-		uvX = 0;
-		uvY = uvO * 1;
-		break;
-	case '6':
-		uvX = uvO;
-		uvY = uvO * 1;
-		break;
-	case '7':
-		uvX = uvO * 2;
-		uvY = uvO * 1;
-		break;
-	case '8':
-		uvX = uvO * 3;
-		uvY = uvO * 1;
-		break;
-	case '9':
-		uvX = 0;
-		uvY = uvO * 2;
-		break;
-	case '0':
-		uvX = uvO;
-		uvY = uvO * 2;
-		break;
-	case 'p':
-		uvX = uvO * 2;
-		uvY = uvO * 2;
-		break;
-	case 'x':
-		uvX = uvO * 3;
-		uvY = uvO * 2;
-		break;
-	}
-
-	GS::Vertex v(nullptr, nullptr, nullptr, nullptr, nullptr);
-	size_t bs = vb->Size();
-	vb->Resize(uint32_t(bs + 6));
-
-	// Top Left
-	v = vb->At(uint32_t(bs + 0));
-	vec3_set(v.position, x, y, depth);
-	vec4_set(v.uv[0], uvX, uvY, 0, 0);
-	*v.color = color;
-	// Top Right
-	v = vb->At(uint32_t(bs + 1));
-	vec3_set(v.position, x + scale, y, depth);
-	vec4_set(v.uv[0], uvX + uvO, uvY, 0, 0);
-	*v.color = color;
-	// Bottom Left
-	v = vb->At(uint32_t(bs + 2));
-	vec3_set(v.position, x, y + scale * 2, depth);
-	vec4_set(v.uv[0], uvX, uvY + uvO, 0, 0);
-	*v.color = color;
-
-	// Top Right
-	v = vb->At(uint32_t(bs + 3));
-	vec3_set(v.position, x + scale, y, depth);
-	vec4_set(v.uv[0], uvX + uvO, uvY, 0, 0);
-	*v.color = color;
-	// Bottom Left
-	v = vb->At(uint32_t(bs + 4));
-	vec3_set(v.position, x, y + scale * 2, depth);
-	vec4_set(v.uv[0], uvX, uvY + uvO, 0, 0);
-	*v.color = color;
-	// Bottom Right
-	v = vb->At(uint32_t(bs + 5));
-	vec3_set(v.position, x + scale, y + scale * 2, depth);
-	vec4_set(v.uv[0], uvX + uvO, uvY + uvO, 0, 0);
-	*v.color = color;
+	Invalidate();
 }
 
 inline bool CloseFloat(float a, float b, float epsilon = 0.01)
@@ -893,228 +672,45 @@ inline bool CloseFloat(float a, float b, float epsilon = 0.01)
 	return abs(a - b) <= epsilon;
 }
 
-void OBS::Display::DrawCropOutline(float x1, float y1, float x2, float y2, vec2 scale)
+static GS::OverlayTransform ToOverlayTransform(const matrix4 &mtx)
 {
-	// This is partially code from OBS Studio. See window-basic-preview.cpp in obs-studio for copyright/license.
-
-	float ySide = (y1 == y2) ? (y1 < 0.5f ? 1.0f : -1.0f) : 0.0f;
-	float xSide = (x1 == x2) ? (x1 < 0.5f ? 1.0f : -1.0f) : 0.0f;
-
-	float dist = sqrt(pow((x1 - x2) * scale.x, 2) + pow((y1 - y2) * scale.y, 2));
-	float offX = (x2 - x1) / dist;
-	float offY = (y2 - y1) / dist;
-
-	int l = static_cast<int>(ceil(dist / 15));
-	for (int i = 0; i < l; ++i) {
-		float xx1 = x1 + i * 15 * offX;
-		float yy1 = y1 + i * 15 * offY;
-
-		float dx;
-		float dy;
-
-		if (x1 < x2) {
-			dx = std::min(xx1 + 7.5f * offX, x2);
-		} else {
-			dx = std::max(xx1 + 7.5f * offX, x2);
-		}
-
-		if (y1 < y2) {
-			dy = std::min(yy1 + 7.5f * offY, y2);
-		} else {
-			dy = std::max(yy1 + 7.5f * offY, y2);
-		}
-
-		GS::Vertex v(nullptr, nullptr, nullptr, nullptr, nullptr);
-
-		v = m_cropOutline->At(0);
-		vec3_set(v.position, xx1, yy1, 0);
-		vec4_set(v.uv[0], 0, 0, 0, 0);
-		*v.color = 0xFFFFFFFF;
-
-		v = m_cropOutline->At(1);
-		vec3_set(v.position, xx1 + (xSide * (5 / scale.x)), yy1 + (ySide * (5 / scale.y)), 0);
-		vec4_set(v.uv[0], 0, 0, 0, 0);
-		*v.color = 0xFFFFFFFF;
-
-		v = m_cropOutline->At(2);
-		vec3_set(v.position, dx, dy, 0);
-		vec4_set(v.uv[0], 0, 0, 0, 0);
-		*v.color = 0xFFFFFFFF;
-
-		v = m_cropOutline->At(3);
-		vec3_set(v.position, dx + (xSide * (5 / scale.x)), dy + (ySide * (5 / scale.y)), 0);
-		vec4_set(v.uv[0], 0, 0, 0, 0);
-		*v.color = 0xFFFFFFFF;
-
-		gs_load_vertexbuffer(m_cropOutline->Update());
-		gs_draw(GS_TRISTRIP, 0, 0);
-	}
-}
-
-static void DrawSolidOutline(GS::VertexBuffer *vertexBuffer)
-{
-	gs_load_vertexbuffer(vertexBuffer->Update(false));
-	gs_draw(GS_LINES, 0, 0);
-}
-
-inline void DrawBoxAt(OBS::Display *dp, float_t x, float_t y, matrix4 &mtx)
-{
-	gs_matrix_push();
-
-	vec3 pos = {x, y, 0.0f};
-	vec3_transform(&pos, &pos, &mtx);
-
-	vec3 offset = {-HANDLE_RADIUS, -HANDLE_RADIUS, 0.0f};
-	offset.x *= dp->m_previewToWorldScale.x;
-	offset.y *= dp->m_previewToWorldScale.y;
-
-	gs_matrix_translate(&pos);
-	gs_matrix_translate(&offset);
-	gs_matrix_scale3f(HANDLE_DIAMETER * dp->m_previewToWorldScale.x, HANDLE_DIAMETER * dp->m_previewToWorldScale.y, 1.0f);
-
-	gs_draw(GS_LINESTRIP, 0, 0);
-	gs_matrix_pop();
+	GS::OverlayTransform transform;
+	transform.xx = mtx.x.x;
+	transform.xy = mtx.x.y;
+	transform.yx = mtx.y.x;
+	transform.yy = mtx.y.y;
+	transform.tx = mtx.t.x;
+	transform.ty = mtx.t.y;
+	return transform;
 }
 
-inline void DrawSquareAt(OBS::Display *dp, float_t x, float_t y, matrix4 &mtx)
+// Copies the vertices into the buffer, which is replaced by a larger one when
+// they don't fit. The whole capacity is uploaded, so it only grows as needed.
+static void UploadOverlay(std::unique_ptr<GS::VertexBuffer> &buffer, const std::vector<GS::OverlayVertex> &vertices,
+			  const std::vector<GS::OverlayVertex> &more = {})
 {
-	gs_matrix_push();
-
-	vec3 pos = {x, y, 0.0f};
-	vec3_transform(&pos, &pos, &mtx);
-
-	vec3 offset = {-HANDLE_RADIUS, -HANDLE_RADIUS, 0.0f};
-	offset.x *= dp->m_previewToWorldScale.x;
-	offset.y *= dp->m_previewToWorldScale.y;
-
-	gs_matrix_translate(&pos);
-	gs_matrix_translate(&offset);
-	gs_matrix_scale3f(HANDLE_DIAMETER * dp->m_previewToWorldScale.x, HANDLE_DIAMETER * dp->m_previewToWorldScale.y, 1.0f);
-
-	gs_draw(GS_TRISTRIP, 0, 0);
-	gs_matrix_pop();
-}
-
-inline void DrawGuideline(OBS::Display *dp, bool rot45, float_t x, float_t y, matrix4 &mtx)
-{
-	gs_rect rect;
-	rect.x = dp->GetPreviewOffset().first;
-	rect.y = dp->GetPreviewOffset().second;
-	rect.cx = dp->GetPreviewSize().first;
-	rect.cy = dp->GetPreviewSize().second;
-
-	gs_set_scissor_rect(&rect);
-	gs_matrix_push();
-
-	vec3 center = {0.5, 0.5, 0.0f};
-	vec3_transform(&center, &center, &mtx);
-
-	vec3 pos = {x, y, 0.0f};
-	vec3_transform(&pos, &pos, &mtx);
-
-	vec3 normal;
-	vec3_sub(&normal, &center, &pos);
-	vec3_norm(&normal, &normal);
-
-	gs_matrix_translate(&pos);
-
-	vec3 up, dn, lt, rt;
-
-	if (rot45) {
-		up = {-0.2, 1.0, 0};
-		dn = {0.2, -1.0, 0};
-		lt = {-1.0, -0.2, 0};
-		rt = {1.0, 0.2, 0};
-	} else {
-		up = {0, 1.0, 0};
-		dn = {0, -1.0, 0};
-		lt = {-1.0, 0, 0};
-		rt = {1.0, 0, 0};
+	uint32_t count = uint32_t(vertices.size() + more.size());
+	if (!buffer || buffer->Capacity() < count) {
+		uint32_t capacity = 256;
+		while (capacity < count)
+			capacity *= 2;
+		buffer = std::make_unique<GS::VertexBuffer>(capacity);
 	}
-
-	if (vec3_dot(&up, &normal) > 0.707f) {
-		// Dominantly looking up.
-		gs_matrix_rotaa4f(0, 0, 1, RAD(-90.0f));
-	} else if (vec3_dot(&dn, &normal) > 0.707f) {
-		// Dominantly looking down.
-		gs_matrix_rotaa4f(0, 0, 1, RAD(90.0f));
-	} else if (vec3_dot(&lt, &normal) > 0.707f) {
-		// Dominantly looking left.
-		gs_matrix_rotaa4f(0, 0, 1, RAD(0.0f));
-	} else if (vec3_dot(&rt, &normal) > 0.707f) {
-		// Dominantly looking right.
-		gs_matrix_rotaa4f(0, 0, 1, RAD(180.0f));
-	}
-
-	gs_matrix_scale3f(65535, 65535, 65535);
-
-	gs_draw(GS_LINES, 0, 2);
-
-	gs_matrix_pop();
-	gs_set_scissor_rect(nullptr);
-}
-
-void OBS::Display::DrawRotationHandle(float rot, matrix4 &mtx)
-{
-	struct vec3 pos;
-	vec3_set(&pos, 0.5f, 0.0f, 0.0f);
-	vec3_transform(&pos, &pos, &mtx);
-
-	gs_load_vertexbuffer(m_rotHandleLine->Update(false));
-
-	gs_matrix_push();
-	gs_matrix_identity();
-	gs_matrix_translate(&pos);
-
-	gs_matrix_rotaa4f(0.0f, 0.0f, 1.0f, RAD(rot));
-	gs_matrix_translate3f(-HANDLE_RADIUS * 1.5, -HANDLE_RADIUS * 1.5, 0.0f);
-	gs_matrix_scale3f(HANDLE_RADIUS * 3, HANDLE_RADIUS * 3, 1.0f);
-
-	gs_draw(GS_TRISTRIP, 0, 0);
-
-	gs_matrix_translate3f(0.0f, -HANDLE_RADIUS * 0.6, 0.0f);
-
-	gs_load_vertexbuffer(m_rotHandleCircle->Update(false));
-	gs_draw(GS_TRISTRIP, 0, 0);
-
-	gs_matrix_pop();
-}
-
-void OBS::Display::DrawOutline(const matrix4 &mtx, const obs_sceneitem_crop &crop, const vec2 &boxScale, gs_eparam_t *color)
-{
-	gs_matrix_push();
-	gs_matrix_mul(&mtx);
-
-	if (crop.left) {
-		gs_effect_set_vec4(color, &m_cropOutlineColorVec4);
-		DrawCropOutline(0.0f, 0.0f, 0.0f, 1.0f, boxScale);
-	} else {
-		gs_effect_set_vec4(color, &m_outlineColorVec4);
-		DrawSolidOutline(m_leftSolidOutline.get());
-	}
-	if (crop.top) {
-		gs_effect_set_vec4(color, &m_cropOutlineColorVec4);
-		DrawCropOutline(0.0f, 0.0f, 1.0f, 0.0f, boxScale);
-	} else {
-		gs_effect_set_vec4(color, &m_outlineColorVec4);
-		DrawSolidOutline(m_topSolidOutline.get());
-	}
-	if (crop.right) {
-		gs_effect_set_vec4(color, &m_cropOutlineColorVec4);
-		DrawCropOutline(1.0f, 0.0f, 1.0f, 1.0f, boxScale);
-	} else {
-		gs_effect_set_vec4(color, &m_outlineColorVec4);
-		DrawSolidOutline(m_rightSolidOutline.get());
-	}
-	if (crop.bottom) {
-		gs_effect_set_vec4(color, &m_cropOutlineColorVec4);
-		DrawCropOutline(0.0f, 1.0f, 1.0f, 1.0f, boxScale);
-	} else {
-		gs_effect_set_vec4(color, &m_outlineColorVec4);
-		DrawSolidOutline(m_bottomSolidOutline.get());
+	buffer->Resize(count);
+
+	vec3 *positions = buffer->GetPositions();
+	uint32_t *colors = buffer->GetColors();
+	vec4 *uvs = buffer->GetUVLayer(0);
+	uint32_t idx = 0;
+	for (const std::vector<GS::OverlayVertex> *list : {&vertices, &more}) {
+		for (const GS::OverlayVertex &vertex : *list) {
+			vec3_set(&positions[idx], vertex.x, vertex.y, 0);
+			vec4_set(&uvs[idx], vertex.u, vertex.v, 0, 0);
+			colors[idx] = vertex.color;
+			idx++;
+		}
 	}
-
-	gs_matrix_pop();
+	buffer->Update();
 }
 
 bool OBS::Display::DrawSelectedSource(obs_scene_t *scene, obs_sceneitem_t *item, void *param)
@@ -1165,9 +761,7 @@ bool OBS::Display::DrawSelectedSource(obs_scene_t *scene, obs_sceneitem_t *item,
 			return true;
 	}
 
-	vec4 color;
-	gs_effect_t *solid = obs_get_base_effect(OBS_EFFECT_SOLID);
-	gs_eparam_t *solid_color = gs_effect_get_param_by_name(solid, "color");
+	dp->m_overflowBoxes.push_back(boxTransform);
 
 	float rot = obs_sceneitem_get_rot(item);
 	bool rot45 = (rot == 45.0f || rot == 135.0f || rot == 225.0f || rot == 315.0f);
@@ -1185,21 +779,22 @@ bool OBS::Display::DrawSelectedSource(obs_scene_t *scene, obs_sceneitem_t *item,
 	obs_sceneitem_crop crop;
 	obs_sceneitem_get_crop(item, &crop);
 
-	dp->DrawOutline(boxTransform, crop, boxScale, solid_color);
+	GS::OverlayBuilder &overlay = dp->m_overlay;
+	GS::OverlayTransform box = ToOverlayTransform(boxTransform);
+
+	uint32_t cropped = (crop.left ? GS::OverlayBuilder::Left : 0) | (crop.top ? GS::OverlayBuilder::Top : 0) |
+			   (crop.right ? GS::OverlayBuilder::Right : 0) | (crop.bottom ? GS::OverlayBuilder::Bottom : 0);
+	overlay.AddOutline(box, cropped, boxScale.x, boxScale.y, dp->m_outlineColor, dp->m_cropOutlineColor);
 
 	if (dp->m_drawGuideLines) {
-		gs_load_vertexbuffer(dp->m_boxLine->Update(false));
-		gs_effect_set_vec4(solid_color, &dp->m_guidelineColorVec4);
-		DrawGuideline(dp, rot45, 0.5, 0, boxTransform);
-		DrawGuideline(dp, rot45, 0.5, 1, boxTransform);
-		DrawGuideline(dp, rot45, 0, 0.5, boxTransform);
-		DrawGuideline(dp, rot45, 1, 0.5, boxTransform);
+		overlay.AddGuideline(box, rot45, 0.5, 0, dp->m_guidelineColor);
+		overlay.AddGuideline(box, rot45, 0.5, 1, dp->m_guidelineColor);
+		overlay.AddGuideline(box, rot45, 0, 0.5, dp->m_guidelineColor);
+		overlay.AddGuideline(box, rot45, 1, 0.5, dp->m_guidelineColor);
 
 		// TEXT RENDERING
 		// THIS DESPERATELY NEEDS TO BE REWRITTEN INTO SHADER CODE
 		// DO SO WHENEVER...
-		GS::Vertex v(nullptr, nullptr, nullptr, nullptr, nullptr);
-
 		matrix4 itemMatrix, sceneToView;
 		obs_sceneitem_get_box_transform(item, &itemMatrix);
 		matrix4_identity(&sceneToView);
@@ -1253,8 +848,7 @@ bool OBS::Display::DrawSelectedSource(obs_scene_t *scene, obs_sceneitem_t *item,
 
 					for (size_t p = 0; p < len; p++) {
 						char v = buf.data()[p];
-						DrawGlyph(dp->m_textVertices, (edge[n].x / 2) - offset + (p * pt), edge[n].y - pt * 2, pt, 0, v,
-							  dp->m_guidelineColor);
+						overlay.AddGlyph((edge[n].x / 2) - offset + (p * pt), edge[n].y - pt * 2, pt, v, dp->m_guidelineColor);
 					}
 				}
 			} else if (left < -0.707f) { // RIGHT
@@ -1265,8 +859,7 @@ bool OBS::Display::DrawSelectedSource(obs_scene_t *scene, obs_sceneitem_t *item,
 
 					for (size_t p = 0; p < len; p++) {
 						char v = buf.data()[p];
-						DrawGlyph(dp->m_textVertices, edge[n].x + (dist / 2) - offset + (p * pt), edge[n].y - pt * 2, pt, 0, v,
-							  dp->m_guidelineColor);
+						overlay.AddGlyph(edge[n].x + (dist / 2) - offset + (p * pt), edge[n].y - pt * 2, pt, v, dp->m_guidelineColor);
 					}
 				}
 			} else if (top > 0.707f) { // UP
@@ -1277,8 +870,7 @@ bool OBS::Display::DrawSelectedSource(obs_scene_t *scene, obs_sceneitem_t *item,
 
 					for (size_t p = 0; p < len; p++) {
 						char v = buf.data()[p];
-						DrawGlyph(dp->m_textVertices, edge[n].x + (p * pt) + 15, edge[n].y - (dist / 2) - pt, pt, 0, v,
-							  dp->m_guidelineColor);
+						overlay.AddGlyph(edge[n].x + (p * pt) + 15, edge[n].y - (dist / 2) - pt, pt, v, dp->m_guidelineColor);
 					}
 				}
 			} else if (top < -0.707f) { // DOWN
@@ -1289,115 +881,51 @@ bool OBS::Display::DrawSelectedSource(obs_scene_t *scene, obs_sceneitem_t *item,
 
 					for (size_t p = 0; p < len; p++) {
 						char v = buf.data()[p];
-						DrawGlyph(dp->m_textVertices, edge[n].x + (p * pt) + 15, edge[n].y + (dist / 2) - pt, pt, 0, v,
-							  dp->m_guidelineColor);
+						overlay.AddGlyph(edge[n].x + (p * pt) + 15, edge[n].y + (dist / 2) - pt, pt, v, dp->m_guidelineColor);
 					}
 				}
 			}
 		}
 	}
 
-	if (dp->m_drawRotationHandle) {
-		gs_effect_set_vec4(solid_color, &dp->m_rotationHandleColorVec4);
-		dp->DrawRotationHandle(rot, boxTransform);
-	}
+	if (dp->m_drawRotationHandle)
+		overlay.AddRotationHandle(box, rot, HANDLE_RADIUS, dp->m_rotationHandleColor);
 
-	gs_load_vertexbuffer(dp->m_boxTris->Update(false));
-	gs_effect_set_vec4(solid_color, &dp->m_resizeInnerColorVec4);
-	DrawSquareAt(dp, 0, 0, boxTransform);
-	DrawSquareAt(dp, 1, 0, boxTransform);
-	DrawSquareAt(dp, 0, 1, boxTransform);
-	DrawSquareAt(dp, 1, 1, boxTransform);
-	DrawSquareAt(dp, 0.5, 0, boxTransform);
-	DrawSquareAt(dp, 0.5, 1, boxTransform);
-	DrawSquareAt(dp, 0, 0.5, boxTransform);
-	DrawSquareAt(dp, 1, 0.5, boxTransform);
-
-	gs_load_vertexbuffer(dp->m_boxLine->Update(false));
-	gs_effect_set_vec4(solid_color, &dp->m_resizeOuterColorVec4);
-	DrawBoxAt(dp, 0, 0, boxTransform);
-	DrawBoxAt(dp, 1, 0, boxTransform);
-	DrawBoxAt(dp, 0, 1, boxTransform);
-	DrawBoxAt(dp, 1, 1, boxTransform);
-	DrawBoxAt(dp, 0.5, 0, boxTransform);
-	DrawBoxAt(dp, 0.5, 1, boxTransform);
-	DrawBoxAt(dp, 0, 0.5, boxTransform);
-	DrawBoxAt(dp, 1, 0.5, boxTransform);
+	static const float handles[][2] = {{0, 0}, {1, 0}, {0, 1}, {1, 1}, {0.5, 0}, {0.5, 1}, {0, 0.5}, {1, 0.5}};
+	for (const auto &handle : handles) {
+		overlay.AddResizeHandle(box, handle[0], handle[1], HANDLE_RADIUS * dp->m_previewToWorldScale.x, HANDLE_RADIUS * dp->m_previewToWorldScale.y,
+					dp->m_resizeInnerColor, dp->m_resizeOuterColor);
+	}
 
 	return true;
 }
 
-bool OBS::Display::DrawSelectedOverflow(obs_scene_t *scene, obs_sceneitem_t *item, void *param)
+// Repeats the overflow pattern over the selected items, which the last
+// overlay rebuild collected.
+void OBS::Display::DrawOverflow()
 {
-	if (obs_sceneitem_locked(item))
-		return true;
-
-	OBS::Display *dp = reinterpret_cast<OBS::Display *>(param);
-
-	if (dp->m_canvas != obs_sceneitem_get_canvas(item))
-		return true;
-
-	obs_source_t *itemSource = obs_sceneitem_get_source(item);
-	uint32_t flags = obs_source_get_output_flags(itemSource);
-	bool isOnlyAudio = (flags & OBS_SOURCE_VIDEO) == 0;
-
-	obs_source_t *sceneSource = obs_scene_get_source(scene);
-
-	uint32_t sceneWidth = obs_source_get_width(sceneSource);
-	uint32_t sceneHeight = obs_source_get_height(sceneSource);
-	uint32_t itemWidth = obs_source_get_width(itemSource);
-	uint32_t itemHeight = obs_source_get_height(itemSource);
-
-	if (!obs_sceneitem_selected(item) || isOnlyAudio || ((itemWidth <= 0) && (itemHeight <= 0)))
-		return true;
-
-	matrix4 boxTransform;
-	matrix4 invBoxTransform;
-	obs_sceneitem_get_box_transform(item, &boxTransform);
-	matrix4_inv(&invBoxTransform, &boxTransform);
-
-	vec3 bounds[] = {
-		{{{0.f, 0.f, 0.f}}},
-		{{{1.f, 0.f, 0.f}}},
-		{{{0.f, 1.f, 0.f}}},
-		{{{1.f, 1.f, 0.f}}},
-	};
-
-	bool visible = std::all_of(std::begin(bounds), std::end(bounds), [&](const vec3 &b) {
-		vec3 pos;
-		vec3_transform(&pos, &b, &boxTransform);
-		vec3_transform(&pos, &pos, &invBoxTransform);
-		return CloseFloat(pos.x, b.x) && CloseFloat(pos.y, b.y);
-	});
-
-	if (!visible)
-		return true;
-
 	gs_effect_t *repeat = obs_get_base_effect(OBS_EFFECT_REPEAT);
 	gs_eparam_t *image = gs_effect_get_param_by_name(repeat, "image");
 	gs_eparam_t *scale = gs_effect_get_param_by_name(repeat, "scale");
 
-	vec2 s;
-	vec2_set(&s, boxTransform.x.x / 96, boxTransform.y.y / 96);
+	gs_texture_t *texture = (m_dayTheme) ? m_overflowDayTexture : m_overflowNightTexture;
 
-	gs_effect_set_vec2(scale, &s);
+	for (const matrix4 &boxTransform : m_overflowBoxes) {
+		vec2 s;
+		vec2_set(&s, boxTransform.x.x / 96, boxTransform.y.y / 96);
 
-	gs_texture_t *texture = (dp->m_dayTheme) ? dp->m_overflowDayTexture : dp->m_overflowNightTexture;
-	gs_effect_set_texture(image, texture);
+		gs_effect_set_vec2(scale, &s);
+		gs_effect_set_texture(image, texture);
 
-	gs_matrix_push();
-	gs_matrix_mul(&boxTransform);
+		gs_matrix_push();
+		gs_matrix_mul(&boxTransform);
 
-	obs_sceneitem_crop crop;
-	obs_sceneitem_get_crop(item, &crop);
+		while (gs_effect_loop(repeat, "Draw")) {
+			gs_draw_sprite(texture, 0, 1, 1);
+		}
 
-	while (gs_effect_loop(repeat, "Draw")) {
-		gs_draw_sprite(texture, 0, 1, 1);
+		gs_matrix_pop();
 	}
-
-	gs_matrix_pop();
-
-	return true;
 }
 
 void OBS::Display::DisplayCallback(void *displayPtr, uint32_t cx, uint32_t cy)
@@ -1441,6 +969,10 @@ void OBS::Display::DisplayCallback(void *displayPtr, uint32_t cx, uint32_t cy)
 	 * that are actually scenes and our main transition scene */
 	obs_scene_t *scene = (source) ? obs_scene_from_source(source) : nullptr;
 
+	dp->WatchScene(scene ? source : nullptr);
+	if (scene && dp->m_shouldDrawUI)
+		dp->UpdateOverlay(scene);
+
 	gs_viewport_push();
 	gs_projection_push();
 
@@ -1463,7 +995,7 @@ void OBS::Display::DisplayCallback(void *displayPtr, uint32_t cx, uint32_t cy)
 
 		gs_matrix_push();
 		gs_matrix_scale3f(dp->m_worldToPreviewScale.x, dp->m_worldToPreviewScale.y, 1.0f);
-		obs_scene_enum_items(scene, DrawSelectedOverflow, dp);
+		dp->DrawOverflow();
 		gs_matrix_pop();
 	}
 
@@ -1522,31 +1054,130 @@ void OBS::Display::DisplayCallback(void *displayPtr, uint32_t cx, uint32_t cy)
 		gs_ortho(tlCorner.x, brCorner.x, tlCorner.y, brCorner.y, -100.0f, 100.0f);
 		gs_reset_viewport();
 
-		dp->m_textVertices->Resize(0);
+		dp->DrawOverlay();
+	}
+
+	obs_source_release(source);
+	gs_projection_pop();
+	gs_viewport_pop();
+}
+
+void OBS::Display::Invalidate()
+{
+	m_generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+void OBS::Display::SceneChanged(void *data, calldata_t *params)
+{
+	static_cast<Display *>(data)->Invalidate();
+}
+
+// Signals of a scene that change what the overlay of its items looks like.
+static const char *sceneSignals[] = {"item_add",    "item_remove", "reorder",       "refresh",       "item_visible",
+				     "item_locked", "item_select", "item_deselect", "item_transform"};
+
+void OBS::Display::WatchScene(obs_source_t *source)
+{
+	if (source == m_watchedScene)
+		return;
+
+	if (m_watchedScene) {
+		signal_handler_t *handler = obs_source_get_signal_handler(m_watchedScene);
+		for (const char *signal : sceneSignals)
+			signal_handler_disconnect(handler, signal, SceneChanged, this);
+		obs_source_release(m_watchedScene);
+	}
+
+	m_watchedScene = source ? obs_source_get_ref(source) : nullptr;
+
+	if (m_watchedScene) {
+		signal_handler_t *handler = obs_source_get_signal_handler(m_watchedScene);
+		for (const char *signal : sceneSignals)
+			signal_handler_connect(handler, signal, SceneChanged, this);
+	}
+	Invalidate();
+}
+
+// Walks the items of the scene again only when something changed since the
+// last rebuild, the geometry stays uploaded in between.
+void OBS::Display::UpdateOverlay(obs_scene_t *scene)
+{
+	uint64_t generation = m_generation.load(std::memory_order_relaxed);
+	if (generation == m_overlayGeneration)
+		return;
+	m_overlayGeneration = generation;
+
+	m_overlay.Clear();
+	m_overflowBoxes.clear();
+	obs_scene_enum_items(scene, DrawSelectedSource, this);
+
+	if (!m_overlay.Triangles().empty())
+		UploadOverlay(m_overlayTriangles, m_overlay.Triangles());
+	if (!m_overlay.Lines().empty() || !m_overlay.Guidelines().empty())
+		UploadOverlay(m_overlayLines, m_overlay.Lines(), m_overlay.Guidelines());
+	if (!m_overlay.Text().empty())
+		UploadOverlay(m_textVertices, m_overlay.Text());
+}
+
+// Draws the overlay UpdateOverlay built, vertices carry their colors so every
+// kind of primitive takes a single draw.
+void OBS::Display::DrawOverlay()
+{
+	gs_effect_t *solid = obs_get_base_effect(OBS_EFFECT_SOLID);
+	gs_eparam_t *solid_color = gs_effect_get_param_by_name(solid, "color");
+	gs_technique_t *solid_tech = gs_effect_get_technique(solid, "SolidColored");
+
+	uint32_t triangles = uint32_t(m_overlay.Triangles().size());
+	uint32_t lines = uint32_t(m_overlay.Lines().size());
+	uint32_t guidelines = uint32_t(m_overlay.Guidelines().size());
+
+	gs_load_indexbuffer(nullptr);
+
+	if (triangles > 0 || lines > 0 || guidelines > 0) {
+		vec4 white;
+		vec4_set(&white, 1.0f, 1.0f, 1.0f, 1.0f);
+		gs_effect_set_vec4(solid_color, &white);
 
 		gs_technique_begin(solid_tech);
 		gs_technique_begin_pass(solid_tech, 0);
 
-		obs_scene_enum_items(scene, DrawSelectedSource, dp);
+		if (triangles > 0) {
+			gs_load_vertexbuffer(m_overlayTriangles->Update(false));
+			gs_draw(GS_TRIS, 0, triangles);
+		}
+
+		if (lines > 0 || guidelines > 0) {
+			gs_load_vertexbuffer(m_overlayLines->Update(false));
+			if (lines > 0)
+				gs_draw(GS_LINES, 0, lines);
+
+			if (guidelines > 0) {
+				gs_rect rect;
+				rect.x = m_previewOffset.first;
+				rect.y = m_previewOffset.second;
+				rect.cx = m_previewSize.first;
+				rect.cy = m_previewSize.second;
+
+				gs_set_scissor_rect(&rect);
+				gs_draw(GS_LINES, lines, guidelines);
+				gs_set_scissor_rect(nullptr);
+			}
+		}
 
 		gs_technique_end_pass(solid_tech);
 		gs_technique_end(solid_tech);
+	}
 
-		// Text Rendering
-		if (dp->m_textVertices->Size() > 0) {
-			gs_vertbuffer_t *vb = dp->m_textVertices->Update();
-			while (gs_effect_loop(dp->m_textEffect, "Draw")) {
-				gs_effect_set_texture(gs_effect_get_param_by_name(dp->m_textEffect, "image"), dp->m_textTexture);
-				gs_load_vertexbuffer(vb);
-				gs_load_indexbuffer(nullptr);
-				gs_draw(GS_TRIS, 0, (uint32_t)dp->m_textVertices->Size());
-			}
+	// Text Rendering
+	if (!m_overlay.Text().empty()) {
+		gs_vertbuffer_t *vb = m_textVertices->Update(false);
+		while (gs_effect_loop(m_textEffect, "Draw")) {
+			gs_effect_set_texture(gs_effect_get_param_by_name(m_textEffect, "image"), m_textTexture);
+			gs_load_vertexbuffer(vb);
+			gs_load_indexbuffer(nullptr);
+			gs_draw(GS_TRIS, 0, uint32_t(m_overlay.Text().size()));
 		}
 	}
-
-	obs_source_release(source);
-	gs_projection_pop();
-	gs_viewport_pop();
 }
 
 obs_source_t *OBS::Display::GetSourceForUIEffects()
@@ -1592,6 +1223,11 @@ void OBS::Display::UpdatePreviewArea()
 	if (sourceH == 0)
 		sourceH = 1;
 
+	auto inputs = std::make_tuple(m_gsInitData.cx, m_gsInitData.cy, sourceW, sourceH, m_paddingSize);
+	if (inputs == m_previewAreaInputs)
+		return;
+	m_previewAreaInputs = inputs;
+
 	RecalculateApectRatioConstrainedSize(m_gsInitData.cx, m_gsInitData.cy, sourceW, sourceH, m_previewOffset.first, m_previewOffset.second,
 					     m_previewSize.first, m_previewSize.second);
 
@@ -1613,6 +1249,7 @@ void OBS::Display::UpdatePreviewArea()
 	m_worldToPreviewScale.y = float_t(m_previewSize.second) / float_t(sourceH);
 	m_previewToWorldScale.x = float_t(sourceW) / float_t(m_previewSize.first);
 	m_previewToWorldScale.y = float_t(sourceH) / float_t(m_previewSize.second);
+	Invalidate();
 }
 
 #if defined(_WIN32)
@@ -1680,6 +1317,7 @@ bool OBS::Display::GetDrawGuideLines(void)
 void OBS::Display::SetDrawGuideLines(bool drawGuideLines)
 {
 	m_drawGuideLines = drawGuideLines;
+	Invalidate();
 }
 
 bool OBS::Display::GetDrawRotationHandle()
@@ -1690,4 +1328,5 @@ bool OBS::Display::GetDrawRotationHandle()
 void OBS::Display::SetDrawRotationHandle(bool drawRotationHandle)
 {
 	m_drawRotationHandle = drawRotationHandle;
+	Invalidate();
 }
@@ -19,10 +19,13 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include <system_error>
 #include <thread>
+#include <tuple>
 #include <vector>
+#include "gs-overlay.h"
 #include "gs-vertexbuffer.h"
 #include "obs.h"
 #include "ipc-server.hpp"
@@ -88,14 +91,18 @@ public:
 	void SetDrawRotationHandle(bool drawRotationHandle);
 	void UpdatePreviewArea();
 
+	// Makes the next frame rebuild the selection overlay.
+	void Invalidate();
+
 private:
 	static void DisplayCallback(void *displayPtr, uint32_t cx, uint32_t cy);
 	static bool DrawSelectedSource(obs_scene_t *scene, obs_sceneitem_t *item, void *param);
-	static bool DrawSelectedOverflow(obs_scene_t *scene, obs_sceneitem_t *item, void *param);
+	static void SceneChanged(void *data, calldata_t *params);
 	obs_source_t *GetSourceForUIEffects();
-	void DrawCropOutline(float x1, float y1, float x2, float y2, vec2 scale);
-	void DrawOutline(const matrix4 &mtx, const obs_sceneitem_crop &crop, const vec2 &boxScale, gs_eparam_t *color);
-	void DrawRotationHandle(float rot, matrix4 &mtx);
+	void WatchScene(obs_source_t *source);
+	void UpdateOverlay(obs_scene_t *scene);
+	void DrawOverflow();
+	void DrawOverlay();
 	void setSizeCall(int step);
 
 public: // Rendering code needs it.
@@ -129,16 +136,18 @@ private:
 	gs_texture_t *m_overflowDayTexture;
 	static std::mutex m_displayMtx;
 
-	GS::VertexBuffer *m_textVertices;
-
-	std::unique_ptr<GS::VertexBuffer> m_leftSolidOutline;
-	std::unique_ptr<GS::VertexBuffer> m_topSolidOutline;
-	std::unique_ptr<GS::VertexBuffer> m_rightSolidOutline;
-	std::unique_ptr<GS::VertexBuffer> m_bottomSolidOutline;
-	std::unique_ptr<GS::VertexBuffer> m_cropOutline;
-
-	std::unique_ptr<GS::VertexBuffer> m_boxLine, m_boxTris;
-	std::unique_ptr<GS::VertexBuffer> m_rotHandleLine, m_rotHandleCircle;
+	std::unique_ptr<GS::VertexBuffer> m_boxTris;
+
+	// Selection overlay, see gs-overlay.h. It is kept between frames and only
+	// rebuilt once m_generation moved, which the signals of the watched scene
+	// and the setters of the display do.
+	GS::OverlayBuilder m_overlay;
+	std::unique_ptr<GS::VertexBuffer> m_overlayTriangles, m_overlayLines, m_textVertices;
+	std::vector<matrix4> m_overflowBoxes;
+	std::atomic<uint64_t> m_generation{1};
+	uint64_t m_overlayGeneration = 0;
+	obs_source_t *m_watchedScene = nullptr;
+	std::tuple<uint32_t, uint32_t, uint32_t, uint32_t, uint32_t> m_previewAreaInputs;
 
 	// Theme/Style
 	/// Padding
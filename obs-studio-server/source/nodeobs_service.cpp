@@ -22,6 +22,7 @@
 #include <windows.h>
 #include <filesystem>
 #endif
+#include "callback-manager.h"
 #include "osn-error.hpp"
 #include "shared.hpp"
 #include "utility.hpp"
@@ -69,10 +70,16 @@ bool isReplayBufferActive = false;
 bool rpUsesRec = false;
 bool rpUsesStream = false;
 
-std::mutex signalMutex;
-std::queue<SignalInfo> outputSignal;
 std::thread releaseWorker;
 
+// Signals of the legacy outputs share the event channel with the osn outputs,
+// the service index tells the client which stream they belong to.
+static void PushSignal(SignalInfo &signal)
+{
+	CallbackManager::NotifyOutputSignal(CallbackManager::ServiceSignalsId, signal.getOutputType(), signal.getSignal(), signal.getCode(),
+					    signal.getErrorMessage(), static_cast<int32_t>(signal.getIndex()));
+}
+
 static constexpr int kSoundtrackArchiveEncoderIdx = 1;
 static constexpr int kSoundtrackArchiveTrackIdx = 5;
 static obs_encoder_t *streamArchiveEncST = nullptr;
@@ -97,7 +104,6 @@ void OBS_service::Register(ipc::server &srv)
 	cls->register_function(
 		std::make_shared<ipc::function>("OBS_service_stopReplayBuffer", std::vector<ipc::type>{ipc::type::Int32}, OBS_service_stopReplayBuffer));
 	cls->register_function(std::make_shared<ipc::function>("OBS_service_connectOutputSignals", std::vector<ipc::type>{}, OBS_service_connectOutputSignals));
-	cls->register_function(std::make_shared<ipc::function>("Query", std::vector<ipc::type>{}, Query));
 	cls->register_function(
 		std::make_shared<ipc::function>("OBS_service_processReplayBufferHotkey", std::vector<ipc::type>{}, OBS_service_processReplayBufferHotkey));
 	cls->register_function(std::make_shared<ipc::function>("OBS_service_splitFile", std::vector<ipc::type>{}, OBS_service_splitFile));
@@ -1165,8 +1171,7 @@ bool OBS_service::startStreaming(StreamServiceId serviceId)
 			signal.setCode(OBS_OUTPUT_ERROR);
 		}
 
-		std::unique_lock<std::mutex> ulock(signalMutex);
-		outputSignal.push(signal);
+		PushSignal(signal);
 	}
 	return isStreaming[serviceId];
 }
@@ -1441,8 +1446,7 @@ bool OBS_service::startRecording(void)
 			}
 			signal.setCode(OBS_OUTPUT_ERROR);
 		}
-		std::unique_lock<std::mutex> ulock(signalMutex);
-		outputSignal.push(signal);
+		PushSignal(signal);
 	}
 	return isRecording;
 }
@@ -1613,8 +1617,7 @@ bool OBS_service::startReplayBuffer(void)
 			}
 			signal.setCode(OBS_OUTPUT_ERROR);
 		}
-		std::unique_lock<std::mutex> ulock(signalMutex);
-		outputSignal.push(signal);
+		PushSignal(signal);
 	} else {
 		isReplayBufferActive = true;
 	}
@@ -2493,30 +2496,6 @@ void OBS_service::OBS_service_connectOutputSignals(void *data, const int64_t id,
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
 }
 
-void OBS_service::Query(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
-{
-	std::unique_lock<std::mutex> ulock(signalMutex);
-	if (outputSignal.empty()) {
-		ulock.unlock();
-		rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
-		AUTO_DEBUG;
-		return;
-	}
-
-	auto frontSignal = outputSignal.front();
-	outputSignal.pop();
-	ulock.unlock();
-
-	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
-	rval.push_back(ipc::value(frontSignal.getOutputType()));
-	rval.push_back(ipc::value(frontSignal.getSignal()));
-	rval.push_back(ipc::value(frontSignal.getCode()));
-	rval.push_back(ipc::value(frontSignal.getErrorMessage()));
-	rval.push_back(ipc::value(static_cast<int32_t>(frontSignal.getIndex())));
-
-	AUTO_DEBUG;
-}
-
 void OBS_service::JSCallbackOutputSignal(void *data, calldata_t *params)
 {
 	SignalInfo &signal = *reinterpret_cast<SignalInfo *>(data);
@@ -2548,8 +2527,7 @@ void OBS_service::JSCallbackOutputSignal(void *data, calldata_t *params)
 		}
 	}
 
-	std::unique_lock<std::mutex> ulock(signalMutex);
-	outputSignal.push(signal);
+	PushSignal(signal);
 }
 
 void OBS_service::connectOutputSignals(StreamServiceId serviceId)
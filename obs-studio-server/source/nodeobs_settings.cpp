@@ -22,6 +22,7 @@
 #include "shared.hpp"
 #include "memory-manager.h"
 #include "osn-video.hpp"
+#include "util-modulemanifest.h"
 
 #ifdef WIN32
 #include <windows.h>
@@ -4318,6 +4319,7 @@ void OBS_settings::saveGenericSettings(std::vector<SubCategory> genericSettings,
 
 void getDevices(const char *source_id, const char *property_name, std::vector<ipc::value> &rval)
 {
+	util::ModuleManifest::LoadSourceType(source_id);
 	auto settings = obs_get_source_defaults(source_id);
 	if (!settings)
 		return;
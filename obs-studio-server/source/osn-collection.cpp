@@ -0,0 +1,491 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#include "osn-collection.hpp"
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <obs.h>
+#include "osn-error.hpp"
+#include "osn-sceneitem.hpp"
+#include "osn-source.hpp"
+#include "settings-binary.hpp"
+#include "shared.hpp"
+#include "util-modulemanifest.h"
+
+void osn::Collection::Register(ipc::server &srv)
+{
+	std::shared_ptr<ipc::collection> cls = std::make_shared<ipc::collection>("Collection");
+	cls->register_function(std::make_shared<ipc::function>("Load", std::vector<ipc::type>{ipc::type::Binary}, Load));
+	cls->register_function(std::make_shared<ipc::function>("Save", std::vector<ipc::type>{}, Save));
+	srv.register_collection(cls);
+}
+
+static void PutInt(settings::Writer &writer, const char *key, int64_t value)
+{
+	writer.put_int(key, std::strlen(key), value);
+}
+
+static void PutDouble(settings::Writer &writer, const char *key, double value)
+{
+	writer.put_double(key, std::strlen(key), value);
+}
+
+static void PutBool(settings::Writer &writer, const char *key, bool value)
+{
+	writer.put_bool(key, std::strlen(key), value);
+}
+
+static void PutString(settings::Writer &writer, const char *key, const char *value)
+{
+	value = value ? value : "";
+	writer.put_string(key, std::strlen(key), value, std::strlen(value));
+}
+
+static void PutSettings(settings::Writer &writer, const char *key, obs_data_t *data)
+{
+	size_t mark = writer.begin_object(key, std::strlen(key));
+	osn::Source::SettingsToBinary(writer, data);
+	writer.end_object(mark);
+}
+
+static std::string StringOf(const settings::Record &record)
+{
+	return record.type == settings::String ? std::string(record.value, record.value_size) : std::string();
+}
+
+static double NumberIn(const settings::Record &object, const char *key, double fallback)
+{
+	settings::Reader reader(object.value, object.value_size);
+	settings::Record record;
+	while (reader.next(record)) {
+		if (record.is(key))
+			return record.number();
+	}
+	return fallback;
+}
+
+// Name, type and settings of a source or filter description.
+struct SourceDesc {
+	std::string name;
+	std::string type;
+	obs_data_t *settings = nullptr;
+
+	SourceDesc(settings::Reader reader)
+	{
+		settings::Record record;
+		while (reader.next(record)) {
+			if (record.is("name"))
+				name = StringOf(record);
+			else if (record.is("type"))
+				type = StringOf(record);
+			else if (record.is("settings") && record.type == settings::Object)
+				settings = osn::Source::SettingsFromBinary(record.value, record.value_size);
+		}
+	}
+	~SourceDesc() { obs_data_release(settings); }
+};
+
+static void ApplySource(obs_source_t *source, settings::Reader reader);
+
+static void AddFilters(obs_source_t *source, const settings::Record &filters)
+{
+	settings::Reader elements(filters.value, filters.value_size);
+	settings::Reader element(nullptr, 0);
+	while (elements.next_element(element)) {
+		SourceDesc desc(element);
+		util::ModuleManifest::LoadSourceType(desc.type);
+		obs_source_t *filter = obs_source_create_private(desc.type.c_str(), desc.name.c_str(), desc.settings);
+		if (!filter) {
+			blog(LOG_WARNING, "Collection: failed to create filter '%s' of type '%s'.", desc.name.c_str(), desc.type.c_str());
+			continue;
+		}
+
+		// Registered like Filter.Create does so that Input.GetFilters reports it
+		osn::Source::Manager::GetInstance().allocate(filter);
+		osn::Source::attach_source_signals(filter);
+		ApplySource(filter, element);
+		obs_source_filter_add(source, filter);
+		obs_source_release(filter);
+	}
+}
+
+static void ApplySource(obs_source_t *source, settings::Reader reader)
+{
+	settings::Record record;
+	while (reader.next(record)) {
+		if (record.is("volume")) {
+			obs_source_set_volume(source, (float)record.number());
+		} else if (record.is("muted") && record.type == settings::Bool) {
+			obs_source_set_muted(source, record.get<uint8_t>() != 0);
+		} else if (record.is("syncOffset") && record.type == settings::Object) {
+			double sec = NumberIn(record, "sec", 0);
+			double nsec = NumberIn(record, "nsec", 0);
+			obs_source_set_sync_offset(source, int64_t(sec) * 1000000000 + int64_t(nsec));
+		} else if (record.is("audioMixers")) {
+			obs_source_set_audio_mixers(source, (uint32_t)record.number());
+		} else if (record.is("deinterlaceMode")) {
+			obs_source_set_deinterlace_mode(source, (obs_deinterlace_mode)(int)record.number());
+		} else if (record.is("deinterlaceFieldOrder")) {
+			obs_source_set_deinterlace_field_order(source, (obs_deinterlace_field_order)(int)record.number());
+		} else if (record.is("enabled") && record.type == settings::Bool) {
+			obs_source_set_enabled(source, record.get<uint8_t>() != 0);
+		} else if (record.is("filters") && record.type == settings::Array) {
+			AddFilters(source, record);
+		}
+	}
+}
+
+static void ApplyItem(obs_sceneitem_t *item, settings::Reader reader)
+{
+	vec2 pos, scale, bounds;
+	obs_sceneitem_get_pos(item, &pos);
+	obs_sceneitem_get_scale(item, &scale);
+	obs_sceneitem_get_bounds(item, &bounds);
+
+	obs_sceneitem_defer_update_begin(item);
+	settings::Record record;
+	while (reader.next(record)) {
+		if (record.is("x")) {
+			pos.x = (float)record.number();
+		} else if (record.is("y")) {
+			pos.y = (float)record.number();
+		} else if (record.is("scaleX")) {
+			scale.x = (float)record.number();
+		} else if (record.is("scaleY")) {
+			scale.y = (float)record.number();
+		} else if (record.is("rotation")) {
+			obs_sceneitem_set_rot(item, (float)record.number());
+		} else if (record.is("visible") && record.type == settings::Bool) {
+			obs_sceneitem_set_visible(item, record.get<uint8_t>() != 0);
+		} else if (record.is("streamVisible") && record.type == settings::Bool) {
+			obs_sceneitem_set_stream_visible(item, record.get<uint8_t>() != 0);
+		} else if (record.is("recordingVisible") && record.type == settings::Bool) {
+			obs_sceneitem_set_recording_visible(item, record.get<uint8_t>() != 0);
+		} else if (record.is("crop") && record.type == settings::Object) {
+			obs_sceneitem_crop crop;
+			crop.left = (int)NumberIn(record, "left", 0);
+			crop.top = (int)NumberIn(record, "top", 0);
+			crop.right = (int)NumberIn(record, "right", 0);
+			crop.bottom = (int)NumberIn(record, "bottom", 0);
+			obs_sceneitem_set_crop(item, &crop);
+		} else if (record.is("scaleFilter")) {
+			obs_sceneitem_set_scale_filter(item, (obs_scale_type)(int)record.number());
+		} else if (record.is("blendingMode")) {
+			obs_sceneitem_set_blending_mode(item, (obs_blending_type)(int)record.number());
+		} else if (record.is("blendingMethod")) {
+			obs_sceneitem_set_blending_method(item, (obs_blending_method)(int)record.number());
+		} else if (record.is("alignment")) {
+			obs_sceneitem_set_alignment(item, (uint32_t)record.number());
+		} else if (record.is("bounds") && record.type == settings::Object) {
+			bounds.x = (float)NumberIn(record, "x", bounds.x);
+			bounds.y = (float)NumberIn(record, "y", bounds.y);
+		} else if (record.is("boundsType")) {
+			obs_sceneitem_set_bounds_type(item, (obs_bounds_type)(int)record.number());
+		} else if (record.is("boundsAlignment")) {
+			obs_sceneitem_set_bounds_alignment(item, (uint32_t)record.number());
+		}
+	}
+	obs_sceneitem_set_pos(item, &pos);
+	obs_sceneitem_set_scale(item, &scale);
+	obs_sceneitem_set_bounds(item, &bounds);
+	obs_sceneitem_defer_update_end(item);
+}
+
+// Count is 0 if the key is missing.
+static settings::Record FindArray(settings::Reader reader, const char *key)
+{
+	settings::Record record;
+	while (reader.next(record)) {
+		if (record.is(key) && record.type == settings::Array)
+			return record;
+	}
+	record = {};
+	return record;
+}
+
+void osn::Collection::Load(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
+{
+	const std::vector<char> &collection = args[0].value_bin;
+	if (!settings::validate(settings::Reader(collection))) {
+		PRETTY_ERROR_RETURN(ErrorCode::OutOfBounds, "Collection is malformed.");
+	}
+
+	std::vector<char> buffer;
+	settings::Writer writer(buffer);
+	// Items are resolved against what this call created first, then against
+	// sources that already existed.
+	std::unordered_map<std::string, obs_source_t *> created;
+
+	settings::Record sources = FindArray(settings::Reader(collection), "sources");
+	settings::Reader elements(sources.value, sources.value_size);
+	settings::Reader element(nullptr, 0);
+	size_t mark = writer.begin_array("sources", 7);
+	for (uint32_t i = 0; i < sources.count && elements.next_element(element); i++) {
+		size_t element_mark = writer.begin_element();
+
+		SourceDesc desc(element);
+		util::ModuleManifest::LoadSourceType(desc.type);
+		obs_source_t *source = obs_source_create(desc.type.c_str(), desc.name.c_str(), desc.settings, nullptr);
+		uint64_t uid = source ? osn::Source::Manager::GetInstance().find(source) : UINT64_MAX;
+		if (uid != UINT64_MAX) {
+			ApplySource(source, element);
+			created[desc.name] = source;
+
+			obs_data_t *settings = obs_source_get_settings(source);
+			PutInt(writer, "id", (int64_t)uid);
+			PutString(writer, "name", desc.name.c_str());
+			PutString(writer, "type", desc.type.c_str());
+			PutSettings(writer, "settings", settings);
+			PutInt(writer, "audioMixers", obs_source_get_audio_mixers(source));
+			PutInt(writer, "deinterlaceMode", obs_source_get_deinterlace_mode(source));
+			PutInt(writer, "deinterlaceFieldOrder", obs_source_get_deinterlace_field_order(source));
+			obs_data_release(settings);
+		} else {
+			// Created but never registered, nothing else holds a reference
+			if (source)
+				obs_source_release(source);
+			blog(LOG_WARNING, "Collection: failed to create source '%s' of type '%s'.", desc.name.c_str(), desc.type.c_str());
+		}
+
+		writer.end_element(element_mark);
+	}
+	writer.end_array(mark, sources.count);
+
+	// Scenes are all created before any item is added so that nested scenes
+	// may come in any order.
+	settings::Record scenes = FindArray(settings::Reader(collection), "scenes");
+	std::vector<obs_scene_t *> created_scenes;
+	elements = settings::Reader(scenes.value, scenes.value_size);
+	for (uint32_t i = 0; i < scenes.count && elements.next_element(element); i++) {
+		SourceDesc desc(element);
+		obs_scene_t *scene = NumberIn(element, "group", 0) != 0 ? obs_group_create(desc.name.c_str()) : obs_scene_create(desc.name.c_str());
+		created_scenes.push_back(scene);
+		if (scene)
+			created[desc.name] = obs_scene_get_source(scene);
+		else
+			blog(LOG_WARNING, "Collection: failed to create scene '%s'.", desc.name.c_str());
+	}
+
+	elements = settings::Reader(scenes.value, scenes.value_size);
+	mark = writer.begin_array("scenes", 6);
+	for (uint32_t i = 0; i < scenes.count && elements.next_element(element); i++) {
+		size_t element_mark = writer.begin_element();
+		obs_scene_t *scene = created_scenes[i];
+		uint64_t uid = scene ? osn::Source::Manager::GetInstance().find(obs_scene_get_source(scene)) : UINT64_MAX;
+		if (uid == UINT64_MAX) {
+			writer.end_element(element_mark);
+			continue;
+		}
+
+		PutInt(writer, "id", (int64_t)uid);
+		PutString(writer, "name", obs_source_get_name(obs_scene_get_source(scene)));
+		PutString(writer, "type", obs_source_get_id(obs_scene_get_source(scene)));
+
+		settings::Record items = FindArray(element, "items");
+		settings::Reader item_elements(items.value, items.value_size);
+		settings::Reader item_element(nullptr, 0);
+		size_t items_mark = writer.begin_array("items", 5);
+		for (uint32_t j = 0; j < items.count && item_elements.next_element(item_element); j++) {
+			size_t item_mark = writer.begin_element();
+			SourceDesc desc(item_element);
+
+			obs_source_t *source = nullptr;
+			auto iter = created.find(desc.name);
+			if (iter != created.end())
+				source = obs_source_get_ref(iter->second);
+			else
+				source = obs_get_source_by_name(desc.name.c_str());
+
+			obs_sceneitem_t *item = source ? obs_scene_add(scene, source) : nullptr;
+			obs_source_release(source);
+
+			uint64_t item_uid = item ? osn::SceneItem::Manager::GetInstance().allocate(item) : UINT64_MAX;
+			if (item_uid != UINT64_MAX) {
+				// Same reference AddSource hands to the client
+				obs_sceneitem_addref(item);
+				ApplyItem(item, item_element);
+				PutInt(writer, "id", (int64_t)item_uid);
+				PutInt(writer, "obsId", obs_sceneitem_get_id(item));
+			} else {
+				blog(LOG_WARNING, "Collection: failed to add '%s' to scene '%s'.", desc.name.c_str(),
+				     obs_source_get_name(obs_scene_get_source(scene)));
+			}
+			writer.end_element(item_mark);
+		}
+		writer.end_array(items_mark, items.count);
+
+		writer.end_element(element_mark);
+	}
+	writer.end_array(mark, scenes.count);
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	rval.push_back(ipc::value(buffer));
+	AUTO_DEBUG;
+}
+
+static void SaveSource(settings::Writer &writer, obs_source_t *source, bool filter)
+{
+	PutString(writer, "name", obs_source_get_name(source));
+	PutString(writer, "type", obs_source_get_id(source));
+	obs_data_t *settings = obs_source_get_settings(source);
+	PutSettings(writer, "settings", settings);
+	obs_data_release(settings);
+	PutBool(writer, "enabled", obs_source_enabled(source));
+	if (filter)
+		return;
+
+	PutDouble(writer, "volume", obs_source_get_volume(source));
+	PutBool(writer, "muted", obs_source_muted(source));
+	int64_t offset = obs_source_get_sync_offset(source);
+	size_t mark = writer.begin_object("syncOffset", 10);
+	PutInt(writer, "sec", offset / 1000000000);
+	PutInt(writer, "nsec", offset % 1000000000);
+	writer.end_object(mark);
+	PutInt(writer, "audioMixers", obs_source_get_audio_mixers(source));
+	PutInt(writer, "deinterlaceMode", obs_source_get_deinterlace_mode(source));
+	PutInt(writer, "deinterlaceFieldOrder", obs_source_get_deinterlace_field_order(source));
+
+	struct FilterData {
+		settings::Writer *writer;
+		uint32_t count;
+	} fd = {&writer, 0};
+	auto cb = [](obs_source_t *parent, obs_source_t *child, void *data) {
+		FilterData *fd = reinterpret_cast<FilterData *>(data);
+		size_t mark = fd->writer->begin_element();
+		SaveSource(*fd->writer, child, true);
+		fd->writer->end_element(mark);
+		fd->count++;
+	};
+	mark = writer.begin_array("filters", 7);
+	obs_source_enum_filters(source, cb, &fd);
+	writer.end_array(mark, fd.count);
+}
+
+static void SaveItem(settings::Writer &writer, obs_sceneitem_t *item)
+{
+	PutString(writer, "name", obs_source_get_name(obs_sceneitem_get_source(item)));
+
+	vec2 pos, scale, bounds;
+	obs_sceneitem_get_pos(item, &pos);
+	obs_sceneitem_get_scale(item, &scale);
+	obs_sceneitem_get_bounds(item, &bounds);
+	PutDouble(writer, "x", pos.x);
+	PutDouble(writer, "y", pos.y);
+	PutDouble(writer, "scaleX", scale.x);
+	PutDouble(writer, "scaleY", scale.y);
+	PutDouble(writer, "rotation", obs_sceneitem_get_rot(item));
+	PutBool(writer, "visible", obs_sceneitem_visible(item));
+	PutBool(writer, "streamVisible", obs_sceneitem_stream_visible(item));
+	PutBool(writer, "recordingVisible", obs_sceneitem_recording_visible(item));
+
+	obs_sceneitem_crop crop;
+	obs_sceneitem_get_crop(item, &crop);
+	size_t mark = writer.begin_object("crop", 4);
+	PutInt(writer, "left", crop.left);
+	PutInt(writer, "top", crop.top);
+	PutInt(writer, "right", crop.right);
+	PutInt(writer, "bottom", crop.bottom);
+	writer.end_object(mark);
+
+	PutInt(writer, "scaleFilter", obs_sceneitem_get_scale_filter(item));
+	PutInt(writer, "blendingMode", obs_sceneitem_get_blending_mode(item));
+	PutInt(writer, "blendingMethod", obs_sceneitem_get_blending_method(item));
+	PutInt(writer, "alignment", obs_sceneitem_get_alignment(item));
+	mark = writer.begin_object("bounds", 6);
+	PutDouble(writer, "x", bounds.x);
+	PutDouble(writer, "y", bounds.y);
+	writer.end_object(mark);
+	PutInt(writer, "boundsType", obs_sceneitem_get_bounds_type(item));
+	PutInt(writer, "boundsAlignment", obs_sceneitem_get_bounds_alignment(item));
+}
+
+struct SaveData {
+	settings::Writer *writer;
+	uint32_t count;
+	std::vector<obs_source_t *> groups;
+};
+
+static void SaveScene(SaveData *sd, obs_source_t *source)
+{
+	size_t mark = sd->writer->begin_element();
+	PutString(*sd->writer, "name", obs_source_get_name(source));
+	if (obs_source_is_group(source))
+		PutBool(*sd->writer, "group", true);
+
+	SaveData items = {sd->writer, 0};
+	auto item_cb = [](obs_scene_t *scene, obs_sceneitem_t *item, void *data) {
+		SaveData *items = reinterpret_cast<SaveData *>(data);
+		size_t mark = items->writer->begin_element();
+		SaveItem(*items->writer, item);
+		items->writer->end_element(mark);
+		items->count++;
+		return true;
+	};
+	size_t items_mark = sd->writer->begin_array("items", 5);
+	obs_scene_t *scene = obs_group_or_scene_from_source(source);
+	if (scene)
+		obs_scene_enum_items(scene, item_cb, &items);
+	sd->writer->end_array(items_mark, items.count);
+
+	sd->writer->end_element(mark);
+	sd->count++;
+}
+
+void osn::Collection::Save(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
+{
+	std::vector<char> buffer;
+	settings::Writer writer(buffer);
+
+	SaveData sd = {&writer, 0};
+	size_t mark = writer.begin_array("sources", 7);
+	// obs_enum_sources also reports groups, they are saved with the scenes so
+	// that Load recreates them with obs_group_create.
+	auto source_cb = [](void *data, obs_source_t *source) {
+		SaveData *sd = reinterpret_cast<SaveData *>(data);
+		if (obs_source_is_group(source)) {
+			sd->groups.push_back(obs_source_get_ref(source));
+			return true;
+		}
+		size_t mark = sd->writer->begin_element();
+		SaveSource(*sd->writer, source, false);
+		sd->writer->end_element(mark);
+		sd->count++;
+		return true;
+	};
+	obs_enum_sources(source_cb, &sd);
+	writer.end_array(mark, sd.count);
+
+	sd.count = 0;
+	mark = writer.begin_array("scenes", 6);
+	auto scene_cb = [](void *data, obs_source_t *source) {
+		SaveScene(reinterpret_cast<SaveData *>(data), source);
+		return true;
+	};
+	obs_enum_scenes(scene_cb, &sd);
+	for (obs_source_t *group : sd.groups) {
+		SaveScene(&sd, group);
+		obs_source_release(group);
+	}
+	writer.end_array(mark, sd.count);
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	rval.push_back(ipc::value(buffer));
+	AUTO_DEBUG;
+}
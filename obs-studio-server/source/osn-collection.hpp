@@ -0,0 +1,46 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#pragma once
+#include <ipc-server.hpp>
+
+namespace osn {
+// Loads and saves a whole scene collection in one call.
+//
+// Collections are settings objects in the format of settings-binary.hpp:
+//	sources: [{ name, type, settings, volume, muted, syncOffset: { sec, nsec },
+//	            audioMixers, deinterlaceMode, deinterlaceFieldOrder, enabled,
+//	            filters: [{ name, type, settings, enabled }] }]
+//	scenes: [{ name, items: [{ name, x, y, scaleX, scaleY, rotation, visible,
+//	           streamVisible, recordingVisible, crop: { left, top, right, bottom },
+//	           scaleFilter, blendingMode, blendingMethod, alignment,
+//	           bounds: { x, y }, boundsType, boundsAlignment }] }]
+// Only name and type are required, items refer to sources and scenes by name.
+//
+// Load answers with one entry per source and scene of the request, in order,
+// empty if it could not be created:
+//	sources: [{ id, name, type, settings, audioMixers, deinterlaceMode, deinterlaceFieldOrder }]
+//	scenes: [{ id, name, items: [{ id, obsId }] }]
+class Collection {
+public:
+	static void Register(ipc::server &);
+
+	static void Load(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
+	static void Save(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
+};
+}
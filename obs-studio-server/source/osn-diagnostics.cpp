@@ -0,0 +1,66 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#include "osn-diagnostics.hpp"
+#include "osn-error.hpp"
+#include "shared.hpp"
+#include "util-flightrecorder.h"
+#include "util-startuptimeline.h"
+
+void osn::Diagnostics::Register(ipc::server &srv)
+{
+	std::shared_ptr<ipc::collection> cls = std::make_shared<ipc::collection>("Diagnostics");
+	cls->register_function(std::make_shared<ipc::function>("GetIpcStats", std::vector<ipc::type>{}, GetIpcStats));
+	cls->register_function(std::make_shared<ipc::function>("GetStartupTimeline", std::vector<ipc::type>{}, GetStartupTimeline));
+	srv.register_collection(cls);
+}
+
+void osn::Diagnostics::GetIpcStats(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
+{
+	std::vector<util::FlightRecorder::CallStats> stats = util::FlightRecorder::Stats();
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	rval.reserve(1 + stats.size() * 7);
+	for (auto &call : stats) {
+		rval.push_back(ipc::value(call.call));
+		rval.push_back(ipc::value(call.calls));
+		rval.push_back(ipc::value(call.p50));
+		rval.push_back(ipc::value(call.p90));
+		rval.push_back(ipc::value(call.p99));
+		rval.push_back(ipc::value(call.max));
+		rval.push_back(ipc::value(call.mean));
+	}
+	AUTO_DEBUG;
+}
+
+// Per phase: String name, UInt64 start and duration in microseconds, UInt32
+// background.
+void osn::Diagnostics::GetStartupTimeline(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
+{
+	std::vector<util::StartupTimeline::Phase> phases = util::StartupTimeline::Phases();
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	rval.reserve(1 + phases.size() * 4);
+	for (auto &phase : phases) {
+		rval.push_back(ipc::value(phase.name));
+		rval.push_back(ipc::value(phase.start));
+		rval.push_back(ipc::value(phase.duration));
+		rval.push_back(ipc::value((uint32_t)phase.background));
+	}
+	AUTO_DEBUG;
+}
@@ -243,6 +243,11 @@ void osn::IFileOutput::GetLastFile(void *data, const int64_t id, const std::vect
 	calldata_free(&cd);
 }
 
+uint64_t osn::FileOutput::GetSignalsId()
+{
+	return osn::IFileOutput::Manager::GetInstance().find(this);
+}
+
 osn::IFileOutput::Manager &osn::IFileOutput::Manager::GetInstance()
 {
 	static osn::IFileOutput::Manager _inst;
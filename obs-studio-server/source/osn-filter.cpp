@@ -23,6 +23,7 @@
 #include "osn-error.hpp"
 #include "osn-source.hpp"
 #include "shared.hpp"
+#include "util-modulemanifest.h"
 
 void osn::Filter::Register(ipc::server &srv)
 {
@@ -37,10 +38,8 @@ void osn::Filter::Register(ipc::server &srv)
 void osn::Filter::Types(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
 {
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
-	const char *typeId = nullptr;
-	for (size_t idx = 0; obs_enum_filter_types(idx, &typeId); idx++) {
-		rval.push_back(ipc::value(typeId ? typeId : ""));
-	}
+	for (const auto &typeId : util::ModuleManifest::FilterTypes())
+		rval.push_back(ipc::value(typeId));
 	AUTO_DEBUG;
 }
 
@@ -58,6 +57,7 @@ void osn::Filter::Create(void *data, const int64_t id, const std::vector<ipc::va
 		break;
 	}
 
+	util::ModuleManifest::LoadSourceType(sourceId);
 	obs_source_t *source = obs_source_create_private(sourceId.c_str(), name.c_str(), settings);
 	if (!source) {
 		PRETTY_ERROR_RETURN(ErrorCode::Error, "Failed to create filter.");
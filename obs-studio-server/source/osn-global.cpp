@@ -21,6 +21,7 @@
 #include <obs.h>
 #include "osn-source.hpp"
 #include "shared.hpp"
+#include "util-modulemanifest.h"
 
 void osn::Global::Register(ipc::server &srv)
 {
@@ -126,6 +127,7 @@ void osn::Global::RemoveSceneFromBackstage(void *data, const int64_t id, const s
 
 void osn::Global::GetOutputFlagsFromId(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
 {
+	util::ModuleManifest::LoadSourceType(args[0].value_str);
 	uint32_t flags = obs_get_source_output_flags(args[0].value_str.c_str());
 
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
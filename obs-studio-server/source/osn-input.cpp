@@ -24,6 +24,7 @@
 #include "osn-error.hpp"
 #include "osn-source.hpp"
 #include "shared.hpp"
+#include "util-modulemanifest.h"
 
 void osn::Input::Register(ipc::server &srv)
 {
@@ -31,11 +32,11 @@ void osn::Input::Register(ipc::server &srv)
 	cls->register_function(std::make_shared<ipc::function>("Types", std::vector<ipc::type>{}, Types));
 	cls->register_function(std::make_shared<ipc::function>("Create", std::vector<ipc::type>{ipc::type::String, ipc::type::String}, Create));
 	cls->register_function(
-		std::make_shared<ipc::function>("Create", std::vector<ipc::type>{ipc::type::String, ipc::type::String, ipc::type::String}, Create));
+		std::make_shared<ipc::function>("Create", std::vector<ipc::type>{ipc::type::String, ipc::type::String, ipc::type::Binary}, Create));
 	cls->register_function(std::make_shared<ipc::function>(
-		"Create", std::vector<ipc::type>{ipc::type::String, ipc::type::String, ipc::type::String, ipc::type::String}, Create));
+		"Create", std::vector<ipc::type>{ipc::type::String, ipc::type::String, ipc::type::Binary, ipc::type::String}, Create));
 	cls->register_function(std::make_shared<ipc::function>("CreatePrivate", std::vector<ipc::type>{ipc::type::String, ipc::type::String}, CreatePrivate));
-	cls->register_function(std::make_shared<ipc::function>("CreatePrivate", std::vector<ipc::type>{ipc::type::String, ipc::type::String, ipc::type::String},
+	cls->register_function(std::make_shared<ipc::function>("CreatePrivate", std::vector<ipc::type>{ipc::type::String, ipc::type::String, ipc::type::Binary},
 							       CreatePrivate));
 	cls->register_function(std::make_shared<ipc::function>("FromName", std::vector<ipc::type>{ipc::type::String}, FromName));
 	cls->register_function(std::make_shared<ipc::function>("GetPublicSources", std::vector<ipc::type>{}, GetPublicSources));
@@ -88,10 +89,8 @@ void osn::Input::Register(ipc::server &srv)
 void osn::Input::Types(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
 {
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
-	const char *typeId = nullptr;
-	for (size_t idx = 0; obs_enum_input_types(idx, &typeId); idx++) {
-		rval.push_back(ipc::value(typeId ? typeId : ""));
-	}
+	for (const auto &typeId : util::ModuleManifest::InputTypes())
+		rval.push_back(ipc::value(typeId));
 	AUTO_DEBUG;
 }
 
@@ -104,13 +103,18 @@ void osn::Input::Create(void *data, const int64_t id, const std::vector<ipc::val
 	case 4:
 		hotkeys = obs_data_create_from_json(args[3].value_str.c_str());
 	case 3:
-		settings = obs_data_create_from_json(args[2].value_str.c_str());
+		settings = osn::Source::SettingsFromBinary(args[2].value_bin);
+		if (!settings) {
+			obs_data_release(hotkeys);
+			PRETTY_ERROR_RETURN(ErrorCode::OutOfBounds, "Settings are malformed.");
+		}
 	case 2:
 		name = args[1].value_str;
 		sourceId = args[0].value_str;
 		break;
 	}
 
+	util::ModuleManifest::LoadSourceType(sourceId);
 	obs_source_t *source = obs_source_create(sourceId.c_str(), name.c_str(), settings, hotkeys);
 	obs_data_release(hotkeys);
 	obs_data_release(settings);
@@ -127,7 +131,7 @@ void osn::Input::Create(void *data, const int64_t id, const std::vector<ipc::val
 
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
 	rval.push_back(ipc::value(uid));
-	rval.push_back(ipc::value(obs_data_get_full_json(settingsSource)));
+	rval.push_back(ipc::value(osn::Source::SettingsToBinary(settingsSource)));
 	rval.push_back(ipc::value(obs_source_get_audio_mixers(source)));
 	rval.push_back(ipc::value((uint32_t)obs_source_get_deinterlace_mode(source)));
 	rval.push_back(ipc::value((uint32_t)obs_source_get_deinterlace_field_order(source)));
@@ -143,13 +147,17 @@ void osn::Input::CreatePrivate(void *data, const int64_t id, const std::vector<i
 
 	switch (args.size()) {
 	case 3:
-		settings = obs_data_create_from_json(args[2].value_str.c_str());
+		settings = osn::Source::SettingsFromBinary(args[2].value_bin);
+		if (!settings) {
+			PRETTY_ERROR_RETURN(ErrorCode::OutOfBounds, "Settings are malformed.");
+		}
 	case 2:
 		name = args[1].value_str;
 		sourceId = args[0].value_str;
 		break;
 	}
 
+	util::ModuleManifest::LoadSourceType(sourceId);
 	obs_source_t *source = obs_source_create_private(sourceId.c_str(), name.c_str(), settings);
 	if (!source) {
 		PRETTY_ERROR_RETURN(ErrorCode::Error, "Failed to create input.");
@@ -162,9 +170,16 @@ void osn::Input::CreatePrivate(void *data, const int64_t id, const std::vector<i
 		PRETTY_ERROR_RETURN(ErrorCode::CriticalError, "Index list is full.");
 	}
 	osn::Source::attach_source_signals(source);
+	obs_data_t *settingsSource = obs_source_get_settings(source);
 
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
 	rval.push_back(ipc::value(uid));
+	rval.push_back(ipc::value(osn::Source::SettingsToBinary(settingsSource)));
+	rval.push_back(ipc::value(obs_source_get_audio_mixers(source)));
+	rval.push_back(ipc::value((uint32_t)obs_source_get_deinterlace_mode(source)));
+	rval.push_back(ipc::value((uint32_t)obs_source_get_deinterlace_field_order(source)));
+
+	obs_data_release(settingsSource);
 	AUTO_DEBUG;
 }
 
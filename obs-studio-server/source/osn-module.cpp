@@ -19,6 +19,7 @@
 #include "osn-module.hpp"
 #include "osn-error.hpp"
 #include "shared.hpp"
+#include "util-modulemanifest.h"
 
 void osn::Module::Register(ipc::server &srv)
 {
@@ -72,6 +73,10 @@ void osn::Module::Modules(void *data, const int64_t id, const std::vector<ipc::v
 		},
 		&modules);
 
+	// Modules that are loaded once one of their sources is created
+	for (const auto &name : util::ModuleManifest::PendingModules())
+		modules.push_back(name);
+
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
 	rval.push_back(ipc::value((uint64_t)modules.size()));
 
@@ -18,6 +18,7 @@
 
 #include "osn-output-signals.hpp"
 #include "nodeobs_api.h"
+#include "callback-manager.h"
 
 void osn::OutputSignals::createOutput(const std::string &type, const std::string &name)
 {
@@ -65,8 +66,16 @@ static void callback(void *data, calldata_t *params)
 
 	const char *error = obs_output_get_last_error(outputClass->output);
 
-	std::unique_lock<std::mutex> ulock(outputClass->signalsMtx);
-	outputClass->signalsReceived.push({signal, (int)calldata_int(params, "code"), error ? std::string(error) : ""});
+	outputClass->PushSignal({signal, (int)calldata_int(params, "code"), error ? std::string(error) : ""});
+}
+
+void osn::OutputSignals::PushSignal(const signalInfo &info)
+{
+	uint64_t uid = GetSignalsId();
+	if (uid == UINT64_MAX)
+		return;
+
+	CallbackManager::NotifyOutputSignal(uid, signalsType, info.signal, info.code, info.errorMessage);
 }
 
 void osn::OutputSignals::ConnectSignals()
@@ -111,6 +120,5 @@ void osn::OutputSignals::startOutput()
 		code = OBS_OUTPUT_ERROR;
 	}
 
-	std::unique_lock<std::mutex> ulock(signalsMtx);
-	signalsReceived.push({"stop", code, errorMessage});
+	PushSignal({"stop", code, errorMessage});
 }
\ No newline at end of file
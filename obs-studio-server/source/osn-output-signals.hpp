@@ -18,8 +18,9 @@
 
 #pragma once
 #include <obs.h>
+#include <condition_variable>
 #include <mutex>
-#include <queue>
+#include <string>
 #include <vector>
 
 namespace osn {
@@ -39,13 +40,17 @@ public:
 	virtual ~OutputSignals() {}
 
 public:
-	std::mutex signalsMtx;
-	std::queue<signalInfo> signalsReceived;
 	std::vector<std::string> signals;
+	// Sent with every signal, tells the client which kind of output raised it.
+	std::string signalsType;
 	obs_output_t *output;
 	obs_video_info *canvas;
 
 	void ConnectSignals();
+	// Forwards a signal to the client through the event channel.
+	void PushSignal(const signalInfo &info);
+	// Id of the output in its manager, the client registers its callback under it.
+	virtual uint64_t GetSignalsId() { return UINT64_MAX; }
 
 public:
 	std::condition_variable cvStop;
@@ -61,32 +61,6 @@ void osn::IRecording::SetVideoEncoder(void *data, const int64_t id, const std::v
 	AUTO_DEBUG;
 }
 
-void osn::IRecording::Query(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
-{
-	Recording *recording = static_cast<Recording *>(osn::IFileOutput::Manager::GetInstance().find(args[0].value_union.ui64));
-	if (!recording) {
-		PRETTY_ERROR_RETURN(ErrorCode::InvalidReference, "Recording reference is not valid.");
-	}
-
-	std::unique_lock<std::mutex> ulock(recording->signalsMtx);
-	if (recording->signalsReceived.empty()) {
-		rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
-		AUTO_DEBUG;
-		return;
-	}
-
-	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
-
-	auto signal = recording->signalsReceived.front();
-	rval.push_back(ipc::value("recording"));
-	rval.push_back(ipc::value(signal.signal));
-	rval.push_back(ipc::value(signal.code));
-	rval.push_back(ipc::value(signal.errorMessage));
-
-	recording->signalsReceived.pop();
-
-	AUTO_DEBUG;
-}
 
 std::string osn::IRecording::GenerateSpecifiedFilename(const std::string &extension, bool noSpace, const std::string &format, int width, int height)
 {
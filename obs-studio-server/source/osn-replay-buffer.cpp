@@ -127,32 +127,6 @@ void osn::IReplayBuffer::SetUsesStream(void *data, const int64_t id, const std::
 	AUTO_DEBUG;
 }
 
-void osn::IReplayBuffer::Query(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
-{
-	ReplayBuffer *replayBuffer = static_cast<ReplayBuffer *>(osn::IFileOutput::Manager::GetInstance().find(args[0].value_union.ui64));
-	if (!replayBuffer) {
-		PRETTY_ERROR_RETURN(ErrorCode::InvalidReference, "ReplayBuffer reference is not valid.");
-	}
-
-	std::unique_lock<std::mutex> ulock(replayBuffer->signalsMtx);
-	if (replayBuffer->signalsReceived.empty()) {
-		rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
-		AUTO_DEBUG;
-		return;
-	}
-
-	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
-
-	auto signal = replayBuffer->signalsReceived.front();
-	rval.push_back(ipc::value("replay-buffer"));
-	rval.push_back(ipc::value(signal.signal));
-	rval.push_back(ipc::value(signal.code));
-	rval.push_back(ipc::value(signal.errorMessage));
-
-	replayBuffer->signalsReceived.pop();
-
-	AUTO_DEBUG;
-}
 
 void osn::IReplayBuffer::Save(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
 {
@@ -32,6 +32,7 @@ public:
 		suffix = "";
 		usesStream = false;
 		signals = {"start", "stop", "stopping", "writing", "wrote", "writing_error"};
+		signalsType = "replay-buffer";
 	}
 	virtual ~ReplayBuffer();
 
@@ -52,7 +53,6 @@ public:
 	static void SetSuffix(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
 	static void GetUsesStream(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
 	static void SetUsesStream(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
-	static void Query(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
 	static void Save(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
 };
 }
@@ -21,6 +21,7 @@
 #include "osn-error.hpp"
 #include "osn-sceneitem.hpp"
 #include "osn-video.hpp"
+#include "sceneitem-batch.hpp"
 #include "shared.hpp"
 
 void osn::Scene::Register(ipc::server &srv)
@@ -63,6 +64,48 @@ void osn::Scene::Register(ipc::server &srv)
 	srv.register_collection(cls);
 }
 
+// Items from back to front, from and to are inclusive.
+static std::vector<obs_sceneitem_t *> EnumItems(obs_scene_t *scene, size_t from = 0, size_t to = SIZE_MAX)
+{
+	struct EnumData {
+		std::vector<obs_sceneitem_t *> items;
+		size_t index_from = 0, index_to = 0;
+		size_t index = 0;
+	} ed;
+	ed.index_from = from;
+	ed.index_to = to;
+
+	auto cb = [](obs_scene_t *scene, obs_sceneitem_t *item, void *data) {
+		EnumData *ed = reinterpret_cast<EnumData *>(data);
+		if (ed->index > ed->index_to)
+			return false;
+		if (ed->index >= ed->index_from)
+			ed->items.push_back(item);
+		ed->index++;
+		return true;
+	};
+	obs_scene_enum_items(scene, cb, &ed);
+	return std::move(ed.items);
+}
+
+// Resolves all ids under a single manager lock, items seen for the first time
+// are registered and kept alive like in FindItemByName.
+static bool PackItems(const std::vector<obs_sceneitem_t *> &items, std::vector<char> &buffer)
+{
+	std::vector<utility::unique_id::id_t> uids(items.size());
+	osn::SceneItem::Manager::GetInstance().find_or_allocate(items.data(), items.size(), uids.data(),
+								  [](obs_sceneitem_t *item) { obs_sceneitem_addref(item); });
+
+	buffer.reserve(items.size() * sizeof(sceneitem::ItemRef));
+	sceneitem::BatchWriter writer(buffer);
+	for (size_t i = 0; i < items.size(); i++) {
+		if (uids[i] == UINT64_MAX)
+			return false;
+		writer.put(sceneitem::ItemRef{uids[i], obs_sceneitem_get_id(items[i])});
+	}
+	return true;
+}
+
 void osn::Scene::Create(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
 {
 	obs_scene_t *scene = obs_scene_create(args[0].value_str.c_str());
@@ -386,28 +429,13 @@ void osn::Scene::OrderItems(void *data, const int64_t id, const std::vector<ipc:
 
 	obs_scene_set_items_order(scene, (int64_t *)new_items_order.data(), items_count);
 
-	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
-
-	std::list<obs_sceneitem_t *> items;
-	auto cb_items = [](obs_scene_t *scene, obs_sceneitem_t *item, void *data) {
-		std::list<obs_sceneitem_t *> *items = reinterpret_cast<std::list<obs_sceneitem_t *> *>(data);
-		items->push_back(item);
-		return true;
-	};
-	obs_scene_enum_items(scene, cb_items, &items);
-
-	for (obs_sceneitem_t *item : items) {
-		utility::unique_id::id_t uid = osn::SceneItem::Manager::GetInstance().find(item);
-		if (uid == UINT64_MAX) {
-			uid = osn::SceneItem::Manager::GetInstance().allocate(item);
-			if (uid == UINT64_MAX) {
-				PRETTY_ERROR_RETURN(ErrorCode::CriticalError, "Index list is full.");
-			}
-			obs_sceneitem_addref(item);
-		}
-		rval.push_back(ipc::value((uint64_t)uid));
-		rval.push_back(ipc::value(obs_sceneitem_get_id(item)));
+	std::vector<char> buffer;
+	if (!PackItems(EnumItems(scene), buffer)) {
+		PRETTY_ERROR_RETURN(ErrorCode::CriticalError, "Index list is full.");
 	}
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	rval.push_back(ipc::value(buffer));
 	AUTO_DEBUG;
 }
 
@@ -460,28 +488,13 @@ void osn::Scene::MoveItem(void *data, const int64_t id, const std::vector<ipc::v
 
 	obs_sceneitem_set_order_position(ed.item, (int(num_items) - 1) - args[2].value_union.i32);
 
-	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
-
-	std::list<obs_sceneitem_t *> items;
-	auto cb_items = [](obs_scene_t *scene, obs_sceneitem_t *item, void *data) {
-		std::list<obs_sceneitem_t *> *items = reinterpret_cast<std::list<obs_sceneitem_t *> *>(data);
-		items->push_back(item);
-		return true;
-	};
-	obs_scene_enum_items(scene, cb_items, &items);
-
-	for (obs_sceneitem_t *item : items) {
-		utility::unique_id::id_t uid = osn::SceneItem::Manager::GetInstance().find(item);
-		if (uid == UINT64_MAX) {
-			uid = osn::SceneItem::Manager::GetInstance().allocate(item);
-			if (uid == UINT64_MAX) {
-				PRETTY_ERROR_RETURN(ErrorCode::CriticalError, "Index list is full.");
-			}
-			obs_sceneitem_addref(item);
-		}
-		rval.push_back(ipc::value((uint64_t)uid));
-		rval.push_back(ipc::value(obs_sceneitem_get_id(item)));
+	std::vector<char> buffer;
+	if (!PackItems(EnumItems(scene), buffer)) {
+		PRETTY_ERROR_RETURN(ErrorCode::CriticalError, "Index list is full.");
 	}
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	rval.push_back(ipc::value(buffer));
 	AUTO_DEBUG;
 }
 
@@ -545,27 +558,13 @@ void osn::Scene::GetItems(void *data, const int64_t id, const std::vector<ipc::v
 		PRETTY_ERROR_RETURN(ErrorCode::InvalidReference, "Source reference is not a scene.");
 	}
 
-	std::list<obs_sceneitem_t *> items;
-	auto cb = [](obs_scene_t *scene, obs_sceneitem_t *item, void *data) {
-		std::list<obs_sceneitem_t *> *items = reinterpret_cast<std::list<obs_sceneitem_t *> *>(data);
-		items->push_back(item);
-		return true;
-	};
-	obs_scene_enum_items(scene, cb, &items);
+	std::vector<char> buffer;
+	if (!PackItems(EnumItems(scene), buffer)) {
+		PRETTY_ERROR_RETURN(ErrorCode::CriticalError, "Index list is full.");
+	}
 
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
-	for (obs_sceneitem_t *item : items) {
-		utility::unique_id::id_t uid = osn::SceneItem::Manager::GetInstance().find(item);
-		if (uid == UINT64_MAX) {
-			uid = osn::SceneItem::Manager::GetInstance().allocate(item);
-			if (uid == UINT64_MAX) {
-				PRETTY_ERROR_RETURN(ErrorCode::CriticalError, "Index list is full.");
-			}
-			obs_sceneitem_addref(item);
-		}
-		rval.push_back(ipc::value((uint64_t)uid));
-		rval.push_back(ipc::value(obs_sceneitem_get_id(item)));
-	}
+	rval.push_back(ipc::value(buffer));
 	AUTO_DEBUG;
 }
 
@@ -581,38 +580,19 @@ void osn::Scene::GetItemsInRange(void *data, const int64_t id, const std::vector
 		PRETTY_ERROR_RETURN(ErrorCode::InvalidReference, "Source reference is not a scene.");
 	}
 
-	struct EnumData {
-		std::list<obs_sceneitem_t *> items;
-		size_t index_from = 0, index_to = 0;
-		size_t index = 0;
-	} ed;
-	ed.index_from = args[1].value_union.ui64;
-	ed.index_to = args[1].value_union.ui64;
+	int32_t from = args[1].value_union.i32;
+	int32_t to = args[2].value_union.i32;
+	if (from < 0 || to < from) {
+		PRETTY_ERROR_RETURN(ErrorCode::OutOfBounds, "Invalid item range.");
+	}
 
-	auto cb = [](obs_scene_t *scene, obs_sceneitem_t *item, void *data) {
-		EnumData *ed = reinterpret_cast<EnumData *>(data);
-		if ((ed->index >= ed->index_from) && (ed->index <= ed->index_to)) {
-			ed->items.push_back(item);
-		} else if (ed->index > ed->index_to) {
-			return false;
-		}
-		ed->index++;
-		return true;
-	};
-	obs_scene_enum_items(scene, cb, &ed);
+	std::vector<char> buffer;
+	if (!PackItems(EnumItems(scene, size_t(from), size_t(to)), buffer)) {
+		PRETTY_ERROR_RETURN(ErrorCode::CriticalError, "Index list is full.");
+	}
 
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
-	for (obs_sceneitem_t *item : ed.items) {
-		utility::unique_id::id_t uid = osn::SceneItem::Manager::GetInstance().find(item);
-		if (uid == UINT64_MAX) {
-			uid = osn::SceneItem::Manager::GetInstance().allocate(item);
-			if (uid == UINT64_MAX) {
-				PRETTY_ERROR_RETURN(ErrorCode::CriticalError, "Index list is full.");
-			}
-			obs_sceneitem_addref(item);
-		}
-		rval.push_back(ipc::value((uint64_t)uid));
-	}
+	rval.push_back(ipc::value(buffer));
 	AUTO_DEBUG;
 }
 
@@ -21,6 +21,7 @@
 #include "osn-source.hpp"
 #include "shared.hpp"
 #include <osn-video.hpp>
+#include <sceneitem-batch.hpp>
 
 void osn::SceneItem::Register(ipc::server &srv)
 {
@@ -87,6 +88,8 @@ void osn::SceneItem::Register(ipc::server &srv)
 	cls->register_function(std::make_shared<ipc::function>("GetBlendingMode", std::vector<ipc::type>{ipc::type::UInt64}, GetBlendingMode));
 	cls->register_function(
 		std::make_shared<ipc::function>("SetBlendingMode", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::UInt32}, SetBlendingMode));
+	cls->register_function(std::make_shared<ipc::function>("BatchGet", std::vector<ipc::type>{ipc::type::Binary, ipc::type::UInt32}, BatchGet));
+	cls->register_function(std::make_shared<ipc::function>("BatchSet", std::vector<ipc::type>{ipc::type::Binary}, BatchSet));
 	srv.register_collection(cls);
 }
 
@@ -793,4 +796,232 @@ void osn::SceneItem::SetBlendingMode(void *data, const int64_t id, const std::ve
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
 	rval.push_back(ipc::value(type));
 	AUTO_DEBUG;
-}
\ No newline at end of file
+}
+static void WriteItemFields(sceneitem::BatchWriter &writer, obs_sceneitem_t *item, uint32_t mask)
+{
+	if (mask & sceneitem::Visible)
+		writer.put<uint8_t>(obs_sceneitem_visible(item));
+	if (mask & sceneitem::Selected)
+		writer.put<uint8_t>(obs_sceneitem_selected(item));
+	if (mask & sceneitem::StreamVisible)
+		writer.put<uint8_t>(obs_sceneitem_stream_visible(item));
+	if (mask & sceneitem::RecordingVisible)
+		writer.put<uint8_t>(obs_sceneitem_recording_visible(item));
+	if (mask & sceneitem::Position) {
+		vec2 pos;
+		obs_sceneitem_get_pos(item, &pos);
+		writer.put<float>(pos.x);
+		writer.put<float>(pos.y);
+	}
+	if (mask & sceneitem::Rotation)
+		writer.put<float>(obs_sceneitem_get_rot(item));
+	if (mask & sceneitem::Scale) {
+		vec2 scale;
+		obs_sceneitem_get_scale(item, &scale);
+		writer.put<float>(scale.x);
+		writer.put<float>(scale.y);
+	}
+	if (mask & sceneitem::Alignment)
+		writer.put<uint32_t>(obs_sceneitem_get_alignment(item));
+	if (mask & sceneitem::Bounds) {
+		vec2 bounds;
+		obs_sceneitem_get_bounds(item, &bounds);
+		writer.put<float>(bounds.x);
+		writer.put<float>(bounds.y);
+	}
+	if (mask & sceneitem::BoundsAlignment)
+		writer.put<uint32_t>(obs_sceneitem_get_bounds_alignment(item));
+	if (mask & sceneitem::BoundsType)
+		writer.put<uint32_t>(obs_sceneitem_get_bounds_type(item));
+	if (mask & sceneitem::Crop) {
+		obs_sceneitem_crop crop;
+		obs_sceneitem_get_crop(item, &crop);
+		writer.put<int32_t>(crop.left);
+		writer.put<int32_t>(crop.top);
+		writer.put<int32_t>(crop.right);
+		writer.put<int32_t>(crop.bottom);
+	}
+	if (mask & sceneitem::ScaleFilter)
+		writer.put<uint32_t>(obs_sceneitem_get_scale_filter(item));
+	if (mask & sceneitem::BlendingMethod)
+		writer.put<uint32_t>(obs_sceneitem_get_blending_method(item));
+	if (mask & sceneitem::BlendingMode)
+		writer.put<uint32_t>(obs_sceneitem_get_blending_mode(item));
+	if (mask & sceneitem::ObsId)
+		writer.put<int64_t>(obs_sceneitem_get_id(item));
+}
+
+// Reads the masked fields of one record and applies them to item, unless item
+// is null in which case the values are only skipped.
+static bool ApplyItemFields(sceneitem::BatchReader &reader, obs_sceneitem_t *item, uint32_t mask)
+{
+	uint8_t flag;
+	float x, y;
+	uint32_t value;
+
+	if (mask & sceneitem::Visible) {
+		if (!reader.get(flag))
+			return false;
+		if (item)
+			obs_sceneitem_set_visible(item, !!flag);
+	}
+	if (mask & sceneitem::Selected) {
+		if (!reader.get(flag))
+			return false;
+		if (item)
+			obs_sceneitem_select(item, !!flag);
+	}
+	if (mask & sceneitem::StreamVisible) {
+		if (!reader.get(flag))
+			return false;
+		if (item)
+			obs_sceneitem_set_stream_visible(item, !!flag);
+	}
+	if (mask & sceneitem::RecordingVisible) {
+		if (!reader.get(flag))
+			return false;
+		if (item)
+			obs_sceneitem_set_recording_visible(item, !!flag);
+	}
+	if (mask & sceneitem::Position) {
+		if (!reader.get(x) || !reader.get(y))
+			return false;
+		vec2 pos = {x, y};
+		if (item)
+			obs_sceneitem_set_pos(item, &pos);
+	}
+	if (mask & sceneitem::Rotation) {
+		if (!reader.get(x))
+			return false;
+		if (item)
+			obs_sceneitem_set_rot(item, x);
+	}
+	if (mask & sceneitem::Scale) {
+		if (!reader.get(x) || !reader.get(y))
+			return false;
+		vec2 scale = {x, y};
+		if (item)
+			obs_sceneitem_set_scale(item, &scale);
+	}
+	if (mask & sceneitem::Alignment) {
+		if (!reader.get(value))
+			return false;
+		if (item)
+			obs_sceneitem_set_alignment(item, value);
+	}
+	if (mask & sceneitem::Bounds) {
+		if (!reader.get(x) || !reader.get(y))
+			return false;
+		vec2 bounds = {x, y};
+		if (item)
+			obs_sceneitem_set_bounds(item, &bounds);
+	}
+	if (mask & sceneitem::BoundsAlignment) {
+		if (!reader.get(value))
+			return false;
+		if (item)
+			obs_sceneitem_set_bounds_alignment(item, value);
+	}
+	if (mask & sceneitem::BoundsType) {
+		if (!reader.get(value))
+			return false;
+		if (item)
+			obs_sceneitem_set_bounds_type(item, (obs_bounds_type)value);
+	}
+	if (mask & sceneitem::Crop) {
+		obs_sceneitem_crop crop;
+		if (!reader.get(crop.left) || !reader.get(crop.top) || !reader.get(crop.right) || !reader.get(crop.bottom))
+			return false;
+		if (item)
+			obs_sceneitem_set_crop(item, &crop);
+	}
+	if (mask & sceneitem::ScaleFilter) {
+		if (!reader.get(value))
+			return false;
+		if (item)
+			obs_sceneitem_set_scale_filter(item, (obs_scale_type)value);
+	}
+	if (mask & sceneitem::BlendingMethod) {
+		if (!reader.get(value))
+			return false;
+		if (item)
+			obs_sceneitem_set_blending_method(item, (obs_blending_method)value);
+	}
+	if (mask & sceneitem::BlendingMode) {
+		if (!reader.get(value))
+			return false;
+		if (item)
+			obs_sceneitem_set_blending_mode(item, (obs_blending_type)value);
+	}
+
+	return true;
+}
+
+void osn::SceneItem::BatchGet(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
+{
+	const std::vector<char> &ids = args[0].value_bin;
+	uint32_t mask = args[1].value_union.ui32 & sceneitem::AllFields;
+
+	if (ids.size() % sizeof(uint64_t) != 0) {
+		PRETTY_ERROR_RETURN(ErrorCode::OutOfBounds, "Item id list is malformed.");
+	}
+
+	std::vector<char> buffer;
+	sceneitem::BatchWriter writer(buffer);
+	sceneitem::BatchReader reader(ids);
+
+	uint64_t uid;
+	while (reader.get(uid)) {
+		obs_sceneitem_t *item = osn::SceneItem::Manager::GetInstance().find(uid);
+		writer.put<uint64_t>(uid);
+		writer.put<uint8_t>(item != nullptr);
+		if (item)
+			WriteItemFields(writer, item, mask);
+	}
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	rval.push_back(ipc::value(buffer));
+	AUTO_DEBUG;
+}
+
+void osn::SceneItem::BatchSet(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
+{
+	const std::vector<char> &payload = args[0].value_bin;
+	uint64_t uid;
+	uint32_t mask;
+
+	// Walk the whole payload without an item first so a truncated record
+	// late in the batch cannot leave the earlier items half applied.
+	sceneitem::BatchReader validator(payload);
+	while (validator.get(uid)) {
+		if (!validator.get(mask) || !ApplyItemFields(validator, nullptr, mask & sceneitem::WritableFields)) {
+			PRETTY_ERROR_RETURN(ErrorCode::OutOfBounds, "Item batch is malformed.");
+		}
+	}
+
+	sceneitem::BatchReader reader(payload);
+	std::vector<obs_sceneitem_t *> deferred;
+	uint32_t invalid = 0;
+
+	while (reader.get(uid)) {
+		reader.get(mask);
+
+		obs_sceneitem_t *item = osn::SceneItem::Manager::GetInstance().find(uid);
+		if (!item) {
+			invalid++;
+		} else {
+			// Hold the transform update until every record is applied.
+			obs_sceneitem_defer_update_begin(item);
+			deferred.push_back(item);
+		}
+
+		ApplyItemFields(reader, item, mask & sceneitem::WritableFields);
+	}
+
+	for (obs_sceneitem_t *item : deferred)
+		obs_sceneitem_defer_update_end(item);
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	rval.push_back(ipc::value(invalid));
+	AUTO_DEBUG;
+}
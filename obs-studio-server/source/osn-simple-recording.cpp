@@ -39,7 +39,6 @@ void osn::ISimpleRecording::Register(ipc::server &srv)
 	cls->register_function(std::make_shared<ipc::function>("SetQuality", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::UInt32}, SetQuality));
 	cls->register_function(std::make_shared<ipc::function>("Start", std::vector<ipc::type>{ipc::type::UInt64}, Start));
 	cls->register_function(std::make_shared<ipc::function>("Stop", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::UInt32}, Stop));
-	cls->register_function(std::make_shared<ipc::function>("Query", std::vector<ipc::type>{ipc::type::UInt64}, Query));
 	cls->register_function(std::make_shared<ipc::function>("GetLowCPU", std::vector<ipc::type>{ipc::type::UInt64}, GetLowCPU));
 	cls->register_function(std::make_shared<ipc::function>("SetLowCPU", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::UInt32}, SetLowCPU));
 	cls->register_function(std::make_shared<ipc::function>("GetLegacySettings", std::vector<ipc::type>{}, GetLegacySettings));
@@ -26,11 +26,13 @@
 #include <obs-data.h>
 #include <obs.h>
 #include <obs.hpp>
+#include "obs-property.hpp"
 #include "osn-error.hpp"
 #include "osn-common.hpp"
 #include "shared.hpp"
 #include "callback-manager.h"
 #include "memory-manager.h"
+#include "settings-binary.hpp"
 
 void osn::Source::initialize_global_signals()
 {
@@ -46,6 +48,9 @@ void osn::Source::finalize_global_signals()
 	signal_handler_disconnect(sh, "source_create", osn::Source::global_source_create_cb, nullptr);
 }
 
+// Scene signals after which the items cached by the client may be stale.
+static const char *scene_change_signals[] = {"item_add", "item_remove", "reorder", "refresh", "item_visible"};
+
 void osn::Source::attach_source_signals(obs_source_t *src)
 {
 	signal_handler_t *sh = obs_source_get_signal_handler(src);
@@ -53,6 +58,11 @@ void osn::Source::attach_source_signals(obs_source_t *src)
 		return;
 	signal_handler_connect(sh, "destroy", osn::Source::global_source_destroy_cb, nullptr);
 	signal_handler_connect(sh, "remove", osn::Source::global_source_remove_cb, nullptr);
+
+	if (obs_source_get_type(src) == OBS_SOURCE_TYPE_SCENE) {
+		for (const char *signal : scene_change_signals)
+			signal_handler_connect(sh, signal, osn::Source::global_scene_changed_cb, nullptr);
+	}
 }
 
 void osn::Source::detach_source_signals(obs_source_t *src)
@@ -62,6 +72,11 @@ void osn::Source::detach_source_signals(obs_source_t *src)
 		return;
 	signal_handler_disconnect(sh, "remove", osn::Source::global_source_remove_cb, nullptr);
 	signal_handler_disconnect(sh, "destroy", osn::Source::global_source_destroy_cb, nullptr);
+
+	if (obs_source_get_type(src) == OBS_SOURCE_TYPE_SCENE) {
+		for (const char *signal : scene_change_signals)
+			signal_handler_disconnect(sh, signal, osn::Source::global_scene_changed_cb, nullptr);
+	}
 }
 
 void osn::Source::global_source_create_cb(void *ptr, calldata_t *cd)
@@ -107,6 +122,17 @@ void osn::Source::global_source_destroy_cb(void *ptr, calldata_t *cd)
 	osn::Source::Manager::GetInstance().free(source);
 }
 
+void osn::Source::global_scene_changed_cb(void *ptr, calldata_t *cd)
+{
+	obs_scene_t *scene = nullptr;
+	if (!calldata_get_ptr(cd, "scene", &scene) || !scene)
+		return;
+
+	uint64_t uid = osn::Source::Manager::GetInstance().find(obs_scene_get_source(scene));
+	if (uid != UINT64_MAX)
+		CallbackManager::NotifySceneChanged(uid);
+}
+
 void osn::Source::global_source_remove_cb(void *ptr, calldata_t *cd)
 {
 	obs_source_t *source = nullptr;
@@ -128,10 +154,12 @@ void osn::Source::Register(ipc::server &srv)
 	cls->register_function(std::make_shared<ipc::function>("Release", std::vector<ipc::type>{ipc::type::UInt64}, Release));
 	cls->register_function(std::make_shared<ipc::function>("IsConfigurable", std::vector<ipc::type>{ipc::type::UInt64}, IsConfigurable));
 	cls->register_function(std::make_shared<ipc::function>("GetProperties", std::vector<ipc::type>{ipc::type::UInt64}, GetProperties));
+	cls->register_function(std::make_shared<ipc::function>("GetPropertiesSnapshot", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::Binary}, GetPropertiesSnapshot));
 	cls->register_function(std::make_shared<ipc::function>("GetSettings", std::vector<ipc::type>{ipc::type::UInt64}, GetSettings));
 	cls->register_function(std::make_shared<ipc::function>("Load", std::vector<ipc::type>{ipc::type::UInt64}, Load));
 	cls->register_function(std::make_shared<ipc::function>("Save", std::vector<ipc::type>{ipc::type::UInt64}, Save));
-	cls->register_function(std::make_shared<ipc::function>("Update", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::String}, Update));
+	cls->register_function(std::make_shared<ipc::function>("Update", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::Binary}, Update));
+	cls->register_function(std::make_shared<ipc::function>("UpdatePatch", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::Binary}, UpdatePatch));
 	cls->register_function(std::make_shared<ipc::function>("GetType", std::vector<ipc::type>{ipc::type::UInt64}, GetType));
 	cls->register_function(std::make_shared<ipc::function>("GetName", std::vector<ipc::type>{ipc::type::UInt64}, GetName));
 	cls->register_function(std::make_shared<ipc::function>("SetName", std::vector<ipc::type>{ipc::type::UInt64}, SetName));
@@ -273,6 +301,31 @@ void osn::Source::GetProperties(void *data, const int64_t id, const std::vector<
 	AUTO_DEBUG;
 }
 
+void osn::Source::GetPropertiesSnapshot(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
+{
+	// Attempt to find the source asked to load.
+	obs_source_t *src = osn::Source::Manager::GetInstance().find(args[0].value_union.ui64);
+	if (src == nullptr) {
+		PRETTY_ERROR_RETURN(ErrorCode::InvalidReference, "Source reference is not valid.");
+	}
+
+	obs_properties_t *prp = obs_source_properties(src);
+	obs_data *settings = obs_source_get_settings(src);
+
+	obs::PropertySnapshot snapshot;
+	utility::SerializeProperties(prp, settings, snapshot);
+
+	obs_properties_destroy(prp);
+	obs_data_release(settings);
+
+	std::vector<char> buf;
+	snapshot.serialize(buf, args[1].value_bin);
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	rval.push_back(ipc::value(buf));
+	AUTO_DEBUG;
+}
+
 void osn::Source::CallHandler(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
 {
 	// Attempt to find the source asked to load.
@@ -323,11 +376,26 @@ void osn::Source::GetSettings(void *data, const int64_t id, const std::vector<ip
 
 	obs_data_t *sets = obs_source_get_settings(src);
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
-	rval.push_back(ipc::value(obs_data_get_full_json(sets)));
+	rval.push_back(ipc::value(SettingsToBinary(sets)));
 	obs_data_release(sets);
 	AUTO_DEBUG;
 }
 
+static void FixFrameRate(obs_source_t *src, obs_data_t *sets)
+{
+	if (strcmp(obs_source_get_id(src), "av_capture_input") != 0)
+		return;
+
+	const char *frame_rate_string = obs_data_get_string(sets, "frame_rate");
+	if (frame_rate_string && strcmp(frame_rate_string, "") != 0) {
+		nlohmann::json fps = nlohmann::json::parse(frame_rate_string);
+		media_frames_per_second obs_fps = {};
+		obs_fps.numerator = fps["numerator"];
+		obs_fps.denominator = fps["denominator"];
+		obs_data_set_frames_per_second(sets, "frame_rate", obs_fps, nullptr);
+	}
+}
+
 void osn::Source::Update(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
 {
 	// Attempt to find the source asked to load.
@@ -336,18 +404,11 @@ void osn::Source::Update(void *data, const int64_t id, const std::vector<ipc::va
 		PRETTY_ERROR_RETURN(ErrorCode::InvalidReference, "Source reference is not valid.");
 	}
 
-	obs_data_t *sets = obs_data_create_from_json(args[1].value_str.c_str());
-
-	if (strcmp(obs_source_get_id(src), "av_capture_input") == 0) {
-		const char *frame_rate_string = obs_data_get_string(sets, "frame_rate");
-		if (frame_rate_string && strcmp(frame_rate_string, "") != 0) {
-			nlohmann::json fps = nlohmann::json::parse(frame_rate_string);
-			media_frames_per_second obs_fps = {};
-			obs_fps.numerator = fps["numerator"];
-			obs_fps.denominator = fps["denominator"];
-			obs_data_set_frames_per_second(sets, "frame_rate", obs_fps, nullptr);
-		}
+	obs_data_t *sets = SettingsFromBinary(args[1].value_bin);
+	if (!sets) {
+		PRETTY_ERROR_RETURN(ErrorCode::OutOfBounds, "Settings are malformed.");
 	}
+	FixFrameRate(src, sets);
 
 	obs_source_update(src, sets);
 	MemoryManager::GetInstance().updateSourceCache(src);
@@ -356,11 +417,270 @@ void osn::Source::Update(void *data, const int64_t id, const std::vector<ipc::va
 	obs_data_t *updatedSettings = obs_source_get_settings(src);
 
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
-	rval.push_back(ipc::value(obs_data_get_full_json(updatedSettings)));
+	rval.push_back(ipc::value(SettingsToBinary(updatedSettings)));
 	obs_data_release(updatedSettings);
 	AUTO_DEBUG;
 }
 
+static bool ReadSettings(settings::Reader &reader, obs_data_t *data)
+{
+	settings::Record record;
+	while (reader.next(record)) {
+		std::string key = record.name();
+
+		switch (record.type) {
+		case settings::Bool:
+			obs_data_set_bool(data, key.c_str(), record.get<uint8_t>() != 0);
+			break;
+		case settings::Int:
+			obs_data_set_int(data, key.c_str(), record.get<int64_t>());
+			break;
+		case settings::Double:
+			obs_data_set_double(data, key.c_str(), record.get<double>());
+			break;
+		case settings::String:
+			obs_data_set_string(data, key.c_str(), std::string(record.value, record.value_size).c_str());
+			break;
+		case settings::Object: {
+			settings::Reader object(record.value, record.value_size);
+			obs_data_t *obj = obs_data_create();
+			bool valid = ReadSettings(object, obj);
+			if (valid)
+				obs_data_set_obj(data, key.c_str(), obj);
+			obs_data_release(obj);
+			if (!valid)
+				return false;
+			break;
+		}
+		case settings::Array: {
+			settings::Reader elements(record.value, record.value_size);
+			obs_data_array_t *array = obs_data_array_create();
+			bool valid = true;
+			for (uint32_t i = 0; valid && i < record.count; i++) {
+				settings::Reader element(nullptr, 0);
+				obs_data_t *obj = obs_data_create();
+				valid = elements.next_element(element) && ReadSettings(element, obj);
+				if (valid)
+					obs_data_array_push_back(array, obj);
+				obs_data_release(obj);
+			}
+			valid = valid && elements.done();
+			if (valid)
+				obs_data_set_array(data, key.c_str(), array);
+			obs_data_array_release(array);
+			if (!valid)
+				return false;
+			break;
+		}
+		}
+	}
+
+	return reader.done();
+}
+
+static void WriteSettings(settings::Writer &writer, obs_data_t *data)
+{
+	for (obs_data_item_t *item = obs_data_first(data); item; obs_data_item_next(&item)) {
+		const char *name = obs_data_item_get_name(item);
+		size_t name_size = strlen(name);
+
+		switch (obs_data_item_gettype(item)) {
+		case OBS_DATA_STRING: {
+			const char *value = obs_data_item_get_string(item);
+			writer.put_string(name, name_size, value, strlen(value));
+			break;
+		}
+		case OBS_DATA_NUMBER:
+			if (obs_data_item_numtype(item) == OBS_DATA_NUM_INT)
+				writer.put_int(name, name_size, obs_data_item_get_int(item));
+			else
+				writer.put_double(name, name_size, obs_data_item_get_double(item));
+			break;
+		case OBS_DATA_BOOLEAN:
+			writer.put_bool(name, name_size, obs_data_item_get_bool(item));
+			break;
+		case OBS_DATA_OBJECT: {
+			obs_data_t *obj = obs_data_item_get_obj(item);
+			if (!obj)
+				break;
+			size_t mark = writer.begin_object(name, name_size);
+			WriteSettings(writer, obj);
+			writer.end_object(mark);
+			obs_data_release(obj);
+			break;
+		}
+		case OBS_DATA_ARRAY: {
+			obs_data_array_t *array = obs_data_item_get_array(item);
+			if (!array)
+				break;
+			size_t count = obs_data_array_count(array);
+			size_t mark = writer.begin_array(name, name_size);
+			for (size_t i = 0; i < count; i++) {
+				obs_data_t *element = obs_data_array_item(array, i);
+				size_t element_mark = writer.begin_element();
+				WriteSettings(writer, element);
+				writer.end_element(element_mark);
+				obs_data_release(element);
+			}
+			writer.end_array(mark, (uint32_t)count);
+			obs_data_array_release(array);
+			break;
+		}
+		default:
+			break;
+		}
+	}
+}
+
+obs_data_t *osn::Source::SettingsFromBinary(const std::vector<char> &buffer)
+{
+	return SettingsFromBinary(buffer.data(), buffer.size());
+}
+
+obs_data_t *osn::Source::SettingsFromBinary(const char *buffer, size_t size)
+{
+	settings::Reader reader(buffer, size);
+	obs_data_t *data = obs_data_create();
+	if (!ReadSettings(reader, data)) {
+		obs_data_release(data);
+		return nullptr;
+	}
+	return data;
+}
+
+std::vector<char> osn::Source::SettingsToBinary(obs_data_t *data)
+{
+	std::vector<char> buffer;
+	settings::Writer writer(buffer);
+	WriteSettings(writer, data);
+	return buffer;
+}
+
+void osn::Source::SettingsToBinary(settings::Writer &writer, obs_data_t *data)
+{
+	WriteSettings(writer, data);
+}
+
+static uint64_t HashBytes(uint64_t hash, const void *data, size_t size)
+{
+	// FNV-1a
+	const uint8_t *bytes = reinterpret_cast<const uint8_t *>(data);
+	for (size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+static uint64_t HashSettings(obs_data_t *data);
+
+// Hash of the effective value of an item, including its name.
+static uint64_t HashItem(obs_data_item_t *item)
+{
+	uint64_t hash = 0xcbf29ce484222325ull;
+	const char *name = obs_data_item_get_name(item);
+	hash = HashBytes(hash, name, strlen(name) + 1);
+
+	int32_t type = obs_data_item_gettype(item);
+	hash = HashBytes(hash, &type, sizeof(type));
+
+	switch (type) {
+	case OBS_DATA_STRING: {
+		const char *value = obs_data_item_get_string(item);
+		if (value)
+			hash = HashBytes(hash, value, strlen(value));
+		break;
+	}
+	case OBS_DATA_NUMBER:
+		if (obs_data_item_numtype(item) == OBS_DATA_NUM_INT) {
+			int64_t value = obs_data_item_get_int(item);
+			hash = HashBytes(hash, &value, sizeof(value));
+		} else {
+			double value = obs_data_item_get_double(item);
+			hash = HashBytes(hash, &value, sizeof(value));
+		}
+		break;
+	case OBS_DATA_BOOLEAN: {
+		uint8_t value = obs_data_item_get_bool(item) ? 1 : 0;
+		hash = HashBytes(hash, &value, sizeof(value));
+		break;
+	}
+	case OBS_DATA_OBJECT: {
+		obs_data_t *obj = obs_data_item_get_obj(item);
+		uint64_t value = obj ? HashSettings(obj) : 0;
+		hash = HashBytes(hash, &value, sizeof(value));
+		obs_data_release(obj);
+		break;
+	}
+	case OBS_DATA_ARRAY: {
+		obs_data_array_t *array = obs_data_item_get_array(item);
+		size_t count = obs_data_array_count(array);
+		for (size_t i = 0; i < count; i++) {
+			obs_data_t *element = obs_data_array_item(array, i);
+			uint64_t value = HashSettings(element);
+			hash = HashBytes(hash, &value, sizeof(value));
+			obs_data_release(element);
+		}
+		obs_data_array_release(array);
+		break;
+	}
+	default:
+		break;
+	}
+
+	return hash;
+}
+
+// Item hashes are summed so the result does not depend on the item order and
+// single items can be swapped out of it.
+static uint64_t HashSettings(obs_data_t *data)
+{
+	uint64_t hash = 0;
+	for (obs_data_item_t *item = obs_data_first(data); item; obs_data_item_next(&item))
+		hash += HashItem(item);
+	return hash;
+}
+
+void osn::Source::UpdatePatch(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
+{
+	obs_source_t *src = osn::Source::Manager::GetInstance().find(args[0].value_union.ui64);
+	if (src == nullptr) {
+		PRETTY_ERROR_RETURN(ErrorCode::InvalidReference, "Source reference is not valid.");
+	}
+
+	obs_data_t *patch = SettingsFromBinary(args[1].value_bin);
+	if (!patch) {
+		PRETTY_ERROR_RETURN(ErrorCode::OutOfBounds, "Settings patch is malformed.");
+	}
+	FixFrameRate(src, patch);
+
+	// Work out what the settings hash to once the patch is applied. If the
+	// source rewrote any setting from its update callback the hashes differ
+	// and the client gets the full settings back, otherwise it applies the
+	// patch to its own copy.
+	obs_data_t *settings = obs_source_get_settings(src);
+	uint64_t expected = HashSettings(settings);
+	for (obs_data_item_t *item = obs_data_first(patch); item; obs_data_item_next(&item)) {
+		obs_data_item_t *previous = obs_data_item_byname(settings, obs_data_item_get_name(item));
+		if (previous) {
+			expected -= HashItem(previous);
+			obs_data_item_release(&previous);
+		}
+		expected += HashItem(item);
+	}
+
+	// Merges the patch into the current settings through obs_data_apply.
+	obs_source_update(src, patch);
+	MemoryManager::GetInstance().updateSourceCache(src);
+	obs_data_release(patch);
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	if (HashSettings(settings) != expected)
+		rval.push_back(ipc::value(SettingsToBinary(settings)));
+	obs_data_release(settings);
+	AUTO_DEBUG;
+}
+
 void osn::Source::Load(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
 {
 	// Attempt to find the source asked to load.
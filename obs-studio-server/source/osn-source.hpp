@@ -19,6 +19,7 @@
 #pragma once
 #include <ipc-server.hpp>
 #include <obs.h>
+#include "settings-binary.hpp"
 #include "utility.hpp"
 #undef strtoll
 #include "nlohmann/json.hpp"
@@ -48,6 +49,7 @@ public:
 	static void global_source_deactivate_cb(void *ptr, calldata_t *cd);
 	static void global_source_destroy_cb(void *ptr, calldata_t *cd);
 	static void global_source_remove_cb(void *ptr, calldata_t *cd);
+	static void global_scene_changed_cb(void *ptr, calldata_t *cd);
 
 	static void attach_source_signals(obs_source_t *src);
 	static void detach_source_signals(obs_source_t *src);
@@ -66,9 +68,18 @@ public:
 	// Settings & Properties
 	static void IsConfigurable(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
 	static void GetProperties(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
+	static void GetPropertiesSnapshot(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
 	static void GetSettings(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
 	static void CallHandler(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
 	static void Update(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
+	static void UpdatePatch(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
+
+	// Settings in the format of settings-binary.hpp. Returns nullptr if the
+	// buffer is malformed, otherwise a new reference.
+	static obs_data_t *SettingsFromBinary(const std::vector<char> &buffer);
+	static obs_data_t *SettingsFromBinary(const char *data, size_t size);
+	static std::vector<char> SettingsToBinary(obs_data_t *data);
+	static void SettingsToBinary(settings::Writer &writer, obs_data_t *data);
 	static void Load(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
 	static void Save(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
 
@@ -301,31 +301,9 @@ bool osn::Streaming::isTwitchVODSupported()
 		return false;
 }
 
-void osn::IStreaming::Query(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
+uint64_t osn::Streaming::GetSignalsId()
 {
-	Streaming *streaming = osn::IStreaming::Manager::GetInstance().find(args[0].value_union.ui64);
-	if (!streaming) {
-		PRETTY_ERROR_RETURN(ErrorCode::InvalidReference, "Streaming reference is not valid.");
-	}
-
-	std::unique_lock<std::mutex> ulock(streaming->signalsMtx);
-	if (streaming->signalsReceived.empty()) {
-		rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
-		AUTO_DEBUG;
-		return;
-	}
-
-	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
-
-	auto signal = streaming->signalsReceived.front();
-	rval.push_back(ipc::value("streaming"));
-	rval.push_back(ipc::value(signal.signal));
-	rval.push_back(ipc::value(signal.code));
-	rval.push_back(ipc::value(signal.errorMessage));
-
-	streaming->signalsReceived.pop();
-
-	AUTO_DEBUG;
+	return osn::IStreaming::Manager::GetInstance().find(this);
 }
 
 osn::IStreaming::Manager &osn::IStreaming::Manager::GetInstance()
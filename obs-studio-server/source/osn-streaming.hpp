@@ -41,12 +41,15 @@ public:
 		oldMixer_desktopSource1 = 0;
 		oldMixer_desktopSource2 = 0;
 		signals = {"start", "stop", "starting", "stopping", "activate", "deactivate", "reconnect", "reconnect_success"};
+		signalsType = "streaming";
 		delay = new Delay();
 		reconnect = new Reconnect();
 		network = new Network();
 	}
 	virtual ~Streaming();
 
+	uint64_t GetSignalsId() override;
+
 public:
 	obs_encoder_t *videoEncoder;
 	obs_encoder_t *streamArchive;
@@ -103,6 +106,5 @@ public:
 	static void SetReconnect(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
 	static void GetNetwork(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
 	static void SetNetwork(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
-	static void Query(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
 };
 }
@@ -23,6 +23,7 @@
 #include "osn-error.hpp"
 #include "osn-source.hpp"
 #include "shared.hpp"
+#include "util-modulemanifest.h"
 
 void osn::Transition::Register(ipc::server &srv)
 {
@@ -48,10 +49,8 @@ void osn::Transition::Register(ipc::server &srv)
 void osn::Transition::Types(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
 {
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
-	const char *typeId = nullptr;
-	for (size_t idx = 0; obs_enum_transition_types(idx, &typeId); idx++) {
-		rval.push_back(ipc::value(typeId ? typeId : ""));
-	}
+	for (const auto &typeId : util::ModuleManifest::TransitionTypes())
+		rval.push_back(ipc::value(typeId));
 	AUTO_DEBUG;
 }
 
@@ -71,6 +70,7 @@ void osn::Transition::Create(void *data, const int64_t id, const std::vector<ipc
 		break;
 	}
 
+	util::ModuleManifest::LoadSourceType(sourceId);
 	obs_source_t *source = obs_source_create(sourceId.c_str(), name.c_str(), settings, hotkeys);
 	if (!source) {
 		PRETTY_ERROR_RETURN(ErrorCode::Error, "Failed to create transition.");
@@ -102,6 +102,7 @@ void osn::Transition::CreatePrivate(void *data, const int64_t id, const std::vec
 		break;
 	}
 
+	util::ModuleManifest::LoadSourceType(sourceId);
 	obs_source_t *source = obs_source_create_private(sourceId.c_str(), name.c_str(), settings);
 	if (!source) {
 		PRETTY_ERROR_RETURN(ErrorCode::Error, "Failed to create transition.");
@@ -22,10 +22,39 @@
 #include "osn-source.hpp"
 #include "shared.hpp"
 #include "utility.hpp"
+#include "callback-manager.h"
+#include <algorithm>
 #include <cmath>
+#include <util/platform.h>
 
 std::mutex mtx;
 
+// Shared memory levels, slots are handed out and released under mtx. The
+// buffer is created once and never replaced, so the audio thread reads it
+// without locking.
+static std::shared_ptr<volmeter::LevelsBuffer> levels;
+static std::vector<uint32_t> free_slots;
+
+// Ballistics never go below this level, silence is reported as -65535 by libobs.
+static const float ballistics_floor = -96.0f;
+
+static_assert(MAX_AUDIO_CHANNELS <= volmeter::levels_max_channels, "Shared levels slots are too small");
+
+static bool CreateLevelsBuffer()
+{
+	if (levels)
+		return true;
+
+	levels = volmeter::LevelsBuffer::Create(volmeter::LevelsBuffer::DefaultName(), volmeter::levels_capacity);
+	if (!levels)
+		return false;
+
+	free_slots.reserve(levels->capacity());
+	for (uint32_t slot = levels->capacity(); slot > 0; slot--)
+		free_slots.push_back(slot - 1);
+	return true;
+}
+
 osn::Volmeter::Manager &osn::Volmeter::Manager::GetInstance()
 {
 	static Manager _inst;
@@ -53,23 +82,47 @@ void osn::Volmeter::Register(ipc::server &srv)
 	cls->register_function(std::make_shared<ipc::function>("Detach", std::vector<ipc::type>{ipc::type::UInt64}, Detach));
 	cls->register_function(std::make_shared<ipc::function>("AddCallback", std::vector<ipc::type>{ipc::type::UInt64}, AddCallback));
 	cls->register_function(std::make_shared<ipc::function>("RemoveCallback", std::vector<ipc::type>{ipc::type::UInt64}, RemoveCallback));
+	cls->register_function(
+		std::make_shared<ipc::function>("SetBallistics", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::Float, ipc::type::Float, ipc::type::Float}, SetBallistics));
 	cls->register_function(std::make_shared<ipc::function>("Query", std::vector<ipc::type>{ipc::type::UInt64}, Query));
+	cls->register_function(std::make_shared<ipc::function>("GetLevelsBuffer", std::vector<ipc::type>{}, GetLevelsBuffer));
 	srv.register_collection(cls);
 }
 
 void osn::Volmeter::ClearVolmeters()
 {
 	Manager::GetInstance().for_each([](const std::shared_ptr<osn::Volmeter> &volmeter) {
-		if (volmeter->id2) {
-			obs_volmeter_remove_callback(volmeter->self, OBSCallback, volmeter->id2);
-			delete volmeter->id2;
-			volmeter->id2 = nullptr;
+		if (volmeter->callback_added) {
+			obs_volmeter_remove_callback(volmeter->self, OBSCallback, volmeter.get());
+			volmeter->callback_added = false;
 		}
+		ReleaseSlot(volmeter.get());
 	});
 
 	Manager::GetInstance().clear();
 }
 
+bool osn::Volmeter::AllocateSlot(Volmeter *meter)
+{
+	if (!CreateLevelsBuffer() || free_slots.empty())
+		return false;
+
+	meter->slot = free_slots.back();
+	free_slots.pop_back();
+	levels->reset(meter->slot, meter->id);
+	return true;
+}
+
+void osn::Volmeter::ReleaseSlot(Volmeter *meter)
+{
+	if (meter->slot == volmeter::levels_invalid_slot)
+		return;
+
+	levels->reset(meter->slot, 0);
+	free_slots.push_back(meter->slot);
+	meter->slot = volmeter::levels_invalid_slot;
+}
+
 void osn::Volmeter::Create(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
 {
 	obs_fader_type type = (obs_fader_type)args[0].value_union.i32;
@@ -88,9 +141,16 @@ void osn::Volmeter::Create(void *data, const int64_t id, const std::vector<ipc::
 		PRETTY_ERROR_RETURN(ErrorCode::CriticalError, "Failed to allocate unique id for Meter.");
 	}
 
+	if (!AllocateSlot(meter.get())) {
+		Manager::GetInstance().free(meter->id);
+		meter.reset();
+		PRETTY_ERROR_RETURN(ErrorCode::CriticalError, "Failed to allocate shared levels for Meter.");
+	}
+
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
 	rval.push_back(ipc::value(meter->id));
 	rval.push_back(ipc::value(obs_volmeter_get_update_interval(meter->self)));
+	rval.push_back(ipc::value(meter->slot));
 	AUTO_DEBUG;
 }
 
@@ -105,11 +165,11 @@ void osn::Volmeter::Destroy(void *data, const int64_t id, const std::vector<ipc:
 	}
 
 	Manager::GetInstance().free(uid);
-	if (meter->id2) { // Ensure there are no more callbacks
-		obs_volmeter_remove_callback(meter->self, OBSCallback, meter->id2);
-		delete meter->id2;
-		meter->id2 = nullptr;
+	if (meter->callback_added) { // Ensure there are no more callbacks
+		obs_volmeter_remove_callback(meter->self, OBSCallback, meter.get());
+		meter->callback_added = false;
 	}
+	ReleaseSlot(meter.get());
 
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
 	AUTO_DEBUG;
@@ -131,12 +191,13 @@ void osn::Volmeter::Attach(void *data, const int64_t id, const std::vector<ipc::
 		PRETTY_ERROR_RETURN(ErrorCode::InvalidReference, "Invalid Source reference.");
 	}
 
+	meter->reset_ballistics.store(true);
+	obs_source_t *previous = meter->source.exchange(source);
 	if (!obs_volmeter_attach_source(meter->self, source)) {
+		meter->source.store(previous);
 		PRETTY_ERROR_RETURN(ErrorCode::Error, "Error attaching source.");
 	}
 
-	meter->uid_source = uid_source;
-
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
 	AUTO_DEBUG;
 }
@@ -151,8 +212,8 @@ void osn::Volmeter::Detach(void *data, const int64_t id, const std::vector<ipc::
 		PRETTY_ERROR_RETURN(ErrorCode::InvalidReference, "Invalid Meter reference.");
 	}
 
-	meter->uid_source = 0;
 	obs_volmeter_detach_source(meter->self);
+	meter->source.store(nullptr);
 
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
 	AUTO_DEBUG;
@@ -169,9 +230,9 @@ void osn::Volmeter::AddCallback(void *data, const int64_t id, const std::vector<
 
 	meter->callback_count++;
 	if (meter->callback_count == 1) {
-		meter->id2 = new uint64_t;
-		*meter->id2 = meter->id;
-		obs_volmeter_add_callback(meter->self, OBSCallback, meter->id2);
+		meter->callback_added = true;
+		meter->reset_ballistics.store(true);
+		obs_volmeter_add_callback(meter->self, OBSCallback, meter.get());
 	}
 
 	rval.push_back(ipc::value(uint64_t(ErrorCode::Ok)));
@@ -190,9 +251,8 @@ void osn::Volmeter::RemoveCallback(void *data, const int64_t id, const std::vect
 
 	meter->callback_count--;
 	if (meter->callback_count == 0) {
-		obs_volmeter_remove_callback(meter->self, OBSCallback, meter->id2);
-		delete meter->id2;
-		meter->id2 = nullptr;
+		obs_volmeter_remove_callback(meter->self, OBSCallback, meter.get());
+		meter->callback_added = false;
 	}
 
 	rval.push_back(ipc::value(uint64_t(ErrorCode::Ok)));
@@ -200,62 +260,144 @@ void osn::Volmeter::RemoveCallback(void *data, const int64_t id, const std::vect
 	AUTO_DEBUG;
 }
 
-void osn::Volmeter::Query(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
+void osn::Volmeter::SetBallistics(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
 {
 	auto uid = args[0].value_union.ui64;
-	std::unique_lock<std::mutex> ulockMutex(mtx);
+	float attack = args[1].value_union.fp32;
+	float decay = args[2].value_union.fp32;
+	float peakHold = args[3].value_union.fp32;
+
+	std::unique_lock<std::mutex> ulock(mtx);
 	auto meter = Manager::GetInstance().find(uid);
 	if (!meter) {
 		PRETTY_ERROR_RETURN(ErrorCode::InvalidReference, "Invalid Meter reference.");
 	}
 
+	if (!std::isfinite(attack) || !std::isfinite(decay) || !std::isfinite(peakHold) || attack < 0 || decay < 0 || peakHold < 0) {
+		PRETTY_ERROR_RETURN(ErrorCode::OutOfBounds, "Invalid Meter ballistics.");
+	}
+
+	meter->attack_time.store(attack);
+	meter->decay_rate.store(decay);
+	meter->peak_hold_time.store(peakHold);
+
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	AUTO_DEBUG;
+}
 
-	std::unique_lock<std::mutex> ulock(meter->current_data_mtx);
+void osn::Volmeter::Query(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
+{
+	auto uid = args[0].value_union.ui64;
+	auto meter = Manager::GetInstance().find(uid);
+	if (!meter) {
+		PRETTY_ERROR_RETURN(ErrorCode::InvalidReference, "Invalid Meter reference.");
+	}
 
-	// Reset audio data if OBSCallBack is idle
-	if (meter->current_data.lastUpdateTime != std::chrono::milliseconds(0)) {
-		if (CheckIdle(GetTime(), meter->current_data.lastUpdateTime)) {
-			meter->current_data.resetData();
-		}
+	volmeter::LevelsSnapshot snapshot;
+	if (!levels || !levels->read(meter->slot, snapshot) || snapshot.uid != meter->id) {
+		PRETTY_ERROR_RETURN(ErrorCode::Error, "Failed to read Meter levels.");
 	}
 
-	rval.push_back(ipc::value(meter->current_data.ch));
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+
+	// Report silence if OBSCallBack is idle
+	int64_t lastUpdate = meter->last_update_ms.load(std::memory_order_relaxed);
+	bool idle = lastUpdate != 0 && CheckIdle(GetTime(), std::chrono::milliseconds(lastUpdate));
 
-	for (size_t ch = 0; ch < meter->current_data.ch; ch++) {
-		rval.push_back(ipc::value(meter->current_data.magnitude[ch]));
-		rval.push_back(ipc::value(meter->current_data.peak[ch]));
-		rval.push_back(ipc::value(meter->current_data.input_peak[ch]));
+	rval.push_back(ipc::value(snapshot.channels));
+
+	for (int32_t ch = 0; ch < snapshot.channels; ch++) {
+		rval.push_back(ipc::value(idle ? -65535.0f : snapshot.magnitude[ch]));
+		rval.push_back(ipc::value(idle ? -65535.0f : snapshot.peak[ch]));
+		rval.push_back(ipc::value(idle ? -65535.0f : snapshot.input_peak[ch]));
 	}
 
-	ulock.unlock();
+	AUTO_DEBUG;
+}
+
+void osn::Volmeter::GetLevelsBuffer(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval)
+{
+	std::unique_lock<std::mutex> ulock(mtx);
+	if (!CreateLevelsBuffer()) {
+		PRETTY_ERROR_RETURN(ErrorCode::Error, "Failed to create shared levels buffer.");
+	}
 
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	rval.push_back(ipc::value(volmeter::LevelsBuffer::DefaultName()));
+	rval.push_back(ipc::value(levels->capacity()));
 	AUTO_DEBUG;
 }
 
 void osn::Volmeter::OBSCallback(void *param, const float magnitude[MAX_AUDIO_CHANNELS], const float peak[MAX_AUDIO_CHANNELS],
 				const float input_peak[MAX_AUDIO_CHANNELS])
 {
-	std::unique_lock<std::mutex> ulockMutex(mtx);
-	auto meter = Manager::GetInstance().find(*reinterpret_cast<uint64_t *>(param));
-	if (!meter) {
-		return;
-	}
+	// Runs on the libobs audio thread: no lock and no lookup in here.
+	Volmeter *meter = reinterpret_cast<Volmeter *>(param);
 
 #define MAKE_FLOAT_SANE(db) (std::isfinite(db) ? db : (db > 0 ? 0.0f : -65535.0f))
-#define PREVIOUS_FRAME_WEIGHT
-
-	std::unique_lock<std::mutex> ulock(meter->current_data_mtx);
 
-	meter->current_data.lastUpdateTime = GetTime();
-	meter->current_data.ch = obs_volmeter_get_nr_channels(meter->self);
+	std::array<float, MAX_AUDIO_CHANNELS> sane_magnitude;
+	std::array<float, MAX_AUDIO_CHANNELS> sane_peak;
+	std::array<float, MAX_AUDIO_CHANNELS> sane_input_peak;
 	for (size_t ch = 0; ch < MAX_AUDIO_CHANNELS; ch++) {
-		meter->current_data.magnitude[ch] = MAKE_FLOAT_SANE(magnitude[ch]);
-		meter->current_data.peak[ch] = MAKE_FLOAT_SANE(peak[ch]);
-		meter->current_data.input_peak[ch] = MAKE_FLOAT_SANE(input_peak[ch]);
+		sane_magnitude[ch] = MAKE_FLOAT_SANE(magnitude[ch]);
+		sane_peak[ch] = MAKE_FLOAT_SANE(peak[ch]);
+		sane_input_peak[ch] = MAKE_FLOAT_SANE(input_peak[ch]);
 	}
 
 #undef MAKE_FLOAT_SANE
+
+	meter->UpdateBallistics(sane_magnitude.data(), sane_peak.data());
+
+	obs_source_t *source = meter->source.load(std::memory_order_acquire);
+	bool isMuted = source ? obs_source_muted(source) : true;
+	levels->write(meter->slot, obs_volmeter_get_nr_channels(meter->self), isMuted, sane_magnitude.data(), sane_peak.data(),
+		      sane_input_peak.data(), meter->ballistics);
+
+	meter->last_update_ms.store(GetTime().count(), std::memory_order_relaxed);
+	meter->pending_update.store(true, std::memory_order_release);
+
+	CallbackManager::NotifyVolmeterUpdate();
+}
+
+// Same ballistics as the OBS volume meter, applied to every callback so that
+// clients polling at any rate see the same smoothed levels.
+void osn::Volmeter::UpdateBallistics(const float *magnitude, const float *peak)
+{
+	uint64_t now = os_gettime_ns();
+	float elapsed = last_callback_ns ? float(now - last_callback_ns) / 1000000000.0f : 0.0f;
+	last_callback_ns = now;
+
+	bool reset = reset_ballistics.exchange(false, std::memory_order_relaxed);
+	float attack = attack_time.load(std::memory_order_relaxed);
+	float decay = decay_rate.load(std::memory_order_relaxed) * elapsed;
+	uint64_t hold_ns = uint64_t(double(peak_hold_time.load(std::memory_order_relaxed)) * 1000000000.0);
+	float coefficient = attack > elapsed ? elapsed / attack : 1.0f;
+
+	for (size_t ch = 0; ch < MAX_AUDIO_CHANNELS; ch++) {
+		float current_magnitude = (std::max)(magnitude[ch], ballistics_floor);
+		float current_peak = (std::max)(peak[ch], ballistics_floor);
+
+		if (reset) {
+			ballistics.display_magnitude[ch] = current_magnitude;
+			ballistics.display_peak[ch] = current_peak;
+			ballistics.peak_hold[ch] = current_peak;
+			peak_hold_ns[ch] = now;
+			continue;
+		}
+
+		ballistics.display_magnitude[ch] += (current_magnitude - ballistics.display_magnitude[ch]) * coefficient;
+
+		if (current_peak >= ballistics.display_peak[ch])
+			ballistics.display_peak[ch] = current_peak;
+		else
+			ballistics.display_peak[ch] = (std::max)(ballistics.display_peak[ch] - decay, current_peak);
+
+		if (current_peak >= ballistics.peak_hold[ch] || now - peak_hold_ns[ch] > hold_ns) {
+			ballistics.peak_hold[ch] = current_peak;
+			peak_hold_ns[ch] = now;
+		}
+	}
 }
 
 std::chrono::milliseconds osn::Volmeter::GetTime()
@@ -276,29 +418,23 @@ bool osn::Volmeter::CheckIdle(std::chrono::milliseconds currentTime, std::chrono
 	return false;
 }
 
-void osn::Volmeter::getAudioData(uint64_t id, std::vector<ipc::value> &rval)
+void osn::Volmeter::getAudioUpdates(std::vector<ipc::value> &rval)
 {
 	std::unique_lock<std::mutex> ulockMutex(mtx);
 
-	auto meter = Manager::GetInstance().find(id);
-	if (!meter) {
-		PRETTY_ERROR_RETURN(ErrorCode::InvalidReference, "Invalid Meter reference.");
-	}
-
-	std::unique_lock<std::mutex> ulock(meter->current_data_mtx);
-
-	rval.push_back(ipc::value(meter->current_data.ch));
+	// Levels are read by the client from the shared buffer, only the ids of
+	// the updated meters go through IPC.
+	size_t countIndex = rval.size();
+	uint32_t count = 0;
+	rval.push_back(ipc::value(count));
 
-	auto source = osn::Source::Manager::GetInstance().find(meter->uid_source);
-	bool isMuted = source ? obs_source_muted(source) : true;
-	rval.push_back(ipc::value(isMuted));
+	Manager::GetInstance().for_each([&rval, &count](const std::shared_ptr<osn::Volmeter> &meter) {
+		if (!meter->callback_added || !meter->pending_update.exchange(false, std::memory_order_acquire))
+			return;
 
-	if (isMuted)
-		return;
+		rval.push_back(ipc::value(meter->id));
+		count++;
+	});
 
-	for (size_t ch = 0; ch < meter->current_data.ch; ch++) {
-		rval.push_back(ipc::value(meter->current_data.magnitude[ch]));
-		rval.push_back(ipc::value(meter->current_data.peak[ch]));
-		rval.push_back(ipc::value(meter->current_data.input_peak[ch]));
-	}
-}
\ No newline at end of file
+	rval[countIndex] = ipc::value(count);
+}
@@ -21,8 +21,10 @@
 #include <memory>
 #include <queue>
 #include <array>
+#include <atomic>
 #include "obs.h"
 #include "utility.hpp"
+#include "volmeter-levels.hpp"
 
 extern std::mutex mtx;
 
@@ -48,27 +50,31 @@ private:
 	obs_volmeter_t *self;
 	uint64_t id;
 	size_t callback_count = 0;
-	uint64_t *id2 = nullptr;
-	uint64_t uid_source = 0;
-
-	struct AudioData {
-		std::array<float, MAX_AUDIO_CHANNELS> magnitude{0};
-		std::array<float, MAX_AUDIO_CHANNELS> peak{0};
-		std::array<float, MAX_AUDIO_CHANNELS> input_peak{0};
-		std::chrono::milliseconds lastUpdateTime = std::chrono::milliseconds(0);
-		int32_t ch = 0;
-
-		void resetData()
-		{
-			std::fill(magnitude.begin(), magnitude.end(), -65535.0f);
-			std::fill(peak.begin(), peak.end(), -65535.0f);
-			std::fill(input_peak.begin(), input_peak.end(), -65535.0f);
-			lastUpdateTime = std::chrono::milliseconds(0);
-		}
-	};
-
-	AudioData current_data;
-	std::mutex current_data_mtx;
+	bool callback_added = false;
+	uint32_t slot = volmeter::levels_invalid_slot;
+
+	// Read by OBSCallback on the audio thread, which gets the meter itself as
+	// parameter. The source is set before attaching and cleared after
+	// detaching, libobs does not call back once obs_volmeter_detach_source or
+	// obs_volmeter_remove_callback returned. Levels go to the meter slot in
+	// the shared buffer, which has its own sequence lock.
+	std::atomic<obs_source_t *> source{nullptr};
+	std::atomic<int64_t> last_update_ms{0};
+	std::atomic<bool> pending_update{false};
+
+	// Ballistics settings, written by SetBallistics and picked up by the
+	// audio thread on its next callback.
+	std::atomic<float> attack_time{0.3f};     // seconds
+	std::atomic<float> decay_rate{23.53f};    // dB per second
+	std::atomic<float> peak_hold_time{20.0f}; // seconds
+	std::atomic<bool> reset_ballistics{true};
+
+	// Ballistics state, only touched by OBSCallback.
+	volmeter::LevelsBallistics ballistics = {};
+	uint64_t peak_hold_ns[volmeter::levels_max_channels] = {};
+	uint64_t last_callback_ns = 0;
+
+	void UpdateBallistics(const float *magnitude, const float *peak);
 
 public:
 	Volmeter(obs_fader_type type);
@@ -78,7 +84,7 @@ public:
 	static void Register(ipc::server &);
 
 	static void ClearVolmeters();
-	static void getAudioData(uint64_t id, std::vector<ipc::value> &rval);
+	static void getAudioUpdates(std::vector<ipc::value> &rval);
 
 	static void Create(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
 	static void Destroy(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
@@ -88,11 +94,16 @@ public:
 	static void AddCallback(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
 	static void RemoveCallback(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
 
+	static void SetBallistics(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
 	static void Query(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
+	static void GetLevelsBuffer(void *data, const int64_t id, const std::vector<ipc::value> &args, std::vector<ipc::value> &rval);
 	static void OBSCallback(void *param, const float magnitude[MAX_AUDIO_CHANNELS], const float peak[MAX_AUDIO_CHANNELS],
 				const float input_peak[MAX_AUDIO_CHANNELS]);
 
 private:
+	static bool AllocateSlot(Volmeter *meter);
+	static void ReleaseSlot(Volmeter *meter);
+
 	static std::chrono::milliseconds GetTime();
 	static bool CheckIdle(std::chrono::milliseconds currentTime, std::chrono::milliseconds lastUpdateTime);
 };
@@ -17,10 +17,12 @@
 ******************************************************************************/
 
 #include "util-crashmanager.h"
+#include "util-flightrecorder.h"
 #include "util-metricsprovider.h"
 
 #include <chrono>
 #include <codecvt>
+#include <cstdio>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -73,7 +75,6 @@ std::vector<std::string> handledOBSCrashes;
 PDH_HQUERY cpuQuery;
 PDH_HCOUNTER cpuTotal;
 std::vector<nlohmann::json> breadcrumbs;
-std::queue<std::pair<int, std::string>> lastActions;
 std::vector<std::string> warnings;
 std::mutex messageMutex;
 util::MetricsProvider metricsClient;
@@ -673,6 +674,7 @@ void util::CrashManager::HandleCrash(const std::string &_crashInfo, bool callAbo
 	}
 
 	SaveBriefCrashInfoToFile();
+	OBS_API::FlushLogs();
 
 	insideCrashMethod = true;
 	try {
@@ -691,8 +693,10 @@ void util::CrashManager::HandleCrash(const std::string &_crashInfo, bool callAbo
 	SetupCrashpad();
 
 	// This value is true by default and only false if we're planning to let crashpad handle cleanup
-	if (callAbort)
+	if (callAbort) {
+		OBS_API::FlushLogs();
 		abort();
+	}
 	else
 		blog(LOG_INFO, "Server finished 'HandleCrash', crashpad will now make a sentry report");
 
@@ -990,11 +994,32 @@ nlohmann::json util::CrashManager::ComputeBreadcrumbs()
 nlohmann::json util::CrashManager::ComputeActions()
 {
 #ifdef WIN32
+	static const size_t MaximumActionsRegistered = 50;
 	nlohmann::json result = nlohmann::json::array();
+	std::vector<std::pair<int, std::string>> actions;
+
+	for (auto &entry : FlightRecorder::Decode()) {
+		// The argument hash keeps calls with different arguments apart, only
+		// true repeats are folded into the counter below
+		char args[16];
+		snprintf(args, sizeof(args), " #%08x", entry.args);
+		std::string message = entry.call + args;
+		if (entry.duration == FlightRecorder::Running)
+			message += " (running)";
+		else if (entry.error != (uint32_t)ErrorCode::Ok)
+			message += " (error " + std::to_string(entry.error) + ")";
+
+		// Check if this and the last message are the same, if true just add a counter
+		if (actions.size() > 0 && message.compare(actions.back().second) == 0)
+			actions.back().first++;
+		else
+			actions.push_back({0, message});
+	}
 
-	while (!lastActions.empty()) {
-		auto counter = lastActions.front().first;
-		auto message = lastActions.front().second;
+	size_t first = actions.size() > MaximumActionsRegistered ? actions.size() - MaximumActionsRegistered : 0;
+	for (size_t i = first; i < actions.size(); i++) {
+		auto counter = actions[i].first;
+		auto message = actions[i].second;
 
 		// Update the message to reflect the count amount, if applicable
 		if (counter > 0) {
@@ -1002,7 +1027,6 @@ nlohmann::json util::CrashManager::ComputeActions()
 		}
 
 		result.push_back(message);
-		lastActions.pop();
 	}
 
 	return result;
@@ -1186,24 +1210,6 @@ void util::CrashManager::AddWarning(const std::string &warning)
 #endif
 }
 
-void RegisterAction(const std::string &message)
-{
-#ifdef WIN32
-	static const int MaximumActionsRegistered = 50;
-	std::lock_guard<std::mutex> lock(messageMutex);
-
-	// Check if this and the last message are the same, if true just add a counter
-	if (lastActions.size() > 0 && message.compare(lastActions.back().second) == 0) {
-		lastActions.back().first++;
-	} else {
-		lastActions.push({0, message});
-		if (lastActions.size() >= MaximumActionsRegistered) {
-			lastActions.pop();
-		}
-	}
-#endif
-}
-
 void util::CrashManager::AddBreadcrumb(const nlohmann::json &message)
 {
 #ifdef WIN32
@@ -1273,26 +1279,23 @@ std::string util::CrashManager::getAppState()
 
 void util::CrashManager::ProcessPreServerCall(const std::string &cname, const std::string &fname, const std::vector<ipc::value> &args)
 {
-	std::string jsonEntry = cname + std::string("::") + fname;
-
-	// Perform this only if this user have a high crash rate (TODO: this check must be implemented)
-	/*
-	nlohmann::json ipcValues = nlohmann::json::array();
-	IPCValuesToData(args, ipcValues);
-	jsonEntry["ipc values"] = ipcValues;
-	*/
-
-	RegisterAction(jsonEntry);
+	FlightRecorder::Begin(cname, fname, args);
 }
 
 void util::CrashManager::ProcessPostServerCall(const std::string &cname, const std::string &fname, const std::vector<ipc::value> &args)
 {
+	FlightRecorder::End(args);
+
+	// The hooks are installed in every build for the flight recorder, warnings
+	// are only collected where a crash report can send them
+#ifdef ENABLE_CRASHREPORT
 	if (args.size() == 0) {
 		AddWarning(std::string("No return params on method ") + fname + std::string(" for class ") + cname);
 	} else if ((ErrorCode)args[0].value_union.ui64 != ErrorCode::Ok) {
 		AddWarning(std::string("Server call returned error number ") + std::to_string(args[0].value_union.ui64) + " on method " + fname +
 			   std::string(" for class ") + cname);
 	}
+#endif
 }
 
 void util::CrashManager::DisableReports()
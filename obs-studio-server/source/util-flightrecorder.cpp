@@ -0,0 +1,271 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#include "util-flightrecorder.h"
+#include <algorithm>
+#include "latency-histogram.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#elif defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+namespace {
+const size_t RecordCount = 256;
+const size_t NameCount = 1024;
+const size_t NameSize = 64;
+const size_t HashedStringBytes = 32;
+
+// A record is valid while sequence holds its claim number plus one, Begin
+// clears it while the other fields are rewritten.
+struct Record {
+	std::atomic<uint64_t> sequence{0};
+	// Ticks since originTicks, duration holds ticks until End completes it.
+	std::atomic<uint64_t> start{0};
+	std::atomic<uint64_t> duration{0};
+	std::atomic<uint32_t> error{0};
+	std::atomic<uint32_t> args{0};
+	std::atomic<uint16_t> call{0};
+};
+
+// Interned "Class::Function" names, the slot index is the id of the call.
+struct Name {
+	std::atomic<uint64_t> key{0};
+	std::atomic<bool> ready{false};
+	char text[NameSize];
+};
+
+Record records[RecordCount];
+Name names[NameCount];
+diagnostics::LatencyHistogram histograms[NameCount]; // In ticks, by call id.
+std::atomic<uint64_t> claimed{0};
+
+// Reading the clock twice per call was most of the cost of recording, the
+// time stamp counter is read instead and only converted to time in Decode.
+inline uint64_t ticks()
+{
+#if (defined(_MSC_VER) && defined(_M_X64)) || defined(__x86_64__)
+	return __rdtsc();
+#else
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+const uint64_t originTicks = ticks();
+const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+
+// Claim of the call in progress on this thread, End completes it.
+thread_local uint64_t current = 0;
+thread_local uint64_t currentStart = 0;
+thread_local uint16_t currentCall = 0;
+
+double nanoseconds_per_tick()
+{
+	double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - origin).count();
+	uint64_t elapsedTicks = ticks() - originTicks;
+	return elapsedTicks > 0 ? elapsed / elapsedTicks : 1;
+}
+
+// Mixes eight bytes at a time, names and arguments are hashed on every call.
+inline void mix(uint64_t &hash, uint64_t word)
+{
+	hash = (hash ^ word) * 0x9E3779B97F4A7C15ull;
+	hash ^= hash >> 29;
+}
+
+inline void hash_bytes(uint64_t &hash, const void *data, size_t size)
+{
+	const char *bytes = static_cast<const char *>(data);
+	uint64_t word;
+	for (; size >= sizeof(word); bytes += sizeof(word), size -= sizeof(word)) {
+		std::memcpy(&word, bytes, sizeof(word));
+		mix(hash, word);
+	}
+	if (size > 0) {
+		word = 0;
+		for (size_t i = 0; i < size; i++)
+			word |= uint64_t(uint8_t(bytes[i])) << (i * 8);
+		mix(hash, word);
+	}
+}
+
+uint16_t intern(const std::string &cname, const std::string &fname)
+{
+	uint64_t key = 14695981039346656037ull;
+	hash_bytes(key, cname.data(), cname.size());
+	mix(key, cname.size());
+	hash_bytes(key, fname.data(), fname.size());
+	if (key == 0)
+		key = 1;
+
+	for (size_t probe = 0; probe < NameCount; probe++) {
+		Name &name = names[(key + probe) % NameCount];
+		uint64_t found = name.key.load(std::memory_order_acquire);
+		if (found == key)
+			return uint16_t((key + probe) % NameCount);
+		if (found != 0)
+			continue;
+
+		if (!name.key.compare_exchange_strong(found, key, std::memory_order_acq_rel)) {
+			if (found == key)
+				return uint16_t((key + probe) % NameCount);
+			continue;
+		}
+
+		std::string text = cname + "::" + fname;
+		size_t size = std::min(text.size(), NameSize - 1);
+		std::memcpy(name.text, text.data(), size);
+		name.text[size] = '\0';
+		name.ready.store(true, std::memory_order_release);
+		return uint16_t((key + probe) % NameCount);
+	}
+	return util::FlightRecorder::UnknownCall;
+}
+
+uint32_t hash_args(const std::vector<ipc::value> &args)
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (const ipc::value &arg : args) {
+		mix(hash, uint64_t(arg.type));
+		switch (arg.type) {
+		case ipc::type::String:
+			hash_bytes(hash, arg.value_str.data(), std::min(arg.value_str.size(), HashedStringBytes));
+			break;
+		case ipc::type::Binary:
+			mix(hash, arg.value_bin.size());
+			break;
+		case ipc::type::Null:
+			break;
+		case ipc::type::Float:
+		case ipc::type::Int32:
+		case ipc::type::UInt32:
+			mix(hash, arg.value_union.ui32);
+			break;
+		default:
+			mix(hash, arg.value_union.ui64);
+			break;
+		}
+	}
+	return uint32_t(hash ^ (hash >> 32));
+}
+}
+
+void util::FlightRecorder::Begin(const std::string &cname, const std::string &fname, const std::vector<ipc::value> &args)
+{
+	uint16_t call = intern(cname, fname);
+	uint64_t claim = claimed.fetch_add(1, std::memory_order_relaxed);
+	Record &record = records[claim % RecordCount];
+
+	current = claim + 1;
+	currentStart = ticks() - originTicks;
+	currentCall = call;
+
+	record.sequence.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	record.start.store(currentStart, std::memory_order_relaxed);
+	record.duration.store(UINT64_MAX, std::memory_order_relaxed);
+	record.error.store(0, std::memory_order_relaxed);
+	record.args.store(hash_args(args), std::memory_order_relaxed);
+	record.call.store(call, std::memory_order_relaxed);
+	record.sequence.store(current, std::memory_order_release);
+}
+
+void util::FlightRecorder::End(const std::vector<ipc::value> &rval)
+{
+	if (current == 0)
+		return;
+
+	Record &record = records[(current - 1) % RecordCount];
+	uint64_t duration = ticks() - originTicks - currentStart;
+	uint32_t error = rval.empty() ? UINT32_MAX : uint32_t(rval[0].value_union.ui64);
+
+	// The ring may have wrapped around while this call ran.
+	if (record.sequence.load(std::memory_order_acquire) == current) {
+		record.error.store(error, std::memory_order_relaxed);
+		record.duration.store(duration, std::memory_order_relaxed);
+	}
+	if (currentCall < NameCount)
+		histograms[currentCall].record(duration);
+	current = 0;
+}
+
+std::vector<util::FlightRecorder::Entry> util::FlightRecorder::Decode()
+{
+	std::vector<Entry> entries;
+	double nanoseconds = nanoseconds_per_tick();
+
+	uint64_t end = claimed.load(std::memory_order_acquire);
+	uint64_t begin = end > RecordCount ? end - RecordCount : 0;
+	entries.reserve(size_t(end - begin));
+
+	for (uint64_t claim = begin; claim < end; claim++) {
+		const Record &record = records[claim % RecordCount];
+		if (record.sequence.load(std::memory_order_acquire) != claim + 1)
+			continue;
+
+		Entry entry;
+		uint16_t call = record.call.load(std::memory_order_relaxed);
+		uint64_t start = record.start.load(std::memory_order_relaxed);
+		uint64_t duration = record.duration.load(std::memory_order_relaxed);
+		entry.error = record.error.load(std::memory_order_relaxed);
+		entry.args = record.args.load(std::memory_order_relaxed);
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (record.sequence.load(std::memory_order_relaxed) != claim + 1)
+			continue;
+
+		entry.start = uint64_t(start * nanoseconds);
+		entry.duration = duration == UINT64_MAX ? Running : uint32_t(std::min(duration * nanoseconds / 1000, double(Running - 1)));
+		if (call < NameCount && names[call].ready.load(std::memory_order_acquire))
+			entry.call = names[call].text;
+		else
+			entry.call = "unknown";
+		entries.push_back(std::move(entry));
+	}
+	return entries;
+}
+
+std::vector<util::FlightRecorder::CallStats> util::FlightRecorder::Stats()
+{
+	std::vector<CallStats> result;
+	double nanoseconds = nanoseconds_per_tick();
+
+	for (size_t call = 0; call < NameCount; call++) {
+		const diagnostics::LatencyHistogram &histogram = histograms[call];
+		if (!names[call].ready.load(std::memory_order_acquire) || histogram.count() == 0)
+			continue;
+
+		CallStats stats;
+		stats.call = names[call].text;
+		size_t separator = stats.call.find("::");
+		if (separator != std::string::npos)
+			stats.call.replace(separator, 2, ".");
+		stats.calls = histogram.count();
+		stats.p50 = uint64_t(histogram.percentile(0.5) * nanoseconds);
+		stats.p90 = uint64_t(histogram.percentile(0.9) * nanoseconds);
+		stats.p99 = uint64_t(histogram.percentile(0.99) * nanoseconds);
+		stats.max = uint64_t(histogram.max() * nanoseconds);
+		stats.mean = uint64_t(histogram.mean() * nanoseconds);
+		result.push_back(std::move(stats));
+	}
+	return result;
+}
@@ -0,0 +1,66 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <ipc.hpp>
+
+namespace util {
+// Keeps the last IPC calls of the server for crash reports, and the latency
+// histogram of every IPC function for Diagnostics.GetIpcStats.
+//
+// Every call takes one slot of a fixed ring of binary records. Names are
+// interned the first time a function is called, after that recording neither
+// allocates nor locks. Records only become text in Decode, when a crash
+// report is written.
+class FlightRecorder {
+public:
+	static const uint32_t Running = UINT32_MAX;
+	static const uint16_t UnknownCall = UINT16_MAX;
+
+	struct Entry {
+		std::string call;
+		uint64_t start;    // Nanoseconds since the recorder started.
+		uint32_t duration; // Microseconds, Running if the call never returned.
+		uint32_t error;
+		uint32_t args; // Hash of the arguments, tells repeated calls apart.
+	};
+
+	// Handler time of one IPC function, in nanoseconds.
+	struct CallStats {
+		std::string call; // "Class.Function"
+		uint64_t calls;
+		uint64_t p50;
+		uint64_t p90;
+		uint64_t p99;
+		uint64_t max;
+		uint64_t mean;
+	};
+
+	static void Begin(const std::string &cname, const std::string &fname, const std::vector<ipc::value> &args);
+	static void End(const std::vector<ipc::value> &rval);
+
+	// Oldest first. Safe to call from any thread, also while calls are recorded.
+	static std::vector<Entry> Decode();
+
+	// Every function called since the server started, see latency-histogram.hpp.
+	static std::vector<CallStats> Stats();
+};
+}
@@ -0,0 +1,194 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#include "util-logsink.h"
+
+// Upper bound of an idle sleep, only matters if a wake up got lost.
+static const std::chrono::milliseconds idle_wait(1000);
+
+util::LogSink::LogSink(size_t capacity, std::chrono::milliseconds flush_interval, write_t write, flush_t flush)
+	: flush_interval(flush_interval), write_cb(write), flush_cb(flush)
+{
+	size_t size = 2;
+	while (size < capacity)
+		size <<= 1;
+
+	cells.reset(new Cell[size]);
+	mask = size - 1;
+	for (size_t i = 0; i < size; i++)
+		cells[i].sequence.store(i, std::memory_order_relaxed);
+
+	thread = std::thread(&LogSink::worker, this);
+}
+
+util::LogSink::~LogSink()
+{
+	{
+		std::unique_lock<std::mutex> ulock(mtx);
+		stop = true;
+		sleeping.store(false);
+		cv.notify_one();
+	}
+
+	if (thread.joinable())
+		thread.join();
+}
+
+// Bounded MPMC queue from Dmitry Vyukov, used with a single consumer.
+bool util::LogSink::try_push(int level, std::string &line)
+{
+	size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+	Cell *cell;
+	for (;;) {
+		cell = &cells[pos & mask];
+		size_t sequence = cell->sequence.load(std::memory_order_acquire);
+		intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+		if (diff == 0) {
+			if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		} else if (diff < 0) {
+			return false;
+		} else {
+			pos = enqueue_pos.load(std::memory_order_relaxed);
+		}
+	}
+
+	cell->level = level;
+	cell->line = std::move(line);
+	cell->sequence.store(pos + 1, std::memory_order_release);
+	return true;
+}
+
+bool util::LogSink::pop(int &level, std::string &line)
+{
+	Cell &cell = cells[dequeue_pos & mask];
+	if (cell.sequence.load(std::memory_order_acquire) != dequeue_pos + 1)
+		return false;
+
+	level = cell.level;
+	line = std::move(cell.line);
+	cell.sequence.store(dequeue_pos + mask + 1, std::memory_order_release);
+	dequeue_pos++;
+	return true;
+}
+
+void util::LogSink::wake()
+{
+	// Pairs with the fence in worker(), either the writer sees the new record
+	// or we see that it went to sleep.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (!sleeping.load(std::memory_order_relaxed) || !sleeping.exchange(false))
+		return;
+
+	std::unique_lock<std::mutex> ulock(mtx);
+	cv.notify_one();
+}
+
+bool util::LogSink::push(int level, std::string &&line)
+{
+	while (!try_push(level, line)) {
+		if (level >= debug_level && drop_debug.load(std::memory_order_relaxed)) {
+			dropped_count.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		// The writer itself must never wait on the ring it drains.
+		if (std::this_thread::get_id() == thread.get_id()) {
+			write_cb(level, line);
+			return true;
+		}
+
+		wake();
+		std::this_thread::yield();
+	}
+
+	wake();
+	return true;
+}
+
+bool util::LogSink::flush(std::chrono::milliseconds timeout)
+{
+	if (std::this_thread::get_id() == thread.get_id())
+		return false;
+
+	std::unique_lock<std::mutex> ulock(mtx);
+	uint64_t ticket = ++flush_requested;
+	sleeping.store(false);
+	cv.notify_one();
+	return cv_flushed.wait_for(ulock, timeout, [this, ticket]() { return flush_done >= ticket; });
+}
+
+void util::LogSink::worker()
+{
+	auto last_flush = std::chrono::steady_clock::now();
+	bool dirty = false;
+	uint64_t reported_drops = 0;
+	int level = 0;
+	std::string line;
+
+	for (;;) {
+		uint64_t requested = 0;
+		bool stopping = false;
+		{
+			std::unique_lock<std::mutex> ulock(mtx);
+			requested = flush_requested;
+			stopping = stop;
+		}
+
+		bool urgent = false;
+		while (pop(level, line)) {
+			write_cb(level, line);
+			urgent |= level <= flush_level;
+			dirty = true;
+		}
+
+		uint64_t drops = dropped();
+		if (drops != reported_drops) {
+			write_cb(300, "[LogSink] Dropped " + std::to_string(drops - reported_drops) + " debug messages, the log writer could not keep up.\n");
+			reported_drops = drops;
+			dirty = true;
+		}
+
+		auto now = std::chrono::steady_clock::now();
+		if (dirty && (urgent || stopping || requested != flush_done || now - last_flush >= flush_interval)) {
+			flush_cb();
+			dirty = false;
+			last_flush = now;
+		}
+
+		std::unique_lock<std::mutex> ulock(mtx);
+		if (requested != flush_done) {
+			flush_done = requested;
+			cv_flushed.notify_all();
+		}
+
+		if (stopping)
+			break;
+
+		sleeping.store(true);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (cells[dequeue_pos & mask].sequence.load(std::memory_order_relaxed) == dequeue_pos + 1) {
+			sleeping.store(false);
+			continue;
+		}
+
+		auto wait = dirty ? flush_interval - std::chrono::duration_cast<std::chrono::milliseconds>(now - last_flush) : idle_wait;
+		cv.wait_for(ulock, wait, [this]() { return !sleeping.load() || stop || flush_requested != flush_done; });
+		sleeping.store(false);
+	}
+}
@@ -0,0 +1,94 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace util {
+// Asynchronous log sink.
+//
+// Any number of threads push pre-formatted records into a bounded lock-free
+// ring, a single writer thread drains it in batches and flushes at most every
+// flush_interval (or right away after an error record).
+class LogSink {
+public:
+	typedef std::function<void(int level, const std::string &line)> write_t;
+	typedef std::function<void()> flush_t;
+
+	// Records at or below this level are flushed as soon as they are written.
+	static constexpr int flush_level = 200; // LOG_ERROR
+	static constexpr int debug_level = 400; // LOG_DEBUG
+
+	LogSink(size_t capacity, std::chrono::milliseconds flush_interval, write_t write, flush_t flush);
+	~LogSink();
+
+	// Queues a record. When the ring is full debug records are dropped if
+	// drop_debug is set, any other record waits for the writer.
+	// Returns false if the record was dropped.
+	bool push(int level, std::string &&line);
+
+	// Waits until everything queued so far is written and flushed, or until
+	// the timeout expired. Returns false on timeout.
+	bool flush(std::chrono::milliseconds timeout);
+
+	void set_drop_debug(bool drop) { drop_debug.store(drop, std::memory_order_relaxed); }
+	uint64_t dropped() const { return dropped_count.load(std::memory_order_relaxed); }
+
+private:
+	struct Cell {
+		std::atomic<size_t> sequence;
+		int level;
+		std::string line;
+	};
+
+	bool try_push(int level, std::string &line);
+	bool pop(int &level, std::string &line);
+	void wake();
+	void worker();
+
+	std::unique_ptr<Cell[]> cells;
+	size_t mask;
+	alignas(64) std::atomic<size_t> enqueue_pos{0};
+	alignas(64) size_t dequeue_pos = 0;
+
+	std::chrono::milliseconds flush_interval;
+	write_t write_cb;
+	flush_t flush_cb;
+
+	std::atomic<bool> drop_debug{true};
+	std::atomic<uint64_t> dropped_count{0};
+
+	// The writer only takes the mutex to sleep, producers take it only when
+	// the writer announced it is sleeping.
+	std::mutex mtx;
+	std::condition_variable cv;
+	std::condition_variable cv_flushed;
+	std::atomic<bool> sleeping{false};
+	uint64_t flush_requested = 0;
+	uint64_t flush_done = 0;
+	bool stop = false;
+	std::thread thread;
+};
+} // namespace util
@@ -0,0 +1,306 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#include "util-modulemanifest.h"
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <obs.h>
+#include <obs-module.h>
+#include <sys/stat.h>
+#include <util/platform.h>
+
+namespace {
+const int64_t Version = 1;
+
+std::mutex mtx;
+std::string manifestPath;
+std::vector<util::ModuleManifest::Module> modules;
+std::map<std::string, size_t> sourceTypes; // Of the modules not loaded yet
+
+typedef bool (*enum_types_t)(size_t idx, const char **id);
+
+struct TypeList {
+	const char *key;
+	enum_types_t enumerate;
+	std::vector<std::string> util::ModuleManifest::Module::*types;
+};
+
+const TypeList typeLists[] = {
+	{"inputs", obs_enum_input_types, &util::ModuleManifest::Module::inputs},
+	{"filters", obs_enum_filter_types, &util::ModuleManifest::Module::filters},
+	{"transitions", obs_enum_transition_types, &util::ModuleManifest::Module::transitions},
+	{"encoders", obs_enum_encoder_types, &util::ModuleManifest::Module::encoders},
+	{"outputs", obs_enum_output_types, &util::ModuleManifest::Module::outputs},
+	{"services", obs_enum_service_types, &util::ModuleManifest::Module::services},
+};
+const size_t TypeListCount = sizeof(typeLists) / sizeof(typeLists[0]);
+
+size_t count_types(enum_types_t enumerate)
+{
+	const char *id = nullptr;
+	size_t count = 0;
+	while (enumerate(count, &id))
+		count++;
+	return count;
+}
+
+int64_t modified_time(const std::string &path)
+{
+	struct stat st;
+	if (os_stat(path.c_str(), &st) != 0)
+		return 0;
+	return int64_t(st.st_mtime);
+}
+
+bool is_lazy(const util::ModuleManifest::Module &module)
+{
+	return module.encoders.empty() && module.outputs.empty() && module.services.empty() &&
+	       !(module.inputs.empty() && module.filters.empty() && module.transitions.empty());
+}
+
+std::string file_name(const std::string &path)
+{
+	size_t separator = path.find_last_of("/\\");
+	return separator == std::string::npos ? path : path.substr(separator + 1);
+}
+
+// libobs appends types as modules register them, so the types of a module are
+// the ones past the counts taken before it was initialized.
+bool load_module(util::ModuleManifest::Module &module)
+{
+	size_t counts[TypeListCount];
+	for (size_t i = 0; i < TypeListCount; i++)
+		counts[i] = count_types(typeLists[i].enumerate);
+
+	obs_module_t *handle = nullptr;
+	int code = obs_open_module(&handle, module.binaryPath.c_str(), module.dataPath.c_str());
+	if (code == MODULE_MISSING_EXPORTS) {
+		blog(LOG_DEBUG, "Skipping module '%s', not an OBS plugin", module.binaryPath.c_str());
+		module.loaded = true;
+		return true;
+	}
+	if (code != MODULE_SUCCESS || !obs_init_module(handle)) {
+		blog(LOG_WARNING, "Failed to load module '%s', error %d", module.binaryPath.c_str(), code);
+		return false;
+	}
+	module.loaded = true;
+
+	for (size_t i = 0; i < TypeListCount; i++) {
+		std::vector<std::string> &types = module.*typeLists[i].types;
+		types.clear();
+		const char *id = nullptr;
+		for (size_t idx = counts[i]; typeLists[i].enumerate(idx, &id); idx++)
+			types.push_back(id ? id : "");
+	}
+	return true;
+}
+
+void read_manifest(std::map<std::string, util::ModuleManifest::Module> &entries)
+{
+	obs_data_t *data = obs_data_create_from_json_file_safe(manifestPath.c_str(), "bak");
+	if (!data)
+		return;
+
+	if (obs_data_get_int(data, "version") == Version) {
+		obs_data_array_t *array = obs_data_get_array(data, "modules");
+		for (size_t i = 0; array && i < obs_data_array_count(array); i++) {
+			obs_data_t *item = obs_data_array_item(array, i);
+			util::ModuleManifest::Module module;
+			module.binaryPath = obs_data_get_string(item, "binary");
+			module.modified = obs_data_get_int(item, "modified");
+			for (const TypeList &list : typeLists) {
+				obs_data_array_t *types = obs_data_get_array(item, list.key);
+				for (size_t j = 0; types && j < obs_data_array_count(types); j++) {
+					obs_data_t *type = obs_data_array_item(types, j);
+					(module.*list.types).push_back(obs_data_get_string(type, "id"));
+					obs_data_release(type);
+				}
+				obs_data_array_release(types);
+			}
+			entries[module.binaryPath] = std::move(module);
+			obs_data_release(item);
+		}
+		obs_data_array_release(array);
+	}
+	obs_data_release(data);
+}
+
+void write_manifest()
+{
+	obs_data_t *data = obs_data_create();
+	obs_data_array_t *array = obs_data_array_create();
+	for (const auto &module : modules) {
+		obs_data_t *item = obs_data_create();
+		obs_data_set_string(item, "binary", module.binaryPath.c_str());
+		obs_data_set_int(item, "modified", module.modified);
+		for (const TypeList &list : typeLists) {
+			obs_data_array_t *types = obs_data_array_create();
+			for (const auto &id : module.*list.types) {
+				obs_data_t *type = obs_data_create();
+				obs_data_set_string(type, "id", id.c_str());
+				obs_data_array_push_back(types, type);
+				obs_data_release(type);
+			}
+			obs_data_set_array(item, list.key, types);
+			obs_data_array_release(types);
+		}
+		obs_data_array_push_back(array, item);
+		obs_data_release(item);
+	}
+	obs_data_set_int(data, "version", Version);
+	obs_data_set_array(data, "modules", array);
+	obs_data_array_release(array);
+
+	if (!obs_data_save_json_safe(data, manifestPath.c_str(), "tmp", "bak"))
+		blog(LOG_WARNING, "Failed to save the module manifest to %s", manifestPath.c_str());
+	obs_data_release(data);
+}
+
+std::vector<std::string> with_pending(enum_types_t enumerate, std::vector<std::string> util::ModuleManifest::Module::*types)
+{
+	std::vector<std::string> result;
+	const char *id = nullptr;
+	for (size_t idx = 0; enumerate(idx, &id); idx++)
+		result.push_back(id ? id : "");
+
+	std::lock_guard<std::mutex> lock(mtx);
+	for (const auto &module : modules) {
+		if (module.loaded)
+			continue;
+		for (const auto &type : module.*types) {
+			if (std::find(result.begin(), result.end(), type) == result.end())
+				result.push_back(type);
+		}
+	}
+	return result;
+}
+}
+
+void util::ModuleManifest::LoadModules(const std::string &path, std::vector<std::string> &failed)
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	manifestPath = path;
+
+	std::map<std::string, Module> entries;
+	read_manifest(entries);
+
+	struct Found {
+		std::map<std::string, Module> &entries;
+		std::vector<Module> &modules;
+	} found{entries, modules};
+
+	obs_find_modules2(
+		[](void *param, const struct obs_module_info2 *info) {
+			Found &found = *static_cast<Found *>(param);
+			Module module;
+			auto entry = found.entries.find(info->bin_path);
+			if (entry != found.entries.end())
+				module = std::move(entry->second);
+			module.name = info->name;
+			module.binaryPath = info->bin_path;
+			module.dataPath = info->data_path;
+			found.modules.push_back(std::move(module));
+		},
+		&found);
+
+	bool changed = modules.size() != entries.size();
+	size_t pending = 0;
+	for (size_t i = 0; i < modules.size(); i++) {
+		Module &module = modules[i];
+		int64_t modified = modified_time(module.binaryPath);
+		if (module.modified == modified && is_lazy(module)) {
+			for (const auto &type : module.inputs)
+				sourceTypes.emplace(type, i);
+			for (const auto &type : module.filters)
+				sourceTypes.emplace(type, i);
+			for (const auto &type : module.transitions)
+				sourceTypes.emplace(type, i);
+			pending++;
+			continue;
+		}
+
+		changed |= module.modified != modified;
+		module.modified = modified;
+		if (!load_module(module))
+			failed.push_back(module.name);
+	}
+
+	blog(LOG_INFO, "Modules: %zu loaded, %zu deferred until one of their sources is created", modules.size() - pending, pending);
+	if (changed)
+		write_manifest();
+}
+
+void util::ModuleManifest::LoadSourceType(const std::string &id)
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	auto found = sourceTypes.find(id);
+	if (found == sourceTypes.end())
+		return;
+
+	Module &module = modules[found->second];
+	Module recorded = module;
+	for (const auto &type : recorded.inputs)
+		sourceTypes.erase(type);
+	for (const auto &type : recorded.filters)
+		sourceTypes.erase(type);
+	for (const auto &type : recorded.transitions)
+		sourceTypes.erase(type);
+
+	// Initialized on this IPC thread and under mtx, see the header
+	blog(LOG_INFO, "Loading module '%s' for source type '%s'", module.name.c_str(), id.c_str());
+	if (!load_module(module)) {
+		// Loaded right away at the next startup
+		module.modified = 0;
+		write_manifest();
+		return;
+	}
+
+	for (const TypeList &list : typeLists) {
+		if (module.*list.types != recorded.*list.types) {
+			write_manifest();
+			break;
+		}
+	}
+}
+
+std::vector<std::string> util::ModuleManifest::InputTypes()
+{
+	return with_pending(obs_enum_input_types, &Module::inputs);
+}
+
+std::vector<std::string> util::ModuleManifest::FilterTypes()
+{
+	return with_pending(obs_enum_filter_types, &Module::filters);
+}
+
+std::vector<std::string> util::ModuleManifest::TransitionTypes()
+{
+	return with_pending(obs_enum_transition_types, &Module::transitions);
+}
+
+std::vector<std::string> util::ModuleManifest::PendingModules()
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	std::vector<std::string> result;
+	for (const auto &module : modules) {
+		if (!module.loaded)
+			result.push_back(file_name(module.binaryPath));
+	}
+	return result;
+}
@@ -0,0 +1,74 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace util {
+// Plugin modules and the types each one registers, saved to a json file so
+// that the types of a module are known without opening it.
+//
+// Modules without a current entry (same modification time) are opened and
+// initialized one at a time, which is how the types of each one are told
+// apart. A module whose entry is current and that registers nothing but
+// sources is left closed until one of its types is used, see LoadSourceType.
+// Modules registering encoders, outputs or services are always loaded, the
+// settings enumerate those types at startup.
+class ModuleManifest {
+public:
+	struct Module {
+		std::string name;
+		std::string binaryPath;
+		std::string dataPath;
+		int64_t modified = 0;
+		std::vector<std::string> inputs;
+		std::vector<std::string> filters;
+		std::vector<std::string> transitions;
+		std::vector<std::string> encoders;
+		std::vector<std::string> outputs;
+		std::vector<std::string> services;
+		bool loaded = false;
+	};
+
+	// Replaces obs_load_all_modules2, path is the manifest file. failed holds
+	// the names of the modules that could not be loaded.
+	static void LoadModules(const std::string &path, std::vector<std::string> &failed);
+
+	// Loads the module registering the source type id if it is still closed.
+	// Call before anything looks the type up in libobs: source creation,
+	// obs_get_source_defaults, obs_get_source_output_flags and the like.
+	// A lookup that skips it sees the type as unknown while lazy loading is on.
+	//
+	// Runs obs_init_module on the calling IPC thread with the manifest lock
+	// held, so that a concurrent call for another type of the same module
+	// waits until that module has registered its types. Module load code must
+	// not call back into ModuleManifest, and a module whose obs_module_load
+	// expects the startup thread is not safe to defer.
+	static void LoadSourceType(const std::string &id);
+
+	// Registered types followed by those of the modules not loaded yet.
+	static std::vector<std::string> InputTypes();
+	static std::vector<std::string> FilterTypes();
+	static std::vector<std::string> TransitionTypes();
+
+	// File names of the modules not loaded yet.
+	static std::vector<std::string> PendingModules();
+};
+}
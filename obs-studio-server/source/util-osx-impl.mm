@@ -119,6 +119,9 @@ unsigned long long UtilObjCInt::getTotalPhysicalMemory(void)
 	return [NSProcessInfo processInfo].physicalMemory;
 }
 
+// Free pages plus those macOS drops without writing them out, inactive and
+// purgeable ones. Compressed and swapped memory is not counted, so this is a
+// lower bound of what the system could still give the process.
 unsigned long long UtilObjCInt::getAvailableMemory(void)
 {
 	mach_port_t host_port;
@@ -126,20 +129,16 @@ unsigned long long UtilObjCInt::getAvailableMemory(void)
 	vm_size_t pagesize;
 
 	host_port = mach_host_self();
-	host_size = sizeof(vm_statistics_data_t) / sizeof(integer_t);
+	host_size = HOST_VM_INFO64_COUNT;
 	host_page_size(host_port, &pagesize);
 
-	vm_statistics_data_t vm_stat;
+	vm_statistics64_data_t vm_stat;
 
-	if (host_statistics(host_port, HOST_VM_INFO, (host_info_t)&vm_stat, &host_size) != KERN_SUCCESS)
+	if (host_statistics64(host_port, HOST_VM_INFO64, (host_info64_t)&vm_stat, &host_size) != KERN_SUCCESS)
 		return 0;
 
-	// uint64_t mem_used = (uint64_t)(vm_stat.active_count +
-	//                       vm_stat.inactive_count +
-	//                       vm_stat.wire_count) * (uint64_t)pagesize;
-
-	uint64_t mem_free = (uint64_t)vm_stat.free_count * (uint64_t)pagesize * 10;
-	return mem_free;
+	uint64_t pages = (uint64_t)vm_stat.free_count + (uint64_t)vm_stat.inactive_count + (uint64_t)vm_stat.purgeable_count;
+	return pages * (uint64_t)pagesize;
 }
 
 std::vector<std::pair<uint32_t, uint32_t>> UtilObjCInt::getAvailableScreenResolutions(void)
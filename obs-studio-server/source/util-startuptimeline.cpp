@@ -0,0 +1,70 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#include "util-startuptimeline.h"
+#include <mutex>
+#include <util/base.h>
+
+namespace {
+const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+
+std::mutex mutex;
+std::vector<util::StartupTimeline::Phase> phases;
+size_t logged = 0;
+
+uint64_t since_origin(std::chrono::steady_clock::time_point time)
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(time - origin).count();
+}
+}
+
+void util::StartupTimeline::Record(const std::string &name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end,
+				   bool background)
+{
+	Phase phase;
+	phase.name = name;
+	phase.start = since_origin(start);
+	phase.duration = since_origin(end) - phase.start;
+	phase.background = background;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	phases.push_back(std::move(phase));
+}
+
+std::chrono::steady_clock::time_point util::StartupTimeline::Mark(const std::string &name, std::chrono::steady_clock::time_point start, bool background)
+{
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+	Record(name, start, end, background);
+	return end;
+}
+
+std::vector<util::StartupTimeline::Phase> util::StartupTimeline::Phases()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return phases;
+}
+
+void util::StartupTimeline::Log()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	for (; logged < phases.size(); logged++) {
+		const Phase &phase = phases[logged];
+		blog(LOG_INFO, "Startup: %s took %.1f ms (at %.1f ms%s)", phase.name.c_str(), phase.duration / 1000.0, phase.start / 1000.0,
+		     phase.background ? ", in the background" : "");
+	}
+}
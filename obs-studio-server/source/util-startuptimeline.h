@@ -0,0 +1,53 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace util {
+// Wall time of the phases of the server startup, logged once OBS_API_initAPI
+// is done and returned by Diagnostics.GetStartupTimeline.
+//
+// Times are in microseconds since the server process started. Phases may be
+// recorded from any thread, work deferred to a background task is marked.
+class StartupTimeline {
+public:
+	struct Phase {
+		std::string name;
+		uint64_t start;
+		uint64_t duration;
+		bool background;
+	};
+
+	static void Record(const std::string &name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end,
+			   bool background = false);
+
+	// Records a phase that ends now and returns the end, which is where the
+	// next phase starts.
+	static std::chrono::steady_clock::time_point Mark(const std::string &name, std::chrono::steady_clock::time_point start, bool background = false);
+
+	// In the order the phases ended.
+	static std::vector<Phase> Phases();
+
+	// Writes the phases recorded since the last call to the log.
+	static void Log();
+};
+}
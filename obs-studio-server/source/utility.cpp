@@ -19,6 +19,10 @@
 #include "utility.hpp"
 #include "obs-property.hpp"
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 std::string utility::osn_current_version(const std::string &_version)
 {
 	static std::string current_version = "";
@@ -28,31 +32,51 @@ std::string utility::osn_current_version(const std::string &_version)
 	return current_version;
 }
 
+// Ids are kept in a three level bitmap. A set bit in `used` marks an allocated
+// id, a set bit in `full` marks a word of `used` with no free id left and a set
+// bit in `full_groups` marks a word of `full` that is all ones. Finding the
+// lowest free id is then three count-trailing-zero operations per 262144 ids.
+static const utility::unique_id::id_t unique_id_limit = utility::unique_id::id_t(1) << 32;
+static const uint64_t word_full = std::numeric_limits<uint64_t>::max();
+
+static inline uint32_t lowest_zero_bit(uint64_t word)
+{
+	uint64_t free_bits = ~word;
+#if defined(_MSC_VER)
+	unsigned long index = 0;
+	_BitScanForward64(&index, free_bits);
+	return index;
+#else
+	return __builtin_ctzll(free_bits);
+#endif
+}
+
+static inline uint64_t word_or_empty(const std::vector<uint64_t> &words, size_t index)
+{
+	return index < words.size() ? words[index] : 0;
+}
+
 utility::unique_id::unique_id() {}
 
 utility::unique_id::~unique_id() {}
 
 utility::unique_id::id_t utility::unique_id::allocate()
 {
-	if (allocated.size() > 0) {
-		for (auto &v : allocated) {
-			if (v.first > 0) {
-				utility::unique_id::id_t v2 = v.first - 1;
-				mark_used(v2);
-				return v2;
-			} else if (v.second < std::numeric_limits<utility::unique_id::id_t>::max()) {
-				utility::unique_id::id_t v2 = v.second + 1;
-				mark_used(v2);
-				return v2;
-			}
-		}
-	} else {
-		mark_used(0);
-		return 0;
+	// Words past the end of a level are implicitly empty, so walking down
+	// from the first group that is not full always yields the lowest free id.
+	size_t group = 0;
+	while (group < full_groups.size() && full_groups[group] == word_full)
+		group++;
+
+	size_t full_index = group * 64 + lowest_zero_bit(word_or_empty(full_groups, group));
+	size_t used_index = full_index * 64 + lowest_zero_bit(word_or_empty(full, full_index));
+	id_t v = used_index * 64 + lowest_zero_bit(word_or_empty(used, used_index));
+
+	if (!mark_used(v)) {
+		// No more free indexes. However that has happened.
+		return std::numeric_limits<utility::unique_id::id_t>::max();
 	}
-
-	// No more free indexes. However that has happened.
-	return std::numeric_limits<utility::unique_id::id_t>::max();
+	return v;
 }
 
 void utility::unique_id::free(utility::unique_id::id_t v)
@@ -62,78 +86,43 @@ void utility::unique_id::free(utility::unique_id::id_t v)
 
 bool utility::unique_id::is_allocated(utility::unique_id::id_t v)
 {
-	for (auto &v2 : allocated) {
-		if ((v >= v2.first) && (v <= v2.second))
-			return true;
-	}
-	return false;
+	if (v >= unique_id_limit)
+		return false;
+	return (word_or_empty(used, v / 64) >> (v % 64)) & 1;
 }
 
 utility::unique_id::id_t utility::unique_id::count(bool count_free)
 {
-	id_t count = 0;
-	for (auto &v : allocated) {
-		count += (v.second - v.first);
-	}
-	return count_free ? (std::numeric_limits<id_t>::max() - count) : count;
+	return count_free ? (std::numeric_limits<id_t>::max() - used_count) : used_count;
 }
 
 bool utility::unique_id::mark_used(utility::unique_id::id_t v)
 {
-	// If no elements have been assigned, simply insert v as used.
-	if (allocated.size() == 0) {
-		range_t r;
-		r.first = r.second = v;
-		allocated.push_back(r);
-		return true;
+	if (v >= unique_id_limit)
+		return false;
+
+	size_t used_index = v / 64;
+	size_t full_index = used_index / 64;
+	size_t group = full_index / 64;
+	if (used_index >= used.size())
+		used.resize(used_index + 1, 0);
+	if (full_index >= full.size())
+		full.resize(full_index + 1, 0);
+	if (group >= full_groups.size())
+		full_groups.resize(group + 1, 0);
+
+	uint64_t bit = uint64_t(1) << (v % 64);
+	if (used[used_index] & bit)
+		return false;
+
+	used[used_index] |= bit;
+	used_count++;
+	if (used[used_index] == word_full) {
+		full[full_index] |= uint64_t(1) << (used_index % 64);
+		if (full[full_index] == word_full)
+			full_groups[group] |= uint64_t(1) << (full_index % 64);
 	}
-
-	// Otherwise, attempt to find the best fitting element.
-	bool lastWasSmaller = false;
-	for (auto iter = allocated.begin(); iter != allocated.end(); iter++) {
-		auto fiter = std::list<range_t>::iterator(iter);
-		auto riter = std::list<range_t>::reverse_iterator(iter);
-		if ((iter->first > 0) && (v == (iter->first - 1))) {
-			// If the minimum of the selected element is > 0 and v is equal to
-			//  (minimum - 1), decrease the minimum.
-			iter->first--;
-
-			// Then test if the previous elements maximum is equal to (v - 1),
-			//  if so merge the two since they are now continuous.
-			riter--;
-			if ((riter != allocated.rend()) && (riter->second == (v - 1))) {
-				riter->second = iter->second;
-				allocated.erase(iter);
-			}
-
-			return true;
-		} else if ((iter->second < std::numeric_limits<utility::unique_id::id_t>::max()) && (v == (iter->second + 1))) {
-			// If the maximum of the selected element is < UINT_MAX and v is
-			//  equal to (maximum + 1), increase the maximum.
-			iter->second++;
-
-			// Then test if the next elements minimum is equal to (v + 1),
-			//  if so merge the two since they are now continuous.
-			fiter++;
-			if ((fiter != allocated.end()) && (fiter->first == (v + 1))) {
-				iter->second = fiter->second;
-				allocated.erase(fiter);
-			}
-
-			return true;
-		} else if (lastWasSmaller && (v < iter->first)) {
-			// If we are between two ranges that are smaller and larger than v
-			//  insert a new element before the larger range containing only v.
-			allocated.insert(iter, {v, v});
-			return true;
-		} else if ((fiter++) == allocated.end()) {
-			// Otherwise if we reached the end of the list, append v.
-			allocated.insert(fiter, {v, v});
-			return true;
-		}
-		lastWasSmaller = (v > iter->second);
-	}
-	return false;
+	return true;
 }
 
 void utility::unique_id::mark_used_range(utility::unique_id::id_t min, utility::unique_id::id_t max)
@@ -145,40 +134,18 @@ void utility::unique_id::mark_used_range(utility::unique_id::id_t min, utility::
 
 bool utility::unique_id::mark_free(utility::unique_id::id_t v)
 {
-	for (auto iter = allocated.begin(); iter != allocated.end(); iter++) {
-		// Is v inside this range?
-		if ((v >= iter->first) && (v <= iter->second)) {
-			if (v == iter->first) {
-				// If v is simply the beginning of the range, increase the
-				//  minimum and test if the range is now no longer valid.
-				iter->first++;
-				if (iter->first > iter->second) {
-					// If the range is no longer valid, just erase it.
-					allocated.erase(iter);
-				}
-				return true;
-			} else if (v == iter->second) {
-				// If v is simply the end of the range, decrease the maximum
-				//  and test if the range is now no longer valid.
-				iter->second--;
-				if (iter->second < iter->first) {
-					// If the range is no longer valid, just erase it.
-					allocated.erase(iter);
-				}
-				return true;
-			} else {
-				// Otherwise, since v is inside the range, split the range at
-				// v and insert a new element.
-				range_t x;
-				x.first = iter->first;
-				x.second = v - 1;
-				iter->first = v + 1;
-				allocated.insert(iter, x);
-				return true;
-			}
-		}
-	}
-	return false;
+	if (!is_allocated(v))
+		return false;
+
+	size_t used_index = v / 64;
+	size_t full_index = used_index / 64;
+	size_t group = full_index / 64;
+
+	used[used_index] &= ~(uint64_t(1) << (v % 64));
+	full[full_index] &= ~(uint64_t(1) << (used_index % 64));
+	full_groups[group] &= ~(uint64_t(1) << (full_index % 64));
+	used_count--;
+	return true;
 }
 
 void utility::unique_id::mark_free_range(utility::unique_id::id_t min, utility::unique_id::id_t max)
@@ -189,6 +156,14 @@ void utility::unique_id::mark_free_range(utility::unique_id::id_t min, utility::
 }
 
 void utility::ProcessProperties(obs_properties_t *prp, obs_data *settings, std::vector<ipc::value> &rval)
+{
+	obs::PropertySnapshot snapshot;
+	SerializeProperties(prp, settings, snapshot);
+	for (auto &entry : snapshot.entries)
+		rval.push_back(ipc::value(std::vector<char>(snapshot.data(entry), snapshot.data(entry) + entry.size)));
+}
+
+void utility::SerializeProperties(obs_properties_t *prp, obs_data *settings, obs::PropertySnapshot &snapshot)
 {
 	const char *buf = nullptr;
 	for (obs_property_t *p = obs_properties_first(prp); (p != nullptr); obs_property_next(&p)) {
@@ -360,7 +335,7 @@ void utility::ProcessProperties(obs_properties_t *prp, obs_data *settings, std::
 		}
 		case OBS_PROPERTY_GROUP: {
 			auto grp = obs_property_group_content(p);
-			ProcessProperties(grp, settings, rval);
+			SerializeProperties(grp, settings, snapshot);
 			prop = nullptr;
 			break;
 		}
@@ -376,10 +351,7 @@ void utility::ProcessProperties(obs_properties_t *prp, obs_data *settings, std::
 		prop->enabled = obs_property_enabled(p);
 		prop->visible = obs_property_visible(p);
 
-		std::vector<char> buf(prop->size());
-		if (prop->serialize(buf)) {
-			rval.push_back(ipc::value(buf));
-		}
+		snapshot.add(*prop);
 	}
 }
 
@@ -17,13 +17,19 @@
 ******************************************************************************/
 
 #pragma once
+#include <array>
+#include <atomic>
 #include <functional>
 #include <limits>
 #include <list>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 #include <obs.h>
 #include <ipc-server.hpp>
+#include "obs-property.hpp"
 
 #if defined(_MSC_VER)
 #define __PRETTY_FUNCTION__ __FUNCSIG__
@@ -72,15 +78,106 @@ protected:
 	void mark_free_range(id_t, id_t);
 
 private:
-	std::list<range_t> allocated;
+	std::vector<uint64_t> used;
+	std::vector<uint64_t> full;
+	std::vector<uint64_t> full_groups;
+	id_t used_count = 0;
+};
+
+// Lock-free id to pointer table backing unique_object_manager::find(id).
+//
+// The managers never hand an id back to the generator, so a slot only ever
+// goes from null to an object and back to null. Readers do two acquire loads
+// and never wait for writers. Writers must be serialized by the caller.
+// Segments are only released with the table.
+template<typename T> class atomic_id_table {
+	static const size_t segment_bits = 12;
+	static const size_t segment_size = size_t(1) << segment_bits;
+	static const size_t segment_count = size_t(1) << 12;
+
+	struct segment {
+		std::atomic<T *> slots[segment_size];
+	};
+	std::unique_ptr<std::atomic<segment *>[]> segments;
+
+public:
+	static const unique_id::id_t capacity = unique_id::id_t(segment_size) * segment_count;
+
+	atomic_id_table() : segments(new std::atomic<segment *>[segment_count])
+	{
+		for (size_t i = 0; i < segment_count; i++)
+			segments[i].store(nullptr, std::memory_order_relaxed);
+	}
+	~atomic_id_table()
+	{
+		for (size_t i = 0; i < segment_count; i++)
+			delete segments[i].load(std::memory_order_relaxed);
+	}
+
+	T *load(unique_id::id_t id) const
+	{
+		if (id >= capacity)
+			return nullptr;
+		segment *seg = segments[id >> segment_bits].load(std::memory_order_acquire);
+		if (!seg)
+			return nullptr;
+		return seg->slots[id & (segment_size - 1)].load(std::memory_order_acquire);
+	}
+
+	// Returns false if the id is past the capacity of the table.
+	bool store(unique_id::id_t id, T *obj)
+	{
+		if (id >= capacity)
+			return false;
+		std::atomic<segment *> &entry = segments[id >> segment_bits];
+		segment *seg = entry.load(std::memory_order_relaxed);
+		if (!seg) {
+			if (!obj)
+				return true;
+			seg = new segment;
+			for (size_t i = 0; i < segment_size; i++)
+				seg->slots[i].store(nullptr, std::memory_order_relaxed);
+			entry.store(seg, std::memory_order_release);
+		}
+		seg->slots[id & (segment_size - 1)].store(obj, std::memory_order_release);
+		return true;
+	}
+
+	void clear()
+	{
+		for (size_t i = 0; i < segment_count; i++) {
+			segment *seg = segments[i].load(std::memory_order_relaxed);
+			if (!seg)
+				continue;
+			for (size_t j = 0; j < segment_size; j++)
+				seg->slots[j].store(nullptr, std::memory_order_release);
+		}
+	}
 };
 
 template<typename T> class unique_object_manager {
 protected:
 	utility::unique_id id_generator;
 	std::map<utility::unique_id::id_t, T *> object_map;
+	// Reverse index of object_map. The same object may be registered under
+	// several ids, lookups by object resolve to the lowest one.
+	std::unordered_multimap<T *, utility::unique_id::id_t> id_map;
+	// Copy of object_map for find(id), which runs on every IPC call and from
+	// libobs signal handlers and must not take internal_mutex.
+	atomic_id_table<T> lookup_table;
 	std::recursive_mutex internal_mutex;
 
+	typename std::unordered_multimap<T *, utility::unique_id::id_t>::iterator find_lowest(T *obj)
+	{
+		auto range = id_map.equal_range(obj);
+		auto lowest = range.first;
+		for (auto iter = range.first; iter != range.second; ++iter) {
+			if (iter->second < lowest->second)
+				lowest = iter;
+		}
+		return range.first == range.second ? id_map.end() : lowest;
+	}
+
 public:
 	unique_object_manager() {}
 	~unique_object_manager() { clear(); }
@@ -94,6 +191,8 @@ public:
 			return uid;
 		}
 		object_map.insert_or_assign(uid, obj);
+		id_map.emplace(obj, uid);
+		lookup_table.store(uid, obj);
 		return uid;
 	}
 
@@ -101,15 +200,35 @@ public:
 	{
 		std::lock_guard<std::recursive_mutex> lock(internal_mutex);
 
-		for (auto kv : object_map) {
-			if (kv.second == obj) {
-				return kv.first;
-			}
+		auto iter = find_lowest(obj);
+		if (iter != id_map.end()) {
+			return iter->second;
 		}
 		return std::numeric_limits<utility::unique_id::id_t>::max();
 	}
+	// Looks up a whole batch under one lock. Objects without an id get one and
+	// are handed to on_allocate, ids past the capacity are left at max().
+	template<typename F> void find_or_allocate(T *const *objs, size_t count, utility::unique_id::id_t *uids, F on_allocate)
+	{
+		std::lock_guard<std::recursive_mutex> lock(internal_mutex);
+
+		for (size_t i = 0; i < count; i++) {
+			auto iter = find_lowest(objs[i]);
+			if (iter != id_map.end()) {
+				uids[i] = iter->second;
+				continue;
+			}
+			uids[i] = allocate(objs[i]);
+			if (uids[i] != std::numeric_limits<utility::unique_id::id_t>::max())
+				on_allocate(objs[i]);
+		}
+	}
 	T *find(utility::unique_id::id_t id)
 	{
+		if (id < atomic_id_table<T>::capacity) {
+			return lookup_table.load(id);
+		}
+
 		std::lock_guard<std::recursive_mutex> lock(internal_mutex);
 
 		auto iter = object_map.find(id);
@@ -123,14 +242,14 @@ public:
 	{
 		std::lock_guard<std::recursive_mutex> lock(internal_mutex);
 
-		utility::unique_id::id_t uid = std::numeric_limits<utility::unique_id::id_t>::max();
-		for (auto kv : object_map) {
-			if (kv.second == obj) {
-				uid = kv.first;
-				object_map.erase(kv.first);
-				break;
-			}
+		auto iter = find_lowest(obj);
+		if (iter == id_map.end()) {
+			return std::numeric_limits<utility::unique_id::id_t>::max();
 		}
+		utility::unique_id::id_t uid = iter->second;
+		id_map.erase(iter);
+		object_map.erase(uid);
+		lookup_table.store(uid, nullptr);
 		return uid;
 	}
 	T *free(utility::unique_id::id_t id)
@@ -143,6 +262,15 @@ public:
 		}
 		T *obj = iter->second;
 		object_map.erase(iter);
+		lookup_table.store(id, nullptr);
+
+		auto range = id_map.equal_range(obj);
+		for (auto rev = range.first; rev != range.second; ++rev) {
+			if (rev->second == id) {
+				id_map.erase(rev);
+				break;
+			}
+		}
 		return obj;
 	}
 
@@ -155,15 +283,63 @@ public:
 
 	size_t size() { return object_map.size(); }
 
-	void clear() { object_map.clear(); }
+	void clear()
+	{
+		std::lock_guard<std::recursive_mutex> lock(internal_mutex);
+
+		object_map.clear();
+		id_map.clear();
+		lookup_table.clear();
+	}
 };
 
 template<typename T> class generic_object_manager {
 protected:
 	utility::unique_id id_generator;
 	std::map<utility::unique_id::id_t, T> object_map;
+	// Reverse index of object_map. The same object may be registered under
+	// several ids, lookups by object resolve to the lowest one.
+	std::unordered_multimap<T, utility::unique_id::id_t> id_map;
 	std::recursive_mutex internal_mutex;
 
+	// find(id) only locks the shard owning the id, so lookups from IPC
+	// threads and libobs callbacks do not serialize on internal_mutex.
+	// Writers hold internal_mutex first, then the shard lock.
+	static const size_t shard_count = 16;
+	struct shard {
+		std::mutex mutex;
+		std::unordered_map<utility::unique_id::id_t, T> objects;
+	};
+	std::array<shard, shard_count> shards;
+
+	shard &shard_for(utility::unique_id::id_t id) { return shards[id % shard_count]; }
+
+	void erase_from_shard(utility::unique_id::id_t id)
+	{
+		// Release the object outside of the shard lock, its destructor may
+		// wait on a thread that is about to call find().
+		T obj;
+		shard &sh = shard_for(id);
+		std::unique_lock<std::mutex> lock(sh.mutex);
+		auto iter = sh.objects.find(id);
+		if (iter != sh.objects.end()) {
+			obj = std::move(iter->second);
+			sh.objects.erase(iter);
+		}
+		lock.unlock();
+	}
+
+	typename std::unordered_multimap<T, utility::unique_id::id_t>::iterator find_lowest(T obj)
+	{
+		auto range = id_map.equal_range(obj);
+		auto lowest = range.first;
+		for (auto iter = range.first; iter != range.second; ++iter) {
+			if (iter->second < lowest->second)
+				lowest = iter;
+		}
+		return range.first == range.second ? id_map.end() : lowest;
+	}
+
 public:
 	generic_object_manager() {}
 	~generic_object_manager() { clear(); }
@@ -177,6 +353,11 @@ public:
 			return uid;
 		}
 		object_map.insert_or_assign(uid, obj);
+		id_map.emplace(obj, uid);
+
+		shard &sh = shard_for(uid);
+		std::lock_guard<std::mutex> shard_lock(sh.mutex);
+		sh.objects.insert_or_assign(uid, obj);
 		return uid;
 	}
 
@@ -184,19 +365,19 @@ public:
 	{
 		std::lock_guard<std::recursive_mutex> lock(internal_mutex);
 
-		for (auto kv : object_map) {
-			if (kv.second == obj) {
-				return kv.first;
-			}
+		auto iter = find_lowest(obj);
+		if (iter != id_map.end()) {
+			return iter->second;
 		}
 		return std::numeric_limits<utility::unique_id::id_t>::max();
 	}
 	T find(utility::unique_id::id_t id)
 	{
-		std::lock_guard<std::recursive_mutex> lock(internal_mutex);
+		shard &sh = shard_for(id);
+		std::lock_guard<std::mutex> lock(sh.mutex);
 
-		auto iter = object_map.find(id);
-		if (iter != object_map.end()) {
+		auto iter = sh.objects.find(id);
+		if (iter != sh.objects.end()) {
 			return iter->second;
 		}
 		return nullptr;
@@ -206,14 +387,14 @@ public:
 	{
 		std::lock_guard<std::recursive_mutex> lock(internal_mutex);
 
-		utility::unique_id::id_t uid = std::numeric_limits<utility::unique_id::id_t>::max();
-		for (auto kv : object_map) {
-			if (kv.second == obj) {
-				uid = kv.first;
-				object_map.erase(kv.first);
-				break;
-			}
+		auto iter = find_lowest(obj);
+		if (iter == id_map.end()) {
+			return std::numeric_limits<utility::unique_id::id_t>::max();
 		}
+		utility::unique_id::id_t uid = iter->second;
+		id_map.erase(iter);
+		object_map.erase(uid);
+		erase_from_shard(uid);
 		return uid;
 	}
 	T free(utility::unique_id::id_t id)
@@ -226,6 +407,15 @@ public:
 		}
 		T obj = iter->second;
 		object_map.erase(iter);
+		erase_from_shard(id);
+
+		auto range = id_map.equal_range(obj);
+		for (auto rev = range.first; rev != range.second; ++rev) {
+			if (rev->second == id) {
+				id_map.erase(rev);
+				break;
+			}
+		}
 		return obj;
 	}
 
@@ -238,9 +428,24 @@ public:
 
 	size_t size() { return object_map.size(); }
 
-	void clear() { object_map.clear(); }
+	void clear()
+	{
+		std::map<utility::unique_id::id_t, T> objects;
+		std::vector<std::unordered_map<utility::unique_id::id_t, T>> shard_objects(shard_count);
+
+		std::unique_lock<std::recursive_mutex> lock(internal_mutex);
+		objects.swap(object_map);
+		id_map.clear();
+		for (size_t i = 0; i < shard_count; i++) {
+			std::lock_guard<std::mutex> shard_lock(shards[i].mutex);
+			shard_objects[i].swap(shards[i].objects);
+		}
+		lock.unlock();
+	}
 };
 
 void ProcessProperties(obs_properties_t *prp, obs_data *settings, std::vector<ipc::value> &rval);
+// Same as ProcessProperties, all properties go into the snapshot's arena.
+void SerializeProperties(obs_properties_t *prp, obs_data *settings, obs::PropertySnapshot &snapshot);
 const char *GetSafeString(const char *str);
 } // namespace utility
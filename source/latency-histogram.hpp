@@ -0,0 +1,131 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#pragma once
+#include <atomic>
+#include <inttypes.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Latency histogram of the IPC calls, kept by the server for the handlers and
+// by the client for the round trips.
+//
+// Buckets are log-linear like an HDR histogram: eight buckets per power of
+// two, so a percentile is off by at most 12.5%, over values up to 2^40. The
+// unit is up to the caller. Recording is wait-free and may happen on any
+// number of threads while another one reads.
+//
+// Diagnostics.GetIpcStats answers with, per function that was called:
+//	String name ("Class.Function"), UInt64 calls,
+//	UInt64 p50, p90, p99, max and mean handler time in nanoseconds.
+namespace diagnostics {
+class LatencyHistogram {
+public:
+	static const uint32_t SubBucketBits = 3;
+	static const uint32_t MaximumBits = 40;
+	static const uint32_t BucketCount = (MaximumBits - SubBucketBits + 1) << SubBucketBits;
+
+	void record(uint64_t value)
+	{
+		buckets[index(value)].fetch_add(1, std::memory_order_relaxed);
+		total.fetch_add(value, std::memory_order_relaxed);
+		uint64_t highest = maximum.load(std::memory_order_relaxed);
+		while (value > highest && !maximum.compare_exchange_weak(highest, value, std::memory_order_relaxed)) {
+		}
+	}
+
+	uint64_t count() const
+	{
+		uint64_t result = 0;
+		for (uint32_t i = 0; i < BucketCount; i++)
+			result += buckets[i].load(std::memory_order_relaxed);
+		return result;
+	}
+
+	uint64_t max() const { return maximum.load(std::memory_order_relaxed); }
+
+	uint64_t mean() const
+	{
+		uint64_t calls = count();
+		return calls ? total.load(std::memory_order_relaxed) / calls : 0;
+	}
+
+	// Upper bound of the bucket holding the given fraction of the values.
+	uint64_t percentile(double fraction) const
+	{
+		uint64_t calls = count();
+		if (calls == 0)
+			return 0;
+
+		uint64_t rank = uint64_t(fraction * calls);
+		if (rank >= calls)
+			rank = calls - 1;
+
+		uint64_t seen = 0;
+		for (uint32_t i = 0; i < BucketCount; i++) {
+			seen += buckets[i].load(std::memory_order_relaxed);
+			if (seen > rank) {
+				uint64_t bound = upper_bound(i);
+				return bound < max() ? bound : max();
+			}
+		}
+		return max();
+	}
+
+	static uint32_t index(uint64_t value)
+	{
+		if (value < (1ull << SubBucketBits))
+			return uint32_t(value);
+		if (value >= (1ull << MaximumBits))
+			return BucketCount - 1;
+
+		uint32_t bits = highest_bit(value);
+		uint32_t sub = uint32_t(value >> (bits - SubBucketBits)) & ((1 << SubBucketBits) - 1);
+		return ((bits - SubBucketBits + 1) << SubBucketBits) + sub;
+	}
+
+	static uint64_t upper_bound(uint32_t index)
+	{
+		if (index < (1 << SubBucketBits))
+			return index;
+
+		uint32_t bits = (index >> SubBucketBits) + SubBucketBits - 1;
+		uint64_t sub = index & ((1 << SubBucketBits) - 1);
+		uint64_t base = (1ull << bits) + (sub << (bits - SubBucketBits));
+		return base + (1ull << (bits - SubBucketBits)) - 1;
+	}
+
+private:
+	static uint32_t highest_bit(uint64_t value)
+	{
+#ifdef _MSC_VER
+		unsigned long bit;
+		_BitScanReverse64(&bit, value);
+		return bit;
+#else
+		return 63 - __builtin_clzll(value);
+#endif
+	}
+
+	std::atomic<uint32_t> buckets[BucketCount] = {};
+	std::atomic<uint64_t> total{0};
+	std::atomic<uint64_t> maximum{0};
+};
+}
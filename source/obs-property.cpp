@@ -17,10 +17,19 @@
 ******************************************************************************/
 
 #include "obs-property.hpp"
+#include <algorithm>
 
 std::shared_ptr<obs::Property> obs::Property::deserialize(std::vector<char> const &buf)
 {
-	obs::Property::Type type = (Type)buf[0];
+	return deserialize(buf.data(), buf.size());
+}
+
+std::shared_ptr<obs::Property> obs::Property::deserialize(const char *data, size_t size)
+{
+	if (size < sizeof(uint8_t)) {
+		return nullptr;
+	}
+	obs::Property::Type type = (Type)data[0];
 
 	std::shared_ptr<Property> prop;
 	switch (type) {
@@ -67,7 +76,8 @@ std::shared_ptr<obs::Property> obs::Property::deserialize(std::vector<char> cons
 	if (!prop) {
 		return nullptr;
 	}
-	if (!prop->read(buf)) {
+	PropertyReader reader(data, size);
+	if (!prop->read(reader)) {
 		return nullptr;
 	}
 	return prop;
@@ -78,84 +88,38 @@ obs::Property::Type obs::Property::type()
 	return Type::Invalid;
 }
 
-size_t obs::Property::size()
+void obs::Property::serialize(std::vector<char> &buf)
 {
-	size_t total = 0;
-	total += sizeof(Type);
-	total += sizeof(size_t);
-	total += name.size();
-	total += sizeof(size_t);
-	total += description.size();
-	total += sizeof(size_t);
-	total += long_description.size();
-	total += sizeof(uint8_t) * 2; // enabled, visible
-	return total;
+	PropertyWriter writer(buf);
+	write(writer);
 }
 
-bool obs::Property::serialize(std::vector<char> &buf)
+void obs::Property::write(PropertyWriter &writer)
 {
-	if (buf.size() < size()) {
-		return false;
-	}
-
-	size_t offset = 0;
-	buf[offset] = uint8_t(type());
-	offset++;
-
-	reinterpret_cast<size_t &>(buf[offset]) = name.size();
-	offset += sizeof(size_t);
-	std::memcpy(&buf[offset], name.data(), name.size());
-	offset += name.size();
-
-	reinterpret_cast<size_t &>(buf[offset]) = description.size();
-	offset += sizeof(size_t);
-	std::memcpy(&buf[offset], description.data(), description.size());
-	offset += description.size();
-
-	reinterpret_cast<size_t &>(buf[offset]) = long_description.size();
-	offset += sizeof(size_t);
-	std::memcpy(&buf[offset], long_description.data(), long_description.size());
-	offset += long_description.size();
-
-	buf[offset] = enabled;
-	offset++;
-	buf[offset] = visible;
-	offset++;
-
-	return true;
+	writer.put<uint8_t>(uint8_t(type()));
+	writer.put_string(name);
+	writer.put_string(description);
+	writer.put_string(long_description);
+	writer.put<uint8_t>(enabled);
+	writer.put<uint8_t>(visible);
 }
 
-bool obs::Property::read(std::vector<char> const &buf)
+bool obs::Property::read(PropertyReader &reader)
 {
-	if (buf.size() < size()) {
+	uint8_t raw_type = 0, raw_enabled = 0, raw_visible = 0;
+
+	/* Type is already checked by deserialize(). */
+	if (!reader.get(raw_type)) {
 		return false;
 	}
-
-	size_t offset = 0;
-
-	size_t length = 0;
-
-	/* Type is already read by deserialize(). */ offset += 1;
-
-	length = reinterpret_cast<const size_t &>(buf[offset]);
-	offset += sizeof(size_t);
-	name = std::string(&buf[offset], length);
-	offset += length;
-
-	length = reinterpret_cast<const size_t &>(buf[offset]);
-	offset += sizeof(size_t);
-	description = std::string(&buf[offset], length);
-	offset += length;
-
-	length = reinterpret_cast<const size_t &>(buf[offset]);
-	offset += sizeof(size_t);
-	long_description = std::string(&buf[offset], length);
-	offset += length;
-
-	enabled = !!buf[offset];
-	offset += sizeof(uint8_t);
-	visible = !!buf[offset];
-	offset += sizeof(uint8_t);
+	if (!reader.get_string(name) || !reader.get_string(description) || !reader.get_string(long_description)) {
+		return false;
+	}
+	if (!reader.get(raw_enabled) || !reader.get(raw_visible)) {
+		return false;
+	}
+	enabled = !!raw_enabled;
+	visible = !!raw_visible;
 
 	return true;
 }
@@ -165,82 +129,44 @@ obs::Property::Type obs::BooleanProperty::type()
 	return obs::Property::Type::Boolean;
 }
 
-size_t obs::BooleanProperty::size()
+void obs::BooleanProperty::write(PropertyWriter &writer)
 {
-	size_t total = Property::size();
-	total += sizeof(bool);
-	return total;
+	Property::write(writer);
+	writer.put<uint8_t>(value);
 }
 
-bool obs::BooleanProperty::serialize(std::vector<char> &buf)
+bool obs::BooleanProperty::read(PropertyReader &reader)
 {
-	if (buf.size() < size()) {
+	if (!Property::read(reader)) {
 		return false;
 	}
 
-	if (!Property::serialize(buf)) {
+	uint8_t raw_value = 0;
+	if (!reader.get(raw_value)) {
 		return false;
 	}
-
-	size_t offset = Property::size();
-	*reinterpret_cast<bool *>(&buf[offset]) = value;
-	offset += sizeof(bool);
+	value = !!raw_value;
 
 	return true;
 }
 
-bool obs::BooleanProperty::read(std::vector<char> const &buf)
+void obs::NumberProperty::write(PropertyWriter &writer)
 {
-	if (buf.size() < size()) {
-		return false;
-	}
-
-	if (!Property::read(buf)) {
-		return false;
-	}
-
-	size_t offset = Property::size();
-	value = *reinterpret_cast<const bool *>(&buf[offset]);
-	offset += sizeof(bool);
-
-	return true;
+	Property::write(writer);
+	writer.put<uint8_t>(uint8_t(field_type));
 }
 
-size_t obs::NumberProperty::size()
+bool obs::NumberProperty::read(PropertyReader &reader)
 {
-	size_t total = Property::size();
-	total += sizeof(uint8_t);
-	return total;
-}
-
-bool obs::NumberProperty::serialize(std::vector<char> &buf)
-{
-	if (buf.size() < size()) {
+	if (!Property::read(reader)) {
 		return false;
 	}
 
-	if (!Property::serialize(buf)) {
+	uint8_t raw_type = 0;
+	if (!reader.get(raw_type)) {
 		return false;
 	}
-
-	size_t offset = Property::size();
-	buf[offset] = uint8_t(field_type);
-
-	return true;
-}
-
-bool obs::NumberProperty::read(std::vector<char> const &buf)
-{
-	if (buf.size() < size()) {
-		return false;
-	}
-
-	if (!Property::read(buf)) {
-		return false;
-	}
-
-	size_t offset = Property::size();
-	field_type = NumberType(buf[offset]);
+	field_type = NumberType(raw_type);
 
 	return true;
 }
@@ -250,57 +176,22 @@ obs::Property::Type obs::IntegerProperty::type()
 	return Type::Integer;
 }
 
-size_t obs::IntegerProperty::size()
+void obs::IntegerProperty::write(PropertyWriter &writer)
 {
-	size_t total = NumberProperty::size();
-	total += sizeof(int64_t) * 4;
-	return total;
-}
-
-bool obs::IntegerProperty::serialize(std::vector<char> &buf)
-{
-	if (buf.size() < size()) {
-		return false;
-	}
-
-	if (!NumberProperty::serialize(buf)) {
-		return false;
-	}
-
-	size_t offset = NumberProperty::size();
-	*reinterpret_cast<int64_t *>(&buf[offset]) = minimum;
-	offset += sizeof(int64_t);
-	*reinterpret_cast<int64_t *>(&buf[offset]) = maximum;
-	offset += sizeof(int64_t);
-	*reinterpret_cast<int64_t *>(&buf[offset]) = step;
-	offset += sizeof(int64_t);
-	*reinterpret_cast<int64_t *>(&buf[offset]) = value;
-	offset += sizeof(int64_t);
-
-	return true;
+	NumberProperty::write(writer);
+	writer.put<int64_t>(minimum);
+	writer.put<int64_t>(maximum);
+	writer.put<int64_t>(step);
+	writer.put<int64_t>(value);
 }
 
-bool obs::IntegerProperty::read(std::vector<char> const &buf)
+bool obs::IntegerProperty::read(PropertyReader &reader)
 {
-	if (buf.size() < size()) {
+	if (!NumberProperty::read(reader)) {
 		return false;
 	}
 
-	if (!NumberProperty::read(buf)) {
-		return false;
-	}
-
-	size_t offset = NumberProperty::size();
-	minimum = *reinterpret_cast<const int64_t *>(&buf[offset]);
-	offset += sizeof(int64_t);
-	maximum = *reinterpret_cast<const int64_t *>(&buf[offset]);
-	offset += sizeof(int64_t);
-	step = *reinterpret_cast<const int64_t *>(&buf[offset]);
-	offset += sizeof(int64_t);
-	value = *reinterpret_cast<const int64_t *>(&buf[offset]);
-	offset += sizeof(int64_t);
-
-	return true;
+	return reader.get(minimum) && reader.get(maximum) && reader.get(step) && reader.get(value);
 }
 
 obs::Property::Type obs::FloatProperty::type()
@@ -308,57 +199,22 @@ obs::Property::Type obs::FloatProperty::type()
 	return Type::Float;
 }
 
-size_t obs::FloatProperty::size()
+void obs::FloatProperty::write(PropertyWriter &writer)
 {
-	size_t total = NumberProperty::size();
-	total += sizeof(double_t) * 4;
-	return total;
+	NumberProperty::write(writer);
+	writer.put<double_t>(minimum);
+	writer.put<double_t>(maximum);
+	writer.put<double_t>(step);
+	writer.put<double_t>(value);
 }
 
-bool obs::FloatProperty::serialize(std::vector<char> &buf)
+bool obs::FloatProperty::read(PropertyReader &reader)
 {
-	if (buf.size() < size()) {
+	if (!NumberProperty::read(reader)) {
 		return false;
 	}
 
-	if (!NumberProperty::serialize(buf)) {
-		return false;
-	}
-
-	size_t offset = NumberProperty::size();
-	*reinterpret_cast<double_t *>(&buf[offset]) = minimum;
-	offset += sizeof(double_t);
-	*reinterpret_cast<double_t *>(&buf[offset]) = maximum;
-	offset += sizeof(double_t);
-	*reinterpret_cast<double_t *>(&buf[offset]) = step;
-	offset += sizeof(double_t);
-	*reinterpret_cast<double_t *>(&buf[offset]) = value;
-	offset += sizeof(double_t);
-
-	return true;
-}
-
-bool obs::FloatProperty::read(std::vector<char> const &buf)
-{
-	if (buf.size() < size()) {
-		return false;
-	}
-
-	if (!NumberProperty::read(buf)) {
-		return false;
-	}
-
-	size_t offset = NumberProperty::size();
-	minimum = *reinterpret_cast<const double_t *>(&buf[offset]);
-	offset += sizeof(double_t);
-	maximum = *reinterpret_cast<const double_t *>(&buf[offset]);
-	offset += sizeof(double_t);
-	step = *reinterpret_cast<const double_t *>(&buf[offset]);
-	offset += sizeof(double_t);
-	value = *reinterpret_cast<const double_t *>(&buf[offset]);
-	offset += sizeof(double_t);
-
-	return true;
+	return reader.get(minimum) && reader.get(maximum) && reader.get(step) && reader.get(value);
 }
 
 obs::Property::Type obs::TextProperty::type()
@@ -366,60 +222,24 @@ obs::Property::Type obs::TextProperty::type()
 	return Type::Text;
 }
 
-size_t obs::TextProperty::size()
-{
-	size_t total = Property::size();
-	total += sizeof(uint8_t);
-	total += sizeof(size_t) + value.size();
-	return total;
-}
-
-bool obs::TextProperty::serialize(std::vector<char> &buf)
+void obs::TextProperty::write(PropertyWriter &writer)
 {
-	if (buf.size() < size()) {
-		return false;
-	}
-
-	if (!Property::serialize(buf)) {
-		return false;
-	}
-
-	size_t offset = Property::size();
-	buf[offset] = uint8_t(field_type);
-	offset += sizeof(uint8_t);
-
-	reinterpret_cast<size_t &>(buf[offset]) = value.size();
-	offset += sizeof(size_t);
-	if (value.size() > 0) {
-		memcpy(&buf[offset], value.data(), value.size());
-		offset += value.size();
-	}
-
-	return true;
+	Property::write(writer);
+	writer.put<uint8_t>(uint8_t(field_type));
+	writer.put_string(value);
 }
 
-bool obs::TextProperty::read(std::vector<char> const &buf)
+bool obs::TextProperty::read(PropertyReader &reader)
 {
-	if (buf.size() < size()) {
+	if (!Property::read(reader)) {
 		return false;
 	}
 
-	if (!Property::read(buf)) {
+	uint8_t raw_type = 0;
+	if (!reader.get(raw_type) || !reader.get_string(value)) {
 		return false;
 	}
-
-	size_t length = 0;
-
-	size_t offset = Property::size();
-	field_type = TextType(buf[offset]);
-	offset += sizeof(uint8_t);
-
-	length = reinterpret_cast<const size_t &>(buf[offset]);
-	offset += sizeof(size_t);
-	if (length > 0) {
-		value = std::string(&buf[offset], length);
-		offset += length;
-	}
+	field_type = TextType(raw_type);
 
 	return true;
 }
@@ -429,90 +249,26 @@ obs::Property::Type obs::PathProperty::type()
 	return Type::Path;
 }
 
-size_t obs::PathProperty::size()
+void obs::PathProperty::write(PropertyWriter &writer)
 {
-	size_t total = Property::size();
-	total += sizeof(uint8_t);
-	total += sizeof(size_t) + filter.size();
-	total += sizeof(size_t) + default_path.size();
-	total += sizeof(size_t) + value.size();
-	return total;
-}
-
-bool obs::PathProperty::serialize(std::vector<char> &buf)
-{
-	if (buf.size() < size()) {
-		return false;
-	}
-
-	if (!Property::serialize(buf)) {
-		return false;
-	}
-
-	size_t offset = Property::size();
-	buf[offset] = uint8_t(field_type);
-	offset += sizeof(uint8_t);
-
-	reinterpret_cast<size_t &>(buf[offset]) = filter.size();
-	offset += sizeof(size_t);
-	if (filter.size() > 0) {
-		memcpy(&buf[offset], filter.data(), filter.size());
-		offset += filter.size();
-	}
-
-	reinterpret_cast<size_t &>(buf[offset]) = default_path.size();
-	offset += sizeof(size_t);
-	if (default_path.size() > 0) {
-		memcpy(&buf[offset], default_path.data(), default_path.size());
-		offset += default_path.size();
-	}
-
-	reinterpret_cast<size_t &>(buf[offset]) = value.size();
-	offset += sizeof(size_t);
-	if (value.size() > 0) {
-		memcpy(&buf[offset], value.data(), value.size());
-		offset += value.size();
-	}
-
-	return true;
+	Property::write(writer);
+	writer.put<uint8_t>(uint8_t(field_type));
+	writer.put_string(filter);
+	writer.put_string(default_path);
+	writer.put_string(value);
 }
 
-bool obs::PathProperty::read(std::vector<char> const &buf)
+bool obs::PathProperty::read(PropertyReader &reader)
 {
-	if (buf.size() < size()) {
+	if (!Property::read(reader)) {
 		return false;
 	}
 
-	if (!Property::read(buf)) {
+	uint8_t raw_type = 0;
+	if (!reader.get(raw_type) || !reader.get_string(filter) || !reader.get_string(default_path) || !reader.get_string(value)) {
 		return false;
 	}
-
-	size_t length = 0;
-
-	size_t offset = Property::size();
-	field_type = PathType(buf[offset]);
-	offset += sizeof(uint8_t);
-
-	length = reinterpret_cast<const size_t &>(buf[offset]);
-	offset += sizeof(size_t);
-	if (length > 0) {
-		filter = std::string(&buf[offset], length);
-		offset += length;
-	}
-
-	length = reinterpret_cast<const size_t &>(buf[offset]);
-	offset += sizeof(size_t);
-	if (length > 0) {
-		default_path = std::string(&buf[offset], length);
-		offset += length;
-	}
-
-	length = reinterpret_cast<const size_t &>(buf[offset]);
-	offset += sizeof(size_t);
-	if (length > 0) {
-		value = std::string(&buf[offset], length);
-		offset += length;
-	}
+	field_type = PathType(raw_type);
 
 	return true;
 }
@@ -522,184 +278,93 @@ obs::Property::Type obs::ListProperty::type()
 	return Type::List;
 }
 
-size_t obs::ListProperty::size()
+void obs::ListProperty::write(PropertyWriter &writer)
 {
-	size_t total = Property::size();
-	total += sizeof(uint8_t);
-	total += sizeof(uint8_t);
-	total += sizeof(size_t);
+	Property::write(writer);
+	writer.put<uint8_t>(uint8_t(field_type));
+	writer.put<uint8_t>(uint8_t(format));
 
+	writer.put<size_t>(items.size());
 	for (auto &entry : items) {
-		total += sizeof(size_t);
-		total += entry.name.size();
-		total += sizeof(uint8_t);
+		writer.put_string(entry.name);
+		writer.put<uint8_t>(entry.enabled);
 		switch (format) {
 		case Format::Integer:
-			total += sizeof(int64_t);
+			writer.put<int64_t>(entry.value_int);
 			break;
 		case Format::Float:
-			total += sizeof(double_t);
+			writer.put<double_t>(entry.value_float);
 			break;
 		case Format::String:
-			total += sizeof(size_t);
-			total += entry.value_string.size();
+			writer.put_string(entry.value_string);
 			break;
 		}
 	}
 
 	switch (format) {
 	case Format::Integer:
-		total += sizeof(int64_t);
+		writer.put<int64_t>(current_value_int);
 		break;
 	case Format::Float:
-		total += sizeof(double_t);
+		writer.put<double_t>(current_value_float);
 		break;
 	case Format::String:
-		total += sizeof(size_t) + current_value_str.size();
+		writer.put_string(current_value_str);
 		break;
 	}
-
-	return total;
 }
 
-bool obs::ListProperty::serialize(std::vector<char> &buf)
+bool obs::ListProperty::read(PropertyReader &reader)
 {
-	if (buf.size() < size()) {
+	if (!Property::read(reader)) {
 		return false;
 	}
 
-	if (!Property::serialize(buf)) {
+	uint8_t raw_type = 0, raw_format = 0;
+	if (!reader.get(raw_type) || !reader.get(raw_format)) {
 		return false;
 	}
+	field_type = ListType(raw_type);
+	format = Format(raw_format);
 
-	size_t offset = Property::size();
-	buf[offset] = uint8_t(field_type);
-	offset += sizeof(uint8_t);
-	buf[offset] = uint8_t(format);
-	offset += sizeof(uint8_t);
-
-	reinterpret_cast<size_t &>(buf[offset]) = items.size();
-	offset += sizeof(size_t);
-	for (auto &entry : items) {
-		reinterpret_cast<size_t &>(buf[offset]) = entry.name.size();
-		offset += sizeof(size_t);
-		if (entry.name.size() > 0) {
-			memcpy(&buf[offset], entry.name.data(), entry.name.size());
-			offset += entry.name.size();
-		}
-		buf[offset] = enabled;
-		offset += sizeof(uint8_t);
-		switch (format) {
-		case Format::Integer:
-			reinterpret_cast<int64_t &>(buf[offset]) = entry.value_int;
-			offset += sizeof(int64_t);
-			break;
-		case Format::Float:
-			reinterpret_cast<double_t &>(buf[offset]) = entry.value_float;
-			offset += sizeof(double_t);
-			break;
-		case Format::String:
-			reinterpret_cast<size_t &>(buf[offset]) = entry.value_string.size();
-			offset += sizeof(size_t);
-			if (entry.value_string.size() > 0) {
-				memcpy(&buf[offset], entry.value_string.data(), entry.value_string.size());
-				offset += entry.value_string.size();
-			}
-			break;
-		}
-	}
-
-	switch (format) {
-	case Format::Integer:
-		reinterpret_cast<int64_t &>(buf[offset]) = current_value_int;
-		offset += sizeof(int64_t);
-		break;
-	case Format::Float:
-		reinterpret_cast<double_t &>(buf[offset]) = current_value_float;
-		offset += sizeof(double_t);
-		break;
-	case Format::String:
-		reinterpret_cast<size_t &>(buf[offset]) = current_value_str.size();
-		offset += sizeof(size_t);
-		if (current_value_str.size() > 0) {
-			memcpy(&buf[offset], current_value_str.data(), current_value_str.size());
-			offset += current_value_str.size();
-		}
-		break;
-	}
-
-	return true;
-}
-
-bool obs::ListProperty::read(std::vector<char> const &buf)
-{
-	if (buf.size() < size()) {
+	size_t num_entries = 0;
+	// Every element takes at least one byte, don't trust larger counts.
+	if (!reader.get(num_entries) || num_entries > reader.remaining()) {
 		return false;
 	}
-
-	if (!Property::read(buf)) {
-		return false;
-	}
-
-	size_t offset = Property::size();
-	field_type = ListType(buf[offset]);
-	offset += sizeof(uint8_t);
-	format = Format(buf[offset]);
-	offset += sizeof(uint8_t);
-
-	size_t num_entries = reinterpret_cast<const size_t &>(buf[offset]);
-	offset += sizeof(size_t);
-	for (size_t idx = 0; idx < num_entries; idx++) {
-		size_t length = 0;
-		Item entry;
-
-		length = reinterpret_cast<const size_t &>(buf[offset]);
-		offset += sizeof(size_t);
-		if (length > 0) {
-			entry.name = std::string(&buf[offset], length);
-			offset += length;
+	items.clear();
+	items.resize(num_entries);
+	for (auto &entry : items) {
+		uint8_t raw_enabled = 0;
+		if (!reader.get_string(entry.name) || !reader.get(raw_enabled)) {
+			return false;
 		}
-		entry.enabled = !!buf[offset];
-		offset += sizeof(uint8_t);
+		entry.enabled = !!raw_enabled;
+
+		bool ok = true;
 		switch (format) {
 		case Format::Integer:
-			entry.value_int = reinterpret_cast<const int64_t &>(buf[offset]);
-			offset += sizeof(int64_t);
+			ok = reader.get(entry.value_int);
 			break;
 		case Format::Float:
-			entry.value_float = reinterpret_cast<const double_t &>(buf[offset]);
-			offset += sizeof(double_t);
+			ok = reader.get(entry.value_float);
 			break;
 		case Format::String:
-			length = reinterpret_cast<const size_t &>(buf[offset]);
-			offset += sizeof(size_t);
-			if (length > 0) {
-				entry.value_string = std::string(&buf[offset], length);
-				offset += length;
-			}
+			ok = reader.get_string(entry.value_string);
 			break;
 		}
-		items.push_back(std::move(entry));
+		if (!ok) {
+			return false;
+		}
 	}
 
-	size_t length = 0;
 	switch (format) {
 	case Format::Integer:
-		current_value_int = reinterpret_cast<const int64_t &>(buf[offset]);
-		offset += sizeof(int64_t);
-		break;
+		return reader.get(current_value_int);
 	case Format::Float:
-		current_value_float = reinterpret_cast<const double_t &>(buf[offset]);
-		offset += sizeof(double_t);
-		break;
+		return reader.get(current_value_float);
 	case Format::String:
-		length = reinterpret_cast<const size_t &>(buf[offset]);
-		offset += sizeof(size_t);
-		if (length > 0) {
-			current_value_str = std::string(&buf[offset], length);
-			offset += length;
-		}
-		break;
+		return reader.get_string(current_value_str);
 	}
 
 	return true;
@@ -710,45 +375,19 @@ obs::Property::Type obs::ColorProperty::type()
 	return Type::Color;
 }
 
-size_t obs::ColorProperty::size()
-{
-	size_t total = NumberProperty::size();
-	total += sizeof(int64_t);
-	return total;
-}
-
-bool obs::ColorProperty::serialize(std::vector<char> &buf)
+void obs::ColorProperty::write(PropertyWriter &writer)
 {
-	if (buf.size() < size()) {
-		return false;
-	}
-
-	if (!NumberProperty::serialize(buf)) {
-		return false;
-	}
-
-	size_t offset = NumberProperty::size();
-	*reinterpret_cast<int64_t *>(&buf[offset]) = value;
-	offset += sizeof(int64_t);
-
-	return true;
+	NumberProperty::write(writer);
+	writer.put<int64_t>(value);
 }
 
-bool obs::ColorProperty::read(std::vector<char> const &buf)
+bool obs::ColorProperty::read(PropertyReader &reader)
 {
-	if (buf.size() < size()) {
-		return false;
-	}
-
-	if (!NumberProperty::read(buf)) {
+	if (!NumberProperty::read(reader)) {
 		return false;
 	}
 
-	size_t offset = NumberProperty::size();
-	value = *reinterpret_cast<const int64_t *>(&buf[offset]);
-	offset += sizeof(int64_t);
-
-	return true;
+	return reader.get(value);
 }
 
 obs::Property::Type obs::CaptureProperty::type()
@@ -756,45 +395,19 @@ obs::Property::Type obs::CaptureProperty::type()
 	return Type::Capture;
 }
 
-size_t obs::CaptureProperty::size()
+void obs::CaptureProperty::write(PropertyWriter &writer)
 {
-	size_t total = NumberProperty::size();
-	total += sizeof(int64_t);
-	return total;
-}
-
-bool obs::CaptureProperty::serialize(std::vector<char> &buf)
-{
-	if (buf.size() < size()) {
-		return false;
-	}
-
-	if (!NumberProperty::serialize(buf)) {
-		return false;
-	}
-
-	size_t offset = NumberProperty::size();
-	*reinterpret_cast<int64_t *>(&buf[offset]) = value;
-	offset += sizeof(int64_t);
-
-	return true;
+	NumberProperty::write(writer);
+	writer.put<int64_t>(value);
 }
 
-bool obs::CaptureProperty::read(std::vector<char> const &buf)
+bool obs::CaptureProperty::read(PropertyReader &reader)
 {
-	if (buf.size() < size()) {
+	if (!NumberProperty::read(reader)) {
 		return false;
 	}
 
-	if (!NumberProperty::read(buf)) {
-		return false;
-	}
-
-	size_t offset = NumberProperty::size();
-	value = *reinterpret_cast<const int64_t *>(&buf[offset]);
-	offset += sizeof(int64_t);
-
-	return true;
+	return reader.get(value);
 }
 
 obs::Property::Type obs::ButtonProperty::type()
@@ -802,19 +415,14 @@ obs::Property::Type obs::ButtonProperty::type()
 	return obs::Property::Type::Button;
 }
 
-size_t obs::ButtonProperty::size()
+void obs::ButtonProperty::write(PropertyWriter &writer)
 {
-	return Property::size();
+	Property::write(writer);
 }
 
-bool obs::ButtonProperty::serialize(std::vector<char> &buf)
+bool obs::ButtonProperty::read(PropertyReader &reader)
 {
-	return Property::serialize(buf);
-}
-
-bool obs::ButtonProperty::read(std::vector<char> const &buf)
-{
-	return Property::read(buf);
+	return Property::read(reader);
 }
 
 obs::Property::Type obs::FontProperty::type()
@@ -822,330 +430,285 @@ obs::Property::Type obs::FontProperty::type()
 	return obs::Property::Type::Font;
 }
 
-size_t obs::FontProperty::size()
+void obs::FontProperty::write(PropertyWriter &writer)
 {
-	size_t total = Property::size();
-	total += sizeof(size_t) + face.size();
-	total += sizeof(size_t) + style.size();
-	total += sizeof(size_t) + path.size();
-	total += sizeof(int64_t);
-	total += sizeof(uint32_t);
-	return total;
+	Property::write(writer);
+	writer.put_string(face);
+	writer.put_string(style);
+	writer.put_string(path);
+	writer.put<int64_t>(sizeF);
+	writer.put<uint32_t>(flags);
 }
 
-bool obs::FontProperty::serialize(std::vector<char> &buf)
+bool obs::FontProperty::read(PropertyReader &reader)
 {
-	if (buf.size() < size()) {
+	if (!Property::read(reader)) {
 		return false;
 	}
 
-	if (!Property::serialize(buf)) {
-		return false;
-	}
-
-	size_t offset = Property::size();
+	return reader.get_string(face) && reader.get_string(style) && reader.get_string(path) && reader.get(sizeF) && reader.get(flags);
+}
 
-	reinterpret_cast<size_t &>(buf[offset]) = face.size();
-	offset += sizeof(size_t);
-	if (face.size() > 0) {
-		memcpy(&buf[offset], face.data(), face.size());
-		offset += face.size();
-	}
+obs::Property::Type obs::EditableListProperty::type()
+{
+	return Type::EditableList;
+}
 
-	reinterpret_cast<size_t &>(buf[offset]) = style.size();
-	offset += sizeof(size_t);
-	if (style.size() > 0) {
-		memcpy(&buf[offset], style.data(), style.size());
-		offset += style.size();
-	}
+void obs::EditableListProperty::write(PropertyWriter &writer)
+{
+	Property::write(writer);
+	writer.put<uint8_t>(uint8_t(field_type));
+	writer.put_string(filter);
+	writer.put_string(default_path);
 
-	reinterpret_cast<size_t &>(buf[offset]) = path.size();
-	offset += sizeof(size_t);
-	if (path.size() > 0) {
-		memcpy(&buf[offset], path.data(), path.size());
-		offset += path.size();
+	writer.put<size_t>(values.size());
+	for (auto &entry : values) {
+		writer.put_string(entry);
 	}
-
-	*reinterpret_cast<int64_t *>(&buf[offset]) = sizeF;
-	offset += sizeof(int64_t);
-	*reinterpret_cast<uint32_t *>(&buf[offset]) = flags;
-	offset += sizeof(uint32_t);
-
-	return true;
 }
 
-bool obs::FontProperty::read(std::vector<char> const &buf)
+bool obs::EditableListProperty::read(PropertyReader &reader)
 {
-	if (buf.size() < size()) {
+	if (!Property::read(reader)) {
 		return false;
 	}
 
-	if (!Property::read(buf)) {
+	uint8_t raw_type = 0;
+	if (!reader.get(raw_type) || !reader.get_string(filter) || !reader.get_string(default_path)) {
 		return false;
 	}
+	field_type = ListType(raw_type);
 
-	size_t length = 0;
-
-	size_t offset = Property::size();
-
-	length = reinterpret_cast<const size_t &>(buf[offset]);
-	offset += sizeof(size_t);
-	if (length > 0) {
-		face = std::string(&buf[offset], length);
-		offset += length;
-	}
-
-	length = reinterpret_cast<const size_t &>(buf[offset]);
-	offset += sizeof(size_t);
-	if (length > 0) {
-		style = std::string(&buf[offset], length);
-		offset += length;
+	size_t num_entries = 0;
+	// Every element takes at least one byte, don't trust larger counts.
+	if (!reader.get(num_entries) || num_entries > reader.remaining()) {
+		return false;
 	}
-
-	length = reinterpret_cast<const size_t &>(buf[offset]);
-	offset += sizeof(size_t);
-	if (length > 0) {
-		path = std::string(&buf[offset], length);
-		offset += length;
+	values.clear();
+	values.resize(num_entries);
+	for (auto &entry : values) {
+		if (!reader.get_string(entry)) {
+			return false;
+		}
 	}
 
-	sizeF = *reinterpret_cast<const int64_t *>(&buf[offset]);
-	offset += sizeof(int64_t);
-	flags = *reinterpret_cast<const uint32_t *>(&buf[offset]);
-	offset += sizeof(uint32_t);
-
 	return true;
 }
 
-obs::Property::Type obs::EditableListProperty::type()
+obs::Property::Type obs::FrameRateProperty::type()
 {
-	return Type::EditableList;
+	return Type::FrameRate;
 }
 
-size_t obs::EditableListProperty::size()
+void obs::FrameRateProperty::write(PropertyWriter &writer)
 {
-	size_t total = Property::size();
-	total += sizeof(uint8_t);
-	total += sizeof(size_t) + filter.size();
-	total += sizeof(size_t) + default_path.size();
-	total += sizeof(size_t);
+	Property::write(writer);
 
-	for (auto &entry : values) {
-		total += sizeof(size_t);
-		total += entry.size();
+	writer.put<size_t>(ranges.size());
+	for (Range &range : ranges) {
+		writer.put<uint32_t>(range.minimum.first);
+		writer.put<uint32_t>(range.minimum.second);
+		writer.put<uint32_t>(range.maximum.first);
+		writer.put<uint32_t>(range.maximum.second);
+	}
+
+	writer.put<size_t>(options.size());
+	for (Option &option : options) {
+		writer.put_string(option.name);
+		writer.put_string(option.description);
 	}
 
-	return total;
+	writer.put<uint32_t>(current_numerator);
+	writer.put<uint32_t>(current_denominator);
 }
 
-bool obs::EditableListProperty::serialize(std::vector<char> &buf)
+bool obs::FrameRateProperty::read(PropertyReader &reader)
 {
-	if (buf.size() < size()) {
+	if (!Property::read(reader)) {
 		return false;
 	}
 
-	if (!Property::serialize(buf)) {
+	size_t num_ranges = 0;
+	// Every element takes at least one byte, don't trust larger counts.
+	if (!reader.get(num_ranges) || num_ranges > reader.remaining()) {
 		return false;
 	}
-
-	size_t offset = Property::size();
-	buf[offset] = uint8_t(field_type);
-	offset += sizeof(uint8_t);
-
-	reinterpret_cast<size_t &>(buf[offset]) = filter.size();
-	offset += sizeof(size_t);
-	if (filter.size() > 0) {
-		memcpy(&buf[offset], filter.data(), filter.size());
-		offset += filter.size();
-	}
-
-	reinterpret_cast<size_t &>(buf[offset]) = default_path.size();
-	offset += sizeof(size_t);
-	if (default_path.size() > 0) {
-		memcpy(&buf[offset], default_path.data(), default_path.size());
-		offset += default_path.size();
-	}
-
-	reinterpret_cast<size_t &>(buf[offset]) = values.size();
-	offset += sizeof(size_t);
-	for (auto &entry : values) {
-		reinterpret_cast<size_t &>(buf[offset]) = entry.size();
-		offset += sizeof(size_t);
-		if (entry.size() > 0) {
-			memcpy(&buf[offset], entry.data(), entry.size());
-			offset += entry.size();
+	ranges.clear();
+	ranges.resize(num_ranges);
+	for (Range &range : ranges) {
+		if (!reader.get(range.minimum.first) || !reader.get(range.minimum.second) || !reader.get(range.maximum.first) ||
+		    !reader.get(range.maximum.second)) {
+			return false;
 		}
 	}
 
-	return true;
-}
-
-bool obs::EditableListProperty::read(std::vector<char> const &buf)
-{
-	if (buf.size() < size()) {
-		return false;
-	}
-
-	if (!Property::read(buf)) {
+	size_t num_options = 0;
+	// Every element takes at least one byte, don't trust larger counts.
+	if (!reader.get(num_options) || num_options > reader.remaining()) {
 		return false;
 	}
-
-	size_t offset = Property::size();
-	field_type = ListType(buf[offset]);
-	offset += sizeof(uint8_t);
-
-	size_t length = reinterpret_cast<const size_t &>(buf[offset]);
-	offset += sizeof(size_t);
-	if (length > 0) {
-		filter = std::string(&buf[offset], length);
-		offset += length;
+	options.clear();
+	options.resize(num_options);
+	for (Option &option : options) {
+		if (!reader.get_string(option.name) || !reader.get_string(option.description)) {
+			return false;
+		}
 	}
 
-	length = reinterpret_cast<const size_t &>(buf[offset]);
-	offset += sizeof(size_t);
-	if (length > 0) {
-		default_path = std::string(&buf[offset], length);
-		offset += length;
-	}
+	return reader.get(current_numerator) && reader.get(current_denominator);
+}
 
-	size_t num_entries = reinterpret_cast<const size_t &>(buf[offset]);
-	offset += sizeof(size_t);
-	for (size_t idx = 0; idx < num_entries; idx++) {
-		length = reinterpret_cast<const size_t &>(buf[offset]);
-		offset += sizeof(size_t);
-		std::string entry = "";
-		if (length > 0) {
-			entry = std::string(&buf[offset], length);
-			offset += length;
-		}
+// 64-bit FNV-1a, only used to detect changes so it does not need to be strong.
+static const uint64_t snapshot_hash_basis = 0xCBF29CE484222325ull;
+static const uint64_t snapshot_hash_prime = 0x00000100000001B3ull;
 
-		values.push_back(entry);
+uint64_t obs::PropertySnapshot::hash_bytes(const char *data, size_t size, uint64_t seed)
+{
+	uint64_t hash = seed;
+	for (size_t idx = 0; idx < size; idx++) {
+		hash ^= uint8_t(data[idx]);
+		hash *= snapshot_hash_prime;
 	}
-
-	return true;
+	return hash;
 }
 
-obs::Property::Type obs::FrameRateProperty::type()
+obs::PropertySnapshot::PropertySnapshot()
 {
-	return Type::FrameRate;
+	hash = snapshot_hash_basis;
 }
 
-size_t obs::FrameRateProperty::size()
+void obs::PropertySnapshot::add(Property &prop)
 {
-	size_t total = Property::size();
-	total += sizeof(size_t);
-	total += (sizeof(uint32_t) * 4) * ranges.size();
-	total += sizeof(size_t);
-	for (Option &option : options) {
-		total += sizeof(size_t);
-		total += option.name.size();
-		total += sizeof(size_t);
-		total += option.description.size();
-	}
-	total += sizeof(uint32_t); // current_numerator
-	total += sizeof(uint32_t); // current_denominator
-	return total;
+	Entry entry;
+	entry.offset = arena.size();
+	prop.serialize(arena);
+	entry.size = arena.size() - entry.offset;
+	entry.hash = hash_bytes(data(entry), entry.size, snapshot_hash_basis);
+	hash = hash_bytes(reinterpret_cast<const char *>(&entry.hash), sizeof(uint64_t), hash);
+	entries.push_back(entry);
 }
 
-bool obs::FrameRateProperty::serialize(std::vector<char> &buf)
+std::vector<char> obs::PropertySnapshot::known(uint64_t hash, std::vector<uint64_t> const &entry_hashes)
 {
-	if (buf.size() < size()) {
-		return false;
-	}
-
-	if (!Property::serialize(buf)) {
-		return false;
-	}
+	std::vector<char> buf(sizeof(uint64_t) * (entry_hashes.size() + 1));
+	std::memcpy(buf.data(), &hash, sizeof(uint64_t));
+	if (entry_hashes.size() > 0)
+		std::memcpy(buf.data() + sizeof(uint64_t), entry_hashes.data(), sizeof(uint64_t) * entry_hashes.size());
+	return buf;
+}
 
-	size_t offset = Property::size();
+static const size_t snapshot_header_size = sizeof(uint32_t) + sizeof(uint16_t) * 2 + sizeof(uint64_t) + sizeof(uint32_t);
+static const size_t snapshot_entry_size = sizeof(uint64_t) + sizeof(uint32_t);
 
-	reinterpret_cast<size_t &>(buf[offset]) = ranges.size();
-	offset += sizeof(size_t);
-	for (Range &range : ranges) {
-		reinterpret_cast<uint32_t &>(buf[offset]) = range.minimum.first;
-		offset += sizeof(uint32_t);
-		reinterpret_cast<uint32_t &>(buf[offset]) = range.minimum.second;
-		offset += sizeof(uint32_t);
-		reinterpret_cast<uint32_t &>(buf[offset]) = range.maximum.first;
-		offset += sizeof(uint32_t);
-		reinterpret_cast<uint32_t &>(buf[offset]) = range.maximum.second;
-		offset += sizeof(uint32_t);
+bool obs::PropertySnapshot::serialize(std::vector<char> &buf, std::vector<char> const &known) const
+{
+	uint64_t known_hash = 0;
+	std::vector<uint64_t> known_entries((known.size() / sizeof(uint64_t)) > 0 ? (known.size() / sizeof(uint64_t)) - 1 : 0);
+	if (known.size() >= sizeof(uint64_t)) {
+		std::memcpy(&known_hash, known.data(), sizeof(uint64_t));
+		if (known_entries.size() > 0)
+			std::memcpy(known_entries.data(), known.data() + sizeof(uint64_t), sizeof(uint64_t) * known_entries.size());
+		std::sort(known_entries.begin(), known_entries.end());
 	}
 
-	reinterpret_cast<size_t &>(buf[offset]) = options.size();
-	offset += sizeof(size_t);
-	for (Option &option : options) {
-		reinterpret_cast<size_t &>(buf[offset]) = option.name.size();
-		offset += sizeof(size_t);
-		if (option.name.size() > 0) {
-			memcpy(&buf[offset], option.name.data(), option.name.size());
-			offset += option.name.size();
-		}
-		reinterpret_cast<size_t &>(buf[offset]) = option.description.size();
-		offset += sizeof(size_t);
-		if (option.description.size() > 0) {
-			memcpy(&buf[offset], option.description.data(), option.description.size());
-			offset += option.description.size();
+	uint16_t out_flags = flags;
+	bool unchanged = known.size() >= sizeof(uint64_t) && known_hash == hash;
+	if (unchanged)
+		out_flags |= Unchanged;
+
+	size_t total = snapshot_header_size;
+	if (!unchanged) {
+		for (auto &entry : entries) {
+			total += snapshot_entry_size;
+			if (!std::binary_search(known_entries.begin(), known_entries.end(), entry.hash))
+				total += entry.size;
 		}
 	}
 
-	reinterpret_cast<uint32_t &>(buf[offset]) = current_numerator;
+	buf.resize(total);
+	size_t offset = 0;
+	std::memcpy(&buf[offset], &magic, sizeof(uint32_t));
 	offset += sizeof(uint32_t);
-	reinterpret_cast<uint32_t &>(buf[offset]) = current_denominator;
+	std::memcpy(&buf[offset], &version, sizeof(uint16_t));
+	offset += sizeof(uint16_t);
+	std::memcpy(&buf[offset], &out_flags, sizeof(uint16_t));
+	offset += sizeof(uint16_t);
+	std::memcpy(&buf[offset], &hash, sizeof(uint64_t));
+	offset += sizeof(uint64_t);
+	uint32_t count = unchanged ? 0 : uint32_t(entries.size());
+	std::memcpy(&buf[offset], &count, sizeof(uint32_t));
 	offset += sizeof(uint32_t);
 
+	if (unchanged)
+		return true;
+
+	for (auto &entry : entries) {
+		uint32_t size = 0;
+		if (!std::binary_search(known_entries.begin(), known_entries.end(), entry.hash))
+			size = uint32_t(entry.size);
+
+		std::memcpy(&buf[offset], &entry.hash, sizeof(uint64_t));
+		offset += sizeof(uint64_t);
+		std::memcpy(&buf[offset], &size, sizeof(uint32_t));
+		offset += sizeof(uint32_t);
+		if (size > 0) {
+			std::memcpy(&buf[offset], data(entry), size);
+			offset += size;
+		}
+	}
+
 	return true;
 }
 
-bool obs::FrameRateProperty::read(std::vector<char> const &buf)
+bool obs::PropertySnapshot::read(std::vector<char> &&buf)
 {
-	if (buf.size() < size()) {
+	arena = std::move(buf);
+	entries.clear();
+
+	if (arena.size() < snapshot_header_size)
 		return false;
-	}
 
-	if (!Property::read(buf)) {
+	size_t offset = 0;
+	uint32_t buf_magic = 0;
+	uint16_t buf_version = 0;
+	std::memcpy(&buf_magic, &arena[offset], sizeof(uint32_t));
+	offset += sizeof(uint32_t);
+	std::memcpy(&buf_version, &arena[offset], sizeof(uint16_t));
+	offset += sizeof(uint16_t);
+	if (buf_magic != magic || buf_version != version)
 		return false;
-	}
 
-	size_t length = 0;
+	std::memcpy(&flags, &arena[offset], sizeof(uint16_t));
+	offset += sizeof(uint16_t);
+	std::memcpy(&hash, &arena[offset], sizeof(uint64_t));
+	offset += sizeof(uint64_t);
+	uint32_t count = 0;
+	std::memcpy(&count, &arena[offset], sizeof(uint32_t));
+	offset += sizeof(uint32_t);
 
-	size_t offset = Property::size();
-	size_t num_ranges = reinterpret_cast<const size_t &>(buf[offset]);
-	offset += sizeof(size_t);
-	for (size_t idx = 0; idx < num_ranges; idx++) {
-		Range range;
-		range.minimum.first = reinterpret_cast<const uint32_t &>(buf[offset]);
-		offset += sizeof(uint32_t);
-		range.minimum.second = reinterpret_cast<const uint32_t &>(buf[offset]);
-		offset += sizeof(uint32_t);
-		range.maximum.first = reinterpret_cast<const uint32_t &>(buf[offset]);
-		offset += sizeof(uint32_t);
-		range.maximum.second = reinterpret_cast<const uint32_t &>(buf[offset]);
+	if (count > (arena.size() - offset) / snapshot_entry_size)
+		return false;
+
+	entries.reserve(count);
+	for (uint32_t idx = 0; idx < count; idx++) {
+		if (arena.size() - offset < snapshot_entry_size)
+			return false;
+
+		Entry entry;
+		uint32_t size = 0;
+		std::memcpy(&entry.hash, &arena[offset], sizeof(uint64_t));
+		offset += sizeof(uint64_t);
+		std::memcpy(&size, &arena[offset], sizeof(uint32_t));
 		offset += sizeof(uint32_t);
-		ranges.push_back(std::move(range));
-	}
 
-	size_t num_options = reinterpret_cast<const size_t &>(buf[offset]);
-	offset += sizeof(size_t);
-	for (size_t idx = 0; idx < num_options; idx++) {
-		Option option;
-		length = reinterpret_cast<const size_t &>(buf[offset]);
-		offset += sizeof(size_t);
-		if (length > 0) {
-			option.name = std::string(&buf[offset], length);
-		}
-		length = reinterpret_cast<const size_t &>(buf[offset]);
-		offset += sizeof(size_t);
-		if (length > 0) {
-			option.description = std::string(&buf[offset], length);
-		}
-		options.push_back(std::move(option));
-	}
+		if (arena.size() - offset < size)
+			return false;
+		entry.offset = offset;
+		entry.size = size;
+		offset += size;
 
-	current_numerator = reinterpret_cast<const uint32_t &>(buf[offset]);
-	offset += sizeof(uint32_t);
-	current_denominator = reinterpret_cast<const uint32_t &>(buf[offset]);
-	offset += sizeof(uint32_t);
+		entries.push_back(entry);
+	}
 
 	return true;
 }
@@ -18,13 +18,103 @@
 
 #pragma once
 #include <inttypes.h>
-#include <list>
+#include <algorithm>
+#include <cstring>
 #include <memory>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <cmath>
 
 namespace obs {
+// Appends to a growable buffer in a single pass, any number of properties can
+// share the same buffer.
+class PropertyWriter {
+public:
+	PropertyWriter(std::vector<char> &arena) : arena(arena), start(arena.size()), offset(start) {}
+	~PropertyWriter() { arena.resize(offset); }
+
+	template<typename T> void put(T value)
+	{
+		reserve(sizeof(T));
+		std::memcpy(arena.data() + offset, &value, sizeof(T));
+		offset += sizeof(T);
+	}
+
+	void put_string(std::string_view value)
+	{
+		put<size_t>(value.size());
+		if (value.size() > 0) {
+			reserve(value.size());
+			std::memcpy(arena.data() + offset, value.data(), value.size());
+			offset += value.size();
+		}
+	}
+
+private:
+	// The arena is grown ahead and trimmed to what was written on destruction.
+	// Growing ahead is bounded by what this writer wrote so far and the
+	// allocation grows by capacity, so many properties sharing one arena do
+	// not reallocate or clear the whole arena once per property.
+	void reserve(size_t size)
+	{
+		if (arena.size() - offset >= size)
+			return;
+		size_t target = offset + (std::max)(size, (std::max)(offset - start, min_grow));
+		if (arena.capacity() < target)
+			arena.reserve((std::max)(arena.capacity() * 2, target));
+		arena.resize(target);
+	}
+
+	static constexpr size_t min_grow = 64;
+
+	std::vector<char> &arena;
+	size_t start;
+	size_t offset;
+};
+
+// Reads back what PropertyWriter wrote. Strings are returned as views into the
+// buffer, which must outlive them.
+class PropertyReader {
+public:
+	PropertyReader(const char *data, size_t size) : data(data), size(size) {}
+
+	template<typename T> bool get(T &value)
+	{
+		if (size - offset < sizeof(T))
+			return false;
+		std::memcpy(&value, data + offset, sizeof(T));
+		offset += sizeof(T);
+		return true;
+	}
+
+	bool get_string(std::string_view &value)
+	{
+		size_t length = 0;
+		if (!get(length) || size - offset < length)
+			return false;
+		value = std::string_view(data + offset, length);
+		offset += length;
+		return true;
+	}
+
+	bool get_string(std::string &value)
+	{
+		std::string_view view;
+		if (!get_string(view))
+			return false;
+		value.assign(view.data(), view.size());
+		return true;
+	}
+
+	size_t remaining() const { return size - offset; }
+
+private:
+	const char *data;
+	size_t size;
+	size_t offset = 0;
+};
+
 struct Property {
 	enum class Type : uint8_t {
 		Invalid,
@@ -53,13 +143,15 @@ struct Property {
 	virtual ~Property(){};
 
 	static std::shared_ptr<Property> deserialize(std::vector<char> const &buf);
+	static std::shared_ptr<Property> deserialize(const char *data, size_t size);
 
 	virtual obs::Property::Type type();
-	virtual size_t size();
-	virtual bool serialize(std::vector<char> &buf);
+	// Appends the property to buf.
+	void serialize(std::vector<char> &buf);
+	virtual void write(PropertyWriter &writer);
 
 protected:
-	virtual bool read(std::vector<char> const &buf);
+	virtual bool read(PropertyReader &reader);
 };
 
 struct BooleanProperty : Property {
@@ -67,11 +159,10 @@ struct BooleanProperty : Property {
 	virtual ~BooleanProperty(){};
 
 	virtual obs::Property::Type type() override;
-	virtual size_t size() override;
-	virtual bool serialize(std::vector<char> &buf) override;
+	virtual void write(PropertyWriter &writer) override;
 
 protected:
-	virtual bool read(std::vector<char> const &buf) override;
+	virtual bool read(PropertyReader &reader) override;
 };
 
 struct NumberProperty : Property {
@@ -82,11 +173,10 @@ struct NumberProperty : Property {
 	NumberType field_type;
 	virtual ~NumberProperty(){};
 
-	virtual size_t size() override;
-	virtual bool serialize(std::vector<char> &buf) override;
+	virtual void write(PropertyWriter &writer) override;
 
 protected:
-	virtual bool read(std::vector<char> const &buf) override;
+	virtual bool read(PropertyReader &reader) override;
 };
 
 struct IntegerProperty : NumberProperty {
@@ -98,11 +188,10 @@ struct IntegerProperty : NumberProperty {
 	virtual ~IntegerProperty(){};
 
 	virtual obs::Property::Type type() override;
-	virtual size_t size() override;
-	virtual bool serialize(std::vector<char> &buf) override;
+	virtual void write(PropertyWriter &writer) override;
 
 protected:
-	virtual bool read(std::vector<char> const &buf) override;
+	virtual bool read(PropertyReader &reader) override;
 };
 
 struct FloatProperty : NumberProperty {
@@ -114,11 +203,10 @@ struct FloatProperty : NumberProperty {
 	virtual ~FloatProperty(){};
 
 	virtual obs::Property::Type type() override;
-	virtual size_t size() override;
-	virtual bool serialize(std::vector<char> &buf) override;
+	virtual void write(PropertyWriter &writer) override;
 
 protected:
-	virtual bool read(std::vector<char> const &buf) override;
+	virtual bool read(PropertyReader &reader) override;
 };
 
 struct TextProperty : Property {
@@ -133,11 +221,10 @@ struct TextProperty : Property {
 	virtual ~TextProperty(){};
 
 	virtual obs::Property::Type type() override;
-	virtual size_t size() override;
-	virtual bool serialize(std::vector<char> &buf) override;
+	virtual void write(PropertyWriter &writer) override;
 
 protected:
-	virtual bool read(std::vector<char> const &buf) override;
+	virtual bool read(PropertyReader &reader) override;
 };
 
 struct PathProperty : Property {
@@ -154,11 +241,10 @@ struct PathProperty : Property {
 	virtual ~PathProperty(){};
 
 	virtual obs::Property::Type type() override;
-	virtual size_t size() override;
-	virtual bool serialize(std::vector<char> &buf) override;
+	virtual void write(PropertyWriter &writer) override;
 
 protected:
-	virtual bool read(std::vector<char> const &buf) override;
+	virtual bool read(PropertyReader &reader) override;
 };
 
 struct ListProperty : Property {
@@ -185,7 +271,7 @@ struct ListProperty : Property {
 		double_t value_float;
 		std::string value_string;
 	};
-	std::list<Item> items;
+	std::vector<Item> items;
 	int64_t current_value_int;
 	double_t current_value_float;
 	std::string current_value_str;
@@ -193,46 +279,42 @@ struct ListProperty : Property {
 	virtual ~ListProperty(){};
 
 	virtual obs::Property::Type type() override;
-	virtual size_t size() override;
-	virtual bool serialize(std::vector<char> &buf) override;
+	virtual void write(PropertyWriter &writer) override;
 
 protected:
-	virtual bool read(std::vector<char> const &buf) override;
+	virtual bool read(PropertyReader &reader) override;
 };
 
 struct ColorProperty : NumberProperty {
 	virtual ~ColorProperty(){};
 
 	virtual obs::Property::Type type() override;
-	virtual size_t size() override;
-	virtual bool serialize(std::vector<char> &buf) override;
+	virtual void write(PropertyWriter &writer) override;
 	int64_t value;
 
 protected:
-	virtual bool read(std::vector<char> const &buf) override;
+	virtual bool read(PropertyReader &reader) override;
 };
 
 struct CaptureProperty : NumberProperty {
 	virtual ~CaptureProperty(){};
 
 	virtual obs::Property::Type type() override;
-	virtual size_t size() override;
-	virtual bool serialize(std::vector<char> &buf) override;
+	virtual void write(PropertyWriter &writer) override;
 	int64_t value;
 
 protected:
-	virtual bool read(std::vector<char> const &buf) override;
+	virtual bool read(PropertyReader &reader) override;
 };
 
 struct ButtonProperty : Property {
 	virtual ~ButtonProperty(){};
 
 	virtual obs::Property::Type type() override;
-	virtual size_t size() override;
-	virtual bool serialize(std::vector<char> &buf) override;
+	virtual void write(PropertyWriter &writer) override;
 
 protected:
-	virtual bool read(std::vector<char> const &buf) override;
+	virtual bool read(PropertyReader &reader) override;
 };
 
 struct FontProperty : Property {
@@ -245,11 +327,10 @@ struct FontProperty : Property {
 	virtual ~FontProperty(){};
 
 	virtual obs::Property::Type type() override;
-	virtual size_t size() override;
-	virtual bool serialize(std::vector<char> &buf) override;
+	virtual void write(PropertyWriter &writer) override;
 
 protected:
-	virtual bool read(std::vector<char> const &buf) override;
+	virtual bool read(PropertyReader &reader) override;
 };
 
 struct EditableListProperty : Property {
@@ -261,16 +342,15 @@ struct EditableListProperty : Property {
 	ListType field_type;
 	std::string filter;
 	std::string default_path;
-	std::list<std::string> values;
+	std::vector<std::string> values;
 
 	virtual ~EditableListProperty(){};
 
 	virtual obs::Property::Type type() override;
-	virtual size_t size() override;
-	virtual bool serialize(std::vector<char> &buf) override;
+	virtual void write(PropertyWriter &writer) override;
 
 protected:
-	virtual bool read(std::vector<char> const &buf) override;
+	virtual bool read(PropertyReader &reader) override;
 };
 
 struct FrameRateProperty : Property {
@@ -278,13 +358,13 @@ struct FrameRateProperty : Property {
 		std::pair<uint32_t, uint32_t> minimum;
 		std::pair<uint32_t, uint32_t> maximum;
 	};
-	std::list<Range> ranges;
+	std::vector<Range> ranges;
 
 	struct Option {
 		std::string name;
 		std::string description;
 	};
-	std::list<Option> options;
+	std::vector<Option> options;
 
 	uint32_t current_numerator;
 	uint32_t current_denominator;
@@ -292,11 +372,56 @@ struct FrameRateProperty : Property {
 	virtual ~FrameRateProperty(){};
 
 	virtual obs::Property::Type type() override;
-	virtual size_t size() override;
-	virtual bool serialize(std::vector<char> &buf) override;
+	virtual void write(PropertyWriter &writer) override;
 
 protected:
-	virtual bool read(std::vector<char> const &buf) override;
+	virtual bool read(PropertyReader &reader) override;
+};
+
+// All properties of an object in a single buffer, used by
+// Source.GetPropertiesSnapshot.
+//
+//	header: uint32_t magic, uint16_t version, uint16_t flags, uint64_t hash, uint32_t count
+//	entry:  uint64_t hash, uint32_t size, then size bytes from Property::write
+//
+// Every entry carries a hash of its serialized bytes and the snapshot hash
+// covers the ordered list of entry hashes. The requester sends the hashes it
+// already holds (see known()), entries matching one of them are sent with
+// size 0 and must be taken from the requester's own copy. If the snapshot hash
+// matches, only the header is sent with the Unchanged flag set.
+struct PropertySnapshot {
+	static constexpr uint32_t magic = 0x504E534F; // 'OSNP'
+	static constexpr uint16_t version = 1;
+
+	enum Flags : uint16_t {
+		Unchanged = (1 << 0),
+	};
+
+	struct Entry {
+		uint64_t hash = 0;
+		// Range in arena, size is 0 if the requester already holds this entry.
+		size_t offset = 0;
+		size_t size = 0;
+	};
+
+	uint16_t flags = 0;
+	uint64_t hash = 0;
+	// Serialized properties of all entries, back to back.
+	std::vector<char> arena;
+	std::vector<Entry> entries;
+
+	PropertySnapshot();
+
+	void add(Property &prop);
+	const char *data(const Entry &entry) const { return arena.data() + entry.offset; }
+
+	bool serialize(std::vector<char> &buf, std::vector<char> const &known) const;
+	// Takes over buf, entries then point into it.
+	bool read(std::vector<char> &&buf);
+
+	// Builds the list of hashes sent along with a request.
+	static std::vector<char> known(uint64_t hash, std::vector<uint64_t> const &entry_hashes);
+	static uint64_t hash_bytes(const char *data, size_t size, uint64_t seed);
 };
 
 } // namespace obs
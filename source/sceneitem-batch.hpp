@@ -0,0 +1,98 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#pragma once
+#include <cstring>
+#include <inttypes.h>
+#include <vector>
+
+// Packed format used by SceneItem.BatchGet and SceneItem.BatchSet.
+//
+// BatchGet takes the item ids as a packed uint64_t array plus a field mask and
+// answers with one record per id:
+//	uint64_t uid, uint8_t valid, then the masked fields if valid.
+// BatchSet takes one record per item:
+//	uint64_t uid, uint32_t mask, then the masked fields.
+// Fields are always written in ascending bit order, see BatchField.
+//
+// Scene.GetItems and Scene.GetItemsInRange answer with one ItemRef per item,
+// back to front.
+namespace sceneitem {
+enum BatchField : uint32_t {
+	Visible = (1 << 0),          // uint8_t
+	Selected = (1 << 1),         // uint8_t
+	StreamVisible = (1 << 2),    // uint8_t
+	RecordingVisible = (1 << 3), // uint8_t
+	Position = (1 << 4),         // float x, float y
+	Rotation = (1 << 5),         // float
+	Scale = (1 << 6),            // float x, float y
+	Alignment = (1 << 7),        // uint32_t
+	Bounds = (1 << 8),           // float x, float y
+	BoundsAlignment = (1 << 9),  // uint32_t
+	BoundsType = (1 << 10),      // uint32_t
+	Crop = (1 << 11),            // int32_t left, top, right, bottom
+	ScaleFilter = (1 << 12),     // uint32_t
+	BlendingMethod = (1 << 13),  // uint32_t
+	BlendingMode = (1 << 14),    // uint32_t
+	ObsId = (1 << 15),           // int64_t, read only
+
+	AllFields = (1 << 16) - 1,
+	WritableFields = AllFields & ~ObsId,
+};
+
+struct ItemRef {
+	uint64_t uid;
+	int64_t obs_id;
+};
+
+class BatchWriter {
+public:
+	BatchWriter(std::vector<char> &buffer) : buffer(buffer) {}
+
+	template<typename T> void put(T value)
+	{
+		size_t offset = buffer.size();
+		buffer.resize(offset + sizeof(T));
+		std::memcpy(buffer.data() + offset, &value, sizeof(T));
+	}
+
+private:
+	std::vector<char> &buffer;
+};
+
+class BatchReader {
+public:
+	BatchReader(const std::vector<char> &buffer) : buffer(buffer) {}
+
+	// Returns false once the buffer is exhausted, value is left untouched.
+	template<typename T> bool get(T &value)
+	{
+		if (buffer.size() - offset < sizeof(T))
+			return false;
+		std::memcpy(&value, buffer.data() + offset, sizeof(T));
+		offset += sizeof(T);
+		return true;
+	}
+
+	bool done() const { return offset >= buffer.size(); }
+
+private:
+	const std::vector<char> &buffer;
+	size_t offset = 0;
+};
+} // namespace sceneitem
@@ -0,0 +1,318 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#pragma once
+#include <cstring>
+#include <inttypes.h>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+// Packed format of source settings, used instead of JSON text between the
+// client and the server.
+//
+// A settings object is a sequence of records, one per key:
+//	uint8_t type, uint32_t key length, key bytes, then the value.
+// Values are stored as:
+//	Bool: uint8_t
+//	Int: int64_t
+//	Double: double
+//	String: uint32_t length, then the bytes
+//	Object: uint32_t size in bytes, then a settings object
+//	Array: uint32_t size in bytes, uint32_t count, then per element a
+//	       uint32_t size in bytes and a settings object
+// A patch is a settings object holding only the keys that changed, values
+// always replace the previous value as a whole.
+namespace settings {
+enum Type : uint8_t {
+	Bool = 1,
+	Int = 2,
+	Double = 3,
+	String = 4,
+	Object = 5,
+	Array = 6,
+};
+
+class Writer {
+public:
+	Writer(std::vector<char> &buffer) : buffer(buffer) {}
+
+	void put_bool(const char *key, size_t key_size, bool value)
+	{
+		uint8_t byte = value ? 1 : 0;
+		put_record(Bool, key, key_size, &byte, sizeof(byte));
+	}
+
+	void put_int(const char *key, size_t key_size, int64_t value) { put_record(Int, key, key_size, &value, sizeof(value)); }
+
+	void put_double(const char *key, size_t key_size, double value) { put_record(Double, key, key_size, &value, sizeof(value)); }
+
+	void put_string(const char *key, size_t key_size, const char *value, size_t size)
+	{
+		uint32_t length = (uint32_t)size;
+		char *out = put_record(String, key, key_size, &length, sizeof(length), size);
+		if (size > 0)
+			std::memcpy(out, value, size);
+	}
+
+	// Nested objects and arrays are written in place, the returned mark is
+	// handed back to end_object or end_array once their content is written.
+	size_t begin_object(const char *key, size_t key_size)
+	{
+		uint32_t size = 0;
+		return put_record(Object, key, key_size, &size, sizeof(size)) - buffer.data() - sizeof(size);
+	}
+
+	void end_object(size_t mark) { end_size(mark); }
+
+	size_t begin_array(const char *key, size_t key_size)
+	{
+		uint32_t size_and_count[2] = {0, 0};
+		return put_record(Array, key, key_size, size_and_count, sizeof(size_and_count)) - buffer.data() - sizeof(size_and_count);
+	}
+
+	size_t begin_element() { return begin_size(); }
+	void end_element(size_t mark) { end_size(mark); }
+
+	void end_array(size_t mark, uint32_t count)
+	{
+		end_size(mark);
+		std::memcpy(buffer.data() + mark + sizeof(uint32_t), &count, sizeof(count));
+	}
+
+	// Copies records that are already encoded.
+	void append(const char *records, size_t size) { buffer.insert(buffer.end(), records, records + size); }
+
+	size_t size() const { return buffer.size(); }
+	void truncate(size_t size) { buffer.resize(size); }
+
+private:
+	// Grows the buffer once per record, extra bytes are left for the caller.
+	char *put_record(Type type, const char *key, size_t key_size, const void *value, size_t value_size, size_t extra = 0)
+	{
+		uint32_t length = (uint32_t)key_size;
+		size_t offset = buffer.size();
+		buffer.resize(offset + sizeof(uint8_t) + sizeof(length) + key_size + value_size + extra);
+
+		char *out = buffer.data() + offset;
+		*out++ = (char)type;
+		std::memcpy(out, &length, sizeof(length));
+		out += sizeof(length);
+		std::memcpy(out, key, key_size);
+		out += key_size;
+		std::memcpy(out, value, value_size);
+		return out + value_size;
+	}
+
+	template<typename T> void put(T value)
+	{
+		size_t offset = buffer.size();
+		buffer.resize(offset + sizeof(T));
+		std::memcpy(buffer.data() + offset, &value, sizeof(T));
+	}
+
+	size_t begin_size()
+	{
+		size_t mark = buffer.size();
+		put<uint32_t>(0);
+		return mark;
+	}
+
+	void end_size(size_t mark)
+	{
+		uint32_t size = (uint32_t)(buffer.size() - mark - sizeof(uint32_t));
+		std::memcpy(buffer.data() + mark, &size, sizeof(size));
+	}
+
+	std::vector<char> &buffer;
+};
+
+struct Record {
+	Type type;
+	const char *key;
+	uint32_t key_size;
+	// String bytes, the records of an Object, the elements of an Array or the
+	// raw Bool, Int and Double value.
+	const char *value;
+	uint32_t value_size;
+	// Number of elements of an Array.
+	uint32_t count;
+	// The whole record, header included.
+	const char *data;
+	size_t size;
+
+	std::string name() const { return std::string(key, key_size); }
+	bool is(const char *other) const { return key_size == std::strlen(other) && std::memcmp(key, other, key_size) == 0; }
+	template<typename T> T get() const
+	{
+		T result;
+		std::memcpy(&result, value, sizeof(T));
+		return result;
+	}
+	// JS numbers arrive as Int or Double depending on their value.
+	double number() const
+	{
+		if (type == Int)
+			return (double)get<int64_t>();
+		if (type == Double)
+			return get<double>();
+		return 0;
+	}
+};
+
+class Reader {
+public:
+	Reader(const char *data, size_t size) : data(data), end(data + size) {}
+	Reader(const std::vector<char> &buffer) : Reader(buffer.data(), buffer.size()) {}
+
+	// Returns false at the end of the object or if the record is malformed,
+	// done() tells both apart.
+	bool next(Record &record)
+	{
+		const char *start = data;
+		uint8_t type;
+		if (!get(type) || !get_bytes(record.key, record.key_size))
+			return fail(start);
+
+		record.type = (Type)type;
+		record.count = 0;
+		switch (type) {
+		case Bool:
+			if (!get_raw(sizeof(uint8_t), record))
+				return fail(start);
+			break;
+		case Int:
+		case Double:
+			if (!get_raw(sizeof(int64_t), record))
+				return fail(start);
+			break;
+		case String:
+		case Object:
+			if (!get_bytes(record.value, record.value_size))
+				return fail(start);
+			break;
+		case Array:
+			if (!get_bytes(record.value, record.value_size) || record.value_size < sizeof(uint32_t))
+				return fail(start);
+			std::memcpy(&record.count, record.value, sizeof(uint32_t));
+			record.value += sizeof(uint32_t);
+			record.value_size -= sizeof(uint32_t);
+			break;
+		default:
+			return fail(start);
+		}
+
+		record.data = start;
+		record.size = data - start;
+		return true;
+	}
+
+	// Iterates the elements of an Array record.
+	bool next_element(Reader &element)
+	{
+		const char *value;
+		uint32_t size;
+		if (!get_bytes(value, size))
+			return false;
+		element = Reader(value, size);
+		return true;
+	}
+
+	bool done() const { return data == end; }
+
+private:
+	template<typename T> bool get(T &value)
+	{
+		if (size_t(end - data) < sizeof(T))
+			return false;
+		std::memcpy(&value, data, sizeof(T));
+		data += sizeof(T);
+		return true;
+	}
+
+	bool get_bytes(const char *&value, uint32_t &size)
+	{
+		if (!get(size) || size_t(end - data) < size)
+			return false;
+		value = data;
+		data += size;
+		return true;
+	}
+
+	bool get_raw(uint32_t size, Record &record)
+	{
+		if (size_t(end - data) < size)
+			return false;
+		record.value = data;
+		record.value_size = size;
+		data += size;
+		return true;
+	}
+
+	// Leaves the reader on the bad record so done() stays false.
+	bool fail(const char *start)
+	{
+		data = start;
+		return false;
+	}
+
+	const char *data;
+	const char *end;
+};
+
+// Checks nested objects and arrays as well, for consumers that must not stop
+// halfway through.
+inline bool validate(Reader reader)
+{
+	Record record;
+	while (reader.next(record)) {
+		if (record.type == Object && !validate(Reader(record.value, record.value_size)))
+			return false;
+		if (record.type != Array)
+			continue;
+
+		Reader elements(record.value, record.value_size);
+		for (uint32_t i = 0; i < record.count; i++) {
+			Reader element(nullptr, 0);
+			if (!elements.next_element(element) || !validate(element))
+				return false;
+		}
+		if (!elements.done())
+			return false;
+	}
+	return reader.done();
+}
+
+// previous with the records of patch in place of those with the same key.
+// Records that were not patched keep their order, the patch comes last.
+inline void merge(Reader previous, Reader patch, std::vector<char> &merged)
+{
+	std::unordered_set<std::string_view> patched;
+	Record record;
+	for (Reader keys = patch; keys.next(record);)
+		patched.emplace(record.key, record.key_size);
+
+	while (previous.next(record)) {
+		if (!patched.count(std::string_view(record.key, record.key_size)))
+			merged.insert(merged.end(), record.data, record.data + record.size);
+	}
+	while (patch.next(record))
+		merged.insert(merged.end(), record.data, record.data + record.size);
+}
+} // namespace settings
@@ -0,0 +1,444 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#pragma once
+#include <charconv>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "settings-binary.hpp"
+
+// Conversion between JSON text and the format of settings-binary.hpp.
+//
+// V8 parses and prints JSON faster than objects can be built or walked one
+// property at a time through N-API, so the client goes through JSON text for
+// settings made of many small values. FromJson follows the rules of the direct
+// conversion: null is left out, integral numbers below 2^53 become Int and
+// array elements that are not objects are dropped. Input is expected to come
+// from JSON.stringify.
+namespace settings {
+class JsonReader {
+public:
+	JsonReader(const char *text, size_t size) : data(text), end(text + size) {}
+
+	// Appends the records of the object at the start of the text.
+	bool read_object(Writer &writer)
+	{
+		skip_space();
+		if (!consume('{'))
+			return false;
+		skip_space();
+		if (consume('}'))
+			return true;
+
+		std::string key;
+		do {
+			skip_space();
+			if (!read_string(key))
+				return false;
+			skip_space();
+			if (!consume(':'))
+				return false;
+			skip_space();
+			if (!read_value(writer, key))
+				return false;
+			skip_space();
+		} while (consume(','));
+		return consume('}');
+	}
+
+private:
+	bool read_value(Writer &writer, const std::string &key)
+	{
+		if (data == end)
+			return false;
+
+		switch (*data) {
+		case '"': {
+			// Strings without escapes are copied straight from the text.
+			const char *start = data + 1;
+			const char *stop = start;
+			while (stop < end && *stop != '"' && *stop != '\\')
+				stop++;
+			if (stop < end && *stop == '"') {
+				writer.put_string(key.data(), key.size(), start, stop - start);
+				data = stop + 1;
+				return true;
+			}
+			if (!read_string(scratch))
+				return false;
+			writer.put_string(key.data(), key.size(), scratch.data(), scratch.size());
+			return true;
+		}
+		case '{': {
+			size_t mark = writer.begin_object(key.data(), key.size());
+			if (!read_object(writer))
+				return false;
+			writer.end_object(mark);
+			return true;
+		}
+		case '[':
+			return read_array(writer, key);
+		case 't':
+			writer.put_bool(key.data(), key.size(), true);
+			return consume_word("true");
+		case 'f':
+			writer.put_bool(key.data(), key.size(), false);
+			return consume_word("false");
+		case 'n':
+			return consume_word("null");
+		default:
+			return read_number(writer, key);
+		}
+	}
+
+	bool read_array(Writer &writer, const std::string &key)
+	{
+		data++;
+		uint32_t count = 0;
+		size_t mark = writer.begin_array(key.data(), key.size());
+		skip_space();
+		if (!consume(']')) {
+			do {
+				skip_space();
+				if (data < end && *data == '{') {
+					size_t element = writer.begin_element();
+					if (!read_object(writer))
+						return false;
+					writer.end_element(element);
+					count++;
+				} else {
+					// Dropped, only its extent matters.
+					std::vector<char> ignored;
+					Writer sink(ignored);
+					if (!read_value(sink, key))
+						return false;
+				}
+				skip_space();
+			} while (consume(','));
+			if (!consume(']'))
+				return false;
+		}
+		writer.end_array(mark, count);
+		return true;
+	}
+
+	bool read_number(Writer &writer, const std::string &key)
+	{
+		char digits[64];
+		size_t length = 0;
+		while (data < end && length < sizeof(digits) - 1 && *data && std::strchr("0123456789+-.eE", *data)) {
+			digits[length++] = *data++;
+		}
+		digits[length] = 0;
+
+		// Most numbers in settings are small integers, strtod is only needed
+		// for the others.
+		const char *digit = digits + (digits[0] == '-');
+		if (length > 0 && length - (digit - digits) <= 15 && *digit) {
+			int64_t value = 0;
+			while (*digit >= '0' && *digit <= '9')
+				value = value * 10 + (*digit++ - '0');
+			if (*digit == 0) {
+				writer.put_int(key.data(), key.size(), digits[0] == '-' ? -value : value);
+				return true;
+			}
+		}
+
+		// JSON.stringify never writes a locale dependent decimal separator,
+		// the process runs in the "C" numeric locale.
+		char *stop = nullptr;
+		double number = std::strtod(digits, &stop);
+		if (length == 0 || stop != digits + length || !std::isfinite(number))
+			return false;
+		if (std::trunc(number) == number && std::fabs(number) < 9007199254740992.0)
+			writer.put_int(key.data(), key.size(), (int64_t)number);
+		else
+			writer.put_double(key.data(), key.size(), number);
+		return true;
+	}
+
+	bool read_string(std::string &value)
+	{
+		value.clear();
+		if (!consume('"'))
+			return false;
+
+		while (data < end) {
+			const char *start = data;
+			while (data < end && *data != '"' && *data != '\\')
+				data++;
+			value.append(start, data - start);
+			if (data == end)
+				return false;
+			if (*data++ == '"')
+				return true;
+			if (data == end)
+				return false;
+
+			switch (*data++) {
+			case '"':
+				value.push_back('"');
+				break;
+			case '\\':
+				value.push_back('\\');
+				break;
+			case '/':
+				value.push_back('/');
+				break;
+			case 'b':
+				value.push_back('\b');
+				break;
+			case 'f':
+				value.push_back('\f');
+				break;
+			case 'n':
+				value.push_back('\n');
+				break;
+			case 'r':
+				value.push_back('\r');
+				break;
+			case 't':
+				value.push_back('\t');
+				break;
+			case 'u': {
+				uint32_t code;
+				if (!read_hex(code))
+					return false;
+				if (code >= 0xD800 && code < 0xDC00 && end - data >= 6 && data[0] == '\\' && data[1] == 'u') {
+					const char *mark = data;
+					uint32_t low;
+					data += 2;
+					if (read_hex(low) && low >= 0xDC00 && low < 0xE000)
+						code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+					else
+						data = mark;
+				}
+				// Lone surrogates become U+FFFD, as in String::Utf8Value.
+				if (code >= 0xD800 && code < 0xE000)
+					code = 0xFFFD;
+				put_utf8(value, code);
+				break;
+			}
+			default:
+				return false;
+			}
+		}
+		return false;
+	}
+
+	bool read_hex(uint32_t &code)
+	{
+		if (end - data < 4)
+			return false;
+		code = 0;
+		for (int i = 0; i < 4; i++) {
+			char c = *data++;
+			code <<= 4;
+			if (c >= '0' && c <= '9')
+				code |= c - '0';
+			else if (c >= 'a' && c <= 'f')
+				code |= c - 'a' + 10;
+			else if (c >= 'A' && c <= 'F')
+				code |= c - 'A' + 10;
+			else
+				return false;
+		}
+		return true;
+	}
+
+	static void put_utf8(std::string &value, uint32_t code)
+	{
+		if (code < 0x80) {
+			value.push_back((char)code);
+		} else if (code < 0x800) {
+			value.push_back((char)(0xC0 | (code >> 6)));
+			value.push_back((char)(0x80 | (code & 0x3F)));
+		} else if (code < 0x10000) {
+			value.push_back((char)(0xE0 | (code >> 12)));
+			value.push_back((char)(0x80 | ((code >> 6) & 0x3F)));
+			value.push_back((char)(0x80 | (code & 0x3F)));
+		} else {
+			value.push_back((char)(0xF0 | (code >> 18)));
+			value.push_back((char)(0x80 | ((code >> 12) & 0x3F)));
+			value.push_back((char)(0x80 | ((code >> 6) & 0x3F)));
+			value.push_back((char)(0x80 | (code & 0x3F)));
+		}
+	}
+
+	void skip_space()
+	{
+		while (data < end && (*data == ' ' || *data == '\n' || *data == '\r' || *data == '\t'))
+			data++;
+	}
+
+	bool consume(char c)
+	{
+		if (data == end || *data != c)
+			return false;
+		data++;
+		return true;
+	}
+
+	bool consume_word(const char *word)
+	{
+		size_t length = std::strlen(word);
+		if (size_t(end - data) < length || std::memcmp(data, word, length) != 0)
+			return false;
+		data += length;
+		return true;
+	}
+
+	const char *data;
+	const char *end;
+	std::string scratch;
+};
+
+// Appends the records of a JSON object, returns false if the text is not one.
+inline bool FromJson(const char *text, size_t size, Writer &writer)
+{
+	JsonReader reader(text, size);
+	return reader.read_object(writer);
+}
+
+inline void PutJsonString(std::string &text, const char *value, size_t size)
+{
+	static const char hex[] = "0123456789abcdef";
+	text.push_back('"');
+	const char *start = value;
+	const char *stop = value + size;
+	for (const char *c = value; c < stop; c++) {
+		unsigned char ch = (unsigned char)*c;
+		if (ch >= 0x20 && ch != '"' && ch != '\\')
+			continue;
+		text.append(start, c - start);
+		start = c + 1;
+		switch (ch) {
+		case '"':
+			text.append("\\\"");
+			break;
+		case '\\':
+			text.append("\\\\");
+			break;
+		case '\n':
+			text.append("\\n");
+			break;
+		case '\r':
+			text.append("\\r");
+			break;
+		case '\t':
+			text.append("\\t");
+			break;
+		default:
+			text.append("\\u00");
+			text.push_back(hex[ch >> 4]);
+			text.push_back(hex[ch & 0xF]);
+			break;
+		}
+	}
+	text.append(start, stop - start);
+	text.push_back('"');
+}
+
+// Short decimals, which is what settings mostly hold, are printed without
+// snprintf. k / 10^d is correctly rounded, so if it gives back the value the
+// text parses back to it as well.
+inline void PutJsonDouble(std::string &text, double value)
+{
+	char number[32];
+	if (!std::isfinite(value)) {
+		text.append("null");
+		return;
+	}
+
+	if (std::fabs(value) < 1e9) {
+		double scale = 1;
+		for (int decimals = 0; decimals <= 6; decimals++, scale *= 10) {
+			double scaled = std::round(value * scale);
+			if (scaled / scale != value)
+				continue;
+
+			int64_t digits = (int64_t)std::fabs(scaled);
+			int64_t divisor = (int64_t)scale;
+			if (std::signbit(value))
+				text.push_back('-');
+			text.append(number, std::to_chars(number, number + sizeof(number), digits / divisor).ptr);
+			if (decimals > 0) {
+				char *end = std::to_chars(number, number + sizeof(number), divisor + digits % divisor).ptr;
+				text.push_back('.');
+				text.append(number + 1, end);
+			}
+			return;
+		}
+	}
+	text.append(number, snprintf(number, sizeof(number), "%.17g", value));
+}
+
+// Appends the JSON text of a settings object. Stops at the first malformed
+// record, like the direct conversion.
+inline void ToJson(Reader reader, std::string &text)
+{
+	char number[32];
+	bool first = true;
+	Record record;
+
+	text.push_back('{');
+	while (reader.next(record)) {
+		if (!first)
+			text.push_back(',');
+		first = false;
+		PutJsonString(text, record.key, record.key_size);
+		text.push_back(':');
+
+		switch (record.type) {
+		case Bool:
+			text.append(record.get<uint8_t>() ? "true" : "false");
+			break;
+		case Int:
+			text.append(number, std::to_chars(number, number + sizeof(number), record.get<int64_t>()).ptr);
+			break;
+		case Double:
+			PutJsonDouble(text, record.get<double>());
+			break;
+		case String:
+			PutJsonString(text, record.value, record.value_size);
+			break;
+		case Object:
+			ToJson(Reader(record.value, record.value_size), text);
+			break;
+		case Array: {
+			Reader elements(record.value, record.value_size);
+			text.push_back('[');
+			for (uint32_t i = 0; i < record.count; i++) {
+				Reader element(nullptr, 0);
+				if (!elements.next_element(element))
+					break;
+				if (i > 0)
+					text.push_back(',');
+				ToJson(element, text);
+			}
+			text.push_back(']');
+			break;
+		}
+		}
+	}
+	text.push_back('}');
+}
+} // namespace settings
@@ -0,0 +1,270 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#include "volmeter-levels.hpp"
+#include <cstring>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// A reader gives up after this many torn reads, which only happens if the
+// writer died in the middle of an update.
+static const int levels_read_retries = 64;
+
+std::string volmeter::LevelsBuffer::DefaultName()
+{
+#ifdef WIN32
+	return "Local\\osn-volmeter-levels-" + std::to_string(GetCurrentProcessId());
+#else
+	// macOS limits shared memory names to 31 characters.
+	return "/osn-vol-" + std::to_string(getpid());
+#endif
+}
+
+std::shared_ptr<volmeter::LevelsBuffer> volmeter::LevelsBuffer::Create(const std::string &name, uint32_t capacity)
+{
+	std::shared_ptr<LevelsBuffer> buffer(new LevelsBuffer());
+	buffer->name = name;
+	buffer->owner = true;
+
+	if (!buffer->map(sizeof(LevelsHeader) + sizeof(LevelsSlot) * capacity, true))
+		return nullptr;
+
+	std::memset(buffer->header, 0, buffer->mapped_size);
+	buffer->header->capacity = capacity;
+	buffer->header->slot_size = sizeof(LevelsSlot);
+	buffer->header->version = levels_version;
+	buffer->header->magic = levels_magic;
+	for (uint32_t i = 0; i < capacity; i++)
+		buffer->reset(i, 0);
+
+	return buffer;
+}
+
+std::shared_ptr<volmeter::LevelsBuffer> volmeter::LevelsBuffer::Open(const std::string &name)
+{
+	std::shared_ptr<LevelsBuffer> buffer(new LevelsBuffer());
+	buffer->name = name;
+
+	if (!buffer->map(sizeof(LevelsHeader), false))
+		return nullptr;
+
+	LevelsHeader header = *buffer->header;
+	if (header.magic != levels_magic || header.version != levels_version || header.slot_size != sizeof(LevelsSlot))
+		return nullptr;
+
+	// Remap now that the real size is known.
+	buffer.reset(new LevelsBuffer());
+	buffer->name = name;
+	if (!buffer->map(sizeof(LevelsHeader) + sizeof(LevelsSlot) * header.capacity, false))
+		return nullptr;
+
+	return buffer;
+}
+
+bool volmeter::LevelsBuffer::map(size_t size, bool create)
+{
+	void *view = nullptr;
+
+#ifdef WIN32
+	HANDLE mapping = nullptr;
+	if (create) {
+		mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, (DWORD)size, name.c_str());
+	} else {
+		mapping = OpenFileMappingA(FILE_MAP_READ | FILE_MAP_WRITE, FALSE, name.c_str());
+	}
+	if (!mapping)
+		return false;
+
+	view = MapViewOfFile(mapping, create ? FILE_MAP_ALL_ACCESS : (FILE_MAP_READ | FILE_MAP_WRITE), 0, 0, size);
+	if (!view) {
+		CloseHandle(mapping);
+		return false;
+	}
+	handle = mapping;
+#else
+	if (create) {
+		shm_unlink(name.c_str());
+		fd = shm_open(name.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+	} else {
+		fd = shm_open(name.c_str(), O_RDWR, 0);
+	}
+	if (fd < 0)
+		return false;
+
+	if (create && ftruncate(fd, size) != 0) {
+		close(fd);
+		fd = -1;
+		return false;
+	}
+
+	view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (view == MAP_FAILED) {
+		close(fd);
+		fd = -1;
+		return false;
+	}
+#endif
+
+	mapped_size = size;
+	header = reinterpret_cast<LevelsHeader *>(view);
+	slots = reinterpret_cast<LevelsSlot *>(reinterpret_cast<char *>(view) + sizeof(LevelsHeader));
+	return true;
+}
+
+volmeter::LevelsBuffer::~LevelsBuffer()
+{
+#ifdef WIN32
+	if (header)
+		UnmapViewOfFile(header);
+	if (handle)
+		CloseHandle(reinterpret_cast<HANDLE>(handle));
+#else
+	if (header)
+		munmap(header, mapped_size);
+	if (fd >= 0)
+		close(fd);
+	if (owner)
+		shm_unlink(name.c_str());
+#endif
+}
+
+volmeter::LevelsSlot *volmeter::LevelsBuffer::get_slot(uint32_t slot) const
+{
+	if (!header || slot >= header->capacity)
+		return nullptr;
+	return &slots[slot];
+}
+
+void volmeter::LevelsBuffer::reset(uint32_t slot, uint64_t uid)
+{
+	LevelsSlot *s = get_slot(slot);
+	if (!s)
+		return;
+
+	uint32_t sequence = s->sequence.load(std::memory_order_relaxed);
+	s->sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	s->uid = uid;
+	s->updates = 0;
+	s->channels = 0;
+	s->muted = 1;
+	for (uint32_t ch = 0; ch < levels_max_channels; ch++) {
+		s->magnitude[ch] = -65535.0f;
+		s->peak[ch] = -65535.0f;
+		s->input_peak[ch] = -65535.0f;
+		s->display_magnitude[ch] = -65535.0f;
+		s->display_peak[ch] = -65535.0f;
+		s->peak_hold[ch] = -65535.0f;
+		s->max_peak[ch] = -65535.0f;
+	}
+	s->read_ack.store(0, std::memory_order_relaxed);
+
+	s->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void volmeter::LevelsBuffer::write(uint32_t slot, int32_t channels, bool muted, const float *magnitude, const float *peak, const float *input_peak,
+				   const LevelsBallistics &ballistics)
+{
+	LevelsSlot *s = get_slot(slot);
+	if (!s)
+		return;
+
+	if (channels < 0)
+		channels = 0;
+	if (channels > (int32_t)levels_max_channels)
+		channels = levels_max_channels;
+
+	uint32_t sequence = s->sequence.load(std::memory_order_relaxed);
+	s->sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	s->channels = channels;
+	s->muted = muted ? 1 : 0;
+	std::memcpy(s->magnitude, magnitude, sizeof(float) * channels);
+	std::memcpy(s->peak, peak, sizeof(float) * channels);
+	std::memcpy(s->input_peak, input_peak, sizeof(float) * channels);
+	std::memcpy(s->display_magnitude, ballistics.display_magnitude, sizeof(float) * channels);
+	std::memcpy(s->display_peak, ballistics.display_peak, sizeof(float) * channels);
+	std::memcpy(s->peak_hold, ballistics.peak_hold, sizeof(float) * channels);
+
+	// Start over only once a reader consumed the latest update. If a write
+	// slipped in between its read and its ack, keep accumulating: a peak may
+	// then be reported twice, but never lost.
+	bool restart = s->read_ack.load(std::memory_order_acquire) >= s->updates;
+	for (int32_t ch = 0; ch < channels; ch++) {
+		if (restart || peak[ch] > s->max_peak[ch])
+			s->max_peak[ch] = peak[ch];
+	}
+	s->updates++;
+
+	s->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+bool volmeter::LevelsBuffer::read(uint32_t slot, LevelsSnapshot &snapshot) const
+{
+	LevelsSlot *s = get_slot(slot);
+	if (!s)
+		return false;
+
+	for (int attempt = 0; attempt < levels_read_retries; attempt++) {
+		uint32_t before = s->sequence.load(std::memory_order_acquire);
+		if (before & 1)
+			continue;
+
+		snapshot.uid = s->uid;
+		snapshot.updates = s->updates;
+		snapshot.channels = s->channels;
+		snapshot.muted = s->muted != 0;
+		std::memcpy(snapshot.magnitude, s->magnitude, sizeof(snapshot.magnitude));
+		std::memcpy(snapshot.peak, s->peak, sizeof(snapshot.peak));
+		std::memcpy(snapshot.input_peak, s->input_peak, sizeof(snapshot.input_peak));
+		std::memcpy(snapshot.display_magnitude, s->display_magnitude, sizeof(snapshot.display_magnitude));
+		std::memcpy(snapshot.display_peak, s->display_peak, sizeof(snapshot.display_peak));
+		std::memcpy(snapshot.peak_hold, s->peak_hold, sizeof(snapshot.peak_hold));
+		std::memcpy(snapshot.max_peak, s->max_peak, sizeof(snapshot.max_peak));
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (s->sequence.load(std::memory_order_relaxed) == before) {
+			if (snapshot.channels < 0 || snapshot.channels > (int32_t)levels_max_channels)
+				snapshot.channels = 0;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void volmeter::LevelsBuffer::acknowledge(uint32_t slot, const LevelsSnapshot &snapshot) const
+{
+	LevelsSlot *s = get_slot(slot);
+	if (!s || s->uid != snapshot.uid)
+		return;
+
+	// Several readers may share a slot, never move the ack backwards.
+	uint64_t ack = s->read_ack.load(std::memory_order_relaxed);
+	while (ack < snapshot.updates && !s->read_ack.compare_exchange_weak(ack, snapshot.updates, std::memory_order_release))
+		;
+}
@@ -0,0 +1,131 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#pragma once
+#include <atomic>
+#include <inttypes.h>
+#include <memory>
+#include <string>
+
+// Volmeter levels shared between the server and the client.
+//
+// The server owns a shared memory block made of one slot per volmeter. Each
+// slot has a single writer (the libobs audio thread of its meter) and is
+// protected by a sequence lock, so any number of readers in the client can
+// copy the latest levels without an IPC round-trip.
+//
+// Next to the raw libobs levels every slot carries the meter ballistics
+// computed by the server on each audio callback, and the highest peak since
+// a reader last acknowledged the slot. Readers acknowledge by storing the
+// update count they consumed in read_ack, the only field they ever write.
+namespace volmeter {
+const uint32_t levels_magic = 0x4C4E534F; // 'OSNL'
+const uint32_t levels_version = 2;
+const uint32_t levels_max_channels = 8;
+const uint32_t levels_capacity = 1024;
+const uint32_t levels_invalid_slot = UINT32_MAX;
+
+struct LevelsHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t capacity;
+	uint32_t slot_size;
+};
+
+struct LevelsSlot {
+	// Odd while the writer updates the slot.
+	std::atomic<uint32_t> sequence;
+	int32_t channels;
+	uint64_t uid;
+	// Incremented on every write, lets readers skip unchanged slots.
+	uint64_t updates;
+	int32_t muted;
+	int32_t reserved;
+	float magnitude[levels_max_channels];
+	float peak[levels_max_channels];
+	float input_peak[levels_max_channels];
+	// Ballistics, see LevelsBallistics.
+	float display_magnitude[levels_max_channels];
+	float display_peak[levels_max_channels];
+	float peak_hold[levels_max_channels];
+	// Highest peak written since the update count in read_ack was read.
+	float max_peak[levels_max_channels];
+	// Written by readers only.
+	std::atomic<uint64_t> read_ack;
+};
+
+// Smoothed levels, in dB:
+//	display_magnitude: magnitude integrated over the attack time.
+//	display_peak: follows rising peaks at once and falls at the decay rate.
+//	peak_hold: highest peak, held for the peak hold duration.
+struct LevelsBallistics {
+	float display_magnitude[levels_max_channels];
+	float display_peak[levels_max_channels];
+	float peak_hold[levels_max_channels];
+};
+
+struct LevelsSnapshot {
+	uint64_t uid = 0;
+	uint64_t updates = 0;
+	int32_t channels = 0;
+	bool muted = true;
+	float magnitude[levels_max_channels];
+	float peak[levels_max_channels];
+	float input_peak[levels_max_channels];
+	float display_magnitude[levels_max_channels];
+	float display_peak[levels_max_channels];
+	float peak_hold[levels_max_channels];
+	float max_peak[levels_max_channels];
+};
+
+class LevelsBuffer {
+public:
+	// Server side, creates a writable block.
+	static std::shared_ptr<LevelsBuffer> Create(const std::string &name, uint32_t capacity);
+	// Client side, maps an existing block. Readers only write read_ack.
+	static std::shared_ptr<LevelsBuffer> Open(const std::string &name);
+
+	~LevelsBuffer();
+
+	uint32_t capacity() const { return header ? header->capacity : 0; }
+
+	void reset(uint32_t slot, uint64_t uid);
+	void write(uint32_t slot, int32_t channels, bool muted, const float *magnitude, const float *peak, const float *input_peak,
+		   const LevelsBallistics &ballistics);
+	bool read(uint32_t slot, LevelsSnapshot &snapshot) const;
+	// Marks everything up to the snapshot as consumed, the next write starts
+	// a new max_peak window unless it already moved past the snapshot.
+	void acknowledge(uint32_t slot, const LevelsSnapshot &snapshot) const;
+
+	static std::string DefaultName();
+
+private:
+	LevelsBuffer() {}
+
+	bool map(size_t size, bool create);
+	LevelsSlot *get_slot(uint32_t slot) const;
+
+	std::string name;
+	bool owner = false;
+	size_t mapped_size = 0;
+	void *handle = nullptr;
+	int fd = -1;
+	LevelsHeader *header = nullptr;
+	LevelsSlot *slots = nullptr;
+};
+} // namespace volmeter
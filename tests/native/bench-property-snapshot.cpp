@@ -0,0 +1,139 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+// Serializes a 500 item list property, the shape of a device picker, and a
+// snapshot with many small properties, which must grow its arena in amortized
+// constant time. Both are read back and compared.
+// `--quick` runs a reduced workload for ctest.
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include "native-test.hpp"
+#include "obs-property.hpp"
+
+namespace {
+template<typename F> double measure(F fn)
+{
+	auto start = std::chrono::steady_clock::now();
+	fn();
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+obs::ListProperty make_list(size_t count)
+{
+	obs::ListProperty prop;
+	prop.name = "device_id";
+	prop.description = "Device";
+	prop.enabled = true;
+	prop.visible = true;
+	prop.field_type = obs::ListProperty::ListType::List;
+	prop.format = obs::ListProperty::Format::String;
+	for (size_t i = 0; i < count; i++) {
+		obs::ListProperty::Item item;
+		item.name = "Capture device " + std::to_string(i) + " (USB 3.0)";
+		item.enabled = i % 7 != 0;
+		item.value_int = 0;
+		item.value_float = 0;
+		item.value_string = "\\\\?\\usb#vid_046d&pid_" + std::to_string(0x0800 + i) + "&mi_00#7&2b1a3c4d&0&0000#{65e8773d-8f56}";
+		prop.items.push_back(std::move(item));
+	}
+	prop.current_value_str = prop.items[count / 2].value_string;
+	return prop;
+}
+
+void bench_list(int iterations)
+{
+	obs::ListProperty prop = make_list(500);
+
+	std::vector<char> buf;
+	double serialize_us = measure([&] {
+		for (int i = 0; i < iterations; i++) {
+			buf.clear();
+			prop.serialize(buf);
+		}
+	});
+
+	std::shared_ptr<obs::Property> decoded;
+	double deserialize_us = measure([&] {
+		for (int i = 0; i < iterations; i++)
+			decoded = obs::Property::deserialize(buf);
+	});
+
+	auto list = std::dynamic_pointer_cast<obs::ListProperty>(decoded);
+	check(list && list->items.size() == prop.items.size(), "list survives a round trip");
+	for (size_t i = 0; i < prop.items.size(); i++) {
+		check(list->items[i].name == prop.items[i].name && list->items[i].enabled == prop.items[i].enabled &&
+			      list->items[i].value_string == prop.items[i].value_string,
+		      "list items survive a round trip");
+	}
+	check(list->current_value_str == prop.current_value_str, "current value survives a round trip");
+
+	printf("500 item list property, %zu bytes:\n", buf.size());
+	printf("  serialize %8.2f us  deserialize %8.2f us\n", serialize_us / iterations, deserialize_us / iterations);
+}
+
+void bench_snapshot(size_t count)
+{
+	std::vector<obs::IntegerProperty> props(count);
+	for (size_t i = 0; i < count; i++) {
+		props[i].name = "setting_" + std::to_string(i);
+		props[i].enabled = true;
+		props[i].visible = true;
+		props[i].field_type = obs::NumberProperty::NumberType::Scroller;
+		props[i].minimum = 0;
+		props[i].maximum = 100;
+		props[i].step = 1;
+		props[i].value = int(i % 100);
+	}
+
+	obs::PropertySnapshot snapshot;
+	double add_us = measure([&] {
+		for (auto &prop : props)
+			snapshot.add(prop);
+	});
+
+	size_t offset = 0;
+	for (auto &entry : snapshot.entries) {
+		check(entry.offset == offset, "entries are packed back to back");
+		offset += entry.size;
+	}
+	check(offset == snapshot.arena.size(), "the arena holds exactly the entries");
+
+	std::vector<char> buf;
+	check(snapshot.serialize(buf, {}), "snapshot serializes");
+	obs::PropertySnapshot copy;
+	check(copy.read(std::move(buf)), "snapshot reads back");
+	check(copy.hash == snapshot.hash && copy.entries.size() == count, "snapshot survives a round trip");
+	auto last = std::dynamic_pointer_cast<obs::IntegerProperty>(
+		obs::Property::deserialize(copy.data(copy.entries.back()), copy.entries.back().size));
+	check(last && last->name == props.back().name && last->value == props.back().value, "last entry survives a round trip");
+
+	printf("snapshot of %zu integer properties, %zu bytes:\n", count, snapshot.arena.size());
+	printf("  add %10.2f us total, %6.3f us per property\n", add_us, add_us / count);
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+	const bool quick = argc > 1 && strcmp(argv[1], "--quick") == 0;
+
+	bench_list(quick ? 50 : 2000);
+	bench_snapshot(quick ? 2000 : 10000);
+	return 0;
+}
@@ -0,0 +1,168 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+// Node addon for bench-settings-v8.js. It compares the JSON text path the
+// client used before settings-v8.cpp with the direct and JSON based
+// conversions of settings-v8.cpp, for settings read from and written to JS.
+// It also times Source.Update, sending the full settings against sending
+// only the records that differ from the cached ones.
+// Only the client side is measured, the old path also had libobs print or
+// parse the JSON text on the server.
+
+#include <napi.h>
+#include <nlohmann/json.hpp>
+#include "settings-json.hpp"
+#include "settings-v8.hpp"
+
+static std::vector<char> binary;
+static std::string text;
+
+// prepare(settings): keeps the binary and JSON text of settings, returns the
+// binary size.
+static Napi::Value Prepare(const Napi::CallbackInfo &info)
+{
+	binary.clear();
+	utilv8::SettingsFromObjectDirect(info[0].ToObject(), binary);
+	text.clear();
+	settings::ToJson(settings::Reader(binary), text);
+	return Napi::Number::New(info.Env(), (double)binary.size());
+}
+
+// The client before settings-v8.cpp: JSON.parse of the server's text.
+static Napi::Value ToObjectText(const Napi::CallbackInfo &info)
+{
+	Napi::Object json = info.Env().Global().Get("JSON").As<Napi::Object>();
+	Napi::Function parse = json.Get("parse").As<Napi::Function>();
+	return parse.Call(json, {Napi::String::New(info.Env(), text)});
+}
+
+static Napi::Value ToObjectDirect(const Napi::CallbackInfo &info)
+{
+	return utilv8::SettingsToObjectDirect(info.Env(), binary);
+}
+
+static Napi::Value ToObjectJson(const Napi::CallbackInfo &info)
+{
+	return utilv8::SettingsToObjectJson(info.Env(), binary);
+}
+
+static Napi::Value ToObject(const Napi::CallbackInfo &info)
+{
+	return utilv8::SettingsToObject(info.Env(), binary);
+}
+
+// The client before settings-v8.cpp: JSON.stringify into a std::string.
+static Napi::Value FromObjectText(const Napi::CallbackInfo &info)
+{
+	Napi::Object json = info.Env().Global().Get("JSON").As<Napi::Object>();
+	Napi::Function stringify = json.Get("stringify").As<Napi::Function>();
+	std::string result = stringify.Call(json, {info[0]}).As<Napi::String>().Utf8Value();
+	return Napi::Number::New(info.Env(), (double)result.size());
+}
+
+// Source.Update before settings-v8.cpp: JSON.stringify, then the new and the
+// cached settings both parsed by nlohmann to compare them.
+static Napi::Value UpdateText(const Napi::CallbackInfo &info)
+{
+	Napi::Object json = info.Env().Global().Get("JSON").As<Napi::Object>();
+	Napi::Function stringify = json.Get("stringify").As<Napi::Function>();
+	std::string result = stringify.Call(json, {info[0]}).As<Napi::String>().Utf8Value();
+	auto updated = nlohmann::json::parse(result);
+	auto cached = nlohmann::json::parse(text);
+	return Napi::Number::New(info.Env(), (double)(updated.size() + cached.size()));
+}
+
+static Napi::Value FromObjectDirect(const Napi::CallbackInfo &info)
+{
+	std::vector<char> result;
+	utilv8::SettingsFromObjectDirect(info[0].ToObject(), result);
+	return Napi::Number::New(info.Env(), (double)result.size());
+}
+
+static Napi::Value FromObjectJson(const Napi::CallbackInfo &info)
+{
+	std::vector<char> result;
+	utilv8::SettingsFromObjectJson(info[0].ToObject(), result);
+	return Napi::Number::New(info.Env(), (double)result.size());
+}
+
+static Napi::Value FromObject(const Napi::CallbackInfo &info)
+{
+	std::vector<char> result;
+	utilv8::SettingsFromObject(info[0].ToObject(), result);
+	return Napi::Number::New(info.Env(), (double)result.size());
+}
+
+// UpdateFull in isource.cpp: the whole settings are encoded and sent.
+// Returns the bytes sent.
+static Napi::Value UpdateFull(const Napi::CallbackInfo &info)
+{
+	std::vector<char> buffer;
+	utilv8::SettingsFromObject(info[0].ToObject(), buffer);
+	return Napi::Number::New(info.Env(), (double)buffer.size());
+}
+
+// ISource::Update with cached settings: only the changed records are sent,
+// then merged into the cache. Returns the bytes sent.
+static Napi::Value UpdatePatch(const Napi::CallbackInfo &info)
+{
+	std::vector<char> patch, merged;
+	utilv8::SettingsPatchFromObject(info[0].ToObject(), binary, patch);
+	merged.reserve(binary.size() + patch.size());
+	settings::merge(settings::Reader(binary), settings::Reader(patch), merged);
+	return Napi::Number::New(info.Env(), (double)patch.size());
+}
+
+// The cache after UpdatePatch, as an object.
+static Napi::Value PatchedObject(const Napi::CallbackInfo &info)
+{
+	std::vector<char> patch, merged;
+	utilv8::SettingsPatchFromObject(info[0].ToObject(), binary, patch);
+	settings::merge(settings::Reader(binary), settings::Reader(patch), merged);
+	return utilv8::SettingsToObjectDirect(info.Env(), merged);
+}
+
+// Both encodings of the argument must be identical.
+static Napi::Value Equal(const Napi::CallbackInfo &info)
+{
+	std::vector<char> direct, json;
+	utilv8::SettingsFromObjectDirect(info[0].ToObject(), direct);
+	utilv8::SettingsFromObjectJson(info[0].ToObject(), json);
+	return Napi::Boolean::New(info.Env(), direct == json);
+}
+
+static Napi::Object Init(Napi::Env env, Napi::Object exports)
+{
+	exports.Set("prepare", Napi::Function::New(env, Prepare));
+	exports.Set("toObjectText", Napi::Function::New(env, ToObjectText));
+	exports.Set("toObjectDirect", Napi::Function::New(env, ToObjectDirect));
+	exports.Set("toObjectJson", Napi::Function::New(env, ToObjectJson));
+	exports.Set("toObject", Napi::Function::New(env, ToObject));
+	exports.Set("fromObjectText", Napi::Function::New(env, FromObjectText));
+	exports.Set("updateText", Napi::Function::New(env, UpdateText));
+	exports.Set("fromObjectDirect", Napi::Function::New(env, FromObjectDirect));
+	exports.Set("fromObjectJson", Napi::Function::New(env, FromObjectJson));
+	exports.Set("fromObject", Napi::Function::New(env, FromObject));
+	exports.Set("updateFull", Napi::Function::New(env, UpdateFull));
+	exports.Set("updatePatch", Napi::Function::New(env, UpdatePatch));
+	exports.Set("patchedObject", Napi::Function::New(env, PatchedObject));
+	exports.Set("equal", Napi::Function::New(env, Equal));
+	return exports;
+}
+
+NODE_API_MODULE(bench_settings_v8, Init)
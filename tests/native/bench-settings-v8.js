@@ -0,0 +1,109 @@
+// Compares settings conversions between JS and the binary settings format.
+//
+//   node bench-settings-v8.js <path to bench_settings_v8.node> [--quick]
+//
+// "text" is the JSON path the client used before settings-v8.cpp and
+// "update" what Source.Update did on top of it to compare against the cache.
+// "direct" and "json" are the two conversions of settings-v8.cpp and "picked"
+// is what SettingsToObject and SettingsFromObject choose.
+
+const assert = require('assert');
+
+const addon = { exports: {} };
+process.dlopen(addon, require('path').resolve(process.argv[2]));
+const bench = addon.exports;
+const quick = process.argv.includes('--quick');
+
+// Many small keys, like a media source with its playlist.
+function smallKeys(size) {
+	const settings = { local_file: 'C:/media/intro.mp4', looping: true, speed_percent: 100, volume: 0.75, playlist: [] };
+	for (let i = 0, length = JSON.stringify(settings).length; length < size; i++) {
+		const clip = { name: 'clip ' + i, path: 'C:/media/clip_' + i + '.mp4', duration: i * 1.5, enabled: i % 2 == 0, id: i };
+		settings.playlist.push(clip);
+		length += JSON.stringify(clip).length + 1;
+	}
+	return settings;
+}
+
+// One large string, like the CSS of a browser source.
+function largeString(size) {
+	const css = 'body { background-color: rgba(0, 0, 0, 0); margin: 0px auto; overflow: hidden; }\n';
+	return { url: 'https://example.com/overlay', width: 1920, height: 1080, fps_custom: false, reroute_audio: true, css: css.repeat(Math.ceil(size / css.length)).slice(0, size) };
+}
+
+function time(fn, iterations) {
+	for (let i = 0; i < (quick ? 1 : 5); i++) fn();
+	const start = process.hrtime.bigint();
+	for (let i = 0; i < iterations; i++) fn();
+	return Number(process.hrtime.bigint() - start) / iterations / 1000;
+}
+
+function format(us) {
+	return us >= 1000 ? (us / 1000).toFixed(2) + ' ms' : us.toFixed(1) + ' us';
+}
+
+// Both conversions must produce the same objects and the same binary.
+const edgeCases = {
+	text: 'quote " backslash \\ newline \n tab \t control \u0001 unicode \u00e9\u4e2d\ud83d\ude00 lone \ud800 end',
+	integer: 42, negative: -7, zero: -0, large: 9007199254740993, fraction: 0.1, exponent: 1e300, tiny: 5e-324,
+	flag: false, nothing: null, missing: undefined,
+	nested: { deeper: { value: 'x' }, empty: {} },
+	list: [{ a: 1 }, 2, 'three', null, [{ b: 4 }], { c: [{ d: 5 }] }],
+	empty_list: [],
+	'key "with" \\ escapes \u00e9': 1,
+	12: 'integer key',
+};
+assert(bench.equal(edgeCases), 'direct and JSON encodings of the edge cases differ');
+bench.prepare(edgeCases);
+assert.deepStrictEqual(bench.toObjectJson(), bench.toObjectDirect());
+assert.strictEqual(JSON.stringify(bench.toObjectText()), JSON.stringify(bench.toObjectDirect()));
+
+const cases = [
+	['many small keys', '10 KB', smallKeys(10 * 1024), quick ? 20 : 5000],
+	['many small keys', '1 MB', smallKeys(1024 * 1024), quick ? 1 : 100],
+	['one large string', '10 KB', largeString(10 * 1024), quick ? 20 : 5000],
+	['one large string', '1 MB', largeString(1024 * 1024), quick ? 1 : 100],
+];
+
+for (const [shape, size, settings, iterations] of cases) {
+	assert(bench.equal(settings), shape + ' ' + size + ': direct and JSON encodings differ');
+	const bytes = bench.prepare(settings);
+	assert.deepStrictEqual(bench.toObjectJson(), bench.toObjectDirect());
+
+	const to = [bench.toObjectText, bench.toObjectDirect, bench.toObjectJson, bench.toObject].map((fn) => format(time(fn, iterations)));
+	const from = [bench.fromObjectText, bench.updateText, bench.fromObjectDirect, bench.fromObjectJson, bench.fromObject].map((fn) => format(time(() => fn(settings), iterations)));
+	console.log(`${shape}, ${size} (${bytes} bytes binary):`);
+	console.log(`  to JS:   text ${to[0]}, direct ${to[1]}, json ${to[2]}, picked ${to[3]}`);
+	console.log(`  from JS: text ${from[0]}, update ${from[1]}, direct ${from[2]}, json ${from[3]}, picked ${from[4]}`);
+}
+
+// Source.Update latency against settings size, with one key changed. "update"
+// is the old JSON text path, "full" sends every record and "patch" only the
+// changed ones, merged into the cached settings.
+const updates = [
+	['many small keys, volume changed', smallKeys, (settings) => ({ ...settings, volume: settings.volume / 2 })],
+	['one large string, width changed', largeString, (settings) => ({ ...settings, width: 1280 })],
+	['one large string, css edited', largeString, (settings) => ({ ...settings, css: settings.css + ' ' })],
+];
+const sizes = [
+	['1 KB', 1024, quick ? 20 : 5000],
+	['10 KB', 10 * 1024, quick ? 20 : 5000],
+	['100 KB', 100 * 1024, quick ? 5 : 500],
+	['1 MB', 1024 * 1024, quick ? 1 : 100],
+];
+
+for (const [change, shape, edit] of updates) {
+	console.log(`${change}:`);
+	for (const [size, length, iterations] of sizes) {
+		const settings = shape(length);
+		const updated = edit(settings);
+		bench.prepare(updated);
+		const expected = bench.toObjectDirect();
+		bench.prepare(settings);
+		assert.deepStrictEqual(bench.patchedObject(updated), expected);
+
+		const sent = [bench.updateFull(updated), bench.updatePatch(updated)];
+		const [text, full, patch] = [bench.updateText, bench.updateFull, bench.updatePatch].map((fn) => format(time(() => fn(updated), iterations)));
+		console.log(`  ${size}: update ${text}, full ${full} (${sent[0]} bytes), patch ${patch} (${sent[1]} bytes)`);
+	}
+}
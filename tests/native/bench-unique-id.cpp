@@ -0,0 +1,305 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+// Compares utility::unique_id and unique_object_manager with the range list
+// allocator and the map scanning manager they replaced, under id churn.
+// `--quick` runs a reduced workload for ctest.
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <list>
+#include <random>
+#include <set>
+#include "native-test.hpp"
+#include "utility.hpp"
+
+namespace {
+// utility::unique_id before the bitmap, a sorted list of allocated ranges.
+class legacy_unique_id {
+public:
+	typedef uint64_t id_t;
+	typedef std::pair<id_t, id_t> range_t;
+
+	id_t allocate()
+	{
+		if (allocated.size() == 0) {
+			mark_used(0);
+			return 0;
+		}
+		for (auto &v : allocated) {
+			if (v.first > 0) {
+				id_t v2 = v.first - 1;
+				mark_used(v2);
+				return v2;
+			} else if (v.second < std::numeric_limits<id_t>::max()) {
+				id_t v2 = v.second + 1;
+				mark_used(v2);
+				return v2;
+			}
+		}
+		return std::numeric_limits<id_t>::max();
+	}
+
+	void free(id_t v) { mark_free(v); }
+
+	bool is_allocated(id_t v)
+	{
+		for (auto &v2 : allocated) {
+			if ((v >= v2.first) && (v <= v2.second))
+				return true;
+		}
+		return false;
+	}
+
+private:
+	bool mark_used(id_t v)
+	{
+		if (allocated.size() == 0) {
+			allocated.push_back({v, v});
+			return true;
+		}
+
+		bool lastWasSmaller = false;
+		for (auto iter = allocated.begin(); iter != allocated.end(); iter++) {
+			auto fiter = std::list<range_t>::iterator(iter);
+			auto riter = std::list<range_t>::reverse_iterator(iter);
+			if ((iter->first > 0) && (v == (iter->first - 1))) {
+				iter->first--;
+				riter--;
+				if ((riter != allocated.rend()) && (riter->second == (v - 1))) {
+					riter->second = iter->second;
+					allocated.erase(iter);
+				}
+				return true;
+			} else if ((iter->second < std::numeric_limits<id_t>::max()) && (v == (iter->second + 1))) {
+				iter->second++;
+				fiter++;
+				if ((fiter != allocated.end()) && (fiter->first == (v + 1))) {
+					iter->second = fiter->second;
+					allocated.erase(fiter);
+				}
+				return true;
+			} else if (lastWasSmaller && (v < iter->first)) {
+				allocated.insert(iter, {v, v});
+				return true;
+			} else if ((fiter++) == allocated.end()) {
+				allocated.insert(fiter, {v, v});
+				return true;
+			}
+			lastWasSmaller = (v > iter->second);
+		}
+		return false;
+	}
+
+	bool mark_free(id_t v)
+	{
+		for (auto iter = allocated.begin(); iter != allocated.end(); iter++) {
+			if ((v >= iter->first) && (v <= iter->second)) {
+				if (v == iter->first) {
+					iter->first++;
+					if (iter->first > iter->second)
+						allocated.erase(iter);
+				} else if (v == iter->second) {
+					iter->second--;
+					if (iter->second < iter->first)
+						allocated.erase(iter);
+				} else {
+					allocated.insert(iter, {iter->first, v - 1});
+					iter->first = v + 1;
+				}
+				return true;
+			}
+		}
+		return false;
+	}
+
+	std::list<range_t> allocated;
+};
+
+// unique_object_manager before the reverse index, find(T *) and free(T *)
+// scan the whole map.
+template<typename T> class legacy_object_manager {
+	legacy_unique_id id_generator;
+	std::map<uint64_t, T *> object_map;
+	std::recursive_mutex internal_mutex;
+
+public:
+	uint64_t allocate(T *obj)
+	{
+		std::lock_guard<std::recursive_mutex> lock(internal_mutex);
+		uint64_t uid = id_generator.allocate();
+		object_map.insert_or_assign(uid, obj);
+		return uid;
+	}
+
+	uint64_t find(T *obj)
+	{
+		std::lock_guard<std::recursive_mutex> lock(internal_mutex);
+		for (auto kv : object_map) {
+			if (kv.second == obj)
+				return kv.first;
+		}
+		return std::numeric_limits<uint64_t>::max();
+	}
+
+	uint64_t free(T *obj)
+	{
+		std::lock_guard<std::recursive_mutex> lock(internal_mutex);
+		for (auto kv : object_map) {
+			if (kv.second == obj) {
+				object_map.erase(kv.first);
+				return kv.first;
+			}
+		}
+		return std::numeric_limits<uint64_t>::max();
+	}
+};
+
+template<typename F> double measure(F fn)
+{
+	auto start = std::chrono::steady_clock::now();
+	fn();
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Every other id of the first `count` is freed, then single ids are looked
+// up and recycled, which is the worst case for the range list.
+template<typename A> double fragmented(int count, int ops)
+{
+	A ids;
+	for (int i = 0; i < count; i++)
+		ids.allocate();
+	for (int i = 0; i < count; i += 2)
+		ids.free(i);
+
+	std::mt19937 rng(3);
+	return measure([&] {
+		for (int i = 0; i < ops; i++) {
+			check(ids.is_allocated(1 + 2 * (rng() % (count / 2))), "odd ids stay allocated");
+			uint64_t id = ids.allocate();
+			ids.free(id);
+		}
+	});
+}
+
+// `live` ids stay allocated, each op frees a random one and allocates again.
+template<typename A> double churn(int live, int ops)
+{
+	A ids;
+	std::vector<uint64_t> current;
+	for (int i = 0; i < live; i++)
+		current.push_back(ids.allocate());
+
+	std::mt19937 rng(1);
+	return measure([&] {
+		for (int i = 0; i < ops; i++) {
+			size_t k = rng() % current.size();
+			ids.free(current[k]);
+			current[k] = ids.allocate();
+			check(ids.is_allocated(current[k]), "allocated id is marked used");
+		}
+	});
+}
+
+// Manager side of a source being replaced: look the object up, free it and
+// register a new one.
+template<typename M> double manager_churn(int live, int ops)
+{
+	M manager;
+	std::vector<int> objects(live * 2);
+	std::vector<int *> current;
+	for (int i = 0; i < live; i++) {
+		current.push_back(&objects[i]);
+		manager.allocate(&objects[i]);
+	}
+
+	std::mt19937 rng(1);
+	size_t next = live;
+	return measure([&] {
+		for (int i = 0; i < ops; i++) {
+			size_t k = rng() % current.size();
+			check(manager.find(current[k]) != std::numeric_limits<uint64_t>::max(), "live object has an id");
+			manager.free(current[k]);
+			current[k] = &objects[next++ % objects.size()];
+			manager.allocate(current[k]);
+		}
+	});
+}
+
+// allocate() must keep returning the lowest free id, as the range list did.
+void check_lowest_free(int ops)
+{
+	utility::unique_id ids;
+	std::set<uint64_t> used;
+	std::mt19937 rng(7);
+
+	for (int i = 0; i < ops; i++) {
+		if (used.empty() || (rng() % 3 && used.size() < 2000)) {
+			uint64_t expected = 0;
+			while (used.count(expected))
+				expected++;
+			uint64_t id = ids.allocate();
+			check(id == expected, "allocate returns the lowest free id");
+			used.insert(id);
+		} else {
+			auto iter = used.begin();
+			std::advance(iter, rng() % used.size());
+			ids.free(*iter);
+			check(!ids.is_allocated(*iter), "freed id is no longer allocated");
+			used.erase(iter);
+		}
+		check(ids.count(false) == used.size(), "count matches the allocated ids");
+	}
+
+	// A dense fill crosses several full words at every level.
+	utility::unique_id dense;
+	for (uint64_t i = 0; i < 600000; i++)
+		check(dense.allocate() == i, "dense fill is sequential");
+	dense.free(300001);
+	check(dense.allocate() == 300001, "a hole in a full group is refilled");
+	check(dense.allocate() == 600000, "allocation resumes after the fill");
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+	const bool quick = argc > 1 && strcmp(argv[1], "--quick") == 0;
+	const int ops = quick ? 2000 : 20000;
+
+	check_lowest_free(quick ? 20000 : 300000);
+
+	printf("fragmented 10000 ids, is_allocated + allocate/free, %d ops:\n", ops);
+	printf("  list %9.2f ms  bitmap %7.2f ms\n", fragmented<legacy_unique_id>(10000, ops), fragmented<utility::unique_id>(10000, ops));
+
+	printf("free + allocate under churn, %d ops:\n", ops);
+	for (int live : {100, 1000, 10000}) {
+		if (quick && live > 1000)
+			break;
+		printf("  %5d live: list %9.2f ms  bitmap %7.2f ms\n", live, churn<legacy_unique_id>(live, ops), churn<utility::unique_id>(live, ops));
+	}
+
+	printf("manager find + free + allocate under churn, %d ops:\n", ops);
+	for (int live : {100, 1000, 10000}) {
+		if (quick && live > 1000)
+			break;
+		printf("  %5d live: scan %9.2f ms  indexed %7.2f ms\n", live, manager_churn<legacy_object_manager<int>>(live, ops),
+		       manager_churn<utility::unique_object_manager<int>>(live, ops));
+	}
+	return 0;
+}
@@ -0,0 +1,164 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+// Latency of the volmeter callback on the audio thread while IPC handlers hold
+// the global volmeter mtx. The old callback took mtx, looked its id up in the
+// meter manager, locked the meter data and looked up the attached source
+// through the source manager. The current one gets the meter as parameter
+// and only loads the source pointer. Both write the real LevelsBuffer.
+// `--quick` runs a reduced workload for ctest.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "native-test.hpp"
+#include "volmeter-levels.hpp"
+
+namespace {
+const uint32_t meter_count = 64;
+const int handler_threads = 4;
+
+// The global volmeter mtx and the locks of the generic object managers
+std::mutex mtx;
+std::recursive_mutex meters_mtx, sources_mtx;
+
+struct Meter {
+	uint64_t id;
+	uint32_t slot;
+	std::mutex data_mtx;
+	float magnitude[volmeter::levels_max_channels];
+	std::atomic<void *> source{nullptr};
+	std::atomic<int64_t> last_update_ms{0};
+	std::atomic<bool> pending_update{false};
+};
+
+std::map<uint64_t, Meter *> meters;
+std::map<uint64_t, void *> sources;
+std::shared_ptr<volmeter::LevelsBuffer> levels;
+const volmeter::LevelsBallistics ballistics = {};
+
+void legacy_callback(Meter *param, const float *magnitude)
+{
+	std::unique_lock<std::mutex> ulock(mtx);
+	Meter *meter;
+	{
+		std::lock_guard<std::recursive_mutex> lock(meters_mtx);
+		meter = meters[param->id];
+	}
+
+	std::lock_guard<std::mutex> lock(meter->data_mtx);
+	memcpy(meter->magnitude, magnitude, sizeof(meter->magnitude));
+	void *source;
+	{
+		std::lock_guard<std::recursive_mutex> lock(sources_mtx);
+		source = sources[meter->id];
+	}
+	levels->write(meter->slot, 2, source == nullptr, meter->magnitude, meter->magnitude, meter->magnitude, ballistics);
+}
+
+void callback(Meter *meter, const float *magnitude)
+{
+	void *source = meter->source.load(std::memory_order_acquire);
+	levels->write(meter->slot, 2, source == nullptr, magnitude, magnitude, magnitude, ballistics);
+	meter->last_update_ms.store(1, std::memory_order_relaxed);
+	meter->pending_update.store(true, std::memory_order_release);
+}
+
+// A Query or Attach handler, a few microseconds of work under mtx
+void handler(uint64_t id)
+{
+	std::unique_lock<std::mutex> ulock(mtx);
+	std::lock_guard<std::recursive_mutex> lock(meters_mtx);
+	std::lock_guard<std::mutex> data_lock(meters[id]->data_mtx);
+	volatile double work = 0;
+	for (int i = 0; i < 2000; i++)
+		work = work + i * 0.5;
+}
+
+// Every meter called back once per tick, back to back instead of every 10 ms
+template<typename Callback> void run(const char *name, Callback cb, int ticks)
+{
+	std::vector<Meter> storage(meter_count);
+	for (uint32_t i = 0; i < meter_count; i++) {
+		Meter &meter = storage[i];
+		meter.id = i;
+		meter.slot = i;
+		meters[i] = &meter;
+		sources[i] = &meter;
+		meter.source = &meter;
+		levels->reset(i, i);
+	}
+
+	std::atomic<bool> stop{false};
+	std::vector<std::thread> threads;
+	for (int t = 0; t < handler_threads; t++) {
+		threads.emplace_back([&stop, t] {
+			for (uint32_t seed = t; !stop;) {
+				seed = seed * 1103515245 + 12345;
+				handler(seed % meter_count);
+			}
+		});
+	}
+
+	const float magnitude[volmeter::levels_max_channels] = {-10, -10, -10, -10, -10, -10, -10, -10};
+	std::vector<double> latency;
+	latency.reserve(size_t(ticks) * meter_count);
+	const auto start = std::chrono::steady_clock::now();
+	for (int tick = 0; tick < ticks; tick++) {
+		for (Meter &meter : storage) {
+			const auto begin = std::chrono::steady_clock::now();
+			cb(&meter, magnitude);
+			latency.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count());
+		}
+	}
+	const double total = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	stop = true;
+	for (auto &thread : threads)
+		thread.join();
+	meters.clear();
+	sources.clear();
+
+	std::sort(latency.begin(), latency.end());
+	const size_t stalls = std::count_if(latency.begin(), latency.end(), [](double us) { return us > 50; });
+	printf("  %-7s %8.1f ms  p50 %5.2f us  p99 %5.2f us  p99.9 %5.2f us  max %7.0f us  %zu over 50 us\n", name, total, latency[latency.size() / 2],
+	       latency[latency.size() * 99 / 100], latency[latency.size() * 999 / 1000], latency.back(), stalls);
+}
+}
+
+int main(int argc, char *argv[])
+{
+	const bool quick = argc > 1 && strcmp(argv[1], "--quick") == 0;
+	const int ticks = quick ? 500 : 20000;
+
+	levels = volmeter::LevelsBuffer::Create("/osn-bench-volmeter-" + std::to_string(getpid()), meter_count);
+	check(levels != nullptr, "the levels buffer is created");
+
+	printf("%u meters, %d ticks, %d handler threads under mtx:\n", meter_count, ticks, handler_threads);
+	run("locked", legacy_callback, ticks);
+	run("current", callback, ticks);
+	return 0;
+}
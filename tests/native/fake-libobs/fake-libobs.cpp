@@ -0,0 +1,706 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+// Stand-in for libobs in the native tests. obs_data is an in-memory tree that
+// is never freed and is saved to files in a line based format, not json.
+// Property lists are empty and blog writes to stdout.
+
+#include "obs.h"
+#include "obs-module.h"
+#include "fake-libobs.h"
+#include "util/platform.h"
+#include "media-io/video-frame.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct obs_data {
+	std::map<std::string, long long> ints;
+	std::map<std::string, std::string> strings;
+	std::map<std::string, obs_data_array *> arrays;
+};
+
+struct obs_data_array {
+	std::vector<obs_data *> items;
+};
+
+struct obs_module {
+	const fake_libobs::module *info;
+};
+
+struct calldata_values {
+	std::map<std::string, long long> ints;
+};
+
+struct signal_handler {
+	struct connection {
+		std::string signal;
+		signal_callback_t callback;
+		void *data;
+	};
+	std::mutex mtx;
+	std::vector<connection> connections;
+};
+
+struct proc_handler {
+	std::mutex mtx;
+	std::map<std::string, std::function<void(calldata_t *)>> procs;
+};
+
+struct obs_source {
+	std::string id;
+	std::string name;
+	obs_data *settings = new obs_data;
+	std::atomic<bool> showing{false};
+	mutable std::atomic<size_t> showing_queries{0};
+	signal_handler signals;
+	proc_handler procs;
+};
+
+namespace {
+std::vector<fake_libobs::module> modules;
+size_t opened = 0;
+std::atomic<size_t> logged = 0;
+// Guards the values of every obs_data, sources are updated from other threads
+std::mutex data_mtx;
+// Registered types, by type list
+std::vector<std::string> inputs, filters, transitions, encoders, outputs, services;
+
+bool enum_types(const std::vector<std::string> &types, size_t idx, const char **id)
+{
+	if (idx >= types.size())
+		return false;
+	*id = types[idx].c_str();
+	return true;
+}
+
+void append(std::vector<std::string> &to, const std::vector<std::string> &types)
+{
+	to.insert(to.end(), types.begin(), types.end());
+}
+
+// One record per line: "i key", "s key" or "a key count" followed by the value
+// line or the count elements, each element between "{" and "}".
+void write_data(std::ostream &out, const obs_data *data)
+{
+	out << "{\n";
+	for (auto &entry : data->ints)
+		out << "i " << entry.first << "\n" << entry.second << "\n";
+	for (auto &entry : data->strings)
+		out << "s " << entry.first << "\n" << entry.second << "\n";
+	for (auto &entry : data->arrays) {
+		out << "a " << entry.first << "\n" << entry.second->items.size() << "\n";
+		for (const obs_data *item : entry.second->items)
+			write_data(out, item);
+	}
+	out << "}\n";
+}
+
+obs_data *read_data(std::istream &in)
+{
+	std::string line;
+	if (!std::getline(in, line) || line != "{")
+		return nullptr;
+
+	obs_data *data = new obs_data;
+	while (std::getline(in, line) && line != "}") {
+		std::string key = line.size() > 2 ? line.substr(2) : std::string();
+		std::string value;
+		if (!std::getline(in, value))
+			return nullptr;
+		if (line[0] == 'i') {
+			data->ints[key] = std::stoll(value);
+		} else if (line[0] == 's') {
+			data->strings[key] = value;
+		} else if (line[0] == 'a') {
+			obs_data_array *array = new obs_data_array;
+			for (size_t count = std::stoul(value); count > 0; count--) {
+				obs_data *item = read_data(in);
+				if (!item)
+					return nullptr;
+				array->items.push_back(item);
+			}
+			data->arrays[key] = array;
+		}
+	}
+	return data;
+}
+}
+
+void fake_libobs::add_module(const module &info)
+{
+	modules.push_back(info);
+}
+
+size_t fake_libobs::opened_modules()
+{
+	return opened;
+}
+
+size_t fake_libobs::logged_messages()
+{
+	return logged;
+}
+
+obs_source_t *fake_libobs::create_source(const std::string &id, const std::string &name)
+{
+	obs_source_t *source = new obs_source;
+	source->id = id;
+	source->name = name;
+	return source;
+}
+
+void fake_libobs::set_showing(obs_source_t *source, bool showing)
+{
+	source->showing = showing;
+}
+
+size_t fake_libobs::showing_queries(obs_source_t *source)
+{
+	return source->showing_queries;
+}
+
+void fake_libobs::set_proc(obs_source_t *source, const std::string &name, std::function<void(calldata_t *)> proc)
+{
+	std::lock_guard<std::mutex> lock(source->procs.mtx);
+	source->procs.procs[name] = std::move(proc);
+}
+
+void fake_libobs::emit_signal(obs_source_t *source, const std::string &signal)
+{
+	calldata_t cd = {0};
+	std::lock_guard<std::mutex> lock(source->signals.mtx);
+	for (auto &connection : source->signals.connections) {
+		if (connection.signal == signal)
+			connection.callback(connection.data, &cd);
+	}
+	calldata_free(&cd);
+}
+
+void blog(int log_level, const char *format, ...)
+{
+	static std::mutex mtx;
+	std::lock_guard<std::mutex> lock(mtx);
+	logged++;
+
+	va_list args;
+	va_start(args, format);
+	vprintf(format, args);
+	va_end(args);
+	printf("\n");
+}
+
+int os_stat(const char *file, struct stat *st)
+{
+	return stat(file, st);
+}
+
+const char *get_video_format_name(enum video_format format)
+{
+	return "video format";
+}
+
+void video_frame_init(struct video_frame *frame, enum video_format format, uint32_t width, uint32_t height)
+{
+	*frame = {};
+	if (format == VIDEO_FORMAT_RGBA || format == VIDEO_FORMAT_BGRA || format == VIDEO_FORMAT_BGRX) {
+		frame->linesize[0] = width * 4;
+		frame->data[0] = new uint8_t[uint64_t(frame->linesize[0]) * height];
+	}
+}
+
+void video_frame_free(struct video_frame *frame)
+{
+	delete[] frame->data[0];
+	*frame = {};
+}
+
+/* Calls and signals */
+void calldata_free(calldata_t *data)
+{
+	delete data->values;
+	data->values = nullptr;
+}
+
+void calldata_set_int(calldata_t *data, const char *name, long long val)
+{
+	if (!data->values)
+		data->values = new calldata_values;
+	data->values->ints[name] = val;
+}
+
+void calldata_set_bool(calldata_t *data, const char *name, bool val)
+{
+	calldata_set_int(data, name, val);
+}
+
+long long calldata_int(const calldata_t *data, const char *name)
+{
+	if (!data->values)
+		return 0;
+	auto iter = data->values->ints.find(name);
+	return iter != data->values->ints.end() ? iter->second : 0;
+}
+
+bool calldata_bool(const calldata_t *data, const char *name)
+{
+	return calldata_int(data, name) != 0;
+}
+
+bool proc_handler_call(proc_handler_t *handler, const char *name, calldata_t *params)
+{
+	std::function<void(calldata_t *)> proc;
+	{
+		std::lock_guard<std::mutex> lock(handler->mtx);
+		auto iter = handler->procs.find(name);
+		if (iter == handler->procs.end())
+			return false;
+		proc = iter->second;
+	}
+	proc(params);
+	return true;
+}
+
+void signal_handler_connect(signal_handler_t *handler, const char *signal, signal_callback_t callback, void *data)
+{
+	std::lock_guard<std::mutex> lock(handler->mtx);
+	handler->connections.push_back({signal, callback, data});
+}
+
+void signal_handler_disconnect(signal_handler_t *handler, const char *signal, signal_callback_t callback, void *data)
+{
+	std::lock_guard<std::mutex> lock(handler->mtx);
+	auto &connections = handler->connections;
+	connections.erase(std::remove_if(connections.begin(), connections.end(),
+					 [&](const auto &connection) {
+						 return connection.signal == signal && connection.callback == callback && connection.data == data;
+					 }),
+			  connections.end());
+}
+
+/* Sources */
+const char *obs_source_get_name(const obs_source_t *source)
+{
+	return source->name.c_str();
+}
+
+const char *obs_source_get_id(const obs_source_t *source)
+{
+	return source->id.c_str();
+}
+
+obs_data_t *obs_source_get_settings(const obs_source_t *source)
+{
+	return source->settings;
+}
+
+void obs_source_update(obs_source_t *source, obs_data_t *settings) {}
+
+bool obs_source_showing(const obs_source_t *source)
+{
+	source->showing_queries++;
+	return source->showing;
+}
+
+signal_handler_t *obs_source_get_signal_handler(const obs_source_t *source)
+{
+	return const_cast<signal_handler_t *>(&source->signals);
+}
+
+proc_handler_t *obs_source_get_proc_handler(const obs_source_t *source)
+{
+	return const_cast<proc_handler_t *>(&source->procs);
+}
+
+/* Modules */
+void obs_find_modules2(obs_find_module_callback2_t callback, void *param)
+{
+	for (auto &module : modules) {
+		obs_module_info2 info = {module.path.c_str(), "data", module.name.c_str()};
+		callback(param, &info);
+	}
+}
+
+int obs_open_module(obs_module_t **module, const char *path, const char *data_path)
+{
+	for (auto &info : modules) {
+		if (info.path != path)
+			continue;
+		if (info.missing_exports)
+			return MODULE_MISSING_EXPORTS;
+		*module = new obs_module{&info};
+		opened++;
+		return MODULE_SUCCESS;
+	}
+	return MODULE_FILE_NOT_FOUND;
+}
+
+bool obs_init_module(obs_module_t *module)
+{
+	append(inputs, module->info->inputs);
+	append(filters, module->info->filters);
+	append(transitions, module->info->transitions);
+	append(encoders, module->info->encoders);
+	append(outputs, module->info->outputs);
+	append(services, module->info->services);
+	return true;
+}
+
+/* Type enumeration */
+bool obs_enum_input_types(size_t idx, const char **id)
+{
+	return enum_types(inputs, idx, id);
+}
+
+bool obs_enum_filter_types(size_t idx, const char **id)
+{
+	return enum_types(filters, idx, id);
+}
+
+bool obs_enum_transition_types(size_t idx, const char **id)
+{
+	return enum_types(transitions, idx, id);
+}
+
+bool obs_enum_encoder_types(size_t idx, const char **id)
+{
+	return enum_types(encoders, idx, id);
+}
+
+bool obs_enum_output_types(size_t idx, const char **id)
+{
+	return enum_types(outputs, idx, id);
+}
+
+bool obs_enum_service_types(size_t idx, const char **id)
+{
+	return enum_types(services, idx, id);
+}
+
+/* Settings */
+obs_data_t *obs_data_create()
+{
+	return new obs_data;
+}
+
+obs_data_t *obs_data_create_from_json_file_safe(const char *json_file, const char *backup_ext)
+{
+	std::ifstream in(json_file);
+	return in ? read_data(in) : nullptr;
+}
+
+bool obs_data_save_json_safe(obs_data_t *data, const char *file, const char *temp_ext, const char *backup_ext)
+{
+	std::ofstream out(file, std::ios::trunc);
+	write_data(out, data);
+	return bool(out);
+}
+
+void obs_data_release(obs_data_t *data) {}
+
+void obs_data_set_bool(obs_data_t *data, const char *name, bool val)
+{
+	obs_data_set_int(data, name, val);
+}
+
+void obs_data_set_int(obs_data_t *data, const char *name, long long val)
+{
+	std::lock_guard<std::mutex> lock(data_mtx);
+	data->ints[name] = val;
+}
+
+void obs_data_set_string(obs_data_t *data, const char *name, const char *val)
+{
+	std::lock_guard<std::mutex> lock(data_mtx);
+	data->strings[name] = val;
+}
+
+void obs_data_set_array(obs_data_t *data, const char *name, obs_data_array_t *array)
+{
+	std::lock_guard<std::mutex> lock(data_mtx);
+	data->arrays[name] = array;
+}
+
+long long obs_data_get_int(obs_data_t *data, const char *name)
+{
+	if (!data)
+		return 0;
+	std::lock_guard<std::mutex> lock(data_mtx);
+	auto iter = data->ints.find(name);
+	return iter != data->ints.end() ? iter->second : 0;
+}
+
+bool obs_data_get_bool(obs_data_t *data, const char *name)
+{
+	return obs_data_get_int(data, name) != 0;
+}
+
+double obs_data_get_double(obs_data_t *data, const char *name)
+{
+	return (double)obs_data_get_int(data, name);
+}
+
+const char *obs_data_get_string(obs_data_t *data, const char *name)
+{
+	if (!data)
+		return "";
+	std::lock_guard<std::mutex> lock(data_mtx);
+	auto iter = data->strings.find(name);
+	return iter != data->strings.end() ? iter->second.c_str() : "";
+}
+
+obs_data_t *obs_data_get_obj(obs_data_t *data, const char *name)
+{
+	return nullptr;
+}
+
+obs_data_array_t *obs_data_get_array(obs_data_t *data, const char *name)
+{
+	if (!data)
+		return nullptr;
+	std::lock_guard<std::mutex> lock(data_mtx);
+	auto iter = data->arrays.find(name);
+	return iter != data->arrays.end() ? iter->second : nullptr;
+}
+
+bool obs_data_get_frames_per_second(obs_data_t *data, const char *name, struct media_frames_per_second *fps, const char **option)
+{
+	return false;
+}
+
+obs_data_array_t *obs_data_array_create()
+{
+	return new obs_data_array;
+}
+
+void obs_data_array_release(obs_data_array_t *array) {}
+
+size_t obs_data_array_count(obs_data_array_t *array)
+{
+	return array ? array->items.size() : 0;
+}
+
+obs_data_t *obs_data_array_item(obs_data_array_t *array, size_t idx)
+{
+	return idx < obs_data_array_count(array) ? array->items[idx] : nullptr;
+}
+
+size_t obs_data_array_push_back(obs_data_array_t *array, obs_data_t *obj)
+{
+	array->items.push_back(obj);
+	return array->items.size() - 1;
+}
+
+/* Properties */
+obs_property_t *obs_properties_first(obs_properties_t *props)
+{
+	return nullptr;
+}
+
+bool obs_property_next(obs_property_t **p)
+{
+	*p = nullptr;
+	return false;
+}
+
+obs_properties_t *obs_property_group_content(obs_property_t *p)
+{
+	return nullptr;
+}
+
+const char *obs_property_name(obs_property_t *p)
+{
+	return "";
+}
+
+const char *obs_property_description(obs_property_t *p)
+{
+	return nullptr;
+}
+
+const char *obs_property_long_description(obs_property_t *p)
+{
+	return nullptr;
+}
+
+enum obs_property_type obs_property_get_type(obs_property_t *p)
+{
+	return OBS_PROPERTY_INVALID;
+}
+
+bool obs_property_enabled(obs_property_t *p)
+{
+	return true;
+}
+
+bool obs_property_visible(obs_property_t *p)
+{
+	return true;
+}
+
+enum obs_number_type obs_property_int_type(obs_property_t *p)
+{
+	return OBS_NUMBER_SCROLLER;
+}
+
+int obs_property_int_min(obs_property_t *p)
+{
+	return 0;
+}
+
+int obs_property_int_max(obs_property_t *p)
+{
+	return 0;
+}
+
+int obs_property_int_step(obs_property_t *p)
+{
+	return 0;
+}
+
+enum obs_number_type obs_property_float_type(obs_property_t *p)
+{
+	return OBS_NUMBER_SCROLLER;
+}
+
+double obs_property_float_min(obs_property_t *p)
+{
+	return 0;
+}
+
+double obs_property_float_max(obs_property_t *p)
+{
+	return 0;
+}
+
+double obs_property_float_step(obs_property_t *p)
+{
+	return 0;
+}
+
+enum obs_text_type obs_proprety_text_type(obs_property_t *p)
+{
+	return OBS_TEXT_DEFAULT;
+}
+
+enum obs_path_type obs_property_path_type(obs_property_t *p)
+{
+	return OBS_PATH_FILE;
+}
+
+const char *obs_property_path_filter(obs_property_t *p)
+{
+	return nullptr;
+}
+
+const char *obs_property_path_default_path(obs_property_t *p)
+{
+	return nullptr;
+}
+
+enum obs_combo_type obs_property_list_type(obs_property_t *p)
+{
+	return OBS_COMBO_TYPE_INVALID;
+}
+
+enum obs_combo_format obs_property_list_format(obs_property_t *p)
+{
+	return OBS_COMBO_FORMAT_INVALID;
+}
+
+size_t obs_property_list_item_count(obs_property_t *p)
+{
+	return 0;
+}
+
+bool obs_property_list_item_disabled(obs_property_t *p, size_t idx)
+{
+	return false;
+}
+
+const char *obs_property_list_item_name(obs_property_t *p, size_t idx)
+{
+	return nullptr;
+}
+
+const char *obs_property_list_item_string(obs_property_t *p, size_t idx)
+{
+	return nullptr;
+}
+
+long long obs_property_list_item_int(obs_property_t *p, size_t idx)
+{
+	return 0;
+}
+
+double obs_property_list_item_float(obs_property_t *p, size_t idx)
+{
+	return 0;
+}
+
+enum obs_editable_list_type obs_property_editable_list_type(obs_property_t *p)
+{
+	return OBS_EDITABLE_LIST_TYPE_STRINGS;
+}
+
+const char *obs_property_editable_list_filter(obs_property_t *p)
+{
+	return nullptr;
+}
+
+const char *obs_property_editable_list_default_path(obs_property_t *p)
+{
+	return nullptr;
+}
+
+size_t obs_property_frame_rate_fps_ranges_count(obs_property_t *p)
+{
+	return 0;
+}
+
+struct media_frames_per_second obs_property_frame_rate_fps_range_min(obs_property_t *p, size_t idx)
+{
+	return {};
+}
+
+struct media_frames_per_second obs_property_frame_rate_fps_range_max(obs_property_t *p, size_t idx)
+{
+	return {};
+}
+
+size_t obs_property_frame_rate_options_count(obs_property_t *p)
+{
+	return 0;
+}
+
+const char *obs_property_frame_rate_option_name(obs_property_t *p, size_t idx)
+{
+	return nullptr;
+}
+
+const char *obs_property_frame_rate_option_description(obs_property_t *p, size_t idx)
+{
+	return nullptr;
+}
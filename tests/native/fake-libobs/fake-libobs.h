@@ -0,0 +1,59 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+// Test controls of fake-libobs, not part of the libobs API.
+
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+#include "obs.h"
+
+namespace fake_libobs {
+// Found by obs_find_modules2 in the order added. Initializing a module
+// appends its types to the lists obs_enum_*_types walk.
+struct module {
+	std::string name;
+	std::string path;
+	std::vector<std::string> inputs;
+	std::vector<std::string> filters;
+	std::vector<std::string> transitions;
+	std::vector<std::string> encoders;
+	std::vector<std::string> outputs;
+	std::vector<std::string> services;
+	bool missing_exports = false; // obs_open_module fails with MODULE_MISSING_EXPORTS
+};
+
+void add_module(const module &info);
+
+// Modules obs_open_module opened successfully.
+size_t opened_modules();
+
+// Messages blog printed so far.
+size_t logged_messages();
+
+// A source with empty settings that is not showing. Sources are never freed.
+obs_source_t *create_source(const std::string &id, const std::string &name);
+void set_showing(obs_source_t *source, bool showing);
+// obs_source_showing calls so far.
+size_t showing_queries(obs_source_t *source);
+// Answers proc_handler_call for name on the calling thread.
+void set_proc(obs_source_t *source, const std::string &name, std::function<void(calldata_t *)> proc);
+// Calls the connected callbacks, disconnecting waits until they returned.
+void emit_signal(obs_source_t *source, const std::string &signal);
+}
@@ -0,0 +1,53 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+// ipc::value as a plain holder, the rest of lib-streamlabs-ipc is not needed.
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ipc {
+enum class type { Null, Int32, Int64, UInt32, UInt64, Float, Double, String, Binary };
+
+struct value {
+	ipc::type type = ipc::type::Null;
+	union {
+		int32_t i32;
+		int64_t i64;
+		uint32_t ui32;
+		uint64_t ui64;
+		float fp32;
+		double fp64;
+	} value_union = {};
+	std::string value_str;
+	std::vector<char> value_bin;
+
+	value() {}
+	value(int32_t v) : type(ipc::type::Int32) { value_union.i32 = v; }
+	value(int64_t v) : type(ipc::type::Int64) { value_union.i64 = v; }
+	value(uint32_t v) : type(ipc::type::UInt32) { value_union.ui32 = v; }
+	value(uint64_t v) : type(ipc::type::UInt64) { value_union.ui64 = v; }
+	value(float v) : type(ipc::type::Float) { value_union.fp32 = v; }
+	value(double v) : type(ipc::type::Double) { value_union.fp64 = v; }
+	value(std::string v) : type(ipc::type::String), value_str(std::move(v)) {}
+	value(const char *v) : type(ipc::type::String), value_str(v) {}
+	value(std::vector<char> v) : type(ipc::type::Binary), value_bin(std::move(v)) {}
+};
+} // namespace ipc
@@ -0,0 +1,41 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+// The part of obs-module.h used to find, open and initialize plugin modules.
+// Modules are the fake ones added with fake_libobs::add_module.
+
+#pragma once
+#include "obs.h"
+
+#define MODULE_SUCCESS 0
+#define MODULE_ERROR -1
+#define MODULE_FILE_NOT_FOUND -2
+#define MODULE_MISSING_EXPORTS -3
+#define MODULE_INCOMPATIBLE_VER -4
+
+struct obs_module_info2 {
+	const char *bin_path;
+	const char *data_path;
+	const char *name;
+};
+
+typedef void (*obs_find_module_callback2_t)(void *param, const struct obs_module_info2 *info);
+
+void obs_find_modules2(obs_find_module_callback2_t callback, void *param);
+int obs_open_module(obs_module_t **module, const char *path, const char *data_path);
+bool obs_init_module(obs_module_t *module);
@@ -0,0 +1,195 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+// The subset of the libobs API used by the sources under test. Declarations
+// follow libobs, the behaviour is described in fake-libobs.cpp.
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+enum { LOG_ERROR = 100, LOG_WARNING = 200, LOG_INFO = 300, LOG_DEBUG = 400 };
+void blog(int log_level, const char *format, ...);
+
+#define MAX_AV_PLANES 8
+
+enum video_format {
+	VIDEO_FORMAT_NONE,
+	VIDEO_FORMAT_I420,
+	VIDEO_FORMAT_NV12,
+	VIDEO_FORMAT_YVYU,
+	VIDEO_FORMAT_YUY2,
+	VIDEO_FORMAT_UYVY,
+	VIDEO_FORMAT_RGBA,
+	VIDEO_FORMAT_BGRA,
+	VIDEO_FORMAT_BGRX,
+	VIDEO_FORMAT_Y800,
+	VIDEO_FORMAT_I444,
+	VIDEO_FORMAT_BGR3,
+	VIDEO_FORMAT_I422,
+	VIDEO_FORMAT_I40A,
+	VIDEO_FORMAT_I42A,
+	VIDEO_FORMAT_YUVA,
+	VIDEO_FORMAT_AYUV,
+	VIDEO_FORMAT_I010,
+	VIDEO_FORMAT_P010,
+	VIDEO_FORMAT_I210,
+	VIDEO_FORMAT_I412,
+	VIDEO_FORMAT_YA2L,
+	VIDEO_FORMAT_P216,
+	VIDEO_FORMAT_P416,
+	VIDEO_FORMAT_V210,
+	VIDEO_FORMAT_R10L,
+};
+
+typedef struct obs_data obs_data_t;
+typedef struct obs_data_array obs_data_array_t;
+typedef struct obs_module obs_module_t;
+typedef struct obs_properties obs_properties_t;
+typedef struct obs_property obs_property_t;
+typedef struct obs_source obs_source_t;
+typedef struct signal_handler signal_handler_t;
+typedef struct proc_handler proc_handler_t;
+
+// Values by name instead of the packed stack of libobs
+struct calldata {
+	struct calldata_values *values;
+};
+typedef struct calldata calldata_t;
+typedef void (*signal_callback_t)(void *data, calldata_t *cd);
+
+struct media_frames_per_second {
+	uint32_t numerator;
+	uint32_t denominator;
+};
+
+enum obs_property_type {
+	OBS_PROPERTY_INVALID,
+	OBS_PROPERTY_BOOL,
+	OBS_PROPERTY_INT,
+	OBS_PROPERTY_FLOAT,
+	OBS_PROPERTY_TEXT,
+	OBS_PROPERTY_PATH,
+	OBS_PROPERTY_LIST,
+	OBS_PROPERTY_COLOR,
+	OBS_PROPERTY_BUTTON,
+	OBS_PROPERTY_FONT,
+	OBS_PROPERTY_EDITABLE_LIST,
+	OBS_PROPERTY_FRAME_RATE,
+	OBS_PROPERTY_GROUP,
+	OBS_PROPERTY_COLOR_ALPHA,
+	OBS_PROPERTY_CAPTURE,
+};
+enum obs_number_type { OBS_NUMBER_SCROLLER, OBS_NUMBER_SLIDER };
+enum obs_text_type { OBS_TEXT_DEFAULT, OBS_TEXT_PASSWORD, OBS_TEXT_MULTILINE, OBS_TEXT_INFO };
+enum obs_path_type { OBS_PATH_FILE, OBS_PATH_FILE_SAVE, OBS_PATH_DIRECTORY };
+enum obs_combo_type { OBS_COMBO_TYPE_INVALID, OBS_COMBO_TYPE_EDITABLE, OBS_COMBO_TYPE_LIST, OBS_COMBO_TYPE_RADIO };
+enum obs_combo_format { OBS_COMBO_FORMAT_INVALID, OBS_COMBO_FORMAT_INT, OBS_COMBO_FORMAT_FLOAT, OBS_COMBO_FORMAT_STRING };
+enum obs_editable_list_type { OBS_EDITABLE_LIST_TYPE_STRINGS, OBS_EDITABLE_LIST_TYPE_FILES, OBS_EDITABLE_LIST_TYPE_FILES_AND_URLS };
+
+const char *get_video_format_name(enum video_format format);
+
+/* Calls and signals */
+void calldata_free(calldata_t *data);
+void calldata_set_int(calldata_t *data, const char *name, long long val);
+void calldata_set_bool(calldata_t *data, const char *name, bool val);
+long long calldata_int(const calldata_t *data, const char *name);
+bool calldata_bool(const calldata_t *data, const char *name);
+bool proc_handler_call(proc_handler_t *handler, const char *name, calldata_t *params);
+void signal_handler_connect(signal_handler_t *handler, const char *signal, signal_callback_t callback, void *data);
+void signal_handler_disconnect(signal_handler_t *handler, const char *signal, signal_callback_t callback, void *data);
+
+/* Sources, created by fake_libobs::create_source */
+const char *obs_source_get_name(const obs_source_t *source);
+const char *obs_source_get_id(const obs_source_t *source);
+obs_data_t *obs_source_get_settings(const obs_source_t *source);
+void obs_source_update(obs_source_t *source, obs_data_t *settings);
+bool obs_source_showing(const obs_source_t *source);
+signal_handler_t *obs_source_get_signal_handler(const obs_source_t *source);
+proc_handler_t *obs_source_get_proc_handler(const obs_source_t *source);
+
+/* Type enumeration */
+bool obs_enum_input_types(size_t idx, const char **id);
+bool obs_enum_filter_types(size_t idx, const char **id);
+bool obs_enum_transition_types(size_t idx, const char **id);
+bool obs_enum_encoder_types(size_t idx, const char **id);
+bool obs_enum_output_types(size_t idx, const char **id);
+bool obs_enum_service_types(size_t idx, const char **id);
+
+/* Settings */
+obs_data_t *obs_data_create();
+obs_data_t *obs_data_create_from_json_file_safe(const char *json_file, const char *backup_ext);
+bool obs_data_save_json_safe(obs_data_t *data, const char *file, const char *temp_ext, const char *backup_ext);
+void obs_data_release(obs_data_t *data);
+void obs_data_set_bool(obs_data_t *data, const char *name, bool val);
+void obs_data_set_int(obs_data_t *data, const char *name, long long val);
+void obs_data_set_string(obs_data_t *data, const char *name, const char *val);
+void obs_data_set_array(obs_data_t *data, const char *name, obs_data_array_t *array);
+long long obs_data_get_int(obs_data_t *data, const char *name);
+bool obs_data_get_bool(obs_data_t *data, const char *name);
+double obs_data_get_double(obs_data_t *data, const char *name);
+const char *obs_data_get_string(obs_data_t *data, const char *name);
+obs_data_t *obs_data_get_obj(obs_data_t *data, const char *name);
+obs_data_array_t *obs_data_get_array(obs_data_t *data, const char *name);
+bool obs_data_get_frames_per_second(obs_data_t *data, const char *name, struct media_frames_per_second *fps, const char **option);
+
+obs_data_array_t *obs_data_array_create();
+void obs_data_array_release(obs_data_array_t *array);
+size_t obs_data_array_count(obs_data_array_t *array);
+obs_data_t *obs_data_array_item(obs_data_array_t *array, size_t idx);
+size_t obs_data_array_push_back(obs_data_array_t *array, obs_data_t *obj);
+
+/* Properties, the fake property lists are always empty */
+obs_property_t *obs_properties_first(obs_properties_t *props);
+bool obs_property_next(obs_property_t **p);
+obs_properties_t *obs_property_group_content(obs_property_t *p);
+const char *obs_property_name(obs_property_t *p);
+const char *obs_property_description(obs_property_t *p);
+const char *obs_property_long_description(obs_property_t *p);
+enum obs_property_type obs_property_get_type(obs_property_t *p);
+bool obs_property_enabled(obs_property_t *p);
+bool obs_property_visible(obs_property_t *p);
+enum obs_number_type obs_property_int_type(obs_property_t *p);
+int obs_property_int_min(obs_property_t *p);
+int obs_property_int_max(obs_property_t *p);
+int obs_property_int_step(obs_property_t *p);
+enum obs_number_type obs_property_float_type(obs_property_t *p);
+double obs_property_float_min(obs_property_t *p);
+double obs_property_float_max(obs_property_t *p);
+double obs_property_float_step(obs_property_t *p);
+enum obs_text_type obs_proprety_text_type(obs_property_t *p);
+enum obs_path_type obs_property_path_type(obs_property_t *p);
+const char *obs_property_path_filter(obs_property_t *p);
+const char *obs_property_path_default_path(obs_property_t *p);
+enum obs_combo_type obs_property_list_type(obs_property_t *p);
+enum obs_combo_format obs_property_list_format(obs_property_t *p);
+size_t obs_property_list_item_count(obs_property_t *p);
+bool obs_property_list_item_disabled(obs_property_t *p, size_t idx);
+const char *obs_property_list_item_name(obs_property_t *p, size_t idx);
+const char *obs_property_list_item_string(obs_property_t *p, size_t idx);
+long long obs_property_list_item_int(obs_property_t *p, size_t idx);
+double obs_property_list_item_float(obs_property_t *p, size_t idx);
+enum obs_editable_list_type obs_property_editable_list_type(obs_property_t *p);
+const char *obs_property_editable_list_filter(obs_property_t *p);
+const char *obs_property_editable_list_default_path(obs_property_t *p);
+size_t obs_property_frame_rate_fps_ranges_count(obs_property_t *p);
+struct media_frames_per_second obs_property_frame_rate_fps_range_min(obs_property_t *p, size_t idx);
+struct media_frames_per_second obs_property_frame_rate_fps_range_max(obs_property_t *p, size_t idx);
+size_t obs_property_frame_rate_options_count(obs_property_t *p);
+const char *obs_property_frame_rate_option_name(obs_property_t *p, size_t idx);
+const char *obs_property_frame_rate_option_description(obs_property_t *p, size_t idx);
@@ -0,0 +1,34 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+// Helpers shared by the native tests and benchmarks.
+
+#pragma once
+#include <cstdio>
+#include <cstdlib>
+
+// Fails the test with what went wrong. Quits without running static
+// destructors, they could join threads that a failed check left blocked.
+inline void check(bool condition, const char *what)
+{
+	if (!condition) {
+		fprintf(stderr, "FAILED: %s\n", what);
+		fflush(stdout);
+		_Exit(1);
+	}
+}
@@ -0,0 +1,102 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+// Checks GetFrameLayout against the layouts of video_frame_init in libobs.
+
+#include <cstdio>
+#include <vector>
+#include "fake-libobs.h"
+#include "frame-layout.h"
+#include "native-test.hpp"
+
+namespace {
+// Planes follow each other, each one padded to FRAME_ALIGNMENT
+void expect(enum video_format format, uint32_t width, uint32_t height, const std::vector<uint32_t> &linesize, const std::vector<uint32_t> &lines,
+	    const char *what)
+{
+	FrameLayout layout;
+	check(GetFrameLayout(format, width, height, layout), what);
+	check(layout.planes == linesize.size(), what);
+
+	uint64_t offset = 0;
+	for (uint32_t i = 0; i < layout.planes; i++) {
+		check(layout.linesize[i] == linesize[i], what);
+		check(layout.height[i] == lines[i], what);
+		check(layout.offset[i] == offset, what);
+		check(offset % FRAME_ALIGNMENT == 0, what);
+		offset = (offset + uint64_t(linesize[i]) * lines[i] + FRAME_ALIGNMENT - 1) / FRAME_ALIGNMENT * FRAME_ALIGNMENT;
+	}
+	check(layout.size == offset, what);
+}
+
+void test_alignment()
+{
+	FrameLayout layout;
+	check(GetFrameLayout(VIDEO_FORMAT_I420, 33, 17, layout), "I420 33x17");
+	check(layout.offset[1] == 576 && layout.offset[2] == 736 && layout.size == 896, "I420 33x17 planes are padded to 32 bytes");
+}
+
+void test_odd_sizes()
+{
+	expect(VIDEO_FORMAT_I420, 1919, 1079, {1919, 960, 960}, {1079, 540, 540}, "I420 rounds chroma up");
+	expect(VIDEO_FORMAT_NV12, 641, 481, {641, 642}, {481, 241}, "NV12 interleaves rounded chroma");
+	expect(VIDEO_FORMAT_I422, 641, 481, {641, 321, 321}, {481, 481, 481}, "I422 halves only the width");
+	expect(VIDEO_FORMAT_YUY2, 1, 1, {4}, {1}, "YUY2 rounds up to two pixels");
+	expect(VIDEO_FORMAT_UYVY, 641, 3, {1284}, {3}, "UYVY rounds up to two pixels");
+	expect(VIDEO_FORMAT_BGR3, 5, 3, {15}, {3}, "BGR3");
+	expect(VIDEO_FORMAT_I010, 641, 481, {1282, 642, 642}, {481, 241, 241}, "I010 uses 16 bit samples");
+	expect(VIDEO_FORMAT_P010, 641, 481, {1282, 1284}, {481, 241}, "P010 interleaves 16 bit chroma");
+	expect(VIDEO_FORMAT_P216, 5, 3, {10, 12}, {3, 3}, "P216 halves only the chroma width");
+	expect(VIDEO_FORMAT_P416, 5, 3, {10, 20}, {3, 3}, "P416 keeps full chroma");
+	expect(VIDEO_FORMAT_R10L, 5, 3, {20}, {3}, "R10L packs 10 bit RGB in 4 bytes");
+	expect(VIDEO_FORMAT_V210, 1, 1, {16}, {1}, "V210 rounds up to a block of six pixels");
+	expect(VIDEO_FORMAT_V210, 6, 1, {16}, {1}, "V210 fits six pixels in a block");
+	expect(VIDEO_FORMAT_V210, 1921, 1081, {5136}, {1081}, "V210 1921x1081");
+}
+
+void test_alpha_planes()
+{
+	expect(VIDEO_FORMAT_I40A, 641, 481, {641, 321, 321, 641}, {481, 241, 241, 481}, "I40A alpha is full size");
+	expect(VIDEO_FORMAT_I42A, 641, 481, {641, 321, 321, 641}, {481, 481, 481, 481}, "I42A alpha is full size");
+	expect(VIDEO_FORMAT_YUVA, 3, 3, {3, 3, 3, 3}, {3, 3, 3, 3}, "YUVA");
+	expect(VIDEO_FORMAT_YA2L, 5, 3, {10, 10, 10, 10}, {3, 3, 3, 3}, "YA2L uses 16 bit samples");
+	expect(VIDEO_FORMAT_AYUV, 5, 3, {20}, {3}, "AYUV packs alpha");
+	expect(VIDEO_FORMAT_RGBA, 5, 3, {20}, {3}, "RGBA");
+}
+
+void test_unknown_format()
+{
+	FrameLayout layout;
+	const size_t logged = fake_libobs::logged_messages();
+	check(!GetFrameLayout(VIDEO_FORMAT_NONE, 64, 64, layout), "an unknown format has no layout");
+	check(!GetFrameLayout(VIDEO_FORMAT_NONE, 32, 32, layout), "an unknown format has no layout");
+	check(fake_libobs::logged_messages() == logged + 1, "an unknown format is logged once");
+	check(!GetFrameLayout((enum video_format)100, 64, 64, layout), "an unknown format has no layout");
+	check(fake_libobs::logged_messages() == logged + 2, "each unknown format is logged");
+}
+}
+
+int main()
+{
+	test_alignment();
+	test_odd_sizes();
+	test_alpha_planes();
+	test_unknown_format();
+	printf("FrameLayout: all checks passed\n");
+	return 0;
+}
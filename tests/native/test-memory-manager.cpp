@@ -0,0 +1,273 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+// Drives the MemoryManager worker pool with fake media sources: coalesced
+// evaluations, sources queued again by media_started, the eviction order and
+// unregisterSource racing a running evaluation. MemoryProbe::Query is
+// replaced to give the cache a budget of 100 MB.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "fake-libobs.h"
+#include "memory-manager.h"
+#include "native-test.hpp"
+
+namespace {
+const uint64_t MB = 1000000;
+const uint64_t GB = 1024ull * 1024 * 1024;
+
+// A looping local media file of BGRA frames of 1 MB each. get_file_info
+// reports no size until the file is open and blocks while held.
+struct TestSource {
+	obs_source_t *source;
+	uint64_t frames;
+	std::atomic<bool> open{true};
+	std::atomic<bool> playing{true};
+	std::atomic<int> file_infos{0};
+	std::atomic<int> playing_queries{0};
+
+	std::mutex gate_mtx;
+	std::condition_variable gate_cv;
+	bool held = false;
+	bool entered = false;
+};
+
+std::mutex created_mtx;
+std::vector<TestSource *> created;
+
+bool cached(TestSource &ts)
+{
+	return obs_data_get_bool(obs_source_get_settings(ts.source), "caching");
+}
+
+// The workers signal nothing when they are done, conditions are polled
+bool wait_for(const std::function<bool()> &condition)
+{
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+	while (std::chrono::steady_clock::now() < deadline) {
+		if (condition())
+			return true;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return condition();
+}
+
+// For what must not happen, long enough for a worker to finish
+void settle()
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+}
+
+TestSource &add(const char *name, uint64_t frames, bool showing)
+{
+	TestSource *ts = new TestSource;
+	ts->source = fake_libobs::create_source("ffmpeg_source", name);
+	ts->frames = frames;
+
+	obs_data_t *settings = obs_source_get_settings(ts->source);
+	obs_data_set_bool(settings, "looping", true);
+	obs_data_set_bool(settings, "is_local_file", true);
+	fake_libobs::set_showing(ts->source, showing);
+
+	fake_libobs::set_proc(ts->source, "get_file_info", [ts](calldata_t *cd) {
+		ts->file_infos++;
+		{
+			std::unique_lock<std::mutex> lock(ts->gate_mtx);
+			ts->entered = true;
+			ts->gate_cv.notify_all();
+			ts->gate_cv.wait(lock, [ts] { return !ts->held; });
+		}
+		if (!ts->open)
+			return;
+		calldata_set_int(cd, "pix_format", VIDEO_FORMAT_BGRA);
+		calldata_set_int(cd, "width", 1000);
+		calldata_set_int(cd, "height", 250);
+		calldata_set_int(cd, "num_frames", ts->frames);
+	});
+	fake_libobs::set_proc(ts->source, "get_playing", [ts](calldata_t *cd) {
+		ts->playing_queries++;
+		calldata_set_bool(cd, "playing", ts->playing);
+	});
+
+	{
+		std::lock_guard<std::mutex> lock(created_mtx);
+		created.push_back(ts);
+	}
+	MemoryManager::GetInstance().registerSource(ts->source);
+	return *ts;
+}
+
+void hold(TestSource &ts)
+{
+	std::lock_guard<std::mutex> lock(ts.gate_mtx);
+	ts.held = true;
+	ts.entered = false;
+}
+
+void wait_entered(TestSource &ts)
+{
+	std::unique_lock<std::mutex> lock(ts.gate_mtx);
+	check(ts.gate_cv.wait_for(lock, std::chrono::seconds(2), [&] { return ts.entered; }), "a worker picks the source up");
+}
+
+void release(TestSource &ts)
+{
+	std::lock_guard<std::mutex> lock(ts.gate_mtx);
+	ts.held = false;
+	ts.gate_cv.notify_all();
+}
+
+// Evaluates a source that is open and waits until its worker read whether it shows
+void evaluate(TestSource &ts)
+{
+	const size_t queries = fake_libobs::showing_queries(ts.source);
+	MemoryManager::GetInstance().updateSourceCache(ts.source);
+	check(wait_for([&] { return fake_libobs::showing_queries(ts.source) > queries; }), "the source is evaluated");
+}
+
+void test_coalescing()
+{
+	TestSource &ts = add("coalesced", 10, true);
+	ts.open = false;
+	hold(ts);
+	MemoryManager::GetInstance().updateSourceCache(ts.source);
+	wait_entered(ts);
+
+	// Queued again while running, once more however often it changes
+	for (int i = 0; i < 10; i++)
+		MemoryManager::GetInstance().updateSourceCache(ts.source);
+	MemoryManager::GetInstance().updateSourcesCache();
+	check(ts.file_infos == 1, "a running source is not evaluated twice at once");
+
+	release(ts);
+	check(wait_for([&] { return ts.file_infos == 2; }), "changes while running queue the source again");
+	settle();
+	check(ts.file_infos == 2, "changes while running are coalesced into one evaluation");
+}
+
+void test_media_started()
+{
+	TestSource &ts = add("media started", 20, true);
+	ts.playing = false;
+	MemoryManager::GetInstance().updateSourceCache(ts.source);
+	check(wait_for([&] { return ts.playing_queries == 1; }), "a source that fits is checked for playback");
+	settle();
+	check(!cached(ts), "a source that is not playing is not cached");
+
+	ts.playing = true;
+	fake_libobs::emit_signal(ts.source, "media_started");
+	check(wait_for([&] { return cached(ts); }), "media_started queues the source again");
+
+	MemoryManager::GetInstance().unregisterSource(ts.source);
+	check(!cached(ts), "an unregistered source leaves the cache");
+}
+
+void test_eviction_order()
+{
+	TestSource &first = add("first hidden", 40, true);
+	TestSource &second = add("second hidden", 40, true);
+	evaluate(first);
+	evaluate(second);
+	check(wait_for([&] { return cached(first) && cached(second); }), "showing sources within the budget are cached");
+
+	// Hidden but kept, close_when_inactive is off
+	fake_libobs::set_showing(first.source, false);
+	evaluate(first);
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	fake_libobs::set_showing(second.source, false);
+	evaluate(second);
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	check(cached(first) && cached(second), "hidden sources stay cached without close_when_inactive");
+
+	TestSource &showing = add("showing", 40, true);
+	evaluate(showing);
+	check(wait_for([&] { return cached(showing); }), "a showing source evicts hidden ones");
+	check(!cached(first), "the source hidden longest is evicted first");
+	check(cached(second), "no more is evicted than needed");
+
+	// Needs 50 MB, only 40 MB are hidden
+	TestSource &large = add("large", 70, true);
+	evaluate(large);
+	check(wait_for([&] { return large.playing_queries == 1; }), "a showing source that does not fit is checked for playback");
+	settle();
+	check(!cached(large), "a source is not cached without enough room");
+	check(cached(second) && cached(showing), "nothing is evicted without enough room");
+}
+
+void test_unregister_while_running()
+{
+	TestSource &ts = add("unregistered", 10, true);
+	ts.open = false;
+	hold(ts);
+	MemoryManager::GetInstance().updateSourceCache(ts.source);
+	wait_entered(ts);
+	MemoryManager::GetInstance().updateSourceCache(ts.source);
+
+	std::atomic<bool> done{false};
+	std::thread unregister([&] {
+		MemoryManager::GetInstance().unregisterSource(ts.source);
+		done = true;
+	});
+	settle();
+	check(!done, "unregisterSource waits for the running evaluation");
+
+	release(ts);
+	unregister.join();
+	settle();
+	check(ts.file_infos == 1, "a removed source is not queued again by its worker");
+
+	fake_libobs::emit_signal(ts.source, "media_started");
+	settle();
+	check(ts.file_infos == 1, "media_started is disconnected from a removed source");
+}
+}
+
+// The cache takes from what is available, 100 MB are left for it
+MemoryStatus MemoryProbe::Query()
+{
+	uint64_t cached_size = 0;
+	{
+		std::lock_guard<std::mutex> lock(created_mtx);
+		for (TestSource *ts : created) {
+			if (cached(*ts))
+				cached_size += ts->frames * MB;
+		}
+	}
+
+	MemoryStatus status;
+	status.total = 8 * GB;
+	status.available = status.total / 10 + 100 * MB - cached_size;
+	return status;
+}
+
+int main()
+{
+	test_coalescing();
+	test_media_started();
+	test_eviction_order();
+	test_unregister_while_running();
+	MemoryManager::GetInstance().shutdownAllSources();
+	printf("MemoryManager: all checks passed\n");
+	return 0;
+}
@@ -0,0 +1,121 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+// Checks MemoryProbe::QueryLinux against fake /proc and /sys trees.
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include "memory-probe.h"
+#include "native-test.hpp"
+
+namespace {
+const uint64_t GB = 1024ull * 1024 * 1024;
+std::filesystem::path root;
+
+void write(const std::string &path, const std::string &text)
+{
+	std::filesystem::path file = root / path;
+	std::filesystem::create_directories(file.parent_path());
+	std::ofstream(file) << text;
+}
+
+MemoryStatus query()
+{
+	return MemoryProbe::QueryLinux(root.string());
+}
+
+void reset()
+{
+	std::filesystem::remove_all(root);
+	std::filesystem::create_directories(root);
+}
+
+void test_meminfo()
+{
+	reset();
+	write("proc/meminfo", "MemTotal:       16777216 kB\nMemFree:         1048576 kB\nMemAvailable:    8388608 kB\nBuffers: 1 kB\n");
+	MemoryStatus status = query();
+	check(status.total == 16 * GB && status.available == 8 * GB, "MemAvailable is used when present");
+
+	write("proc/meminfo", "MemTotal: 4194304 kB\nMemFree: 1048576 kB\nBuffers: 524288 kB\nCached: 524288 kB\n");
+	status = query();
+	check(status.total == 4 * GB && status.available == 2 * GB, "without MemAvailable free, buffers and cached add up");
+
+	write("proc/meminfo", "garbage\n");
+	status = query();
+	check(status.total == 0, "a meminfo without MemTotal is an error");
+}
+
+void test_cgroups()
+{
+	reset();
+	write("proc/meminfo", "MemTotal: 16777216 kB\nMemAvailable: 12582912 kB\n");
+	MemoryStatus status = query();
+	check(status.total == 16 * GB && status.available == 12 * GB, "without /proc/self/cgroup only meminfo counts");
+
+	write("proc/self/cgroup", "0::/render/node1\n");
+	status = query();
+	check(status.total == 16 * GB && status.available == 12 * GB, "missing cgroup files are skipped");
+
+	write("sys/fs/cgroup/render/node1/memory.max", "max\n");
+	write("sys/fs/cgroup/render/node1/memory.current", "1073741824\n");
+	status = query();
+	check(status.total == 16 * GB && status.available == 12 * GB, "memory.max set to max does not limit");
+
+	write("sys/fs/cgroup/render/memory.max", "6442450944\n");
+	write("sys/fs/cgroup/render/memory.current", "2147483648\n");
+	status = query();
+	check(status.total == 6 * GB && status.available == 4 * GB, "the limit of a parent cgroup applies to nested ones");
+
+	// Media files read through the page cache fill the cgroup, most of it is
+	// inactive and reclaimed before the limit
+	write("sys/fs/cgroup/render/memory.current", "6442450944\n");
+	write("sys/fs/cgroup/render/memory.stat", "anon 1073741824\nfile 5368709120\nactive_file 1073741824\ninactive_file 4294967296\n");
+	status = query();
+	check(status.total == 6 * GB && status.available == 4 * GB, "inactive page cache does not count as used");
+
+	write("sys/fs/cgroup/render/memory.stat", "inactive_file 8589934592\n");
+	status = query();
+	check(status.total == 6 * GB && status.available == 6 * GB, "page cache above the usage leaves all of it available");
+
+		write("sys/fs/cgroup/memory.max", "3221225472\n");
+	write("sys/fs/cgroup/memory.current", "4294967296\n");
+	status = query();
+	check(status.total == 3 * GB && status.available == 0, "usage over the limit leaves nothing available");
+
+	write("proc/self/cgroup", "12:memory:/docker/abc\n");
+	status = query();
+	check(status.total == 16 * GB, "cgroup v1 entries are ignored");
+
+	std::filesystem::remove(root / "proc/meminfo");
+	status = query();
+	check(status.total == 0 && status.available == 0, "without meminfo nothing is known");
+}
+}
+
+int main()
+{
+	root = std::filesystem::temp_directory_path() / "test-memory-probe";
+	test_meminfo();
+	test_cgroups();
+	std::filesystem::remove_all(root);
+	printf("MemoryProbe: all checks passed\n");
+	return 0;
+}
@@ -0,0 +1,173 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+// Runs util::ModuleManifest against the fake modules of fake-libobs over
+// several server starts, each one a separate process since the manifest
+// state is static:
+// - build: no manifest yet, every module is loaded and recorded
+// - deferred: only the module with an encoder is loaded, the others wait
+//   for LoadSourceType
+// - rebuilt: a module with a new modification time is loaded at startup
+// - refreshed: the rebuilt module is deferred again with its new types
+//
+// Usage: test-module-manifest [directory phase]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "fake-libobs.h"
+#include "native-test.hpp"
+#include "obs.h"
+#include "util-modulemanifest.h"
+
+namespace {
+const char *const phases[] = {"build", "deferred", "rebuilt", "refreshed"};
+
+bool contains(const std::vector<std::string> &list, const char *item)
+{
+	return std::find(list.begin(), list.end(), item) != list.end();
+}
+
+size_t registered_inputs()
+{
+	const char *id = nullptr;
+	size_t count = 0;
+	while (obs_enum_input_types(count, &id))
+		count++;
+	return count;
+}
+
+size_t registered_encoders()
+{
+	const char *id = nullptr;
+	size_t count = 0;
+	while (obs_enum_encoder_types(count, &id))
+		count++;
+	return count;
+}
+
+std::string module_path(const std::filesystem::path &directory, const char *name)
+{
+	return (directory / (std::string(name) + ".so")).string();
+}
+
+void add_modules(const std::filesystem::path &directory, bool rebuilt)
+{
+	fake_libobs::module image;
+	image.name = "image";
+	image.path = module_path(directory, "image");
+	image.inputs = {"image_source"};
+	image.filters = {"mask_filter"};
+	fake_libobs::add_module(image);
+
+	fake_libobs::module capture;
+	capture.name = "capture";
+	capture.path = module_path(directory, "capture");
+	capture.inputs = {"game_capture", "window_capture"};
+	if (rebuilt)
+		capture.inputs.push_back("monitor_capture");
+	fake_libobs::add_module(capture);
+
+	fake_libobs::module x264;
+	x264.name = "x264";
+	x264.path = module_path(directory, "x264");
+	x264.encoders = {"obs_x264"};
+	fake_libobs::add_module(x264);
+
+	// Registers nothing, so it is opened at every start
+	fake_libobs::module helper;
+	helper.name = "helper";
+	helper.path = module_path(directory, "helper");
+	helper.missing_exports = true;
+	fake_libobs::add_module(helper);
+}
+
+void run_phase(const std::filesystem::path &directory, const std::string &phase)
+{
+	add_modules(directory, phase == "rebuilt" || phase == "refreshed");
+	std::vector<std::string> failed;
+	util::ModuleManifest::LoadModules((directory / "manifest").string(), failed);
+	check(failed.empty(), "every module loads");
+
+	if (phase == "build") {
+		check(fake_libobs::opened_modules() == 3, "without a manifest every module is loaded");
+		check(registered_inputs() == 3, "their inputs are registered");
+		check(util::ModuleManifest::PendingModules().empty(), "nothing is deferred");
+		check(std::filesystem::exists(directory / "manifest"), "the manifest is written");
+	} else if (phase == "deferred") {
+		check(fake_libobs::opened_modules() == 1, "only the encoder module is loaded");
+		check(registered_encoders() == 1 && registered_inputs() == 0, "only the encoder is registered");
+		auto inputs = util::ModuleManifest::InputTypes();
+		check(inputs.size() == 3 && contains(inputs, "image_source") && contains(inputs, "game_capture"),
+		      "deferred inputs are listed from the manifest");
+		check(util::ModuleManifest::FilterTypes().size() == 1, "deferred filters are listed from the manifest");
+		check(util::ModuleManifest::PendingModules().size() == 2, "image and capture are deferred");
+
+		util::ModuleManifest::LoadSourceType("window_capture");
+		check(fake_libobs::opened_modules() == 2 && registered_inputs() == 2, "a deferred type loads its module");
+		util::ModuleManifest::LoadSourceType("game_capture");
+		util::ModuleManifest::LoadSourceType("color_source");
+		check(fake_libobs::opened_modules() == 2, "loaded and unknown types open nothing");
+		check(util::ModuleManifest::InputTypes().size() == 3, "loaded types are not listed twice");
+		check(util::ModuleManifest::PendingModules() == std::vector<std::string>{"image.so"}, "image is still deferred");
+	} else if (phase == "rebuilt") {
+		check(fake_libobs::opened_modules() == 2, "the rebuilt module is loaded at startup");
+		check(registered_inputs() == 3, "with its new input");
+		check(util::ModuleManifest::PendingModules() == std::vector<std::string>{"image.so"}, "image is still deferred");
+	} else if (phase == "refreshed") {
+		check(fake_libobs::opened_modules() == 1, "the refreshed entry defers the rebuilt module again");
+		check(contains(util::ModuleManifest::InputTypes(), "monitor_capture"), "the manifest holds the new input");
+	}
+}
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc == 3) {
+		run_phase(argv[1], argv[2]);
+		return 0;
+	}
+
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "test-module-manifest";
+	std::filesystem::remove_all(directory);
+	std::filesystem::create_directories(directory);
+	for (const char *name : {"image", "capture", "x264", "helper"})
+		std::ofstream(module_path(directory, name)) << name;
+
+	for (const char *phase : phases) {
+		if (std::string(phase) == "rebuilt") {
+			std::filesystem::path capture = module_path(directory, "capture");
+			std::filesystem::last_write_time(capture, std::filesystem::last_write_time(capture) + std::chrono::seconds(10));
+		}
+
+		std::string command = "\"" + std::string(argv[0]) + "\" \"" + directory.string() + "\" " + phase;
+		if (std::system(command.c_str()) != 0) {
+			fprintf(stderr, "FAILED: phase %s\n", phase);
+			return 1;
+		}
+	}
+
+	std::filesystem::remove_all(directory);
+	printf("ModuleManifest: all phases passed\n");
+	return 0;
+}
@@ -0,0 +1,166 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+// Hammers unique_object_manager::find(id) and generic_object_manager::find(id)
+// from several threads while other threads register and release objects.
+// A lookup must return either nothing or the object registered under that
+// id, never a different or half published one. Build with
+// -fsanitize=thread to also check the memory ordering.
+//
+// Usage: test-object-manager-stress [duration in ms]
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <random>
+#include <thread>
+#include "native-test.hpp"
+#include "utility.hpp"
+
+namespace {
+const int reader_count = 8;
+const int writer_count = 2;
+const size_t live_limit = 2000;
+const uint64_t untagged = std::numeric_limits<uint64_t>::max();
+
+struct object {
+	// The id is only known once allocate() returned, so readers can see an
+	// object before its tag is set.
+	std::atomic<uint64_t> tag{untagged};
+};
+
+object *get(object *obj)
+{
+	return obj;
+}
+
+object *get(const std::shared_ptr<object> &obj)
+{
+	return obj.get();
+}
+
+// M is the manager, make() creates an object of its element type.
+template<typename M, typename Make> void stress(const char *name, int duration_ms, Make make)
+{
+	typedef decltype(make()) element_t;
+
+	M manager;
+	std::atomic<bool> stop{false};
+	std::atomic<uint64_t> high_water{0};
+	std::atomic<uint64_t> lookups{0}, hits{0}, churn{0};
+
+	std::vector<std::thread> threads;
+	for (int r = 0; r < reader_count; r++) {
+		threads.emplace_back([&, r] {
+			std::mt19937 rng(r);
+			uint64_t count = 0, found = 0;
+			while (!stop.load(std::memory_order_relaxed)) {
+				uint64_t top = high_water.load(std::memory_order_relaxed);
+				uint64_t id = top - std::min<uint64_t>(top, rng() % 4096);
+				element_t obj = manager.find(id);
+				count++;
+				if (!obj)
+					continue;
+				found++;
+				uint64_t tag = get(obj)->tag.load(std::memory_order_acquire);
+				check(tag == untagged || tag == id, "find(id) returned the object of another id");
+			}
+			lookups += count;
+			hits += found;
+		});
+	}
+
+	std::vector<std::vector<uint64_t>> live(writer_count);
+	for (int w = 0; w < writer_count; w++) {
+		threads.emplace_back([&, w] {
+			std::mt19937 rng(100 + w);
+			std::vector<uint64_t> &ids = live[w];
+			auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(duration_ms);
+			while (std::chrono::steady_clock::now() < end) {
+				if (ids.size() < live_limit && (ids.empty() || rng() % 2)) {
+					element_t obj = make();
+					uint64_t id = manager.allocate(obj);
+					check(id != untagged, "allocate succeeds");
+					get(obj)->tag.store(id, std::memory_order_release);
+					uint64_t top = high_water.load(std::memory_order_relaxed);
+					while (top < id && !high_water.compare_exchange_weak(top, id, std::memory_order_relaxed)) {
+					}
+					ids.push_back(id);
+				} else {
+					size_t k = rng() % ids.size();
+					element_t obj = manager.free(ids[k]);
+					check(obj && get(obj)->tag.load() == ids[k], "free(id) releases the object of that id");
+					check(!manager.find(ids[k]), "a released id no longer resolves");
+					ids[k] = ids.back();
+					ids.pop_back();
+				}
+				churn++;
+			}
+		});
+	}
+
+	for (int w = 0; w < writer_count; w++)
+		threads[reader_count + w].join();
+	stop = true;
+	for (int r = 0; r < reader_count; r++)
+		threads[r].join();
+
+	// Everything still registered resolves both ways.
+	size_t expected = 0;
+	for (auto &ids : live) {
+		expected += ids.size();
+		for (uint64_t id : ids) {
+			element_t obj = manager.find(id);
+			check(obj && get(obj)->tag.load() == id, "a live id resolves to its object");
+			check(manager.find(obj) == id, "a live object resolves to its id");
+		}
+	}
+	check(manager.size() == expected, "size() matches the live objects");
+
+	printf("%s: %d readers, %d writers, %llu lookups (%llu hits), %llu allocate/free\n", name, reader_count, writer_count,
+	       (unsigned long long)lookups.load(), (unsigned long long)hits.load(), (unsigned long long)churn.load());
+
+	manager.clear();
+	check(manager.size() == 0, "clear() releases everything");
+	for (auto &ids : live) {
+		for (uint64_t id : ids)
+			check(!manager.find(id), "a cleared id no longer resolves");
+	}
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+	const int duration_ms = argc > 1 ? atoi(argv[1]) : 2000;
+
+	// unique_object_manager does not own its objects and a reader may still
+	// hold a released one, so they are only deleted at the end.
+	std::mutex storage_mutex;
+	std::deque<std::unique_ptr<object>> storage;
+	stress<utility::unique_object_manager<object>>("unique_object_manager", duration_ms, [&] {
+		std::lock_guard<std::mutex> lock(storage_mutex);
+		storage.emplace_back(new object);
+		return storage.back().get();
+	});
+
+	stress<utility::generic_object_manager<std::shared_ptr<object>>>("generic_object_manager", duration_ms,
+									 [] { return std::make_shared<object>(); });
+	return 0;
+}
@@ -0,0 +1,141 @@
+/******************************************************************************
+    Copyright (C) 2016-2019 by Streamlabs (General Workings Inc)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+// Checks the geometry GS::OverlayBuilder produces for the selection overlay
+// of a 200x100 box at (50, 20).
+
+#include <cmath>
+#include <cstdio>
+#include "gs-overlay.h"
+#include "native-test.hpp"
+
+namespace {
+bool near(float a, float b)
+{
+	return std::fabs(a - b) < 1e-3f;
+}
+
+struct Bounds {
+	float minX = INFINITY, minY = INFINITY;
+	float maxX = -INFINITY, maxY = -INFINITY;
+};
+
+Bounds bounds_of(const std::vector<GS::OverlayVertex> &vertices, size_t first, size_t last)
+{
+	Bounds bounds;
+	for (size_t i = first; i < last; i++) {
+		bounds.minX = std::fmin(bounds.minX, vertices[i].x);
+		bounds.minY = std::fmin(bounds.minY, vertices[i].y);
+		bounds.maxX = std::fmax(bounds.maxX, vertices[i].x);
+		bounds.maxY = std::fmax(bounds.maxY, vertices[i].y);
+	}
+	return bounds;
+}
+
+GS::OverlayTransform box()
+{
+	GS::OverlayTransform box;
+	box.xx = 200;
+	box.yy = 100;
+	box.tx = 50;
+	box.ty = 20;
+	return box;
+}
+
+void test_outline()
+{
+	GS::OverlayBuilder builder;
+	builder.AddOutline(box(), 0, 200, 100, 1, 2);
+	auto &lines = builder.Lines();
+	check(lines.size() == 8, "an uncropped outline is 4 lines");
+	check(builder.Triangles().empty(), "an uncropped outline has no dashes");
+	check(near(lines[0].x, 50) && near(lines[1].y, 120), "the left side runs down the box");
+	check(near(lines[6].y, 120) && near(lines[7].x, 250), "the bottom side runs along the box");
+
+	builder.Clear();
+	builder.AddOutline(box(), GS::OverlayBuilder::Top | GS::OverlayBuilder::Left, 200, 100, 1, 2);
+	auto &dashes = builder.Triangles();
+	// 15px per dash and gap: ceil(200 / 15) dashes on top, ceil(100 / 15) on the left
+	check(dashes.size() == (14 + 7) * 6, "cropped sides are dashed quads");
+	check(builder.Lines().size() == 4, "the other sides stay lines");
+	check(dashes[0].color == 2 && builder.Lines()[0].color == 1, "dashes use the crop color");
+	Bounds first = bounds_of(dashes, 0, 6);
+	check(near(first.maxX, 55) && near(first.maxY, 27.5f), "a dash is 5px wide and 7.5px long");
+}
+
+void test_guidelines()
+{
+	GS::OverlayBuilder builder;
+	builder.AddGuideline(box(), false, 0.5f, 0, 3);
+	builder.AddGuideline(box(), false, 0.5f, 1, 3);
+	builder.AddGuideline(box(), false, 0, 0.5f, 3);
+	builder.AddGuideline(box(), false, 1, 0.5f, 3);
+	auto &lines = builder.Guidelines();
+	check(lines.size() == 8, "one line per guideline");
+	check(near(lines[0].x, 150) && near(lines[0].y, 20), "a guideline starts on the box");
+	check(near(lines[1].y, 20 - 65535), "the top guideline points up");
+	check(near(lines[3].y, 120 + 65535), "the bottom guideline points down");
+	check(near(lines[5].x, 50 - 65535), "the left guideline points left");
+	check(near(lines[7].x, 250 + 65535), "the right guideline points right");
+}
+
+void test_handles()
+{
+	GS::OverlayBuilder builder;
+	builder.AddResizeHandle(box(), 1, 1, 5, 5, 4, 5);
+	auto &square = builder.Triangles();
+	check(square.size() == 6 && builder.Lines().size() == 8, "a resize handle is a quad with an outline");
+	check(near(square[0].x, 245) && near(square[0].y, 115) && near(square[5].x, 255), "the resize handle is centered on its corner");
+	check(builder.Lines()[0].color == 5, "the resize handle outline uses the outer color");
+
+	builder.Clear();
+	builder.AddRotationHandle(box(), 0, 5, 6);
+	auto &handle = builder.Triangles();
+	check(handle.size() == 6 + 40 * 3, "a rotation handle is a line quad and a 40 segment circle");
+	Bounds line = bounds_of(handle, 0, 6);
+	check(near(line.minY, 20 - 37.5f) && near(line.maxY, 20), "the line goes 37.5px up from the top edge");
+	Bounds circle = bounds_of(handle, 6, handle.size());
+	check(near(circle.maxY, 20 - 37.5f) && near(circle.minY, 20 - 52.5f), "the circle sits on the end of the line");
+
+	builder.Clear();
+	builder.AddRotationHandle(box(), 90, 5, 6);
+	Bounds rotated = bounds_of(builder.Triangles(), 0, builder.Triangles().size());
+	check(near(rotated.maxX, 150 + 52.5f), "rotated by 90 degrees the handle points right");
+}
+
+void test_glyphs()
+{
+	GS::OverlayBuilder builder;
+	builder.AddGlyph(10, 10, 8, 'x', 7);
+	builder.AddGlyph(10, 10, 8, ' ', 7);
+	auto &text = builder.Text();
+	check(text.size() == 6, "glyphs outside the atlas are skipped");
+	check(near(text[0].u, 0.75f) && near(text[0].v, 0.5f), "'x' is the last cell of the third row");
+	check(near(text[5].x, 18) && near(text[5].y, 26), "a glyph is scale wide and twice as high");
+}
+}
+
+int main()
+{
+	test_outline();
+	test_guidelines();
+	test_handles();
+	test_glyphs();
+	printf("OverlayBuilder: all checks passed\n");
+	return 0;
+}
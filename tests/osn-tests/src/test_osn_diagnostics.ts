@@ -0,0 +1,76 @@
+import 'mocha';
+import { expect } from 'chai';
+import * as osn from '../osn';
+import { logInfo, logEmptyLine } from '../util/logger';
+import { OBSHandler } from '../util/obs_handler';
+import { deleteConfigFiles } from '../util/general';
+import { ETestErrorMsg, GetErrorMessage } from '../util/error_messages';
+
+const testName = 'osn-diagnostics';
+
+describe(testName, () => {
+    let obs: OBSHandler;
+    let hasTestFailed: boolean = false;
+
+    // Initialize OBS process
+    before(function() {
+        logInfo(testName, 'Starting ' + testName + ' tests');
+        deleteConfigFiles();
+        obs = new OBSHandler(testName);
+    });
+
+    // Shutdown OBS process
+    after(async function() {
+        obs.shutdown();
+
+        if (hasTestFailed === true) {
+            logInfo(testName, 'One or more test cases failed. Uploading cache');
+            await obs.uploadTestCache();
+        }
+
+        obs = null;
+        deleteConfigFiles();
+        logInfo(testName, 'Finished ' + testName + ' tests');
+        logEmptyLine();
+    });
+
+    afterEach(function() {
+        if (this.currentTest.state == 'failed') {
+            hasTestFailed = true;
+        }
+    });
+
+    it('Get IPC latency stats', () => {
+        // Making a few calls that always reach the server
+        for (let i = 0; i < 10; i++) {
+            expect(osn.Global.laggedFrames).to.be.a('number', GetErrorMessage(ETestErrorMsg.LaggedFrames));
+        }
+
+        const stats = osn.Diagnostics.getIpcStats();
+        const laggedFrames = stats.find(call => call.name === 'Global.LaggedFrames');
+
+        // Checking if both sides timed the calls
+        expect(laggedFrames).to.not.equal(undefined, GetErrorMessage(ETestErrorMsg.IpcStats));
+        expect(laggedFrames.calls).to.be.at.least(10, GetErrorMessage(ETestErrorMsg.IpcStats));
+        expect(laggedFrames.handlerCalls).to.be.at.least(10, GetErrorMessage(ETestErrorMsg.IpcStats));
+        expect(laggedFrames.roundTrip.p50).to.be.at.most(laggedFrames.roundTrip.p99, GetErrorMessage(ETestErrorMsg.IpcStats));
+        expect(laggedFrames.handler.max).to.be.at.most(laggedFrames.roundTrip.max, GetErrorMessage(ETestErrorMsg.IpcStats));
+    });
+
+    it('Get startup timeline', () => {
+        const phases = osn.Diagnostics.getStartupTimeline();
+        const names = phases.map(phase => phase.name);
+
+        expect(names).to.include('obs_startup', GetErrorMessage(ETestErrorMsg.StartupTimeline));
+        expect(names).to.include('Load modules', GetErrorMessage(ETestErrorMsg.StartupTimeline));
+
+        const initAPI = phases.find(phase => phase.name === 'OBS_API_initAPI');
+        expect(initAPI).to.not.equal(undefined, GetErrorMessage(ETestErrorMsg.StartupTimeline));
+
+        // Every phase of the main thread happened within OBS_API_initAPI
+        phases.filter(phase => !phase.background && !phase.name.startsWith('Waiting')).forEach(phase => {
+            expect(phase.duration).to.be.at.least(0, GetErrorMessage(ETestErrorMsg.StartupTimeline));
+            expect(phase.start + phase.duration).to.be.at.most(initAPI.start + initAPI.duration + 0.001, GetErrorMessage(ETestErrorMsg.StartupTimeline));
+        });
+    });
+});
@@ -295,6 +295,71 @@ describe(testName, () => {
         scene.release();
     });
 
+    it('Load and save a scene collection', () => {
+        const sceneName = 'collection_scene';
+        const inputName = 'collection_input';
+
+        // Loading one input and a scene showing it, in a single call
+        const loaded = osn.CollectionFactory.load({
+            sources: [{
+                name: inputName,
+                type: EOBSInputTypes.ImageSource,
+                settings: { unload: true },
+                filters: [],
+                muted: false,
+                volume: 1,
+                syncOffset: { sec: 0, nsec: 0 },
+                deinterlaceMode: osn.EDeinterlaceMode.Disable,
+                deinterlaceFieldOrder: osn.EDeinterlaceFieldOrder.Top
+            }],
+            scenes: [{
+                name: sceneName,
+                items: [{
+                    name: inputName,
+                    crop: { left: 0, top: 0, right: 0, bottom: 0 },
+                    scaleX: 2,
+                    scaleY: 2,
+                    visible: true,
+                    x: 10,
+                    y: 20,
+                    rotation: 0,
+                    streamVisible: true,
+                    recordingVisible: true,
+                    scaleFilter: osn.EScaleType.Disable,
+                    blendingMode: osn.EBlendingMode.Normal
+                }]
+            }]
+        });
+
+        // Checking if sources, scenes and items were created in order
+        expect(loaded.sources.length).to.equal(1, GetErrorMessage(ETestErrorMsg.CreateInput, EOBSInputTypes.ImageSource));
+        expect(loaded.sources[0].name).to.equal(inputName, GetErrorMessage(ETestErrorMsg.InputName, EOBSInputTypes.ImageSource));
+        expect(loaded.sources[0].settings.unload).to.equal(true, GetErrorMessage(ETestErrorMsg.InputName, EOBSInputTypes.ImageSource));
+        expect(loaded.scenes.length).to.equal(1, GetErrorMessage(ETestErrorMsg.CreateScene, sceneName));
+        expect(loaded.scenes[0].name).to.equal(sceneName, GetErrorMessage(ETestErrorMsg.SceneName, sceneName));
+        expect(loaded.items[0].length).to.equal(1, GetErrorMessage(ETestErrorMsg.GetSceneItems, sceneName));
+        expect(loaded.items[0][0].source.name).to.equal(inputName, GetErrorMessage(ETestErrorMsg.SceneItemInputName, inputName));
+        expect(loaded.items[0][0].position).to.eql({ x: 10, y: 20 }, GetErrorMessage(ETestErrorMsg.SceneItemInputName, inputName));
+        expect(loaded.scenes[0].getItems().length).to.equal(1, GetErrorMessage(ETestErrorMsg.GetSceneItems, sceneName));
+
+        // Saving the collection back
+        const saved = osn.CollectionFactory.save();
+        const savedScene = saved.scenes.find(scene => scene.name === sceneName);
+        const savedInput = saved.sources.find(source => source.name === inputName);
+
+        // Checking if the saved collection matches what was loaded
+        expect(savedInput).to.not.equal(undefined, GetErrorMessage(ETestErrorMsg.InputName, EOBSInputTypes.ImageSource));
+        expect(savedInput.type).to.equal(EOBSInputTypes.ImageSource, GetErrorMessage(ETestErrorMsg.InputId, EOBSInputTypes.ImageSource));
+        expect(savedScene).to.not.equal(undefined, GetErrorMessage(ETestErrorMsg.SceneName, sceneName));
+        expect(savedScene.items.length).to.equal(1, GetErrorMessage(ETestErrorMsg.GetSceneItems, sceneName));
+        expect(savedScene.items[0].name).to.equal(inputName, GetErrorMessage(ETestErrorMsg.SceneItemInputName, inputName));
+        expect(savedScene.items[0].scaleX).to.equal(2, GetErrorMessage(ETestErrorMsg.SceneItemInputName, inputName));
+
+        loaded.items[0][0].remove();
+        loaded.sources[0].release();
+        loaded.scenes[0].release();
+    });
+
     it('Fail test - Get scene from name that don\'t exist ', () => {
         expect(function() {
             const failSceneFromName = osn.SceneFactory.fromName('does_not_exist');
@@ -399,4 +399,60 @@ describe(testName, () => {
         sceneItem.source.release();
         sceneItem.remove();
     });
+
+    it('Set and get multiple scene items in a single batch', () => {
+        let position: IVec2 = {x: 10, y: 20};
+        let crop: ICrop = {top: 5, bottom: 5, left: 3, right: 3};
+
+        // Getting scene
+        const scene = osn.SceneFactory.fromName(sceneName);
+
+        // Getting source
+        const source = osn.InputFactory.fromName(sourceName);
+
+        // Adding input source to scene twice to create two scene items
+        const firstItem = scene.add(source);
+        const secondItem = scene.add(source);
+
+        // Checking if input source was added to the scene correctly
+        expect(firstItem).to.not.equal(undefined, GetErrorMessage(ETestErrorMsg.AddSourceToScene, EOBSInputTypes.ImageSource, sceneName));
+        expect(secondItem).to.not.equal(undefined, GetErrorMessage(ETestErrorMsg.AddSourceToScene, EOBSInputTypes.ImageSource, sceneName));
+
+        // Updating both scene items in one call
+        const skipped = osn.SceneItemFactory.batchSet([
+            {item: firstItem, visible: false, position: position},
+            {item: secondItem, crop: crop},
+        ]);
+        expect(skipped).to.equal(0);
+
+        // Reading both scene items back in one call
+        const states = osn.SceneItemFactory.batchGet([firstItem, secondItem],
+            osn.ESceneItemField.Visible | osn.ESceneItemField.Position | osn.ESceneItemField.Crop | osn.ESceneItemField.Id);
+        expect(states.length).to.equal(2);
+
+        // Checking if the values were set properly
+        expect(states[0].visible).to.equal(false, GetErrorMessage(ETestErrorMsg.Visible));
+        expect(states[0].position.x).to.equal(position.x, GetErrorMessage(ETestErrorMsg.PositionX));
+        expect(states[0].position.y).to.equal(position.y, GetErrorMessage(ETestErrorMsg.PositionY));
+        expect(states[0].id).to.equal(firstItem.id);
+        expect(states[1].visible).to.equal(true, GetErrorMessage(ETestErrorMsg.Visible));
+        expect(states[1].crop.top).to.equal(crop.top, GetErrorMessage(ETestErrorMsg.CropTop));
+        expect(states[1].crop.bottom).to.equal(crop.bottom, GetErrorMessage(ETestErrorMsg.CropBottom));
+        expect(states[1].crop.left).to.equal(crop.left, GetErrorMessage(ETestErrorMsg.CropLeft));
+        expect(states[1].crop.right).to.equal(crop.right, GetErrorMessage(ETestErrorMsg.CropRight));
+        expect(states[1].id).to.equal(secondItem.id);
+
+        // Checking if the single accessors agree with the batch
+        expect(firstItem.visible).to.equal(false, GetErrorMessage(ETestErrorMsg.Visible));
+        expect(secondItem.crop.top).to.equal(crop.top, GetErrorMessage(ETestErrorMsg.CropTop));
+
+        // Checking that removed scene items are reported as null
+        secondItem.remove();
+        const remaining = osn.SceneItemFactory.batchGet([firstItem, secondItem], osn.ESceneItemField.Visible);
+        expect(remaining[0]).to.not.equal(null);
+        expect(remaining[1]).to.equal(null);
+
+        source.release();
+        firstItem.remove();
+    });
 });
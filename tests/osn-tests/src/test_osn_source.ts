@@ -614,4 +614,73 @@ describe(testName, () => {
             filter.release();
         });
     });
+
+    it('Refresh properties after a settings change', () => {
+        // Creating input source
+        const input = osn.InputFactory.create(EOBSInputTypes.ColorSource, 'input');
+
+        // Checking if input source was created correctly
+        expect(input).to.not.equal(undefined, GetErrorMessage(ETestErrorMsg.CreateInput, EOBSInputTypes.ColorSource));
+
+        // Getting properties twice, the second call only receives changed entries
+        const count = input.properties.count();
+        expect(input.properties.count()).to.equal(count, GetErrorMessage(ETestErrorMsg.Properties, EOBSInputTypes.ColorSource));
+
+        // Changing one setting
+        const settings = input.settings;
+        settings['width'] = 640;
+        input.update(settings);
+
+        // Checking if the changed property was refreshed and the others kept
+        const properties = input.properties;
+        expect(properties.count()).to.equal(count, GetErrorMessage(ETestErrorMsg.Properties, EOBSInputTypes.ColorSource));
+        expect(properties.get('width').value).to.equal(640, GetErrorMessage(ETestErrorMsg.Properties, EOBSInputTypes.ColorSource));
+        expect(properties.get('color')).to.not.equal(undefined, GetErrorMessage(ETestErrorMsg.Properties, EOBSInputTypes.ColorSource));
+
+        input.release();
+    });
+
+    it('Update settings with only the changed keys', () => {
+        // Creating input source
+        const input = osn.InputFactory.create(EOBSInputTypes.ColorSource, 'input');
+
+        // Checking if input source was created correctly
+        expect(input).to.not.equal(undefined, GetErrorMessage(ETestErrorMsg.CreateInput, EOBSInputTypes.ColorSource));
+
+        // Reading the settings once so that the next updates are sent as patches
+        let settings = input.settings;
+        settings['width'] = 640;
+        input.update(settings);
+        settings['height'] = 360;
+        input.update(settings);
+
+        // Checking if both changes were applied and the other settings kept
+        expect(input.settings).to.eql(settings, GetErrorMessage(ETestErrorMsg.SaveSettings, EOBSInputTypes.ColorSource));
+
+        // Updating a single key, the cached settings must follow
+        input.update({ width: 320 });
+        settings['width'] = 320;
+        expect(input.settings).to.eql(settings, GetErrorMessage(ETestErrorMsg.SaveSettings, EOBSInputTypes.ColorSource));
+
+        input.release();
+    });
+
+    it('Keep nested settings through an update', () => {
+        // Creating input source
+        const input = osn.InputFactory.create(EOBSInputTypes.ColorSource, 'input');
+
+        // Checking if input source was created correctly
+        expect(input).to.not.equal(undefined, GetErrorMessage(ETestErrorMsg.CreateInput, EOBSInputTypes.ColorSource));
+
+        // Objects, arrays of objects, doubles and large strings must come back as they were sent
+        let settings = input.settings;
+        settings['custom'] = { name: 'nested', ratio: 0.5, inner: { enabled: true } };
+        settings['list'] = [{ value: 'first' }, { value: 'second', hidden: false }];
+        settings['text'] = 'x'.repeat(1 << 20);
+        input.update(settings);
+
+        expect(input.settings).to.eql(settings, GetErrorMessage(ETestErrorMsg.SaveSettings, EOBSInputTypes.ColorSource));
+
+        input.release();
+    });
 });
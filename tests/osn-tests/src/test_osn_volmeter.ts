@@ -112,4 +112,64 @@ describe(testName, () => {
 
         input.release();
     });
+
+    it('Read volmeter levels from the shared level buffer', () => {
+        // Creating audio source
+        const input = osn.InputFactory.create(EOBSInputTypes.WASAPIInput, 'input');
+
+        // Checking if input source was created correctly
+        expect(input).to.not.equal(undefined, GetErrorMessage(ETestErrorMsg.CreateInput, EOBSInputTypes.WASAPIInput));
+
+        // Creating volmeter
+        const volmeter = osn.VolmeterFactory.create(osn.EFaderType.IEC);
+
+        // Checking if volmeter was created correctly
+        expect(volmeter).to.not.equal(undefined, GetErrorMessage(ETestErrorMsg.CreateVolmeter));
+
+        volmeter.attach(input);
+
+        // Reading levels
+        const levels = volmeter.readLevels();
+
+        // Checking if levels were returned as magnitude, peak and input peak per channel
+        expect(levels).to.be.instanceOf(Float32Array);
+        expect(levels.length % 3).to.equal(0);
+
+        volmeter.detach();
+        volmeter.destroy();
+        input.release();
+    });
+
+    it('Configure volmeter ballistics and read the smoothed levels', () => {
+        // Creating audio source
+        const input = osn.InputFactory.create(EOBSInputTypes.WASAPIInput, 'input');
+
+        // Checking if input source was created correctly
+        expect(input).to.not.equal(undefined, GetErrorMessage(ETestErrorMsg.CreateInput, EOBSInputTypes.WASAPIInput));
+
+        // Creating volmeter
+        const volmeter = osn.VolmeterFactory.create(osn.EFaderType.IEC);
+
+        // Checking if volmeter was created correctly
+        expect(volmeter).to.not.equal(undefined, GetErrorMessage(ETestErrorMsg.CreateVolmeter));
+
+        volmeter.attach(input);
+
+        // Setting attack time, decay rate and peak hold duration
+        expect(() => volmeter.setBallistics(0.3, 20, 1)).to.not.throw();
+
+        // Negative values are rejected
+        expect(() => volmeter.setBallistics(-1, 20, 1)).to.throw();
+
+        // Reading levels with ballistics
+        const levels = volmeter.readLevels(true);
+
+        // Checking if the ballistic values were appended to the raw levels
+        expect(levels).to.be.instanceOf(Float32Array);
+        expect(levels.length % 7).to.equal(0);
+
+        volmeter.detach();
+        volmeter.destroy();
+        input.release();
+    });
 });
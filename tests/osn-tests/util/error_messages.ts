@@ -50,6 +50,9 @@ export const enum ETestErrorMsg {
     AdvancedSettings = 'One or more advanced setting failed to be updated',
     EmptyCategoriesList = 'Got empty list of settings categories',
     CategoriesListIsMissingValue = 'List of settings categories is missing a category',
+    // osn-diagnostics
+    IpcStats = 'IPC stats are missing or inconsistent',
+    StartupTimeline = 'Startup timeline is missing or inconsistent',
     // osn-fader
     CreateFader = 'Failed to create %VALUE1% fader',
     GetDecibel = 'Failed to get decibel value of fader %VALUE1%',